@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include <components/detournavigator/navmeshdb.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+
+    constexpr std::string_view worldspace = "sys::default";
+    constexpr int tilesPerSide = 32;
+
+    // Looks like a serialized navmesh tile: vertices on a grid with small height variation followed by indices
+    template <typename Random>
+    std::vector<std::byte> generateTileData(Random& random)
+    {
+        constexpr int verticesPerSide = 48;
+        std::uniform_real_distribution<float> heightDistribution(-8, 8);
+        std::vector<float> vertices;
+        vertices.reserve(verticesPerSide * verticesPerSide * 3);
+        for (int x = 0; x < verticesPerSide; ++x)
+            for (int y = 0; y < verticesPerSide; ++y)
+            {
+                vertices.push_back(static_cast<float>(x) * 0.2f);
+                vertices.push_back(heightDistribution(random));
+                vertices.push_back(static_cast<float>(y) * 0.2f);
+            }
+        std::vector<int> indices;
+        indices.reserve((verticesPerSide - 1) * (verticesPerSide - 1) * 6);
+        for (int x = 0; x < verticesPerSide - 1; ++x)
+            for (int y = 0; y < verticesPerSide - 1; ++y)
+            {
+                const int i = x * verticesPerSide + y;
+                indices.insert(indices.end(), {i, i + 1, i + verticesPerSide, i + 1, i + verticesPerSide + 1, i + verticesPerSide});
+            }
+        std::vector<std::byte> result(vertices.size() * sizeof(float) + indices.size() * sizeof(int));
+        std::memcpy(result.data(), vertices.data(), vertices.size() * sizeof(float));
+        std::memcpy(result.data() + vertices.size() * sizeof(float), indices.data(), indices.size() * sizeof(int));
+        return result;
+    }
+
+    std::vector<std::byte> makeInput(const TilePosition& tilePosition)
+    {
+        const int position[] = {tilePosition.x(), tilePosition.y()};
+        std::vector<std::byte> result(sizeof(position));
+        std::memcpy(result.data(), position, sizeof(position));
+        return result;
+    }
+
+    struct TemporaryFile
+    {
+        const boost::filesystem::path mPath = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw-navmeshdb-benchmark-%%%%-%%%%-%%%%.db");
+
+        ~TemporaryFile()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(mPath, ec);
+        }
+    };
+
+    template <int compressionLevel, std::uint64_t mmapSize>
+    void getTileData(benchmark::State& state)
+    {
+        const TemporaryFile file;
+        NavMeshDb db(file.mPath.string(), std::numeric_limits<std::uint64_t>::max(), compressionLevel, mmapSize);
+        std::minstd_rand random;
+
+        {
+            Sqlite3::Transaction transaction = db.startTransaction();
+            TileId tileId {1};
+            for (int x = 0; x < tilesPerSide; ++x)
+                for (int y = 0; y < tilesPerSide; ++y)
+                {
+                    const TilePosition tilePosition(x, y);
+                    db.insertTile(tileId, worldspace, tilePosition, TileVersion {1}, makeInput(tilePosition),
+                        generateTileData(random));
+                    ++tileId;
+                }
+            transaction.commit();
+        }
+
+        std::uniform_int_distribution<int> distribution(0, tilesPerSide - 1);
+        std::size_t bytes = 0;
+
+        for (auto _ : state)
+        {
+            const TilePosition tilePosition(distribution(random), distribution(random));
+            const auto result = db.getTileData(worldspace, tilePosition, makeInput(tilePosition));
+            bytes += result->mData.size();
+            benchmark::DoNotOptimize(result);
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    }
+
+    void getTileData_lz4(benchmark::State& state)
+    {
+        getTileData<0, 0>(state);
+    }
+
+    void getTileData_lz4hc(benchmark::State& state)
+    {
+        getTileData<9, 0>(state);
+    }
+
+    void getTileData_lz4_mmap(benchmark::State& state)
+    {
+        getTileData<0, 256 * 1024 * 1024>(state);
+    }
+
+    void getTileData_lz4hc_mmap(benchmark::State& state)
+    {
+        getTileData<9, 256 * 1024 * 1024>(state);
+    }
+} // namespace
+
+BENCHMARK(getTileData_lz4);
+BENCHMARK(getTileData_lz4hc);
+BENCHMARK(getTileData_lz4_mmap);
+BENCHMARK(getTileData_lz4hc_mmap);
+
+BENCHMARK_MAIN();
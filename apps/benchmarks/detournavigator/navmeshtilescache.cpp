@@ -175,6 +175,85 @@ namespace
         }
     }
 
+    // Models tiles rebuilt around the player in one cell: the agent, the heightfield and most of the mesh are the same
+    // and only a few vertices moved, so keys can't be told apart by their prefix.
+    template <class Random>
+    struct SameCellKeyGenerator
+    {
+        Random& mRandom;
+        AgentBounds mAgentBounds {CollisionShapeType::Aabb, generateAgentHalfExtents(0.5, 1.5, mRandom)};
+        osg::Vec2i mCellPosition = generateVec2i(1000, mRandom);
+        Mesh mMesh = generateMesh(trianglesPerTile, mRandom);
+        Heightfield mHeightfield = generateHeightfield(mRandom);
+        FlatHeightfield mFlatHeightfield = generateFlatHeightfield(mRandom);
+
+        Key operator()()
+        {
+            constexpr int tilesPerCellSide = 4;
+            std::uniform_int_distribution<int> tileDistribution(0, tilesPerCellSide - 1);
+            const TilePosition tilePosition = mCellPosition * tilesPerCellSide
+                + TilePosition(tileDistribution(mRandom), tileDistribution(mRandom));
+            std::vector<int> indices = mMesh.getIndices();
+            std::vector<float> vertices = mMesh.getVertices();
+            std::vector<AreaType> areaTypes = mMesh.getAreaTypes();
+            if (!vertices.empty())
+                vertices.back() = std::uniform_real_distribution<float>(0.0, 1.0)(mRandom);
+            Mesh mesh(std::move(indices), std::move(vertices), std::move(areaTypes));
+            std::vector<CellWater> water {CellWater {mCellPosition, Water {ESM::Land::REAL_SIZE, 0.0f}}};
+            RecastMesh recastMesh(0, 0, std::move(mesh), std::move(water), {mHeightfield}, {mFlatHeightfield}, {});
+            return Key {mAgentBounds, tilePosition, std::move(recastMesh)};
+        }
+    };
+
+    template <std::size_t maxCacheSize, int hitPercentage>
+    void getFromFilledCacheSameCell(benchmark::State& state)
+    {
+        NavMeshTilesCache cache(maxCacheSize);
+        std::minstd_rand random;
+        SameCellKeyGenerator<std::minstd_rand> generator {random};
+        std::vector<Key> keys;
+        std::size_t size = 0;
+        while (true)
+        {
+            Key key = generator();
+            cache.set(key.mAgentBounds, key.mTilePosition, key.mRecastMesh, std::make_unique<PreparedNavMeshData>());
+            keys.push_back(std::move(key));
+            const std::size_t newSize = cache.getStats().mNavMeshCacheSize;
+            if (size >= newSize)
+                break;
+            size = newSize;
+        }
+        std::generate_n(std::back_inserter(keys), keys.size() * (100 - hitPercentage) / 100, generator);
+        std::size_t n = 0;
+
+        while (state.KeepRunning())
+        {
+            const auto& key = keys[n++ % keys.size()];
+            const auto result = cache.get(key.mAgentBounds, key.mTilePosition, key.mRecastMesh);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void getFromFilledCacheSameCell_4m_100hit(benchmark::State& state)
+    {
+        getFromFilledCacheSameCell<4 * 1024 * 1024, 100>(state);
+    }
+
+    void getFromFilledCacheSameCell_16m_100hit(benchmark::State& state)
+    {
+        getFromFilledCacheSameCell<16 * 1024 * 1024, 100>(state);
+    }
+
+    void getFromFilledCacheSameCell_4m_70hit(benchmark::State& state)
+    {
+        getFromFilledCacheSameCell<4 * 1024 * 1024, 70>(state);
+    }
+
+    void getFromFilledCacheSameCell_16m_70hit(benchmark::State& state)
+    {
+        getFromFilledCacheSameCell<16 * 1024 * 1024, 70>(state);
+    }
+
     template <std::size_t maxCacheSize, int hitPercentage>
     void getFromFilledCache(benchmark::State& state)
     {
@@ -282,6 +361,10 @@ BENCHMARK(getFromFilledCache_1m_70hit);
 BENCHMARK(getFromFilledCache_4m_70hit);
 BENCHMARK(getFromFilledCache_16m_70hit);
 BENCHMARK(getFromFilledCache_64m_70hit);
+BENCHMARK(getFromFilledCacheSameCell_4m_100hit);
+BENCHMARK(getFromFilledCacheSameCell_16m_100hit);
+BENCHMARK(getFromFilledCacheSameCell_4m_70hit);
+BENCHMARK(getFromFilledCacheSameCell_16m_70hit);
 BENCHMARK(setToBoundedNonEmptyCache_1m);
 BENCHMARK(setToBoundedNonEmptyCache_4m);
 BENCHMARK(setToBoundedNonEmptyCache_16m);
@@ -0,0 +1,186 @@
+#include <benchmark/benchmark.h>
+
+#include <components/esm3/loadland.hpp>
+#include <components/esm3/loadltex.hpp>
+#include <components/esm3terrain/storage.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <osg/Image>
+#include <osg/Vec3f>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr int sWorldSize = 8;
+    constexpr int sNumTextures = 8;
+
+    template <typename Random>
+    std::unique_ptr<ESM::Land> generateLand(Random& random)
+    {
+        std::uniform_real_distribution<float> heights(-1024.0f, 4096.0f);
+        std::uniform_real_distribution<float> slopes(-0.5f, 0.5f);
+        std::uniform_int_distribution<int> colours(0, 255);
+        std::uniform_int_distribution<int> textures(0, sNumTextures);
+
+        auto land = std::make_unique<ESM::Land>();
+        land->blank();
+        ESM::Land::LandData& data = *land->getLandData();
+        for (float& height : data.mHeights)
+            height = heights(random);
+        for (int i = 0; i < ESM::Land::LAND_NUM_VERTS; ++i)
+        {
+            osg::Vec3f normal(slopes(random), slopes(random), 1.0f);
+            normal.normalize();
+            for (int j = 0; j < 3; ++j)
+                data.mNormals[i * 3 + j] = static_cast<ESM::Land::VNML>(normal[j] * 127);
+        }
+        for (unsigned char& colour : data.mColours)
+            colour = static_cast<unsigned char>(colours(random));
+        // Vanilla texture placement is patchy rather than noisy, so repeat each texture for a few texels
+        for (int y = 0; y < ESM::Land::LAND_TEXTURE_SIZE; ++y)
+            for (int x = 0; x < ESM::Land::LAND_TEXTURE_SIZE; x += 4)
+                std::fill_n(data.mTextures + y * ESM::Land::LAND_TEXTURE_SIZE + x, 4, static_cast<std::uint16_t>(textures(random)));
+        return land;
+    }
+
+    class Storage final : public ESMTerrain::Storage
+    {
+    public:
+        explicit Storage(const VFS::Manager* vfs)
+            : ESMTerrain::Storage(vfs)
+        {
+            std::minstd_rand random;
+            for (int x = 0; x < sWorldSize; ++x)
+            {
+                for (int y = 0; y < sWorldSize; ++y)
+                {
+                    std::unique_ptr<ESM::Land> land = generateLand(random);
+                    mLandObjects.emplace(std::make_pair(x, y), new ESMTerrain::LandObject(land.get(), ESM::Land::DATA_VHGT
+                        | ESM::Land::DATA_VNML | ESM::Land::DATA_VCLR | ESM::Land::DATA_VTEX));
+                    mLands.push_back(std::move(land));
+                }
+            }
+            for (int i = 0; i < sNumTextures; ++i)
+                mLandTextures[i].mTexture = "texture" + std::to_string(i) + ".dds";
+        }
+
+        osg::ref_ptr<const ESMTerrain::LandObject> getLand(int cellX, int cellY) override
+        {
+            const auto it = mLandObjects.find(std::make_pair(cellX, cellY));
+            if (it == mLandObjects.end())
+                return nullptr;
+            return it->second;
+        }
+
+        const ESM::LandTexture* getLandTexture(int index, short /*plugin*/) override
+        {
+            if (index < 0 || index >= sNumTextures)
+                return nullptr;
+            return &mLandTextures[index];
+        }
+
+        void getBounds(float& minX, float& maxX, float& minY, float& maxY) override
+        {
+            minX = 0;
+            minY = 0;
+            maxX = sWorldSize;
+            maxY = sWorldSize;
+        }
+
+    private:
+        std::vector<std::unique_ptr<ESM::Land>> mLands;
+        std::map<std::pair<int, int>, osg::ref_ptr<const ESMTerrain::LandObject>> mLandObjects;
+        std::array<ESM::LandTexture, sNumTextures> mLandTextures;
+    };
+
+    Storage& getStorage()
+    {
+        static const VFS::Manager vfs(false);
+        static Storage storage(&vfs);
+        return storage;
+    }
+
+    void fillVertexBuffers(benchmark::State& state, float size)
+    {
+        Storage& storage = getStorage();
+        const int lodLevel = static_cast<int>(state.range(0));
+        // Chunks in the middle of the world have neighbours on all sides
+        const osg::Vec2f center(sWorldSize / 2.0f, sWorldSize / 2.0f);
+        osg::ref_ptr<osg::Vec3Array> positions(new osg::Vec3Array);
+        osg::ref_ptr<osg::Vec3Array> normals(new osg::Vec3Array);
+        osg::ref_ptr<osg::Vec4ubArray> colours(new osg::Vec4ubArray);
+
+        while (state.KeepRunning())
+        {
+            storage.fillVertexBuffers(lodLevel, size, center, positions, normals, colours);
+            benchmark::DoNotOptimize(positions->front());
+            benchmark::DoNotOptimize(normals->front());
+            benchmark::DoNotOptimize(colours->front());
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(positions->size()));
+    }
+
+    void fillVertexBuffers_quarterCell(benchmark::State& state)
+    {
+        fillVertexBuffers(state, 0.25f);
+    }
+
+    void fillVertexBuffers_1cell(benchmark::State& state)
+    {
+        fillVertexBuffers(state, 1.0f);
+    }
+
+    void fillVertexBuffers_4cells(benchmark::State& state)
+    {
+        fillVertexBuffers(state, 2.0f);
+    }
+
+    void fillVertexBuffers_16cells(benchmark::State& state)
+    {
+        fillVertexBuffers(state, 4.0f);
+    }
+
+    void getBlendmaps(benchmark::State& state, float size)
+    {
+        Storage& storage = getStorage();
+        const osg::Vec2f center(sWorldSize / 2.0f, sWorldSize / 2.0f);
+
+        while (state.KeepRunning())
+        {
+            ESMTerrain::Storage::ImageVector blendmaps;
+            std::vector<Terrain::LayerInfo> layerList;
+            storage.getBlendmaps(size, center, blendmaps, layerList);
+            benchmark::DoNotOptimize(blendmaps);
+        }
+    }
+
+    void getBlendmaps_quarterCell(benchmark::State& state)
+    {
+        getBlendmaps(state, 0.25f);
+    }
+
+    void getBlendmaps_1cell(benchmark::State& state)
+    {
+        getBlendmaps(state, 1.0f);
+    }
+}
+
+// A cell has 64 quads per side, so LOD 6 is the coarsest level that still has a vertex per cell corner
+BENCHMARK(fillVertexBuffers_quarterCell)->DenseRange(0, 4);
+BENCHMARK(fillVertexBuffers_1cell)->DenseRange(0, 6);
+BENCHMARK(fillVertexBuffers_4cells)->DenseRange(0, 6);
+BENCHMARK(fillVertexBuffers_16cells)->DenseRange(0, 6);
+BENCHMARK(getBlendmaps_quarterCell);
+BENCHMARK(getBlendmaps_1cell);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,509 @@
+#include <benchmark/benchmark.h>
+
+#include <components/compiler/context.hpp>
+#include <components/compiler/extensions.hpp>
+#include <components/compiler/extensions0.hpp>
+#include <components/compiler/fileparser.hpp>
+#include <components/compiler/nullerrorhandler.hpp>
+#include <components/compiler/opcodes.hpp>
+#include <components/compiler/scanner.hpp>
+#include <components/interpreter/context.hpp>
+#include <components/interpreter/installopcodes.hpp>
+#include <components/interpreter/interpreter.hpp>
+#include <components/interpreter/opcodes.hpp>
+#include <components/interpreter/runtime.hpp>
+#include <components/misc/stringops.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Scripts in the style of the vanilla local and global scripts. Most vanilla scripts call engine functions that need
+    // a running game, so these only use the ones stubbed below.
+    const std::vector<std::string> sScripts {
+        R"mwscript(Begin bm_lighttimer
+
+short state
+float timer
+
+if ( MenuMode == 1 )
+    return
+endif
+
+set timer to timer + GetSecondsPassed
+
+if ( state == 0 )
+    if ( timer > 5 )
+        Disable
+        set state to 1
+        set timer to 0
+    endif
+elseif ( state == 1 )
+    if ( timer > 3 )
+        Enable
+        set state to 0
+        set timer to 0
+    endif
+endif
+
+End)mwscript",
+        R"mwscript(Begin bm_shrineactivate
+
+short doOnce
+
+if ( OnActivate == 1 )
+    if ( doOnce == 0 )
+        set bm_shrinecount to bm_shrinecount + 1
+        set doOnce to 1
+    endif
+endif
+
+End)mwscript",
+        R"mwscript(Begin bm_randomambient
+
+float timer
+short roll
+
+if ( MenuMode )
+    return
+endif
+
+set timer to ( timer + GetSecondsPassed )
+if ( timer < 1 )
+    return
+endif
+
+set timer to 0
+set roll to Random 100
+
+if ( roll < 10 )
+    set bm_ambientstate to 1
+elseif ( roll < 40 )
+    set bm_ambientstate to 2
+elseif ( roll < 70 )
+    set bm_ambientstate to 3
+else
+    set bm_ambientstate to 0
+endif
+
+End)mwscript",
+        R"mwscript(Begin bm_daycounter
+
+short lastDay
+
+if ( Day != lastDay )
+    set lastDay to Day
+    set bm_dayspassed to bm_dayspassed + 1
+endif
+
+if ( GameHour >= 20 )
+    set bm_nighttime to 1
+elseif ( GameHour < 6 )
+    set bm_nighttime to 1
+else
+    set bm_nighttime to 0
+endif
+
+End)mwscript",
+        R"mwscript(Begin bm_arithmetic
+
+short i
+long total
+float average
+
+set i to 0
+set total to 0
+while ( i < 20 )
+    set total to total + ( i * i ) - ( i / 2 )
+    set i to i + 1
+endwhile
+set average to total / 20.0
+
+End)mwscript",
+    };
+
+    // Number of objects running each local script
+    constexpr std::size_t sInstances = 64;
+
+    const std::map<std::string, char, std::less<>> sGlobalTypes {
+        {"bm_ambientstate", 's'},
+        {"bm_dayspassed", 'l'},
+        {"bm_nighttime", 's'},
+        {"bm_shrinecount", 's'},
+        {"day", 's'},
+        {"gamehour", 'f'},
+    };
+
+    class CompilerContext : public Compiler::Context
+    {
+    public:
+        bool canDeclareLocals() const override { return true; }
+
+        char getGlobalType(const std::string& name) const override
+        {
+            const auto it = sGlobalTypes.find(Misc::StringUtils::lowerCase(name));
+            return it == sGlobalTypes.end() ? ' ' : it->second;
+        }
+
+        std::pair<char, bool> getMemberType(const std::string& name, const std::string& id) const override { return {' ', false}; }
+
+        bool isId(const std::string& name) const override { return false; }
+    };
+
+    struct Globals
+    {
+        std::map<std::string, Interpreter::Data, std::less<>> mValues;
+    };
+
+    class InterpreterContext : public Interpreter::Context
+    {
+        Globals* mGlobals;
+        std::vector<int> mShorts;
+        std::vector<int> mLongs;
+        std::vector<float> mFloats;
+
+    public:
+        InterpreterContext(Globals& globals, const Compiler::Locals& locals)
+            : mGlobals(&globals)
+            , mShorts(locals.get('s').size())
+            , mLongs(locals.get('l').size())
+            , mFloats(locals.get('f').size())
+        {}
+
+        std::string getTarget() const override { return {}; }
+
+        int getLocalShort(int index) const override { return mShorts[index]; }
+
+        int getLocalLong(int index) const override { return mLongs[index]; }
+
+        float getLocalFloat(int index) const override { return mFloats[index]; }
+
+        void setLocalShort(int index, int value) override { mShorts[index] = value; }
+
+        void setLocalLong(int index, int value) override { mLongs[index] = value; }
+
+        void setLocalFloat(int index, float value) override { mFloats[index] = value; }
+
+        void messageBox(const std::string& message, const std::vector<std::string>& buttons) override {}
+
+        void report(const std::string& message) override {}
+
+        int getGlobalShort(std::string_view name) const override { return getGlobal(name).mInteger; }
+
+        int getGlobalLong(std::string_view name) const override { return getGlobal(name).mInteger; }
+
+        float getGlobalFloat(std::string_view name) const override { return getGlobal(name).mFloat; }
+
+        void setGlobalShort(std::string_view name, int value) override { setGlobal(name).mInteger = value; }
+
+        void setGlobalLong(std::string_view name, int value) override { setGlobal(name).mInteger = value; }
+
+        void setGlobalFloat(std::string_view name, float value) override { setGlobal(name).mFloat = value; }
+
+        std::vector<std::string> getGlobals() const override { return {}; }
+
+        char getGlobalType(std::string_view name) const override
+        {
+            const auto it = sGlobalTypes.find(name);
+            return it == sGlobalTypes.end() ? ' ' : it->second;
+        }
+
+        std::string getActionBinding(std::string_view action) const override { return {}; }
+
+        std::string getActorName() const override { return {}; }
+
+        std::string getNPCRace() const override { return {}; }
+
+        std::string getNPCClass() const override { return {}; }
+
+        std::string getNPCFaction() const override { return {}; }
+
+        std::string getNPCRank() const override { return {}; }
+
+        std::string getPCName() const override { return {}; }
+
+        std::string getPCRace() const override { return {}; }
+
+        std::string getPCClass() const override { return {}; }
+
+        std::string getPCRank() const override { return {}; }
+
+        std::string getPCNextRank() const override { return {}; }
+
+        int getPCBounty() const override { return {}; }
+
+        std::string getCurrentCellName() const override { return {}; }
+
+        int getMemberShort(std::string_view id, std::string_view name, bool global) const override { return {}; }
+
+        int getMemberLong(std::string_view id, std::string_view name, bool global) const override { return {}; }
+
+        float getMemberFloat(std::string_view id, std::string_view name, bool global) const override { return {}; }
+
+        void setMemberShort(std::string_view id, std::string_view name, int value, bool global) override {}
+
+        void setMemberLong(std::string_view id, std::string_view name, int value, bool global) override {}
+
+        void setMemberFloat(std::string_view id, std::string_view name, float value, bool global) override {}
+
+    private:
+        Interpreter::Data getGlobal(std::string_view name) const
+        {
+            const auto it = mGlobals->mValues.find(name);
+            return it == mGlobals->mValues.end() ? Interpreter::Data {} : it->second;
+        }
+
+        Interpreter::Data& setGlobal(std::string_view name)
+        {
+            const auto it = mGlobals->mValues.find(name);
+            if (it != mGlobals->mValues.end())
+                return it->second;
+            return mGlobals->mValues[std::string(name)];
+        }
+    };
+
+    template <class T>
+    class OpPush : public Interpreter::Opcode0
+    {
+        T mValue;
+
+    public:
+        explicit OpPush(T value) : mValue(value) {}
+
+        void execute(Interpreter::Runtime& runtime) override { runtime.push(mValue); }
+    };
+
+    class OpNothing : public Interpreter::Opcode0
+    {
+    public:
+        void execute(Interpreter::Runtime& runtime) override {}
+    };
+
+    class OpRandom : public Interpreter::Opcode0
+    {
+        std::uint32_t mState = 1;
+
+    public:
+        void execute(Interpreter::Runtime& runtime) override
+        {
+            const Interpreter::Type_Integer limit = runtime[0].mInteger;
+            runtime.pop();
+            mState = mState * 1664525u + 1013904223u;
+            runtime.push(static_cast<Interpreter::Type_Float>(mState % static_cast<std::uint32_t>(limit)));
+        }
+    };
+
+    // The dispatch Interpreter::run used before opcodes were kept in tables: a std::map lookup for every executed
+    // instruction. It shares the opcodes of the interpreter, so only the dispatch differs.
+    class MapDispatch
+    {
+        std::map<int, Interpreter::Opcode1*> mSegment0;
+        std::map<int, Interpreter::Opcode1*> mSegment2;
+        std::map<int, Interpreter::Opcode1*> mSegment3;
+        std::map<int, Interpreter::Opcode0*> mSegment5;
+        Interpreter::Runtime mRuntime;
+
+        template <class TOp, class TGetOpcode, class TMakeCode>
+        static void addOpcodes(const Interpreter::Interpreter& interpreter, int begin, int end,
+            std::map<int, TOp*>& segment, TGetOpcode&& getOpcode, TMakeCode&& makeCode)
+        {
+            std::vector<Interpreter::Type_Code> code {static_cast<Interpreter::Type_Code>(end - begin), 0, 0, 0};
+            for (int opcode = begin; opcode < end; ++opcode)
+                code.push_back(makeCode(opcode));
+            const std::vector<Interpreter::Instruction> instructions
+                = interpreter.decode(code.data(), static_cast<int>(code.size()));
+            for (int opcode = begin; opcode < end; ++opcode)
+                if (TOp* op = getOpcode(instructions[opcode - begin]))
+                    segment.emplace(opcode, op);
+        }
+
+        template <class TOp>
+        static TOp* getDispatcher(const std::map<int, TOp*>& segment, int opcode)
+        {
+            const auto it = segment.find(opcode);
+            if (it == segment.end())
+                throw std::runtime_error("unknown opcode " + std::to_string(opcode));
+            return it->second;
+        }
+
+        void execute(Interpreter::Type_Code code)
+        {
+            switch (code >> 30)
+            {
+                case 0:
+                    return getDispatcher(mSegment0, code >> 24)->execute(mRuntime, code & 0xffffff);
+                case 2:
+                    return getDispatcher(mSegment2, (code >> 20) & 0x3ff)->execute(mRuntime, code & 0xfffff);
+            }
+
+            switch (code >> 26)
+            {
+                case 0x30:
+                    return getDispatcher(mSegment3, (code >> 8) & 0x3ffff)->execute(mRuntime, code & 0xff);
+                case 0x32:
+                    return getDispatcher(mSegment5, code & 0x3ffffff)->execute(mRuntime);
+            }
+
+            throw std::runtime_error("unknown segment");
+        }
+
+    public:
+        explicit MapDispatch(const Interpreter::Interpreter& interpreter)
+        {
+            const auto getOpcode1 = [](const Interpreter::Instruction& v) { return v.mOpcode1; };
+            const auto getOpcode0 = [](const Interpreter::Instruction& v) { return v.mOpcode0; };
+            addOpcodes(interpreter, 0, 64, mSegment0, getOpcode1,
+                [](int opcode) { return static_cast<Interpreter::Type_Code>(opcode) << 24; });
+            addOpcodes(interpreter, 0, 1024, mSegment2, getOpcode1,
+                [](int opcode) { return 0x80000000u | static_cast<Interpreter::Type_Code>(opcode) << 20; });
+            addOpcodes(interpreter, 0, 262144, mSegment3, getOpcode1,
+                [](int opcode) { return 0xc0000000u | static_cast<Interpreter::Type_Code>(opcode) << 8; });
+            // Segment 5 is too large to scan, its opcodes are at the start of the interpreter and extension ranges
+            const auto makeCode5 = [](int opcode) { return 0xc8000000u | static_cast<Interpreter::Type_Code>(opcode); };
+            addOpcodes(interpreter, 0, 1024, mSegment5, getOpcode0, makeCode5);
+            addOpcodes(interpreter, 0x2000000, 0x2010000, mSegment5, getOpcode0, makeCode5);
+        }
+
+        void run(const Interpreter::Type_Code* code, int codeSize, Interpreter::Context& context)
+        {
+            mRuntime.configure(code, codeSize, context);
+
+            const int opcodes = static_cast<int>(code[0]);
+            const Interpreter::Type_Code* codeBlock = code + 4;
+
+            while (mRuntime.getPC() >= 0 && mRuntime.getPC() < opcodes)
+            {
+                const Interpreter::Type_Code runCode = codeBlock[mRuntime.getPC()];
+                mRuntime.setPC(mRuntime.getPC() + 1);
+                execute(runCode);
+            }
+
+            mRuntime.clear();
+        }
+    };
+
+    struct Script
+    {
+        std::vector<Interpreter::Type_Code> mByteCode;
+        std::vector<Interpreter::Instruction> mInstructions;
+        std::vector<InterpreterContext> mContexts;
+    };
+
+    struct Corpus
+    {
+        Interpreter::Interpreter mInterpreter;
+        Globals mGlobals;
+        std::vector<Script> mScripts;
+        std::unique_ptr<MapDispatch> mMapDispatch;
+
+        Corpus()
+        {
+            Interpreter::installOpcodes(mInterpreter);
+            mInterpreter.installSegment5<OpPush<Interpreter::Type_Integer>>(Compiler::Misc::opcodeMenuMode, 0);
+            mInterpreter.installSegment5<OpPush<Interpreter::Type_Float>>(Compiler::Misc::opcodeGetSecondsPassed, 1 / 60.0f);
+            mInterpreter.installSegment5<OpPush<Interpreter::Type_Integer>>(Compiler::Misc::opcodeOnActivate, 1);
+            mInterpreter.installSegment5<OpPush<Interpreter::Type_Integer>>(Compiler::Misc::opcodeGetDisabled, 0);
+            mInterpreter.installSegment5<OpNothing>(Compiler::Misc::opcodeEnable);
+            mInterpreter.installSegment5<OpNothing>(Compiler::Misc::opcodeDisable);
+            mInterpreter.installSegment5<OpRandom>(Compiler::Misc::opcodeRandom);
+
+            Compiler::Extensions extensions;
+            Compiler::registerExtensions(extensions);
+            CompilerContext compilerContext;
+            compilerContext.setExtensions(&extensions);
+            Compiler::NullErrorHandler errorHandler;
+            Compiler::FileParser parser(errorHandler, compilerContext);
+
+            for (const std::string& source : sScripts)
+            {
+                parser.reset();
+                errorHandler.reset();
+                std::istringstream input(source);
+                Compiler::Scanner scanner(errorHandler, input, compilerContext.getExtensions());
+                scanner.scan(parser);
+                if (!errorHandler.isGood())
+                    throw std::runtime_error("Failed to compile benchmark script:\n" + source);
+
+                Script& script = mScripts.emplace_back();
+                parser.getCode(script.mByteCode);
+                script.mInstructions = mInterpreter.decode(script.mByteCode.data(), static_cast<int>(script.mByteCode.size()));
+                script.mContexts.resize(sInstances, InterpreterContext(mGlobals, parser.getLocals()));
+            }
+
+            mMapDispatch = std::make_unique<MapDispatch>(mInterpreter);
+        }
+    };
+
+    Corpus& getCorpus()
+    {
+        static Corpus corpus;
+        return corpus;
+    }
+
+    void runScriptsWithMapDispatch(benchmark::State& state)
+    {
+        Corpus& corpus = getCorpus();
+        std::size_t count = 0;
+
+        while (state.KeepRunning())
+        {
+            for (Script& script : corpus.mScripts)
+                for (InterpreterContext& context : script.mContexts)
+                {
+                    corpus.mMapDispatch->run(script.mByteCode.data(), static_cast<int>(script.mByteCode.size()), context);
+                    ++count;
+                }
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(count));
+    }
+
+    void runScripts(benchmark::State& state)
+    {
+        Corpus& corpus = getCorpus();
+        std::size_t count = 0;
+
+        while (state.KeepRunning())
+        {
+            for (Script& script : corpus.mScripts)
+                for (InterpreterContext& context : script.mContexts)
+                {
+                    corpus.mInterpreter.run(script.mByteCode.data(), static_cast<int>(script.mByteCode.size()), context);
+                    ++count;
+                }
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(count));
+    }
+
+    void runDecodedScripts(benchmark::State& state)
+    {
+        Corpus& corpus = getCorpus();
+        std::size_t count = 0;
+
+        while (state.KeepRunning())
+        {
+            for (Script& script : corpus.mScripts)
+                for (InterpreterContext& context : script.mContexts)
+                {
+                    corpus.mInterpreter.run(script.mByteCode.data(), static_cast<int>(script.mByteCode.size()),
+                        script.mInstructions, context);
+                    ++count;
+                }
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(count));
+    }
+}
+
+BENCHMARK(runScriptsWithMapDispatch);
+BENCHMARK(runScripts);
+BENCHMARK(runDecodedScripts);
+
+BENCHMARK_MAIN();
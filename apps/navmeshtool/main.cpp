@@ -29,6 +29,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <stdexcept>
 #include <thread>
@@ -100,6 +101,10 @@ namespace NavMeshTool
 
                 ("write-binary-log", bpo::value<bool>()->implicit_value(true)
                     ->default_value(false), "write progress in binary messages to be consumed by the launcher")
+
+                ("recompress", bpo::value<bool>()->implicit_value(true)
+                    ->default_value(false), "compress all stored tiles using \"navmeshdb compression level\" setting "
+                    "and quit without generating navmesh")
             ;
             Files::ConfigurationManager::addCommonOptions(result);
 
@@ -161,6 +166,7 @@ namespace NavMeshTool
             const bool processInteriorCells = variables["process-interior-cells"].as<bool>();
             const bool removeUnusedTiles = variables["remove-unused-tiles"].as<bool>();
             const bool writeBinaryLog = variables["write-binary-log"].as<bool>();
+            const bool recompress = variables["recompress"].as<bool>();
 
 #ifdef WIN32
             if (writeBinaryLog)
@@ -180,11 +186,19 @@ namespace NavMeshTool
             const osg::Vec3f agentHalfExtents = Settings::Manager::getVector3("default actor pathfind half extents", "Game");
             const DetourNavigator::AgentBounds agentBounds {agentCollisionShape, agentHalfExtents};
             const std::uint64_t maxDbFileSize = static_cast<std::uint64_t>(Settings::Manager::getInt64("max navmeshdb file size", "Navigator"));
+            const int dbCompressionLevel = std::clamp(Settings::Manager::getInt("navmeshdb compression level", "Navigator"), 0, 12);
             const std::string dbPath = (config.getUserDataPath() / "navmesh.db").string();
 
             Log(Debug::Info) << "Using navmeshdb at " << dbPath;
 
-            DetourNavigator::NavMeshDb db(dbPath, maxDbFileSize);
+            DetourNavigator::NavMeshDb db(dbPath, maxDbFileSize, dbCompressionLevel);
+
+            if (recompress)
+            {
+                const std::size_t recompressed = recompressAllNavMeshTiles(db);
+                Log(Debug::Info) << "Recompressed " << recompressed << " navmesh tiles with level " << dbCompressionLevel;
+                return 0;
+            }
 
             ESM::ReadersCache readers;
             EsmLoader::Query query;
@@ -23,6 +23,7 @@
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <limits>
 #include <utility>
 #include <vector>
 #include <random>
@@ -41,6 +42,7 @@ namespace NavMeshTool
         using DetourNavigator::MeshSource;
         using DetourNavigator::Settings;
         using DetourNavigator::ShapeId;
+        using DetourNavigator::TileData;
         using DetourNavigator::TileId;
         using DetourNavigator::TilePosition;
         using DetourNavigator::TileVersion;
@@ -319,4 +321,36 @@ namespace NavMeshTool
 
         return status;
     }
+
+    std::size_t recompressAllNavMeshTiles(NavMeshDb& db)
+    {
+        constexpr int batchSize = 1024;
+
+        Log(Debug::Info) << "Recompressing navmesh tiles...";
+
+        std::size_t recompressed = 0;
+        TileId lastTileId {std::numeric_limits<std::int64_t>::min()};
+
+        while (true)
+        {
+            Transaction transaction = db.startTransaction(Sqlite3::TransactionMode::Immediate);
+            const std::vector<TileData> tiles = db.getTilesData(lastTileId, batchSize);
+            if (tiles.empty())
+                break;
+            for (const TileData& tile : tiles)
+                db.updateTile(tile.mTileId, tile.mVersion, tile.mData);
+            transaction.commit();
+            recompressed += tiles.size();
+            lastTileId = tiles.back().mTileId;
+            Log(Debug::Info) << recompressed << " navmesh tiles are recompressed";
+        }
+
+        if (recompressed > 0)
+        {
+            Log(Debug::Info) << "Vacuuming the database...";
+            db.vacuum();
+        }
+
+        return recompressed;
+    }
 }
@@ -26,6 +26,8 @@ namespace NavMeshTool
     Status generateAllNavMeshTiles(const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Settings& settings,
         std::size_t threadsNumber, bool removeUnusedTiles, bool writeBinaryLog, WorldspaceData& cellsData,
         DetourNavigator::NavMeshDb&& db);
+
+    std::size_t recompressAllNavMeshTiles(DetourNavigator::NavMeshDb& db);
 }
 
 #endif
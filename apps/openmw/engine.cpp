@@ -1,5 +1,6 @@
 #include "engine.hpp"
 
+#include <algorithm>
 #include <iomanip>
 #include <chrono>
 #include <thread>
@@ -320,14 +321,37 @@ namespace
 void OMW::Engine::executeLocalScripts()
 {
     MWWorld::LocalScripts& localScripts = mWorld->getLocalScripts();
+    MWScript::ScriptProfiler& profiler = mScriptManager->getProfiler();
+    const osg::Vec3f playerPos = mWorld->getPlayerPtr().getRefData().getPosition().asVec3();
+    const float deferDistance2 = mLocalScriptsDeferDistance * mLocalScriptsDeferDistance;
+    const float frameDuration = mEnvironment.getFrameDuration();
 
     localScripts.startIteration();
     std::pair<std::string, MWWorld::Ptr> script;
     while (localScripts.getNext(script))
     {
+        // Over budget, postpone scripts of far away objects to the next frame. Deferred scripts are run first then,
+        // so every script gets its turn eventually.
+        if (mLocalScriptsBudget > 0 && profiler.getFrameProfile().mTime > mLocalScriptsBudget
+            && script.second.getContainerStore() == nullptr
+            && (script.second.getRefData().getPosition().asVec3() - playerPos).length2() > deferDistance2)
+        {
+            localScripts.deferCurrent(frameDuration);
+            profiler.addDeferred(script.first);
+            continue;
+        }
+
+        // A postponed script gets the time it missed, as if it had run every frame
+        const float deferredTime = localScripts.takeDeferredTime();
+        if (deferredTime > 0)
+            mEnvironment.setFrameDuration(frameDuration + deferredTime);
+
         MWScript::InterpreterContext interpreterContext (
             &script.second.getRefData().getLocals(), script.second);
         mScriptManager->run (script.first, interpreterContext);
+
+        if (deferredTime > 0)
+            mEnvironment.setFrameDuration(frameDuration);
     }
 }
 
@@ -388,6 +412,8 @@ bool OMW::Engine::frame(float frametime)
         {
             ScopedProfile<UserStatsType::Script> profile(frameStart, frameNumber, *timer, *stats);
 
+            mScriptManager->getProfiler().startFrame();
+
             if (mStateManager->getState() != MWBase::StateManager::State_NoGame)
             {
                 if (!paused)
@@ -458,11 +484,11 @@ bool OMW::Engine::frame(float frametime)
 
         const bool reportResource = stats->collectStats("resource");
 
-        if (reportResource)
-            stats->setAttribute(frameNumber, "UnrefQueue", mUnrefQueue->getSize());
-
         mUnrefQueue->flush(*mWorkQueue);
 
+        if (reportResource)
+            mUnrefQueue->reportStats(frameNumber, *stats);
+
         if (reportResource)
         {
             stats->setAttribute(frameNumber, "FrameNumber", frameNumber);
@@ -475,6 +501,22 @@ bool OMW::Engine::frame(float frametime)
             mMechanicsManager->reportStats(frameNumber, *stats);
             mWorld->reportStats(frameNumber, *stats);
             mLuaManager->reportStats(frameNumber, *stats);
+
+            MWScript::ScriptProfiler& profiler = mScriptManager->getProfiler();
+            profiler.reportStats(frameNumber, *stats);
+            // Measure script times from now on, so that the overlay shows them from the next frame
+            profiler.setTimingEnabled(true);
+        }
+
+        if (mScriptProfileDumpInterval > 0)
+        {
+            mScriptProfileDumpTimer += frametime;
+            if (mScriptProfileDumpTimer >= mScriptProfileDumpInterval)
+            {
+                mScriptProfileDumpTimer = 0;
+                boost::filesystem::ofstream stream(mCfgMgr.getLogPath() / "scriptprofile.csv");
+                mScriptManager->getProfiler().writeCsv(stream);
+            }
         }
     }
     catch (const std::exception& e)
@@ -503,6 +545,10 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
   , mFSStrict (false)
   , mScriptBlacklistUse (true)
   , mNewGame (false)
+  , mLocalScriptsBudget (0)
+  , mLocalScriptsDeferDistance (0)
+  , mScriptProfileDumpInterval (0)
+  , mScriptProfileDumpTimer (0)
   , mCfgMgr(configurationManager)
   , mGlMaxTextureImageUnits(0)
 #ifdef USE_OPENXR
@@ -819,7 +865,10 @@ void OMW::Engine::prepareEngine()
     if (numThreads <= 0)
         throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
     mWorkQueue = new SceneUtil::WorkQueue(numThreads);
-    mUnrefQueue = std::make_unique<SceneUtil::UnrefQueue>();
+    const int unrefMaxObjects = Settings::Manager::getInt("unref queue max objects", "Cells");
+    const float unrefMaxTime = Settings::Manager::getFloat("unref queue max time", "Cells");
+    mUnrefQueue = std::make_unique<SceneUtil::UnrefQueue>(static_cast<std::size_t>(std::max(unrefMaxObjects, 0)),
+        std::max(unrefMaxTime, 0.f) / 1000.0);
 
     mScreenCaptureOperation = new SceneUtil::AsyncScreenCaptureOperation(
         mWorkQueue,
@@ -992,6 +1041,11 @@ void OMW::Engine::prepareEngine()
         mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>());
     mEnvironment.setScriptManager(*mScriptManager);
 
+    mLocalScriptsBudget = std::max(0.f, Settings::Manager::getFloat("local scripts budget", "Game")) / 1000.f;
+    mLocalScriptsDeferDistance = std::max(0.f, Settings::Manager::getFloat("local scripts defer distance", "Game"));
+    mScriptProfileDumpInterval = std::max(0.f, Settings::Manager::getFloat("script profile dump interval", "Game"));
+    mScriptManager->getProfiler().setTimingEnabled(mLocalScriptsBudget > 0 || mScriptProfileDumpInterval > 0);
+
     // Create game mechanics system
     mMechanicsManager = std::make_unique<MWMechanics::MechanicsManager>();
     mEnvironment.setMechanicsManager(*mMechanicsManager);
@@ -198,6 +198,11 @@ namespace OMW
             bool mScriptBlacklistUse;
             bool mNewGame;
 
+            float mLocalScriptsBudget; // in seconds, 0 = unlimited
+            float mLocalScriptsDeferDistance;
+            float mScriptProfileDumpInterval; // in seconds, 0 = disabled
+            float mScriptProfileDumpTimer;
+
             // not implemented
             Engine (const Engine&);
             Engine& operator= (const Engine&);
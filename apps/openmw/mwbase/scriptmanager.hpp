@@ -17,6 +17,7 @@ namespace Compiler
 namespace MWScript
 {
     class GlobalScripts;
+    class ScriptProfiler;
 }
 
 namespace MWBase
@@ -55,6 +56,9 @@ namespace MWBase
             virtual MWScript::GlobalScripts& getGlobalScripts() = 0;
 
             virtual const Compiler::Extensions& getExtensions() const = 0;
+
+            virtual MWScript::ScriptProfiler& getProfiler() = 0;
+            ///< Instructions executed by and time spent in each script.
    };
 }
 
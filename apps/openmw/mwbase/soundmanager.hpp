@@ -5,6 +5,7 @@
 #include <string>
 #include <string_view>
 #include <set>
+#include <vector>
 
 #include "../mwworld/ptr.hpp"
 #include "../mwsound/type.hpp"
@@ -172,6 +173,9 @@ namespace MWBase
             ///< Is the given sound currently playing on the given object?
             ///  If you want to check if sound played with playSound is playing, use empty Ptr
 
+            virtual void preloadSounds(const std::vector<std::string>& soundIds) = 0;
+            ///< Decode given sounds in background so they can be played without delay.
+
             virtual void pauseSounds(MWSound::BlockerType blocker, int types=int(Type::Mask)) = 0;
             ///< Pauses all currently playing sounds, including music.
 
@@ -212,6 +212,15 @@ namespace MWClass
         }
     }
 
+    void Creature::getSoundsToPreload(const MWWorld::Ptr &ptr, std::vector<std::string> &sounds) const
+    {
+        const MWWorld::LiveCellRef<ESM::Creature> *ref = ptr.get<ESM::Creature>();
+        const std::string& ourId = (ref->mBase->mOriginal.empty()) ? ptr.getCellRef().getRefId() : ref->mBase->mOriginal;
+
+        const std::vector<std::string>& creatureSounds = MWBase::Environment::get().getWorld()->getStore().getCreatureSounds(ourId);
+        sounds.insert(sounds.end(), creatureSounds.begin(), creatureSounds.end());
+    }
+
     std::string Creature::getName (const MWWorld::ConstPtr& ptr) const
     {
         const MWWorld::LiveCellRef<ESM::Creature> *ref = ptr.get<ESM::Creature>();
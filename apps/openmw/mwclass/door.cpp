@@ -108,6 +108,15 @@ namespace MWClass
         return !name.empty() ? name : ref->mBase->mId;
     }
 
+    void Door::getSoundsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& sounds) const
+    {
+        const MWWorld::LiveCellRef<ESM::Door> *ref = ptr.get<ESM::Door>();
+        if (!ref->mBase->mOpenSound.empty())
+            sounds.push_back(ref->mBase->mOpenSound);
+        if (!ref->mBase->mCloseSound.empty())
+            sounds.push_back(ref->mBase->mCloseSound);
+    }
+
     std::unique_ptr<MWWorld::Action> Door::activate (const MWWorld::Ptr& ptr,
         const MWWorld::Ptr& actor) const
     {
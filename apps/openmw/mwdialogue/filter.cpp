@@ -148,11 +148,10 @@ bool MWDialogue::Filter::testPlayer (const ESM::DialInfo& info) const
     return true;
 }
 
-bool MWDialogue::Filter::testSelectStructs (const ESM::DialInfo& info) const
+bool MWDialogue::Filter::testSelectStructs (const InfoIndex::Entry& entry) const
 {
-    for (std::vector<ESM::DialInfo::SelectStruct>::const_iterator iter (info.mSelects.begin());
-        iter != info.mSelects.end(); ++iter)
-        if (!testSelectStruct (*iter))
+    for (const SelectWrapper& select : entry.mSelects)
+        if (!testSelectStruct (select))
             return false;
 
     return true;
@@ -178,7 +177,7 @@ bool MWDialogue::Filter::testFunctionLocal(const MWDialogue::SelectWrapper& sele
     if (scriptName.empty())
         return false; // no script
 
-    std::string name = Misc::StringUtils::lowerCase (select.getName());
+    const std::string& name = select.getName();
 
     const Compiler::Locals& localDefs =
         MWBase::Environment::get().getScriptManager()->getLocals (scriptName);
@@ -607,7 +606,26 @@ bool MWDialogue::Filter::hasFactionRankReputationRequirements (const MWWorld::Pt
 
 MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer)
 : mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer)
-{}
+{
+    mSpeaker.mIsCreature = (mActor.getType() != ESM::NPC::sRecordId);
+    mSpeaker.mId = Misc::StringUtils::lowerCase (mActor.getCellRef().getRefId());
+
+    if (!mSpeaker.mIsCreature)
+    {
+        const ESM::NPC* npc = mActor.get<ESM::NPC>()->mBase;
+        mSpeaker.mRace = Misc::StringUtils::lowerCase (npc->mRace);
+        mSpeaker.mClass = Misc::StringUtils::lowerCase (npc->mClass);
+        mSpeaker.mFaction = Misc::StringUtils::lowerCase (mActor.getClass().getPrimaryFaction (mActor));
+    }
+}
+
+std::vector<const MWDialogue::InfoIndex::Entry*> MWDialogue::Filter::getCandidates (const ESM::Dialogue& dialogue) const
+{
+    const MWDialogue::InfoIndex& index =
+        MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>().getInfoIndex (dialogue);
+
+    return index.getCandidates (mSpeaker);
+}
 
 const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue, const bool fallbackToInfoRefusal) const
 {
@@ -622,10 +640,10 @@ const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue,
 std::vector<const ESM::DialInfo *> MWDialogue::Filter::listAll (const ESM::Dialogue& dialogue) const
 {
     std::vector<const ESM::DialInfo *> infos;
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter!=dialogue.mInfo.end(); ++iter)
+    for (const InfoIndex::Entry* entry : getCandidates (dialogue))
     {
-        if (testActor (*iter))
-            infos.push_back(&*iter);
+        if (testActor (*entry->mInfo))
+            infos.push_back(entry->mInfo);
     }
     return infos;
 }
@@ -638,13 +656,13 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
     bool infoRefusal = false;
 
     // Iterate over topic responses to find a matching one
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    for (const InfoIndex::Entry* entry : getCandidates (dialogue))
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        const ESM::DialInfo& info = *entry->mInfo;
+        if (testActor (info) && testPlayer (info) && testSelectStructs (*entry))
         {
-            if (testDisposition (*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+            if (testDisposition (info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
@@ -663,13 +681,15 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
         const ESM::Dialogue& infoRefusalDialogue = *dialogues.find ("Info Refusal");
 
-        for (ESM::Dialogue::InfoContainer::const_iterator iter = infoRefusalDialogue.mInfo.begin();
-            iter!=infoRefusalDialogue.mInfo.end(); ++iter)
-            if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter) && testDisposition(*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+        for (const InfoIndex::Entry* entry : getCandidates (infoRefusalDialogue))
+        {
+            const ESM::DialInfo& info = *entry->mInfo;
+            if (testActor (info) && testPlayer (info) && testSelectStructs (*entry) && testDisposition(info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
+        }
     }
 
     return infos;
@@ -0,0 +1,73 @@
+#include "infoindex.hpp"
+
+#include <algorithm>
+
+#include <components/esm3/loaddial.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    void addBucket (const std::unordered_map<std::string, std::vector<std::size_t>>& buckets, const std::string& key,
+        std::vector<std::size_t>& indices)
+    {
+        if (key.empty())
+            return;
+
+        const auto it = buckets.find (key);
+        if (it != buckets.end())
+            indices.insert (indices.end(), it->second.begin(), it->second.end());
+    }
+}
+
+MWDialogue::InfoIndex::InfoIndex (const ESM::Dialogue& dialogue)
+{
+    mEntries.reserve (dialogue.mInfo.size());
+
+    for (const ESM::DialInfo& info : dialogue.mInfo)
+    {
+        const std::size_t index = mEntries.size();
+
+        Entry& entry = mEntries.emplace_back();
+        entry.mInfo = &info;
+        entry.mSelects.reserve (info.mSelects.size());
+        for (const ESM::DialInfo::SelectStruct& select : info.mSelects)
+            entry.mSelects.emplace_back (select);
+
+        if (!info.mActor.empty())
+            mByActor[Misc::StringUtils::lowerCase (info.mActor)].push_back (index);
+        else if (!info.mRace.empty())
+            mByRace[Misc::StringUtils::lowerCase (info.mRace)].push_back (index);
+        else if (!info.mClass.empty())
+            mByClass[Misc::StringUtils::lowerCase (info.mClass)].push_back (index);
+        else if (!info.mFactionLess && !info.mFaction.empty())
+            mByFaction[Misc::StringUtils::lowerCase (info.mFaction)].push_back (index);
+        else
+            mGeneric.push_back (index);
+    }
+}
+
+std::vector<const MWDialogue::InfoIndex::Entry*> MWDialogue::InfoIndex::getCandidates (const Speaker& speaker) const
+{
+    std::vector<std::size_t> indices;
+
+    addBucket (mByActor, speaker.mId, indices);
+
+    // Creatures must not have topics aside of those specific to their id
+    if (!speaker.mIsCreature)
+    {
+        addBucket (mByRace, speaker.mRace, indices);
+        addBucket (mByClass, speaker.mClass, indices);
+        addBucket (mByFaction, speaker.mFaction, indices);
+        indices.insert (indices.end(), mGeneric.begin(), mGeneric.end());
+
+        // Buckets are disjoint, restore the order of the dialogue, which decides which info is used
+        std::sort (indices.begin(), indices.end());
+    }
+
+    std::vector<const Entry*> candidates;
+    candidates.reserve (indices.size());
+    for (std::size_t index : indices)
+        candidates.push_back (&mEntries[index]);
+
+    return candidates;
+}
@@ -0,0 +1,67 @@
+#ifndef GAME_MWDIALOGUE_INFOINDEX_H
+#define GAME_MWDIALOGUE_INFOINDEX_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "selectwrapper.hpp"
+
+namespace ESM
+{
+    struct DialInfo;
+    struct Dialogue;
+}
+
+namespace MWDialogue
+{
+    /// \brief The infos of a dialogue with decoded select structs, bucketed by the most specific speaker condition
+    ///
+    /// Each info is put into exactly one bucket: by actor ID if it has one, otherwise by race, class or faction, in
+    /// that order. Infos without any of these conditions are generic. Buckets only rule out infos that can't match
+    /// the speaker, all conditions still have to be tested on the candidates.
+    class InfoIndex
+    {
+        public:
+
+            struct Entry
+            {
+                const ESM::DialInfo* mInfo;
+                std::vector<SelectWrapper> mSelects;
+            };
+
+            struct Speaker
+            {
+                bool mIsCreature = false;
+                std::string mId;
+                std::string mRace;
+                std::string mClass;
+                std::string mFaction;
+            };
+            ///< All IDs have to be lower case.
+
+        private:
+
+            using Bucket = std::vector<std::size_t>;
+            using Buckets = std::unordered_map<std::string, Bucket>;
+
+            std::vector<Entry> mEntries;
+            Buckets mByActor;
+            Buckets mByRace;
+            Buckets mByClass;
+            Buckets mByFaction;
+            Bucket mGeneric;
+
+        public:
+
+            explicit InfoIndex (const ESM::Dialogue& dialogue);
+
+            std::size_t getSize() const { return mEntries.size(); }
+
+            std::vector<const Entry*> getCandidates (const Speaker& speaker) const;
+            ///< Infos that could be used for \a speaker, in the order of the dialogue.
+    };
+}
+
+#endif
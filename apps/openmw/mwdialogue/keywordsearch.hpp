@@ -1,17 +1,24 @@
 #ifndef GAME_MWDIALOGUE_KEYWORDSEARCH_H
 #define GAME_MWDIALOGUE_KEYWORDSEARCH_H
 
-#include <cctype>
-#include <map>
+#include <array>
+#include <cstddef>
 #include <stdexcept>
+#include <utility>
 #include <vector>
-#include <algorithm>    // std::reverse
+#include <algorithm>
 
 #include <components/misc/stringops.hpp>
 
 namespace MWDialogue
 {
 
+/// Finds keywords in a text with an Aho-Corasick automaton, so the text is scanned once regardless of the number of
+/// keywords. Keywords and text are compared byte-wise with ASCII letters case-folded, so UTF-8 works as long as
+/// keywords and text use the same case for non-ASCII characters.
+///
+/// Seeding only extends the keyword trie. The automaton is compiled into flat arrays on the next search, so seeding
+/// many keywords at once is cheap and adding keywords later only recompiles once.
 template <typename string_t, typename value_t>
 class KeywordSearch
 {
@@ -26,46 +33,63 @@ public:
         value_t mValue;
     };
 
+    KeywordSearch ()
+    {
+        clear ();
+    }
+
     void seed (string_t keyword, value_t value)
     {
         if (keyword.empty())
             return;
-        seed_impl  (std::move(keyword), std::move (value), 0, mRoot);
+
+        int node = 0;
+        for (char ch : keyword)
+        {
+            const unsigned char folded = static_cast<unsigned char> (Misc::StringUtils::toLower (ch));
+            int child = findChild (node, folded);
+            if (child < 0)
+            {
+                child = static_cast<int> (mTrie.size());
+                mTrie[node].mChildren.emplace_back (folded, child);
+                mTrie.emplace_back ();
+            }
+            node = child;
+        }
+
+        if (mTrie[node].mKeyword >= 0)
+            throw std::runtime_error ("duplicate keyword inserted");
+
+        mTrie[node].mKeyword = static_cast<int> (mKeywords.size());
+        mTrie[node].mDepth = keyword.size();
+        mKeywords.emplace_back (std::move (keyword), std::move (value));
+        mCompiled = false;
     }
 
     void clear ()
     {
-        mRoot.mChildren.clear ();
-        mRoot.mKeyword.clear ();
+        mTrie.assign (1, TrieNode ());
+        mKeywords.clear ();
+        mNodes.clear ();
+        mEdges.clear ();
+        mCompiled = false;
     }
 
-    bool containsKeyword (const string_t& keyword, value_t& value)
+    bool containsKeyword (const string_t& keyword, value_t& value) const
     {
-        typename Entry::childen_t::iterator current;
-        typename Entry::childen_t::iterator next;
-
-        current = mRoot.mChildren.find (Misc::StringUtils::toLower (*keyword.begin()));
-        if (current == mRoot.mChildren.end())
-            return false;
-        else if (current->second.mKeyword.size() && Misc::StringUtils::ciEqual(current->second.mKeyword, keyword))
-        {
-            value = current->second.mValue;
-            return true;
-        }
-
-        for (Point i = ++keyword.begin(); i != keyword.end(); ++i)
+        int node = 0;
+        for (char ch : keyword)
         {
-            next = current->second.mChildren.find(Misc::StringUtils::toLower (*i));
-            if (next == current->second.mChildren.end())
+            node = findChild (node, static_cast<unsigned char> (Misc::StringUtils::toLower (ch)));
+            if (node < 0)
                 return false;
-            if (Misc::StringUtils::ciEqual(next->second.mKeyword, keyword))
-            {
-                value = next->second.mValue;
-                return true;
-            }
-            current = next;
         }
-        return false;
+
+        if (node == 0 || mTrie[node].mKeyword < 0)
+            return false;
+
+        value = mKeywords[mTrie[node].mKeyword].second;
+        return true;
     }
 
 
@@ -76,76 +100,38 @@ public:
 
     void highlightKeywords (Point beg, Point end, std::vector<Match>& out) const
     {
-        std::vector<Match> matches;
-        for (Point i = beg; i != end; ++i)
-        {
-            // check first character
-            typename Entry::childen_t::const_iterator candidate = mRoot.mChildren.find (Misc::StringUtils::toLower (*i));
-
-            // no match, on to next character
-            if (candidate == mRoot.mChildren.end ())
-                continue;
+        compile ();
 
-            // see how far the match goes
-            Point j = i;
+        // the longest keyword starting at each position of the text
+        std::vector<int> longest (end - beg, -1);
 
-            // some keywords might be longer variations of other keywords, so we definitely need a list of candidates
-            // the first element in the pair is length of the match, i.e. depth from the first character on
-            std::vector< typename std::pair<int, typename Entry::childen_t::const_iterator> > candidates;
+        int state = 0;
+        for (Point i = beg; i != end; ++i)
+        {
+            state = next (state, static_cast<unsigned char> (Misc::StringUtils::toLower (*i)));
 
-            while ((j + 1) != end)
+            // all keywords ending here, longest first
+            for (int node = mNodes[state].mKeyword >= 0 ? state : mNodes[state].mOutput; node > 0; node = mNodes[node].mOutput)
             {
-                typename Entry::childen_t::const_iterator next = candidate->second.mChildren.find (Misc::StringUtils::toLower (*++j));
-
-                if (next == candidate->second.mChildren.end ())
-                {
-                    if (candidate->second.mKeyword.size() > 0)
-                        candidates.push_back(std::make_pair((j-i), candidate));
-                    break;
-                }
-
-                candidate = next;
-
-                if (candidate->second.mKeyword.size() > 0)
-                    candidates.push_back(std::make_pair((j-i), candidate));
+                const std::size_t start = (i - beg) + 1 - mNodes[node].mDepth;
+                const int current = longest[start];
+                if (current < 0 || mNodes[current].mDepth < mNodes[node].mDepth)
+                    longest[start] = node;
             }
+        }
 
-            if (candidates.empty())
-                continue; // didn't match enough to disambiguate, on to next character
-
-            // shorter candidates will be added to the vector first. however, we want to check against longer candidates first
-            std::reverse(candidates.begin(), candidates.end());
-
-            for (typename std::vector< std::pair<int, typename Entry::childen_t::const_iterator> >::iterator it = candidates.begin();
-                 it != candidates.end(); ++it)
-            {
-                candidate = it->second;
-                // try to match the rest of the keyword
-                Point k = i + it->first;
-                typename string_t::const_iterator t = candidate->second.mKeyword.begin () + (k - i);
-
-
-                while (k != end && t != candidate->second.mKeyword.end ())
-                {
-                    if (Misc::StringUtils::toLower (*k) != Misc::StringUtils::toLower (*t))
-                        break;
-
-                    ++k, ++t;
-                }
+        std::vector<Match> matches;
+        for (std::size_t start = 0; start < longest.size(); ++start)
+        {
+            if (longest[start] < 0)
+                continue;
 
-                // didn't match full keyword, try the next candidate
-                if (t != candidate->second.mKeyword.end ())
-                    continue;
-
-                // found a keyword, but there might still be longer keywords that start somewhere _within_ this keyword
-                // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
-                Match match;
-                match.mValue = candidate->second.mValue;
-                match.mBeg = i;
-                match.mEnd = k;
-                matches.push_back(match);
-                break;
-            }
+            const Node& node = mNodes[longest[start]];
+            Match match;
+            match.mValue = mKeywords[node.mKeyword].second;
+            match.mBeg = beg + start;
+            match.mEnd = match.mBeg + node.mDepth;
+            matches.push_back(match);
         }
 
         // resolve overlapping keywords
@@ -192,54 +178,103 @@ public:
 
 private:
 
-    struct Entry
+    struct TrieNode
     {
-        typedef std::map <wchar_t, Entry> childen_t;
+        std::vector<std::pair<unsigned char, int>> mChildren;
+        int mKeyword = -1;
+        std::size_t mDepth = 0;
+    };
 
-        string_t mKeyword;
-        value_t mValue;
-        childen_t mChildren;
+    struct Node
+    {
+        int mFail = 0;
+        int mOutput = 0; ///< Closest node on the failure chain ending a keyword, 0 if none.
+        int mKeyword = -1;
+        std::size_t mDepth = 0; ///< Length of the keyword ending at this node.
+        std::size_t mEdgesBegin = 0;
+        std::size_t mEdgesEnd = 0;
     };
 
-    void seed_impl (string_t keyword, value_t value, size_t depth, Entry  & entry)
+    struct Edge
     {
-        int ch = Misc::StringUtils::toLower (keyword.at (depth));
+        unsigned char mChar;
+        int mTarget;
+    };
 
-        typename Entry::childen_t::iterator j = entry.mChildren.find (ch);
+    int findChild (int node, unsigned char ch) const
+    {
+        for (const auto& [childChar, child] : mTrie[node].mChildren)
+            if (childChar == ch)
+                return child;
+        return -1;
+    }
 
-        if (j == entry.mChildren.end ())
+    int next (int state, unsigned char ch) const
+    {
+        while (state != 0)
         {
-            entry.mChildren [ch].mValue = std::move (value);
-            entry.mChildren [ch].mKeyword = std::move (keyword);
+            const Node& node = mNodes[state];
+            for (std::size_t i = node.mEdgesBegin; i < node.mEdgesEnd; ++i)
+                if (mEdges[i].mChar == ch)
+                    return mEdges[i].mTarget;
+            state = node.mFail;
         }
-        else
+        return mRootNext[ch];
+    }
+
+    void compile () const
+    {
+        if (mCompiled)
+            return;
+
+        mNodes.assign (mTrie.size(), Node ());
+        mEdges.clear ();
+        mRootNext.fill (0);
+
+        // lay out the edges of each node contiguously
+        for (std::size_t i = 0; i < mTrie.size(); ++i)
         {
-            if (j->second.mKeyword.size () > 0)
-            {
-                if (keyword == j->second.mKeyword)
-                    throw std::runtime_error ("duplicate keyword inserted");
+            Node& node = mNodes[i];
+            node.mKeyword = mTrie[i].mKeyword;
+            node.mDepth = mTrie[i].mDepth;
+            node.mEdgesBegin = mEdges.size();
+            for (const auto& [ch, child] : mTrie[i].mChildren)
+                mEdges.push_back (Edge {ch, child});
+            node.mEdgesEnd = mEdges.size();
+        }
 
-                value_t pushValue = j->second.mValue;
-                string_t pushKeyword = j->second.mKeyword;
+        for (const auto& [ch, child] : mTrie[0].mChildren)
+            mRootNext[ch] = child;
 
-                if (depth >= pushKeyword.size ())
-                    throw std::runtime_error ("unexpected");
+        // breadth first, so failure links always point to already processed nodes
+        std::vector<int> queue;
+        queue.reserve (mTrie.size());
+        for (const auto& [ch, child] : mTrie[0].mChildren)
+            queue.push_back (child);
 
-                if (depth+1 < pushKeyword.size())
-                {
-                    seed_impl (std::move (pushKeyword), std::move (pushValue), depth+1, j->second);
-                    j->second.mKeyword.clear ();
-                }
+        for (std::size_t i = 0; i < queue.size(); ++i)
+        {
+            const int parent = queue[i];
+            for (const auto& [ch, child] : mTrie[parent].mChildren)
+            {
+                Node& node = mNodes[child];
+                node.mFail = next (mNodes[parent].mFail, ch);
+                const Node& fail = mNodes[node.mFail];
+                node.mOutput = fail.mKeyword >= 0 ? node.mFail : fail.mOutput;
+                queue.push_back (child);
             }
-            if (depth+1 == keyword.size())
-                j->second.mKeyword = value;
-            else // depth+1 < keyword.size()
-                seed_impl (std::move (keyword), std::move (value), depth+1, j->second);
         }
 
+        mCompiled = true;
     }
 
-    Entry mRoot;
+    std::vector<TrieNode> mTrie;
+    std::vector<std::pair<string_t, value_t>> mKeywords;
+
+    mutable bool mCompiled = false;
+    mutable std::vector<Node> mNodes;
+    mutable std::vector<Edge> mEdges;
+    mutable std::array<int, 256> mRootNext;
 };
 
 }
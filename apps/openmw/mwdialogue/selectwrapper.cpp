@@ -24,29 +24,19 @@ namespace
         throw std::runtime_error ("unknown compare type in dialogue info select");
     }
 
-    template<typename T>
-    bool selectCompareImp (const ESM::DialInfo::SelectStruct& select, T value1)
+    int decodeIndex (const std::string& rule)
     {
-        if (select.mValue.getType()==ESM::VT_Int)
-        {
-            return selectCompareImp (select.mSelectRule[4], value1, select.mValue.getInteger());
-        }
-        else if (select.mValue.getType()==ESM::VT_Float)
-        {
-            return selectCompareImp (select.mSelectRule[4], value1, select.mValue.getFloat());
-        }
-        else
-            throw std::runtime_error (
-                "unsupported variable type in dialogue info select");
+        int index = 0;
+
+        if (rule.size()>2)
+            std::istringstream (rule.substr(2,2)) >> index;
+
+        return index;
     }
 }
 
-MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction() const
+MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction (int index)
 {
-    int index = 0;
-
-    std::istringstream (mSelect.mSelectRule.substr(2,2)) >> index;
-
     switch (index)
     {
         case  0: return Function_RankLow;
@@ -94,15 +84,27 @@ MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction()
     return Function_False;
 }
 
-MWDialogue::SelectWrapper::SelectWrapper (const ESM::DialInfo::SelectStruct& select) : mSelect (select) {}
-
-MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::getFunction() const
+MWDialogue::SelectWrapper::SelectWrapper (const ESM::DialInfo::SelectStruct& select)
+: mComparison (select.mSelectRule.size()>4 ? select.mSelectRule[4] : '\0')
+, mValueType (select.mValue.getType())
+, mIntValue (mValueType==ESM::VT_Int ? select.mValue.getInteger() : 0)
+, mFloatValue (mValueType==ESM::VT_Float ? select.mValue.getFloat() : 0)
+, mName (select.mSelectRule.size()>5 ? Misc::StringUtils::lowerCase (select.mSelectRule.substr (5)) : std::string())
 {
-    char type = mSelect.mSelectRule[1];
+    const char type = select.mSelectRule.size()>1 ? select.mSelectRule[1] : '\0';
+    const int index = type=='1' ? decodeIndex (select.mSelectRule) : 0;
+
+    mFunction = decodeFunction (type, index);
+    mArgument = type=='1' ? decodeArgument (index) : 0;
+    mType = decodeType (mFunction);
+    mNpcOnly = decodeNpcOnly (mFunction);
+}
 
+MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction (char type, int index)
+{
     switch (type)
     {
-        case '1': return decodeFunction();
+        case '1': return decodeFunction (index);
         case '2': return Function_Global;
         case '3': return Function_Local;
         case '4': return Function_Journal;
@@ -119,15 +121,8 @@ MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::getFunction() con
     return Function_None;
 }
 
-int MWDialogue::SelectWrapper::getArgument() const
+int MWDialogue::SelectWrapper::decodeArgument (int index)
 {
-    if (mSelect.mSelectRule[1]!='1')
-        return 0;
-
-    int index = 0;
-
-    std::istringstream (mSelect.mSelectRule.substr(2,2)) >> index;
-
     switch (index)
     {
         // AI settings
@@ -184,7 +179,7 @@ int MWDialogue::SelectWrapper::getArgument() const
     return 0;
 }
 
-MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
+MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::decodeType (Function function)
 {
     static const Function integerFunctions[] =
     {
@@ -233,8 +228,6 @@ MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
         Function_None // end marker
     };
 
-    Function function = getFunction();
-
     for (int i=0; integerFunctions[i]!=Function_None; ++i)
         if (integerFunctions[i]==function)
             return Type_Integer;
@@ -254,7 +247,7 @@ MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
     return Type_None;
 }
 
-bool MWDialogue::SelectWrapper::isNpcOnly() const
+bool MWDialogue::SelectWrapper::decodeNpcOnly (Function function)
 {
     static const Function functions[] =
     {
@@ -267,8 +260,6 @@ bool MWDialogue::SelectWrapper::isNpcOnly() const
         Function_None // end marker
     };
 
-    Function function = getFunction();
-
     for (int i=0; functions[i]!=Function_None; ++i)
         if (functions[i]==function)
             return true;
@@ -276,22 +267,58 @@ bool MWDialogue::SelectWrapper::isNpcOnly() const
     return false;
 }
 
+MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::getFunction() const
+{
+    return mFunction;
+}
+
+int MWDialogue::SelectWrapper::getArgument() const
+{
+    return mArgument;
+}
+
+MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
+{
+    return mType;
+}
+
+bool MWDialogue::SelectWrapper::isNpcOnly() const
+{
+    return mNpcOnly;
+}
+
+template<typename T>
+bool MWDialogue::SelectWrapper::selectCompareImp (T value) const
+{
+    if (mValueType==ESM::VT_Int)
+    {
+        return ::selectCompareImp (mComparison, value, mIntValue);
+    }
+    else if (mValueType==ESM::VT_Float)
+    {
+        return ::selectCompareImp (mComparison, value, mFloatValue);
+    }
+    else
+        throw std::runtime_error (
+            "unsupported variable type in dialogue info select");
+}
+
 bool MWDialogue::SelectWrapper::selectCompare (int value) const
 {
-    return selectCompareImp (mSelect, value);
+    return selectCompareImp (value);
 }
 
 bool MWDialogue::SelectWrapper::selectCompare (float value) const
 {
-    return selectCompareImp (mSelect, value);
+    return selectCompareImp (value);
 }
 
 bool MWDialogue::SelectWrapper::selectCompare (bool value) const
 {
-    return selectCompareImp (mSelect, static_cast<int> (value));
+    return selectCompareImp (static_cast<int> (value));
 }
 
-std::string MWDialogue::SelectWrapper::getName() const
+const std::string& MWDialogue::SelectWrapper::getName() const
 {
-    return Misc::StringUtils::lowerCase (mSelect.mSelectRule.substr (5));
+    return mName;
 }
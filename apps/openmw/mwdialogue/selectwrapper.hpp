@@ -1,14 +1,15 @@
 #ifndef GAME_MWDIALOGUE_SELECTWRAPPER_H
 #define GAME_MWDIALOGUE_SELECTWRAPPER_H
 
+#include <string>
+
 #include <components/esm3/loadinfo.hpp>
 
 namespace MWDialogue
 {
+    /// \brief A select struct of a dialogue info decoded once, so testing it doesn't have to parse the select rule
     class SelectWrapper
     {
-            const ESM::DialInfo::SelectStruct& mSelect;
-
         public:
 
             enum Function
@@ -57,7 +58,28 @@ namespace MWDialogue
 
         private:
 
-            Function decodeFunction() const;
+            Function mFunction;
+            Type mType;
+            int mArgument;
+            bool mNpcOnly;
+            char mComparison;
+            ESM::VarType mValueType;
+            int mIntValue;
+            float mFloatValue;
+            std::string mName;
+
+            static Function decodeFunction (int index);
+
+            static Function decodeFunction (char type, int index);
+
+            static int decodeArgument (int index);
+
+            static Type decodeType (Function function);
+
+            static bool decodeNpcOnly (Function function);
+
+            template<typename T>
+            bool selectCompareImp (T value) const;
 
         public:
 
@@ -78,7 +100,7 @@ namespace MWDialogue
 
             bool selectCompare (bool value) const;
 
-            std::string getName() const;
+            const std::string& getName() const;
             ///< Return case-smashed name.
     };
 }
@@ -7,6 +7,10 @@
 #include <osg/VertexAttribDivisor>
 #include <osg/Program>
 
+#include <cstdlib>
+#include <sstream>
+
+#include <components/debug/debuglog.hpp>
 #include <components/esm3/esmreader.hpp>
 #include <components/sceneutil/lightmanager.hpp>
 #include <components/sceneutil/nodecallback.hpp>
@@ -24,10 +28,9 @@ namespace MWRender
     class InstancingVisitor : public osg::NodeVisitor
     {
     public:
-        InstancingVisitor(std::vector<Groundcover::GroundcoverEntry>& instances, osg::Vec3f& chunkPosition)
+        InstancingVisitor(const GroundcoverInstances& instances)
         : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
         , mInstances(instances)
-        , mChunkPosition(chunkPosition)
         {
         }
 
@@ -35,42 +38,32 @@ namespace MWRender
         {
             for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); ++i)
             {
-                geom.getPrimitiveSet(i)->setNumInstances(mInstances.size());
+                geom.getPrimitiveSet(i)->setNumInstances(mInstances.mOffsets->size());
             }
 
-            osg::ref_ptr<osg::Vec4Array> transforms = new osg::Vec4Array(mInstances.size());
-            osg::BoundingBox box;
-            float radius = geom.getBoundingBox().radius();
-            for (unsigned int i = 0; i < transforms->getNumElements(); i++)
-            {
-                osg::Vec3f pos(mInstances[i].mPos.asVec3());
-                osg::Vec3f relativePos = pos - mChunkPosition;
-                (*transforms)[i] = osg::Vec4f(relativePos, mInstances[i].mScale);
-
-                // Use an additional margin due to groundcover animation
-                float instanceRadius = radius * mInstances[i].mScale * 1.1f;
-                osg::BoundingSphere instanceBounds(relativePos, instanceRadius);
-                box.expandBy(instanceBounds);
-            }
+            geom.setInitialBound(getGroundcoverInstancesBound(mInstances, geom.getBoundingBox().radius()));
 
-            geom.setInitialBound(box);
+            geom.setVertexAttribArray(6, mInstances.mOffsets.get(), osg::Array::BIND_PER_VERTEX);
+            geom.setVertexAttribArray(7, mInstances.mRotations.get(), osg::Array::BIND_PER_VERTEX);
+        }
+    private:
+        const GroundcoverInstances& mInstances;
+    };
 
-            osg::ref_ptr<osg::Vec3Array> rotations = new osg::Vec3Array(mInstances.size());
-            for (unsigned int i = 0; i < rotations->getNumElements(); i++)
-            {
-                (*rotations)[i] = mInstances[i].mPos.asRotationVec3();
-            }
+    class PrepareInstancingVisitor : public osg::NodeVisitor
+    {
+    public:
+        PrepareInstancingVisitor()
+        : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+        {
+        }
 
+        void apply(osg::Geometry& geom) override
+        {
             // Display lists do not support instancing in OSG 3.4
             geom.setUseDisplayList(false);
             geom.setUseVertexBufferObjects(true);
-
-            geom.setVertexAttribArray(6, transforms.get(), osg::Array::BIND_PER_VERTEX);
-            geom.setVertexAttribArray(7, rotations.get(), osg::Array::BIND_PER_VERTEX);
         }
-    private:
-        std::vector<Groundcover::GroundcoverEntry> mInstances;
-        osg::Vec3f mChunkPosition;
     };
 
     class DensityCalculator
@@ -151,6 +144,7 @@ namespace MWRender
          , mDensity(density)
          , mStateset(new osg::StateSet)
          , mGroundcoverStore(store)
+         , mInstancingTemplates(new Resource::ObjectCache)
     {
          setViewDistance(viewDistance);
          // MGE uses default alpha settings for groundcover, so we can not rely on alpha properties
@@ -213,7 +207,7 @@ namespace MWRender
                     ESM::CellRef& ref = pair.second;
                     const std::string& model = mGroundcoverStore.getGroundcoverModel(ref.mRefID);
                     if (!model.empty())
-                        instances[model].emplace_back(std::move(ref));
+                        instances[model].push_back(GroundcoverEntry {ref.mPos, ref.mScale});
                 }
             }
         }
@@ -221,17 +215,27 @@ namespace MWRender
 
     osg::ref_ptr<osg::Node> Groundcover::createChunk(InstanceMap& instances, const osg::Vec2f& center)
     {
+        static const bool dump = getenv("OPENMW_GROUNDCOVER_DUMP") != nullptr;
+
         osg::ref_ptr<osg::Group> group = new osg::Group;
+        osg::ref_ptr<Resource::TemplateMultiRef> templateRefs = new Resource::TemplateMultiRef;
         osg::Vec3f worldCenter = osg::Vec3f(center.x(), center.y(), 0)*ESM::Land::REAL_SIZE;
         for (auto& pair : instances)
         {
-            const osg::Node* temp = mSceneManager->getTemplate(pair.first);
-            osg::ref_ptr<osg::Node> node = static_cast<osg::Node*>(temp->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_USERDATA|osg::CopyOp::DEEP_COPY_ARRAYS|osg::CopyOp::DEEP_COPY_PRIMITIVES));
+            // The vertices and state are shared with the template, only the instance arrays are stored per chunk
+            osg::ref_ptr<const osg::Node> temp = getInstancingTemplate(pair.first);
+            templateRefs->addRef(temp);
+            osg::ref_ptr<osg::Node> node = static_cast<osg::Node*>(temp->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_USERDATA|osg::CopyOp::DEEP_COPY_PRIMITIVES));
 
-            // Keep link to original mesh to keep it in cache
-            group->getOrCreateUserDataContainer()->addUserObject(new Resource::TemplateRef(temp));
+            const GroundcoverInstances instanceArrays = makeGroundcoverInstances(pair.second, worldCenter);
+            if (dump)
+            {
+                std::ostringstream stream;
+                dumpGroundcoverInstances(stream, pair.first, worldCenter, instanceArrays);
+                Log(Debug::Info) << stream.str();
+            }
 
-            InstancingVisitor visitor(pair.second, worldCenter);
+            InstancingVisitor visitor(instanceArrays);
             node->accept(visitor);
             group->addChild(node);
         }
@@ -241,13 +245,31 @@ namespace MWRender
         osg::BoundingBox box = cbv.getBoundingBox();
         group->addCullCallback(new ViewDistanceCallback(getViewDistance(), box));
 
-        group->setStateSet(mStateset);
+        group->getOrCreateUserDataContainer()->addUserObject(templateRefs);
+
         group->setNodeMask(Mask_Groundcover);
         if (mSceneManager->getLightingMethod() != SceneUtil::LightingMethod::FFP)
             group->addCullCallback(new SceneUtil::LightListCallback);
+        group->getBound();
+        return group;
+    }
+
+    osg::ref_ptr<const osg::Node> Groundcover::getInstancingTemplate(const std::string& model)
+    {
+        if (osg::ref_ptr<osg::Object> obj = mInstancingTemplates->getRefFromObjectCache(model))
+            return static_cast<const osg::Node*>(obj.get());
+
+        const osg::Node* temp = mSceneManager->getTemplate(model);
+        osg::ref_ptr<osg::Group> group = new osg::Group;
+        group->setStateSet(mStateset);
+        group->addChild(static_cast<osg::Node*>(temp->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_USERDATA|osg::CopyOp::DEEP_COPY_ARRAYS|osg::CopyOp::DEEP_COPY_PRIMITIVES)));
+
+        PrepareInstancingVisitor visitor;
+        group->accept(visitor);
         mSceneManager->recreateShaders(group, "groundcover", true, mProgramTemplate);
         mSceneManager->shareState(group);
-        group->getBound();
+
+        mInstancingTemplates->addEntryToObjectCache(model, group);
         return group;
     }
 
@@ -256,8 +278,27 @@ namespace MWRender
         return Mask_Groundcover;
     }
 
+    void Groundcover::updateCache(double referenceTime)
+    {
+        GenericResourceManager<GroundcoverChunkId>::updateCache(referenceTime);
+        mInstancingTemplates->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
+        mInstancingTemplates->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
+    }
+
+    void Groundcover::clearCache()
+    {
+        GenericResourceManager<GroundcoverChunkId>::clearCache();
+        mInstancingTemplates->clear();
+    }
+
     void Groundcover::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Groundcover Chunk", mCache->getCacheSize());
     }
+
+    void Groundcover::releaseGLObjects(osg::State* state)
+    {
+        GenericResourceManager<GroundcoverChunkId>::releaseGLObjects(state);
+        mInstancingTemplates->releaseGLObjects(state);
+    }
 }
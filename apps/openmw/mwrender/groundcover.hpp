@@ -5,6 +5,10 @@
 #include <components/resource/scenemanager.hpp>
 #include <components/esm3/loadcell.hpp>
 
+#include <map>
+
+#include "groundcoverinstances.hpp"
+
 namespace MWWorld
 {
     class ESMStore;
@@ -28,16 +32,13 @@ namespace MWRender
 
         unsigned int getNodeMask() override;
 
-        void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
+        void updateCache(double referenceTime) override;
 
-        struct GroundcoverEntry
-        {
-            ESM::Position mPos;
-            float mScale;
+        void clearCache() override;
 
-            GroundcoverEntry(const ESM::CellRef& ref) : mPos(ref.mPos), mScale(ref.mScale)
-            {}
-        };
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
+
+        void releaseGLObjects(osg::State* state) override;
 
     private:
         Resource::SceneManager* mSceneManager;
@@ -46,9 +47,14 @@ namespace MWRender
         osg::ref_ptr<osg::Program> mProgramTemplate;
         const MWWorld::GroundcoverStore& mGroundcoverStore;
 
+        // Copies of the models with shaders already set up, chunks only copy their nodes and drawables.
+        // Chunks keep the templates they use referenced, so unused ones expire along with the chunks.
+        osg::ref_ptr<Resource::ObjectCache> mInstancingTemplates;
+
         typedef std::map<std::string, std::vector<GroundcoverEntry>> InstanceMap;
         osg::ref_ptr<osg::Node> createChunk(InstanceMap& instances, const osg::Vec2f& center);
         void collectInstances(InstanceMap& instances, float size, const osg::Vec2f& center);
+        osg::ref_ptr<const osg::Node> getInstancingTemplate(const std::string& model);
     };
 }
 
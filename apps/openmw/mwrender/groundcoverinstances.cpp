@@ -0,0 +1,56 @@
+#include "groundcoverinstances.hpp"
+
+#include <osg/BufferObject>
+
+#include <ostream>
+
+namespace MWRender
+{
+    GroundcoverInstances makeGroundcoverInstances(const std::vector<GroundcoverEntry>& entries, const osg::Vec3f& chunkPosition)
+    {
+        GroundcoverInstances result;
+        result.mOffsets = new osg::Vec4Array(static_cast<unsigned int>(entries.size()));
+        result.mRotations = new osg::Vec3Array(static_cast<unsigned int>(entries.size()));
+
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            const GroundcoverEntry& entry = entries[i];
+            (*result.mOffsets)[i] = osg::Vec4f(entry.mPos.asVec3() - chunkPosition, entry.mScale);
+            (*result.mRotations)[i] = entry.mPos.asRotationVec3();
+        }
+
+        // Otherwise osg::Geometry would append them to the buffer object of the vertices, which is shared with the template
+        osg::ref_ptr<osg::VertexBufferObject> vbo = new osg::VertexBufferObject;
+        result.mOffsets->setVertexBufferObject(vbo);
+        result.mRotations->setVertexBufferObject(vbo);
+
+        return result;
+    }
+
+    osg::BoundingBox getGroundcoverInstancesBound(const GroundcoverInstances& instances, float radius)
+    {
+        osg::BoundingBox box;
+        for (const osg::Vec4f& offset : *instances.mOffsets)
+        {
+            // Use an additional margin due to groundcover animation
+            const float instanceRadius = radius * offset.w() * 1.1f;
+            box.expandBy(osg::BoundingSphere(osg::Vec3f(offset.x(), offset.y(), offset.z()), instanceRadius));
+        }
+        return box;
+    }
+
+    void dumpGroundcoverInstances(std::ostream& stream, const std::string& model, const osg::Vec3f& chunkPosition,
+        const GroundcoverInstances& instances)
+    {
+        stream << "model " << model << " chunk " << chunkPosition.x() << ' ' << chunkPosition.y() << ' ' << chunkPosition.z()
+               << " instances " << instances.mOffsets->size() << '\n';
+        for (std::size_t i = 0; i < instances.mOffsets->size(); ++i)
+        {
+            const osg::Vec4f& offset = (*instances.mOffsets)[i];
+            const osg::Vec3f& rotation = (*instances.mRotations)[i];
+            stream << "  offset " << offset.x() << ' ' << offset.y() << ' ' << offset.z()
+                   << " scale " << offset.w()
+                   << " rotation " << rotation.x() << ' ' << rotation.y() << ' ' << rotation.z() << '\n';
+        }
+    }
+}
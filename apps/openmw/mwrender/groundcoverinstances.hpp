@@ -0,0 +1,43 @@
+#ifndef OPENMW_MWRENDER_GROUNDCOVERINSTANCES_H
+#define OPENMW_MWRENDER_GROUNDCOVERINSTANCES_H
+
+#include <components/esm/defs.hpp>
+
+#include <osg/Array>
+#include <osg/BoundingBox>
+#include <osg/ref_ptr>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace MWRender
+{
+    struct GroundcoverEntry
+    {
+        ESM::Position mPos;
+        float mScale;
+    };
+
+    /// @brief Per-instance vertex attributes of all instances of one groundcover model in a chunk.
+    /// @par Shared by all geometries of the model, which draw them with a vertex attribute divisor of 1.
+    struct GroundcoverInstances
+    {
+        /// Position relative to the chunk in xyz, scale in w. Bound to the aOffset attribute.
+        osg::ref_ptr<osg::Vec4Array> mOffsets;
+        /// Rotation in radians. Bound to the aRotation attribute.
+        osg::ref_ptr<osg::Vec3Array> mRotations;
+    };
+
+    /// @note The arrays get their own buffer object, so they are not merged into the buffer of the geometry's vertices.
+    GroundcoverInstances makeGroundcoverInstances(const std::vector<GroundcoverEntry>& entries, const osg::Vec3f& chunkPosition);
+
+    /// @param radius Radius of the geometry drawn for every instance.
+    osg::BoundingBox getGroundcoverInstancesBound(const GroundcoverInstances& instances, float radius);
+
+    /// Write one line per instance in a stable text format, for inspecting chunks without rendering them.
+    void dumpGroundcoverInstances(std::ostream& stream, const std::string& model, const osg::Vec3f& chunkPosition,
+        const GroundcoverInstances& instances);
+}
+
+#endif
@@ -1,6 +1,15 @@
 #include "objectpaging.hpp"
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <locale>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <osg/LOD>
@@ -8,14 +17,19 @@
 #include <osg/Sequence>
 #include <osg/MatrixTransform>
 #include <osg/Material>
+#include <osg/BufferObject>
+#include <osg/TriangleIndexFunctor>
 #include <osgUtil/IncrementalCompileOperation>
 
 #include <components/esm3/esmreader.hpp>
+#include <components/files/memorystream.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/sceneutil/optimizer.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/clone.hpp>
+#include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/staticgeometry.hpp>
 #include <components/sceneutil/util.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/esm3/readerscache.hpp>
@@ -29,6 +43,7 @@
 #include <components/sceneutil/riggeometry.hpp>
 #include <components/settings/settings.hpp>
 #include <components/misc/rng.hpp>
+#include <components/debug/debuglog.hpp>
 
 #include "apps/openmw/mwworld/esmstore.hpp"
 #include "apps/openmw/mwbase/environment.hpp"
@@ -74,6 +89,82 @@ namespace MWRender
         }
     }
 
+    struct ChunkRefChange
+    {
+        bool mHidden = false;
+        bool mBlacklisted = false;
+    };
+
+    struct ChunkRequest : public osg::Referenced
+    {
+        enum class State
+        {
+            Queued,
+            Building,
+            Built
+        };
+
+        ChunkId mId;
+        osg::Vec3f mViewPoint;
+        // Handed out to the views instead of the chunk. Only referenced by the request itself once no view needs the chunk anymore.
+        osg::ref_ptr<osg::Group> mPlaceholder;
+        State mState = State::Queued;
+        osg::ref_ptr<osg::Node> mResult;
+        std::atomic_bool mCompiled {false};
+        // References enabled, disabled or blacklisted since the build started, applied to the result before it is attached
+        std::map<ESM::RefNum, ChunkRefChange> mRefChanges;
+        // The whole set of disabled and blacklisted references changed since the build started
+        bool mOutdated = false;
+    };
+
+    class ChunkCompiledCallback : public osgUtil::IncrementalCompileOperation::CompileCompletedCallback
+    {
+    public:
+        ChunkCompiledCallback(ChunkRequest* request) : mRequest(request) {}
+
+        bool compileCompleted(osgUtil::IncrementalCompileOperation::CompileSet*) override
+        {
+            mRequest->mCompiled = true;
+            // The chunk is attached by ObjectPaging::update()
+            return true;
+        }
+
+    private:
+        osg::ref_ptr<ChunkRequest> mRequest;
+    };
+
+    class ChunkBuildWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        ChunkBuildWorkItem(ObjectPaging* objectPaging) : mObjectPaging(objectPaging) {}
+
+        void doWork() override
+        {
+            mObjectPaging->buildNextChunk(mAbort);
+        }
+
+        void abort() override
+        {
+            mAbort = true;
+        }
+
+    private:
+        ObjectPaging* mObjectPaging;
+        std::atomic_bool mAbort {false};
+    };
+
+    /// @return Distance of the chunk to the viewer, weighted by up to a factor of 2 for chunks behind the viewer. Lower is more important.
+    float getRequestPriority(const ChunkId& id, const osg::Vec3f& viewerPosition, const osg::Vec3f& viewerDirection)
+    {
+        osg::Vec2f toChunk = std::get<0>(id) * ESM::Land::REAL_SIZE - osg::Vec2f(viewerPosition.x(), viewerPosition.y());
+        const float radius = std::get<1>(id) * ESM::Land::REAL_SIZE * std::sqrt(0.5f);
+        const float distance = std::max(0.f, toChunk.normalize() - radius);
+        osg::Vec2f direction(viewerDirection.x(), viewerDirection.y());
+        if (direction.normalize() == 0.f)
+            return distance;
+        return distance * (1.5f - 0.5f * (toChunk * direction));
+    }
+
     osg::ref_ptr<osg::Node> ObjectPaging::getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
     {
         if (activeGrid && !mActiveGrid)
@@ -84,6 +175,10 @@ namespace MWRender
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(id);
         if (obj)
             return static_cast<osg::Node*>(obj.get());
+        // Requests from the cull traversal (compile == false) must not stall the frame. The active grid is still built
+        // right away because objects would be missing next to the player otherwise.
+        else if (mWorkQueue && !compile && !activeGrid)
+            return requestChunk(id, viewPoint);
         else
         {
             osg::ref_ptr<osg::Node> node = createChunk(size, center, activeGrid, viewPoint, compile);
@@ -280,6 +375,218 @@ namespace MWRender
         std::vector<ESM::RefNum> mRefnums;
     };
 
+    /// Maps the references of a chunk to the parts of the chunk that render them, so that single references can be
+    /// hidden and shown again without rebuilding the chunk. Unmerged references are hidden with their node mask.
+    /// Merged geometries are never modified: they are replaced with a shallow copy sharing the vertex data, whose
+    /// primitive sets leave out the primitives using vertices of hidden references.
+    class ChunkRefIndex : public osg::Object
+    {
+    public:
+        ChunkRefIndex() {}
+        ChunkRefIndex(const ChunkRefIndex& copy, const osg::CopyOp&)
+            : mMergedGeometries(copy.mMergedGeometries), mInstances(copy.mInstances), mHidden(copy.mHidden) {}
+        META_Object(MWRender, ChunkRefIndex)
+
+        using VertexRange = std::pair<unsigned int, unsigned int>; // [begin, end)
+
+        struct MergedGeometry
+        {
+            osg::ref_ptr<osg::Geometry> mPristine;
+            osg::ref_ptr<osg::Geometry> mCurrent;
+            std::map<ESM::RefNum, std::vector<VertexRange>> mRanges;
+        };
+
+        struct Instance
+        {
+            osg::ref_ptr<osg::Node> mNode;
+            osg::Node::NodeMask mNodeMask;
+        };
+
+        std::vector<MergedGeometry> mMergedGeometries;
+        std::map<ESM::RefNum, std::vector<Instance>> mInstances;
+        std::set<ESM::RefNum> mHidden;
+
+        bool contains(const ESM::RefNum& refnum) const
+        {
+            if (mInstances.count(refnum))
+                return true;
+            for (const MergedGeometry& geometry : mMergedGeometries)
+                if (geometry.mRanges.count(refnum))
+                    return true;
+            return false;
+        }
+
+        /// @return false if the chunk can not be patched and needs to be rebuilt
+        bool setHidden(const ESM::RefNum& refnum, bool hidden)
+        {
+            if (hidden ? !mHidden.insert(refnum).second : !mHidden.erase(refnum))
+                return true;
+
+            auto instances = mInstances.find(refnum);
+            if (instances != mInstances.end())
+            {
+                for (Instance& instance : instances->second)
+                    instance.mNode->setNodeMask(hidden ? 0 : instance.mNodeMask);
+            }
+
+            for (MergedGeometry& geometry : mMergedGeometries)
+            {
+                if (geometry.mRanges.count(refnum) && !updateGeometry(geometry))
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        struct FilterTrianglesFunctor
+        {
+            osg::DrawElements* mResult = nullptr;
+            const std::vector<bool>* mHiddenVertices = nullptr;
+            bool mValid = true;
+
+            void operator()(unsigned int i1, unsigned int i2, unsigned int i3)
+            {
+                const std::vector<bool>& hidden = *mHiddenVertices;
+                if (i1 >= hidden.size() || i2 >= hidden.size() || i3 >= hidden.size())
+                    mValid = false;
+                else if (!hidden[i1] && !hidden[i2] && !hidden[i3])
+                {
+                    mResult->addElement(i1);
+                    mResult->addElement(i2);
+                    mResult->addElement(i3);
+                }
+            }
+        };
+
+        /// @return Triangles of the primitive set without those using hidden vertices, nullptr if it can not be filtered
+        static osg::ref_ptr<osg::DrawElements> filterPrimitives(const osg::PrimitiveSet& primitives, const std::vector<bool>& hiddenVertices)
+        {
+            // Points and lines
+            if (primitives.getMode() < GL_TRIANGLES)
+                return nullptr;
+
+            osg::ref_ptr<osg::DrawElements> result;
+            if (hiddenVertices.size() <= std::numeric_limits<GLushort>::max() + 1u)
+                result = new osg::DrawElementsUShort(GL_TRIANGLES);
+            else
+                result = new osg::DrawElementsUInt(GL_TRIANGLES);
+            result->setNumInstances(primitives.getNumInstances());
+
+            // Strips and fans are converted to triangle lists
+            osg::TriangleIndexFunctor<FilterTrianglesFunctor> functor;
+            functor.mResult = result;
+            functor.mHiddenVertices = &hiddenVertices;
+            primitives.accept(functor);
+            if (!functor.mValid)
+                return nullptr;
+            return result;
+        }
+
+        bool updateGeometry(MergedGeometry& geometry)
+        {
+            const osg::Array* pristineVertices = geometry.mPristine->getVertexArray();
+            if (!pristineVertices)
+                return false;
+
+            std::vector<bool> hiddenVertices;
+            for (const auto& [refnum, ranges] : geometry.mRanges)
+            {
+                if (!mHidden.count(refnum))
+                    continue;
+                if (hiddenVertices.empty())
+                    hiddenVertices.resize(pristineVertices->getNumElements(), false);
+                for (const VertexRange& range : ranges)
+                {
+                    if (range.second > hiddenVertices.size() || range.first >= range.second)
+                        return false;
+                    std::fill(hiddenVertices.begin() + range.first, hiddenVertices.begin() + range.second, true);
+                }
+            }
+
+            osg::ref_ptr<osg::Geometry> patched = geometry.mPristine;
+            if (!hiddenVertices.empty())
+            {
+                // Only indices are rebuilt, vertex arrays and their buffer objects stay shared with the pristine geometry
+                osg::Geometry::PrimitiveSetList primitiveSets;
+                osg::ref_ptr<osg::ElementBufferObject> ebo = new osg::ElementBufferObject;
+                for (const osg::ref_ptr<osg::PrimitiveSet>& primitives : geometry.mPristine->getPrimitiveSetList())
+                {
+                    osg::ref_ptr<osg::DrawElements> filtered = filterPrimitives(*primitives, hiddenVertices);
+                    if (!filtered)
+                        return false;
+                    if (filtered->getNumIndices() == 0)
+                        continue;
+                    filtered->setElementBufferObject(ebo);
+                    primitiveSets.push_back(filtered);
+                }
+                patched = new osg::Geometry(*geometry.mPristine, osg::CopyOp::SHALLOW_COPY);
+                patched->setPrimitiveSetList(primitiveSets);
+            }
+
+            // The current geometry may still be in use by the draw thread, so it is replaced rather than modified
+            const osg::Node::ParentList parents = geometry.mCurrent->getParents();
+            for (osg::Group* parent : parents)
+                parent->replaceChild(geometry.mCurrent, patched);
+            geometry.mCurrent = patched;
+            return true;
+        }
+    };
+
+    class BuildChunkRefIndexVisitor : public osg::NodeVisitor
+    {
+    public:
+        BuildChunkRefIndexVisitor(ChunkRefIndex& index) : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN), mIndex(index) {}
+
+        void apply(osg::Node& node) override
+        {
+            if (const RefnumMarker* marker = getMarker(node))
+            {
+                if (!marker->mNumVertices)
+                {
+                    mIndex.mInstances[marker->mRefnum].push_back(ChunkRefIndex::Instance {&node, node.getNodeMask()});
+                    return;
+                }
+            }
+            traverse(node);
+        }
+
+        void apply(osg::Geometry& geometry) override
+        {
+            osg::UserDataContainer* udc = geometry.getUserDataContainer();
+            if (!udc)
+                return;
+            ChunkRefIndex::MergedGeometry merged;
+            unsigned int vertexCounter = 0;
+            for (unsigned int i = 0; i < udc->getNumUserObjects(); ++i)
+            {
+                if (const RefnumMarker* marker = dynamic_cast<const RefnumMarker*>(udc->getUserObject(i)))
+                {
+                    merged.mRanges[marker->mRefnum].emplace_back(vertexCounter, vertexCounter + marker->mNumVertices);
+                    vertexCounter += marker->mNumVertices;
+                }
+            }
+            if (merged.mRanges.empty())
+                return;
+            merged.mPristine = &geometry;
+            merged.mCurrent = &geometry;
+            mIndex.mMergedGeometries.push_back(std::move(merged));
+        }
+
+    private:
+        static const RefnumMarker* getMarker(const osg::Node& node)
+        {
+            const osg::UserDataContainer* udc = node.getUserDataContainer();
+            if (!udc)
+                return nullptr;
+            for (unsigned int i = 0; i < udc->getNumUserObjects(); ++i)
+                if (const RefnumMarker* marker = dynamic_cast<const RefnumMarker*>(udc->getUserObject(i)))
+                    return marker;
+            return nullptr;
+        }
+
+        ChunkRefIndex& mIndex;
+    };
+
     class AnalyzeVisitor : public osg::NodeVisitor
     {
     public:
@@ -398,10 +705,214 @@ namespace MWRender
         }
     };
 
+    class CollectStateSetsVisitor : public osg::NodeVisitor
+    {
+    public:
+        CollectStateSetsVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) { setNodeMaskOverride(~0u); }
+
+        void apply(osg::Node& node) override
+        {
+            if (osg::StateSet* stateSet = node.getStateSet())
+                mStateSets.push_back(stateSet);
+            traverse(node);
+        }
+
+        std::vector<const osg::StateSet*> mStateSets;
+    };
+
+    std::vector<const osg::StateSet*> collectStateSets(const osg::Node& node)
+    {
+        CollectStateSetsVisitor visitor;
+        const_cast<osg::Node&>(node).accept(visitor); // const-trickery required because there is no const version of NodeVisitor
+        return std::move(visitor.mStateSets);
+    }
+
+    // Merged geometry of distant chunks is cached on disk. The StateSets of the merged geometry are shared with the
+    // object templates, so they are stored as a reference to the template StateSet they come from.
+    namespace ChunkCache
+    {
+        constexpr std::uint32_t sVersion = 1;
+
+        enum class StateSetKind : std::uint8_t
+        {
+            Template = 1,
+            MergedAlphaBlending = 2,
+        };
+
+        template <class T>
+        void write(std::ostream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <class T>
+        T read(std::istream& stream)
+        {
+            T value;
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if (!stream)
+                throw std::runtime_error("Unexpected end of object paging chunk cache entry");
+            return value;
+        }
+
+        std::string getName(float size, const osg::Vec2f& center)
+        {
+            std::ostringstream stream;
+            stream.imbue(std::locale::classic());
+            stream << "objects_" << center.x() << '_' << center.y() << '_' << size << ".bin";
+            return stream.str();
+        }
+
+        /// Matches the StateSet the optimizer adds to merged alpha blended geometry, see SceneUtil::Optimizer::MergeGeometryVisitor.
+        bool isMergedAlphaBlendingStateSet(const osg::StateSet& stateSet)
+        {
+            if (stateSet.getAttributeList().size() != 1 || !stateSet.getModeList().empty() || !stateSet.getTextureAttributeList().empty()
+                || !stateSet.getTextureModeList().empty() || !stateSet.getUniformList().empty() || !stateSet.getDefineList().empty()
+                || stateSet.getRenderingHint() != osg::StateSet::DEFAULT_BIN || stateSet.getRenderBinMode() != osg::StateSet::INHERIT_RENDERBIN_DETAILS
+                || stateSet.getUpdateCallback() || stateSet.getEventCallback())
+                return false;
+            const auto* depth = dynamic_cast<const SceneUtil::AutoDepth*>(stateSet.getAttributeList().begin()->second.first.get());
+            return depth && !depth->getWriteMask() && depth->getFunction() == osg::Depth::LESS;
+        }
+
+        bool writeRefnumMarker(const osg::Object& object, std::ostream& stream)
+        {
+            const RefnumMarker* marker = dynamic_cast<const RefnumMarker*>(&object);
+            if (!marker)
+                return false;
+            write(stream, static_cast<std::uint32_t>(marker->mRefnum.mIndex));
+            write(stream, static_cast<std::int32_t>(marker->mRefnum.mContentFile));
+            write(stream, static_cast<std::uint32_t>(marker->mNumVertices));
+            return true;
+        }
+
+        osg::ref_ptr<osg::Object> readRefnumMarker(std::istream& stream)
+        {
+            osg::ref_ptr<RefnumMarker> marker = new RefnumMarker;
+            marker->mRefnum.mIndex = read<std::uint32_t>(stream);
+            marker->mRefnum.mContentFile = read<std::int32_t>(stream);
+            marker->mNumVertices = read<std::uint32_t>(stream);
+            return marker;
+        }
+
+        using Models = std::vector<std::pair<std::string, const osg::Node*>>;
+
+        /// @return std::nullopt if the merged geometry can not be cached
+        std::optional<std::string> serialize(const std::vector<ESM::RefNum>& refnums, const Models& models, const osg::Node& mergeGroup)
+        {
+            std::ostringstream stream(std::ios::binary);
+            write(stream, sVersion);
+            write(stream, static_cast<std::uint32_t>(refnums.size()));
+            for (const ESM::RefNum& refnum : refnums)
+            {
+                write(stream, static_cast<std::uint32_t>(refnum.mIndex));
+                write(stream, static_cast<std::int32_t>(refnum.mContentFile));
+            }
+
+            std::unordered_map<const osg::StateSet*, std::pair<std::uint32_t, std::uint32_t>> stateSetIndex;
+            write(stream, static_cast<std::uint32_t>(models.size()));
+            for (std::size_t i = 0; i < models.size(); ++i)
+            {
+                const std::string& name = models[i].first;
+                write(stream, static_cast<std::uint32_t>(name.size()));
+                stream.write(name.data(), name.size());
+                const std::vector<const osg::StateSet*> stateSets = collectStateSets(*models[i].second);
+                write(stream, static_cast<std::uint32_t>(stateSets.size()));
+                for (std::size_t j = 0; j < stateSets.size(); ++j)
+                    stateSetIndex.emplace(stateSets[j], std::make_pair(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j)));
+            }
+
+            const auto writeStateSet = [&] (const osg::StateSet& stateSet, std::ostream& out)
+            {
+                const auto found = stateSetIndex.find(&stateSet);
+                if (found != stateSetIndex.end())
+                {
+                    write(out, StateSetKind::Template);
+                    write(out, found->second.first);
+                    write(out, found->second.second);
+                    return true;
+                }
+                if (isMergedAlphaBlendingStateSet(stateSet))
+                {
+                    write(out, StateSetKind::MergedAlphaBlending);
+                    return true;
+                }
+                return false;
+            };
+
+            if (!SceneUtil::writeStaticGeometry(mergeGroup, stream, writeStateSet, writeRefnumMarker))
+                return std::nullopt;
+            return stream.str();
+        }
+
+        /// @return nullptr if the entry was built from different references or models
+        /// @throw std::runtime_error if the entry is invalid
+        osg::ref_ptr<osg::Node> deserialize(const std::string& data, const std::vector<ESM::RefNum>& refnums, const Models& models)
+        {
+            Files::IMemStream stream(data.data(), data.size());
+            if (read<std::uint32_t>(stream) != sVersion)
+                return nullptr;
+            if (read<std::uint32_t>(stream) != refnums.size())
+                return nullptr;
+            for (const ESM::RefNum& refnum : refnums)
+            {
+                ESM::RefNum cached;
+                cached.mIndex = read<std::uint32_t>(stream);
+                cached.mContentFile = read<std::int32_t>(stream);
+                if (!(cached == refnum))
+                    return nullptr;
+            }
+
+            if (read<std::uint32_t>(stream) != models.size())
+                return nullptr;
+            std::vector<std::vector<const osg::StateSet*>> stateSets;
+            for (const auto& [name, node] : models)
+            {
+                std::string cachedName(read<std::uint32_t>(stream), '\0');
+                stream.read(cachedName.data(), cachedName.size());
+                if (!stream || cachedName != name)
+                    return nullptr;
+                stateSets.push_back(collectStateSets(*node));
+                if (read<std::uint32_t>(stream) != stateSets.back().size())
+                    return nullptr;
+            }
+
+            const auto readStateSet = [&] (std::istream& in) -> osg::ref_ptr<osg::StateSet>
+            {
+                switch (read<StateSetKind>(in))
+                {
+                    case StateSetKind::Template:
+                    {
+                        const std::uint32_t model = read<std::uint32_t>(in);
+                        const std::uint32_t index = read<std::uint32_t>(in);
+                        if (model >= stateSets.size() || index >= stateSets[model].size())
+                            throw std::runtime_error("Invalid StateSet reference in object paging chunk cache entry");
+                        return const_cast<osg::StateSet*>(stateSets[model][index]);
+                    }
+                    case StateSetKind::MergedAlphaBlending:
+                    {
+                        osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet;
+                        osg::ref_ptr<osg::Depth> depth = new SceneUtil::AutoDepth;
+                        depth->setWriteMask(false);
+                        stateSet->setAttribute(depth);
+                        return stateSet;
+                    }
+                }
+                throw std::runtime_error("Invalid StateSet kind in object paging chunk cache entry");
+            };
+
+            return SceneUtil::readStaticGeometry(stream, readStateSet, readRefnumMarker);
+        }
+    }
+
     ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager)
             : GenericResourceManager<ChunkId>(nullptr)
          , mSceneManager(sceneManager)
          , mRefTrackerLocked(false)
+         , mBuildScheduled(false)
+         , mBuildsStopped(false)
+         , mChunksChanged(false)
+         , mNumCancelledRequests(0)
     {
         mActiveGrid = Settings::Manager::getBool("object paging active grid", "Terrain");
         mDebugBatches = Settings::Manager::getBool("debug chunks", "Terrain");
@@ -411,7 +922,154 @@ namespace MWRender
         mMinSizeCostMultiplier = Settings::Manager::getFloat("object paging min size cost multiplier", "Terrain");
     }
 
-    osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
+    ObjectPaging::~ObjectPaging()
+    {
+        osg::ref_ptr<SceneUtil::WorkItem> buildItem;
+        {
+            std::lock_guard<std::mutex> lock(mRequestMutex);
+            mBuildsStopped = true;
+            buildItem = mBuildItem;
+        }
+        if (buildItem)
+        {
+            buildItem->abort();
+            buildItem->waitTillDone();
+        }
+    }
+
+    osg::ref_ptr<osg::Node> ObjectPaging::requestChunk(const ChunkId& id, const osg::Vec3f& viewPoint)
+    {
+        std::lock_guard<std::mutex> lock(mRequestMutex);
+        osg::ref_ptr<ChunkRequest>& request = mRequests[id];
+        if (!request)
+        {
+            request = new ChunkRequest;
+            request->mId = id;
+            request->mPlaceholder = new osg::Group;
+            request->mPlaceholder->setNodeMask(Mask_PagedStatic);
+            scheduleBuild();
+        }
+        request->mViewPoint = viewPoint;
+        return request->mPlaceholder;
+    }
+
+    void ObjectPaging::scheduleBuild()
+    {
+        if (mBuildScheduled || mBuildsStopped)
+            return;
+        mBuildScheduled = true;
+        mBuildItem = new ChunkBuildWorkItem(this);
+        mWorkQueue->addWorkItem(mBuildItem);
+    }
+
+    osg::ref_ptr<ChunkRequest> ObjectPaging::takeNextRequest()
+    {
+        std::lock_guard<std::mutex> lock(mRequestMutex);
+        osg::ref_ptr<ChunkRequest> next;
+        float nextPriority = std::numeric_limits<float>::max();
+        for (auto it = mRequests.begin(); it != mRequests.end();)
+        {
+            ChunkRequest& request = *it->second;
+            // Views only obtain the placeholder through getChunk() which locks mRequestMutex, so it can not be picked up again
+            if (request.mState != ChunkRequest::State::Building && request.mPlaceholder->referenceCount() == 1)
+            {
+                it = mRequests.erase(it);
+                ++mNumCancelledRequests;
+                continue;
+            }
+            if (request.mState == ChunkRequest::State::Queued)
+            {
+                const float priority = getRequestPriority(request.mId, mViewerPosition, mViewerDirection);
+                if (priority < nextPriority)
+                {
+                    next = it->second;
+                    nextPriority = priority;
+                }
+            }
+            ++it;
+        }
+        if (next)
+        {
+            // The build reads the current references, earlier changes are part of it already
+            next->mState = ChunkRequest::State::Building;
+            next->mRefChanges.clear();
+            next->mOutdated = false;
+        }
+        else
+            mBuildScheduled = false;
+        return next;
+    }
+
+    void ObjectPaging::buildNextChunk(const std::atomic_bool& abort)
+    {
+        if (abort)
+            return;
+
+        osg::ref_ptr<ChunkRequest> request = takeNextRequest();
+        if (!request)
+            return;
+
+        const auto& [center, size, activeGrid] = request->mId;
+        osg::ref_ptr<ChunkCompiledCallback> compileCompleted = new ChunkCompiledCallback(request);
+        osg::ref_ptr<osg::Node> node = createChunk(size, center, activeGrid, request->mViewPoint, true, compileCompleted);
+
+        std::lock_guard<std::mutex> lock(mRequestMutex);
+        request->mResult = node;
+        request->mState = ChunkRequest::State::Built;
+        // Go to the back of the work queue, so that other work like cell preloading is not held up by a long backlog of
+        // chunks. The next item picks the chunk by the viewer position at that time.
+        mBuildScheduled = false;
+        if (!abort)
+            scheduleBuild();
+    }
+
+    void ObjectPaging::requeue(ChunkRequest& request)
+    {
+        request.mState = ChunkRequest::State::Queued;
+        request.mResult = nullptr;
+        request.mCompiled = false;
+        scheduleBuild();
+    }
+
+    bool ObjectPaging::update()
+    {
+        std::lock_guard<std::mutex> lock(mRequestMutex);
+        for (auto it = mRequests.begin(); it != mRequests.end();)
+        {
+            ChunkRequest& request = *it->second;
+            if (request.mState != ChunkRequest::State::Built || !request.mCompiled)
+            {
+                ++it;
+                continue;
+            }
+            if (request.mOutdated || !patchRequest(request))
+            {
+                requeue(request);
+                ++it;
+                continue;
+            }
+            request.mPlaceholder->addChild(request.mResult);
+            mCache->addEntryToObjectCache(request.mId, request.mResult);
+            it = mRequests.erase(it);
+            mChunksChanged = true;
+        }
+        return std::exchange(mChunksChanged, false);
+    }
+
+    void ObjectPaging::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+    {
+        mWorkQueue = workQueue;
+    }
+
+    void ObjectPaging::setViewer(const osg::Vec3f& position, const osg::Vec3f& direction)
+    {
+        std::lock_guard<std::mutex> lock(mRequestMutex);
+        mViewerPosition = position;
+        mViewerDirection = direction;
+    }
+
+    osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile,
+        osgUtil::IncrementalCompileOperation::CompileCompletedCallback* compileCompleted)
     {
         osg::Vec2i startCell = osg::Vec2i(std::floor(center.x() - size/2.f), std::floor(center.y() - size/2.f));
 
@@ -487,6 +1145,7 @@ namespace MWRender
         osg::Vec2f maxBound = (center + osg::Vec2f(size/2.f, size/2.f));
         struct InstanceList
         {
+            std::string mModel;
             std::vector<const ESM::CellRef*> mInstances;
             AnalyzeVisitor::Result mAnalyzeResult;
             bool mNeedCompile = false;
@@ -494,6 +1153,7 @@ namespace MWRender
         typedef std::map<osg::ref_ptr<const osg::Node>, InstanceList> NodeMap;
         NodeMap nodes;
         osg::ref_ptr<RefnumSet> refnumSet = activeGrid ? new RefnumSet : nullptr;
+        std::vector<ESM::RefNum> disabledRefs;
 
         // Mask_UpdateVisitor is used in such cases in NIF loader:
         // 1. For collision nodes, which is not supposed to be rendered.
@@ -559,9 +1219,11 @@ namespace MWRender
             }
 
             {
+                // Disabled objects are built into the chunk anyway and hidden afterwards, so that enabling them does not
+                // require a rebuild
                 std::lock_guard<std::mutex> lock(mRefTrackerMutex);
                 if (getRefTracker().mDisabled.count(pair.first))
-                    continue;
+                    disabledRefs.push_back(pair.first);
             }
 
             float radius2 = cnode->getBound().radius2() * ref.mScale*ref.mScale;
@@ -575,6 +1237,7 @@ namespace MWRender
             auto emplaced = nodes.emplace(cnode, InstanceList());
             if (emplaced.second)
             {
+                emplaced.first->second.mModel = model;
                 const_cast<osg::Node*>(cnode.get())->accept(analyzeVisitor); // const-trickery required because there is no const version of NodeVisitor
                 emplaced.first->second.mAnalyzeResult = analyzeVisitor.retrieveResult();
                 emplaced.first->second.mNeedCompile = compile && cnode->referenceCount() <= 3;
@@ -590,6 +1253,45 @@ namespace MWRender
         osgUtil::StateToCompile stateToCompile(0, nullptr);
         CopyOp copyop;
         copyop.mCopyMask = copyMask;
+
+        const auto copyInstance = [&] (const osg::Node* cnode, const ESM::CellRef& ref, osg::Group* trans, bool merge)
+        {
+            const osg::Vec3f pos = ref.mPos.asVec3();
+            // DO NOT COPY AND PASTE THIS CODE. Cloning osg::Geometry without also cloning its contained Arrays is generally unsafe.
+            // In this specific case the operation is safe under the following two assumptions:
+            // - When Arrays are removed or replaced in the cloned geometry, the original Arrays in their place must outlive the cloned geometry regardless. (ensured by TemplateMultiRef)
+            // - Arrays that we add or replace in the cloned geometry must be explicitely forbidden from reusing BufferObjects of the original geometry. (ensured by needvbo() in optimizer.cpp)
+            copyop.setCopyFlags(merge ? osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES : osg::CopyOp::DEEP_COPY_NODES);
+            copyop.mOptimizeBillboards = (size > 1/4.f);
+            copyop.mNodePath.push_back(trans);
+            copyop.mSqrDistance = (viewPoint - pos).length2();
+            copyop.mViewVector = (viewPoint - worldCenter);
+            copyop.copy(cnode, trans);
+            copyop.mNodePath.pop_back();
+
+            if (merge)
+            {
+                AddRefnumMarkerVisitor visitor(ref.mRefNum);
+                trans->accept(visitor);
+            }
+            else
+            {
+                osg::ref_ptr<RefnumMarker> marker = new RefnumMarker; marker->mRefnum = ref.mRefNum;
+                trans->getOrCreateUserDataContainer()->addUserObject(marker);
+            }
+        };
+
+        // Copies of merged instances are deferred, they are not needed if the merged geometry is in the cache
+        struct MergeInstance
+        {
+            const osg::Node* mTemplate;
+            const ESM::CellRef* mRef;
+            osg::ref_ptr<osg::Group> mTransform;
+        };
+        std::vector<MergeInstance> mergeInstances;
+        std::vector<ESM::RefNum> mergedRefnums;
+        ChunkCache::Models mergedModels;
+
         for (const auto& pair : nodes)
         {
             const osg::Node* cnode = pair.first;
@@ -641,34 +1343,18 @@ namespace MWRender
                     pat->setAttitude(nodeAttitude);
                 }
 
-                // DO NOT COPY AND PASTE THIS CODE. Cloning osg::Geometry without also cloning its contained Arrays is generally unsafe.
-                // In this specific case the operation is safe under the following two assumptions:
-                // - When Arrays are removed or replaced in the cloned geometry, the original Arrays in their place must outlive the cloned geometry regardless. (ensured by TemplateMultiRef)
-                // - Arrays that we add or replace in the cloned geometry must be explicitely forbidden from reusing BufferObjects of the original geometry. (ensured by needvbo() in optimizer.cpp)
-                copyop.setCopyFlags(merge ? osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES : osg::CopyOp::DEEP_COPY_NODES);
-                copyop.mOptimizeBillboards = (size > 1/4.f);
-                copyop.mNodePath.push_back(trans);
-                copyop.mSqrDistance = (viewPoint - pos).length2();
-                copyop.mViewVector = (viewPoint - worldCenter);
-                copyop.copy(cnode, trans);
-                copyop.mNodePath.pop_back();
-
-                if (activeGrid)
+                if (merge)
                 {
-                    if (merge)
-                    {
-                        AddRefnumMarkerVisitor visitor(ref.mRefNum);
-                        trans->accept(visitor);
-                    }
-                    else
-                    {
-                        osg::ref_ptr<RefnumMarker> marker = new RefnumMarker; marker->mRefnum = ref.mRefNum;
-                        trans->getOrCreateUserDataContainer()->addUserObject(marker);
-                    }
+                    if (mergedModels.empty() || mergedModels.back().second != cnode)
+                        mergedModels.emplace_back(pair.second.mModel, cnode);
+                    mergeInstances.push_back(MergeInstance {cnode, cref, trans});
+                    mergedRefnums.push_back(ref.mRefNum);
+                }
+                else
+                {
+                    copyInstance(cnode, ref, trans, false);
+                    group->addChild(trans);
                 }
-
-                osg::Group* attachTo = merge ? mergeGroup : group;
-                attachTo->addChild(trans);
                 ++numinstances;
             }
             if (numinstances > 0)
@@ -688,7 +1374,42 @@ namespace MWRender
             }
         }
 
-        if (mergeGroup->getNumChildren())
+        const bool canCache = mLodCache && !activeGrid && !mDebugBatches && !mergeInstances.empty();
+        const std::string cacheName = canCache ? ChunkCache::getName(size, center) : std::string();
+        bool cached = false;
+        if (canCache)
+        {
+            // The iteration order of nodes depends on template addresses, so the cache is keyed by sorted lists
+            std::sort(mergedRefnums.begin(), mergedRefnums.end());
+            std::sort(mergedModels.begin(), mergedModels.end(), [] (const auto& l, const auto& r) { return l.first < r.first; });
+            if (const std::optional<std::string> data = mLodCache->read(cacheName))
+            {
+                try
+                {
+                    osg::ref_ptr<osg::Node> node = ChunkCache::deserialize(*data, mergedRefnums, mergedModels);
+                    if (node && node->asGroup())
+                    {
+                        mergeGroup = node->asGroup();
+                        cached = true;
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Warning) << "Failed to load object paging chunk " << cacheName << " from cache: " << e.what();
+                }
+            }
+        }
+
+        if (!cached)
+        {
+            for (const MergeInstance& instance : mergeInstances)
+            {
+                copyInstance(instance.mTemplate, *instance.mRef, instance.mTransform, true);
+                mergeGroup->addChild(instance.mTransform);
+            }
+        }
+
+        if (!cached && mergeGroup->getNumChildren())
         {
             SceneUtil::Optimizer optimizer;
             if (size > 1/8.f)
@@ -701,13 +1422,23 @@ namespace MWRender
 
             optimizer.optimize(mergeGroup, options);
 
-            group->addChild(mergeGroup);
+            if (canCache)
+            {
+                if (std::optional<std::string> data = ChunkCache::serialize(mergedRefnums, mergedModels, *mergeGroup))
+                    mLodCache->write(cacheName, std::move(*data));
+            }
 
             if (mDebugBatches)
             {
                 DebugVisitor dv;
                 mergeGroup->accept(dv);
             }
+        }
+
+        if (mergeGroup->getNumChildren())
+        {
+            group->addChild(mergeGroup);
+
             if (compile)
             {
                 stateToCompile._mode = osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS;
@@ -720,11 +1451,24 @@ namespace MWRender
         {
             auto compileSet = new osgUtil::IncrementalCompileOperation::CompileSet(group);
             compileSet->buildCompileMap(ico->getContextSet(), stateToCompile);
+            compileSet->_compileCompletedCallback = compileCompleted;
             ico->add(compileSet, false);
         }
+        else if (compileCompleted)
+            compileCompleted->compileCompleted(nullptr);
+
+        osg::ref_ptr<ChunkRefIndex> refIndex = new ChunkRefIndex;
+        BuildChunkRefIndexVisitor buildRefIndexVisitor(*refIndex);
+        group->accept(buildRefIndexVisitor);
+        for (const ESM::RefNum& refnum : disabledRefs)
+        {
+            // A failure leaves the object visible. That can only happen for merged points and lines.
+            if (!refIndex->setHidden(refnum, true))
+                Log(Debug::Warning) << "Failed to hide disabled object " << refnum.mIndex << " in object paging chunk";
+        }
 
         group->getBound();
-        group->setNodeMask(Mask_Static);
+        group->setNodeMask(Mask_PagedStatic);
         osg::UserDataContainer* udc = group->getOrCreateUserDataContainer();
         if (activeGrid)
         {
@@ -734,13 +1478,14 @@ namespace MWRender
             group->addCullCallback(new SceneUtil::LightListCallback);
         }
         udc->addUserObject(templateRefs);
+        udc->addUserObject(refIndex);
 
         return group;
     }
 
     unsigned int ObjectPaging::getNodeMask()
     {
-        return Mask_Static;
+        return Mask_PagedStatic;
     }
 
     struct ClearCacheFunctor
@@ -786,10 +1531,7 @@ namespace MWRender
         ccf.mPosition = pos;
         ccf.mCell = cell;
         mCache->call(ccf);
-        if (ccf.mToClear.empty()) return false;
-        for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
-        return true;
+        return patchChunks(ccf, refnum, !enabled, false);
     }
 
     bool ObjectPaging::blacklistObject(int type, const ESM::RefNum & refnum, const osg::Vec3f& pos, const osg::Vec2i& cell)
@@ -808,9 +1550,89 @@ namespace MWRender
         ccf.mCell = cell;
         ccf.mActiveGridOnly = true;
         mCache->call(ccf);
-        if (ccf.mToClear.empty()) return false;
+        return patchChunks(ccf, refnum, true, true);
+    }
+
+    bool ObjectPaging::patchChunks(ClearCacheFunctor& ccf, const ESM::RefNum& refnum, bool hidden, bool blacklisted)
+    {
+        {
+            // Chunks still being built are patched by update() before they are attached
+            std::lock_guard<std::mutex> lock(mRequestMutex);
+            for (auto& [id, request] : mRequests)
+            {
+                if (!ccf.intersects(id, ccf.mPosition))
+                    continue;
+                ChunkRefChange& change = request->mRefChanges[refnum];
+                change.mHidden = hidden;
+                change.mBlacklisted = change.mBlacklisted || blacklisted;
+            }
+        }
+
+        bool needsRebuild = false;
         for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
+        {
+            osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(chunk);
+            if (!obj)
+                continue;
+
+            mChunksChanged = true;
+            if (!patchChunk(*obj, std::get<2>(chunk), refnum, hidden, blacklisted))
+            {
+                mCache->removeFromObjectCache(chunk);
+                needsRebuild = true;
+            }
+        }
+        return needsRebuild;
+    }
+
+    bool ObjectPaging::patchRequest(ChunkRequest& request)
+    {
+        for (const auto& [refnum, change] : request.mRefChanges)
+        {
+            if (!patchChunk(*request.mResult, std::get<2>(request.mId), refnum, change.mHidden, change.mBlacklisted))
+                return false;
+        }
+        request.mRefChanges.clear();
+        return true;
+    }
+
+    bool ObjectPaging::patchChunk(osg::Object& chunk, bool activeGrid, const ESM::RefNum& refnum, bool hidden, bool blacklisted)
+    {
+        ChunkRefIndex* refIndex = nullptr;
+        RefnumSet* refnumSet = nullptr;
+        if (osg::UserDataContainer* udc = chunk.getUserDataContainer())
+        {
+            for (unsigned int i = 0; i < udc->getNumUserObjects(); ++i)
+            {
+                if (!refIndex)
+                    refIndex = dynamic_cast<ChunkRefIndex*>(udc->getUserObject(i));
+                if (!refnumSet)
+                    refnumSet = dynamic_cast<RefnumSet*>(udc->getUserObject(i));
+            }
+        }
+
+        // References outside of the chunk would not be part of a rebuilt chunk either
+        if (refIndex && !refIndex->contains(refnum))
+            return true;
+
+        bool hide = hidden;
+        if (!hide && activeGrid)
+        {
+            // Blacklisted references stay hidden in the active grid even when they are enabled
+            std::lock_guard<std::mutex> lock(mRefTrackerMutex);
+            hide = getRefTracker().mBlacklist.count(refnum) != 0;
+        }
+
+        if (!refIndex || !refIndex->setHidden(refnum, hide))
+            return false;
+
+        // Blacklisted references are no longer paged and will be inserted into the scene as regular objects
+        if (blacklisted && refnumSet)
+        {
+            auto found = std::lower_bound(refnumSet->mRefnums.begin(), refnumSet->mRefnums.end(), refnum);
+            if (found != refnumSet->mRefnums.end() && *found == refnum)
+                refnumSet->mRefnums.erase(found);
+        }
         return true;
     }
 
@@ -834,6 +1656,12 @@ namespace MWRender
             else
                 mRefTracker = mRefTrackerNew;
         }
+        {
+            // Queued requests read the new references once they are built
+            std::lock_guard<std::mutex> lock(mRequestMutex);
+            for (auto& [id, request] : mRequests)
+                request->mOutdated = request->mState != ChunkRequest::State::Queued;
+        }
         mCache->clear();
         return true;
     }
@@ -872,6 +1700,12 @@ namespace MWRender
     void ObjectPaging::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Object Chunk", mCache->getCacheSize());
+        if (mWorkQueue)
+        {
+            std::lock_guard<std::mutex> lock(mRequestMutex);
+            stats->setAttribute(frameNumber, "Object Chunk Queued", mRequests.size());
+            stats->setAttribute(frameNumber, "Object Chunk Cancelled", mNumCancelledRequests);
+        }
     }
 
 }
@@ -4,7 +4,13 @@
 #include <components/terrain/quadtreeworld.hpp>
 #include <components/resource/resourcemanager.hpp>
 #include <components/esm3/loadcell.hpp>
+#include <components/sceneutil/lodcache.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
+#include <osgUtil/IncrementalCompileOperation>
+
+#include <atomic>
+#include <map>
 #include <mutex>
 
 namespace Resource
@@ -21,15 +27,33 @@ namespace MWRender
 
     typedef std::tuple<osg::Vec2f, float, bool> ChunkId; // Center, Size, ActiveGrid
 
+    struct ChunkRequest;
+    struct ClearCacheFunctor;
+
     class ObjectPaging : public Resource::GenericResourceManager<ChunkId>, public Terrain::QuadTreeWorld::ChunkManager
     {
     public:
         ObjectPaging(Resource::SceneManager* sceneManager);
-        ~ObjectPaging() = default;
+        ~ObjectPaging();
 
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile) override;
 
-        osg::ref_ptr<osg::Node> createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile);
+        /// @param compileCompleted Invoked once the chunk can be drawn without compiling GL objects, i.e. right away if there is nothing to compile.
+        osg::ref_ptr<osg::Node> createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile,
+            osgUtil::IncrementalCompileOperation::CompileCompletedCallback* compileCompleted = nullptr);
+
+        /// Enables building chunks that are requested by the cull traversal in the background.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
+        /// Store merged geometry of distant chunks in the given cache and load it from there instead of merging it again.
+        void setLodCache(SceneUtil::LodCache* cache) { mLodCache = cache; }
+
+        /// Set the position and looking direction used to prioritize background builds.
+        void setViewer(const osg::Vec3f& position, const osg::Vec3f& direction);
+
+        /// Attach compiled background builds to the scene graph. Must be called from the main thread.
+        /// @return true if chunks in the scene graph were attached, patched or removed since the last call
+        bool update();
 
         unsigned int getNodeMask() override;
 
@@ -50,6 +74,39 @@ namespace MWRender
         void getPagedRefnums(const osg::Vec4i &activeGrid, std::vector<ESM::RefNum>& out);
 
     private:
+        friend class ChunkBuildWorkItem;
+
+        /// Queue a chunk for a background build.
+        /// @return Placeholder the chunk will be added to once it is built and compiled.
+        osg::ref_ptr<osg::Node> requestChunk(const ChunkId& id, const osg::Vec3f& viewPoint);
+
+        /// Build the queued chunk closest to the viewer and schedule another work item for the rest. Called by a worker thread.
+        void buildNextChunk(const std::atomic_bool& abort);
+
+        /// Drop requests that are no longer referenced by any view and pick the one with the highest priority.
+        /// @return nullptr if there is nothing left to build
+        osg::ref_ptr<ChunkRequest> takeNextRequest();
+
+        /// @note Must be called with mRequestMutex locked.
+        void scheduleBuild();
+
+        /// Build the chunk of a request again.
+        /// @note Must be called with mRequestMutex locked.
+        void requeue(ChunkRequest& request);
+
+        /// Hide or show a reference in the cached chunks collected by the functor without rebuilding them. Chunks that can not
+        /// be patched are removed from the cache. Requests intersecting the position are patched once their build is done.
+        /// @return true if view needs rebuild
+        bool patchChunks(ClearCacheFunctor& ccf, const ESM::RefNum& refnum, bool hidden, bool blacklisted);
+
+        /// Apply the reference changes that happened during the build to the result.
+        /// @return false if the chunk needs to be built again
+        /// @note Must be called with mRequestMutex locked.
+        bool patchRequest(ChunkRequest& request);
+
+        /// @return false if the chunk can not be patched and needs to be built again
+        bool patchChunk(osg::Object& chunk, bool activeGrid, const ESM::RefNum& refnum, bool hidden, bool blacklisted);
+
         Resource::SceneManager* mSceneManager;
         bool mActiveGrid;
         bool mDebugBatches;
@@ -75,6 +132,19 @@ namespace MWRender
         std::mutex mSizeCacheMutex;
         typedef std::map<ESM::RefNum, float> SizeCache;
         SizeCache mSizeCache;
+
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        mutable std::mutex mRequestMutex;
+        std::map<ChunkId, osg::ref_ptr<ChunkRequest>> mRequests;
+        osg::ref_ptr<SceneUtil::WorkItem> mBuildItem;
+        bool mBuildScheduled;
+        bool mBuildsStopped;
+        bool mChunksChanged;
+        osg::Vec3f mViewerPosition;
+        osg::Vec3f mViewerDirection;
+        std::size_t mNumCancelledRequests;
+
+        osg::ref_ptr<SceneUtil::LodCache> mLodCache;
     };
 
     class RefnumMarker : public osg::Object
@@ -3,6 +3,8 @@
 #include <osg/Group>
 #include <osg/UserDataContainer>
 
+#include <components/esm3/loadstat.hpp>
+#include <components/sceneutil/occlusionculling.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
 
@@ -23,6 +25,7 @@ Objects::Objects(Resource::ResourceSystem* resourceSystem, const osg::ref_ptr<os
     : mRootNode(rootNode)
     , mResourceSystem(resourceSystem)
     , mUnrefQueue(unrefQueue)
+    , mOcclusionCuller(nullptr)
 {
 }
 
@@ -44,9 +47,7 @@ void Objects::insertBegin(const MWWorld::Ptr& ptr)
     CellMap::iterator found = mCellSceneNodes.find(ptr.getCell());
     if (found == mCellSceneNodes.end())
     {
-        cellnode = new osg::Group;
-        cellnode->setName("Cell Root");
-        mRootNode->addChild(cellnode);
+        cellnode = createCellNode();
         mCellSceneNodes[ptr.getCell()] = cellnode;
     }
     else
@@ -69,6 +70,16 @@ void Objects::insertBegin(const MWWorld::Ptr& ptr)
     ptr.getRefData().setBaseNode(insert);
 }
 
+osg::ref_ptr<osg::Group> Objects::createCellNode()
+{
+    osg::ref_ptr<osg::Group> cellnode = new osg::Group;
+    cellnode->setName("Cell Root");
+    if (mOcclusionCuller)
+        cellnode->addCullCallback(new SceneUtil::OcclusionCullCallback(*mOcclusionCuller));
+    mRootNode->addChild(cellnode);
+    return cellnode;
+}
+
 void Objects::insertModel(const MWWorld::Ptr &ptr, const std::string &mesh, bool animated, bool allowLight)
 {
     insertBegin(ptr);
@@ -77,6 +88,9 @@ void Objects::insertModel(const MWWorld::Ptr &ptr, const std::string &mesh, bool
     osg::ref_ptr<ObjectAnimation> anim (new ObjectAnimation(ptr, mesh, mResourceSystem, animated, allowLight));
 
     mObjects.emplace(ptr.mRef, std::move(anim));
+
+    if (mOcclusionCuller && ptr.getType() == ESM::Static::sRecordId)
+        mOcclusionCuller->addOccluder(ptr.getRefData().getBaseNode());
 }
 
 void Objects::insertCreature(const MWWorld::Ptr &ptr, const std::string &mesh, bool weaponsShields)
@@ -118,6 +132,9 @@ bool Objects::removeObject (const MWWorld::Ptr& ptr)
     const auto iter = mObjects.find(ptr.mRef);
     if(iter != mObjects.end())
     {
+        if (mOcclusionCuller)
+            mOcclusionCuller->removeOccluder(ptr.getRefData().getBaseNode());
+
         iter->second->removeFromScene();
         mUnrefQueue.push(std::move(iter->second));
         mObjects.erase(iter);
@@ -153,6 +170,9 @@ void Objects::removeCell(const MWWorld::CellStore* store)
                 ptr.getClass().getContainerStore(ptr).setContListener(nullptr);
             }
 
+            if (mOcclusionCuller)
+                mOcclusionCuller->removeOccluder(ptr.getRefData().getBaseNode());
+
             iter->second->removeFromScene();
             mUnrefQueue.push(std::move(iter->second));
             iter = mObjects.erase(iter);
@@ -179,8 +199,7 @@ void Objects::updatePtr(const MWWorld::Ptr &old, const MWWorld::Ptr &cur)
 
     osg::Group* cellnode;
     if(mCellSceneNodes.find(newCell) == mCellSceneNodes.end()) {
-        cellnode = new osg::Group;
-        mRootNode->addChild(cellnode);
+        cellnode = createCellNode();
         mCellSceneNodes[newCell] = cellnode;
     } else {
         cellnode = mCellSceneNodes[newCell];
@@ -27,6 +27,7 @@ namespace MWWorld
 namespace SceneUtil
 {
     class UnrefQueue;
+    class OcclusionCuller;
 }
 
 namespace MWRender{
@@ -65,14 +66,20 @@ class Objects
     osg::ref_ptr<osg::Group> mRootNode;
     Resource::ResourceSystem* mResourceSystem;
     SceneUtil::UnrefQueue& mUnrefQueue;
+    SceneUtil::OcclusionCuller* mOcclusionCuller;
 
     void insertBegin(const MWWorld::Ptr& ptr);
 
+    osg::ref_ptr<osg::Group> createCellNode();
+
 public:
     Objects(Resource::ResourceSystem* resourceSystem, const osg::ref_ptr<osg::Group>& rootNode,
         SceneUtil::UnrefQueue& unrefQueue);
     ~Objects();
 
+    /// Use large static objects as occluders and test all objects against them. Must be set before any object is inserted.
+    void setOcclusionCuller(SceneUtil::OcclusionCuller* culler) { mOcclusionCuller = culler; }
+
     /// @param animated Attempt to load separate keyframes from a .kf file matching the model file?
     /// @param allowLight If false, no lights will be created, and particles systems will be removed.
     void insertModel(const MWWorld::Ptr& ptr, const std::string &model, bool animated=false, bool allowLight=true);
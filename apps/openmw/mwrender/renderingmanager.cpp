@@ -2,6 +2,9 @@
 
 #include <limits>
 #include <cstdlib>
+#include <sstream>
+
+#include <boost/filesystem/path.hpp>
 
 #include <osg/Light>
 #include <osg/LightModel>
@@ -37,12 +40,14 @@
 #include <components/sceneutil/depth.hpp>
 #include <components/sceneutil/visitor.hpp>
 #include <components/sceneutil/lightmanager.hpp>
+#include <components/sceneutil/lodcache.hpp>
 #include <components/sceneutil/statesetupdater.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/workqueue.hpp>
 #include <components/sceneutil/writescene.hpp>
 #include <components/sceneutil/shadow.hpp>
 #include <components/sceneutil/rtt.hpp>
+#include <components/sceneutil/occlusionculling.hpp>
 
 #include <components/misc/constants.hpp>
 
@@ -378,7 +383,7 @@ namespace MWRender
 
     RenderingManager::RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode, std::unique_ptr<Camera> camera,
         Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue, const std::string& resourcePath,
-        DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore,
+        const std::string& userDataPath, const std::string& contentFilesVersion, DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore,
         SceneUtil::UnrefQueue& unrefQueue)
         : mSkyBlending(Settings::Manager::getBool("sky blending", "Fog"))
         , mViewer(viewer)
@@ -444,11 +449,11 @@ namespace MWRender
 
         int indoorShadowCastingTraversalMask = shadowCastingTraversalMask;
         if (Settings::Manager::getBool("object shadows", "Shadows"))
-            shadowCastingTraversalMask |= (Mask_Object|Mask_Static);
+            shadowCastingTraversalMask |= (Mask_Object|Mask_Static|Mask_PagedStatic);
         if (Settings::Manager::getBool("terrain shadows", "Shadows"))
             shadowCastingTraversalMask |= Mask_Terrain;
 
-        mShadowManager = std::make_unique<SceneUtil::ShadowManager>(sceneRoot, mRootNode, shadowCastingTraversalMask, indoorShadowCastingTraversalMask, Mask_Terrain|Mask_Object|Mask_Static, mResourceSystem->getSceneManager()->getShaderManager());
+        mShadowManager = std::make_unique<SceneUtil::ShadowManager>(sceneRoot, mRootNode, shadowCastingTraversalMask, indoorShadowCastingTraversalMask, Mask_Terrain|Mask_Object|Mask_Static|Mask_PagedStatic, Mask_Terrain|Mask_PagedStatic, mResourceSystem->getSceneManager()->getShaderManager());
 
         Shader::ShaderManager::DefineMap shadowDefines = mShadowManager->getShadowDefines();
         Shader::ShaderManager::DefineMap lightDefines = sceneRoot->getLightDefines();
@@ -493,6 +498,20 @@ namespace MWRender
 
         mObjects = std::make_unique<Objects>(mResourceSystem, sceneRoot, unrefQueue);
 
+        if (Settings::Manager::getBool("occlusion culling", "Camera"))
+        {
+            if (Stereo::getStereo())
+                Log(Debug::Warning) << "Occlusion culling is not supported in stereo mode and will be disabled";
+            else
+            {
+                const int resolution = std::clamp(Settings::Manager::getInt("occlusion culling resolution", "Camera"), 16, 1024);
+                const float occluderSize = std::max(0.f, Settings::Manager::getFloat("occlusion culling occluder size", "Camera"));
+                mOcclusionCuller = std::make_unique<SceneUtil::OcclusionCuller>(resolution, resolution,
+                    ~(Mask_UpdateVisitor | Mask_Effect | Mask_ParticleSystem), occluderSize);
+                mObjects->setOcclusionCuller(mOcclusionCuller.get());
+            }
+        }
+
         if (getenv("OPENMW_DONT_PRECOMPILE") == nullptr)
         {
             mViewer->setIncrementalCompileOperation(new osgUtil::IncrementalCompileOperation);
@@ -527,9 +546,35 @@ namespace MWRender
             mTerrain = std::make_unique<Terrain::QuadTreeWorld>(
                 sceneRoot, mRootNode, mResourceSystem, mTerrainStorage.get(), Mask_Terrain, Mask_PreCompile, Mask_Debug,
                 compMapResolution, compMapLevel, lodFactor, vertexLodMod, maxCompGeometrySize, debugChunks);
+            const bool distantLandCache = Settings::Manager::getBool("distant land cache", "Terrain");
+            const boost::filesystem::path lodCachePath = boost::filesystem::path(userDataPath) / "lod";
+            if (distantLandCache)
+            {
+                std::ostringstream version;
+                version << contentFilesVersion << "composite map resolution=" << compMapResolution << "\ncomposite map level=" << compMapLevel
+                    << "\nmax composite geometry size=" << maxCompGeometrySize << "\nformat=1\n";
+                mTerrain->setLodCache(new SceneUtil::LodCache(lodCachePath / "terrain", version.str(), mWorkQueue));
+            }
             if (Settings::Manager::getBool("object paging", "Terrain"))
             {
                 mObjectPaging = std::make_unique<ObjectPaging>(mResourceSystem->getSceneManager());
+                mObjectPaging->setUnrefQueue(&unrefQueue);
+                if (Settings::Manager::getBool("object paging async build", "Terrain"))
+                    mObjectPaging->setWorkQueue(mWorkQueue);
+                if (distantLandCache)
+                {
+                    std::ostringstream version;
+                    version << contentFilesVersion
+                        << "object paging merge factor=" << Settings::Manager::getFloat("object paging merge factor", "Terrain")
+                        << "\nobject paging min size=" << Settings::Manager::getFloat("object paging min size", "Terrain")
+                        << "\nobject paging min size merge factor=" << Settings::Manager::getFloat("object paging min size merge factor", "Terrain")
+                        << "\nobject paging min size cost multiplier=" << Settings::Manager::getFloat("object paging min size cost multiplier", "Terrain")
+                        << "\nforce shaders=" << Settings::Manager::getBool("force shaders", "Shaders")
+                        << "\nauto use object normal maps=" << Settings::Manager::getBool("auto use object normal maps", "Shaders")
+                        << "\nauto use object specular maps=" << Settings::Manager::getBool("auto use object specular maps", "Shaders")
+                        << "\nformat=1\n";
+                    mObjectPaging->setLodCache(new SceneUtil::LodCache(lodCachePath / "objects", version.str(), mWorkQueue));
+                }
                 static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->addChunkManager(mObjectPaging.get());
                 mResourceSystem->addResourceManager(mObjectPaging.get());
             }
@@ -538,6 +583,8 @@ namespace MWRender
             mTerrain = std::make_unique<Terrain::TerrainGrid>(sceneRoot, mRootNode, mResourceSystem, mTerrainStorage.get(), Mask_Terrain, Mask_PreCompile, Mask_Debug);
 
         mTerrain->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
+        mTerrain->setWorkQueue(mWorkQueue);
+        mTerrain->setUnrefQueue(&unrefQueue);
 
         if (groundcover)
         {
@@ -813,6 +860,8 @@ namespace MWRender
         {
             mTerrain->loadCell(store->getCell()->getGridX(), store->getCell()->getGridY());
         }
+
+        mShadowManager->dirtyStaticShadowMaps();
     }
     void RenderingManager::removeCell(const MWWorld::CellStore *store)
     {
@@ -826,6 +875,8 @@ namespace MWRender
         }
 
         mWater->removeCell(store);
+
+        mShadowManager->dirtyStaticShadowMaps();
     }
 
     void RenderingManager::enableTerrain(bool enable)
@@ -944,6 +995,15 @@ namespace MWRender
         }
         mCamera->update(dt, paused);
 
+        if (mObjectPaging)
+        {
+            const osg::Matrixf& viewMatrix = mCamera->getViewMatrix();
+            mObjectPaging->setViewer(mCamera->getPosition(), osg::Vec3f(-viewMatrix(0, 2), -viewMatrix(1, 2), -viewMatrix(2, 2)));
+            // Only paged objects and terrain are rendered into the static shadow maps
+            if (mObjectPaging->update())
+                mShadowManager->dirtyStaticShadowMaps();
+        }
+
         bool isUnderwater = mWater->isUnderwater(mCamera->getPosition());
 
         float fogStart = mFog->getFogStart(isUnderwater);
@@ -1431,6 +1491,13 @@ namespace MWRender
         if (stats->collectStats("resource"))
         {
             mTerrain->reportStats(frameNumber, stats);
+            mSceneRoot->reportStats(frameNumber, stats);
+            if (mOcclusionCuller)
+            {
+                stats->setAttribute(frameNumber, "Occluder", mOcclusionCuller->getNumOccluders());
+                stats->setAttribute(frameNumber, "Occlusion Tested", mOcclusionCuller->getNumTested());
+                stats->setAttribute(frameNumber, "Occlusion Culled", mOcclusionCuller->getNumOccluded());
+            }
         }
     }
 
@@ -59,11 +59,14 @@ namespace MWRender
 
         // Vr masks
         Mask_3DGUI = (1 << 21),
-        Mask_Pointer = (1 << 22)
+        Mask_Pointer = (1 << 22),
+
+        // child of Terrain, set on object paging chunks. Unlike Mask_Static, these never animate and may be cached in static shadow maps.
+        Mask_PagedStatic = (1 << 23)
     };
 
     // Defines masks to remove when using ToggleWorld command
-    constexpr static unsigned int sToggleWorldMask = Mask_Debug | Mask_Actor | Mask_Terrain | Mask_Object | Mask_Static | Mask_Groundcover;
+    constexpr static unsigned int sToggleWorldMask = Mask_Debug | Mask_Actor | Mask_Terrain | Mask_Object | Mask_Static | Mask_PagedStatic | Mask_Groundcover;
 
 }
 
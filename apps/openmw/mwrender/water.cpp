@@ -332,7 +332,7 @@ private:
 
     unsigned int mNodeMask;
 
-    static constexpr unsigned int sDefaultCullMask = Mask_Effect | Mask_Scene | Mask_Object | Mask_Static | Mask_Terrain | Mask_Actor | Mask_ParticleSystem | Mask_Sky | Mask_Sun | Mask_Player | Mask_Lighting | Mask_Groundcover;
+    static constexpr unsigned int sDefaultCullMask = Mask_Effect | Mask_Scene | Mask_Object | Mask_Static | Mask_PagedStatic | Mask_Terrain | Mask_Actor | Mask_ParticleSystem | Mask_Sky | Mask_Sun | Mask_Player | Mask_Lighting | Mask_Groundcover;
 };
 
 class Reflection : public SceneUtil::RTTNode
@@ -406,7 +406,7 @@ private:
         reflectionDetail = std::clamp(reflectionDetail, mInterior ? 2 : 0, 5);
         unsigned int extraMask = 0;
         if(reflectionDetail >= 1) extraMask |= Mask_Terrain;
-        if(reflectionDetail >= 2) extraMask |= Mask_Static;
+        if(reflectionDetail >= 2) extraMask |= Mask_Static | Mask_PagedStatic;
         if(reflectionDetail >= 3) extraMask |= Mask_Effect | Mask_ParticleSystem | Mask_Object;
         if(reflectionDetail >= 4) extraMask |= Mask_Player | Mask_Actor;
         if(reflectionDetail >= 5) extraMask |= Mask_Groundcover;
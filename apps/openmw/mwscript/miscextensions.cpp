@@ -1,5 +1,6 @@
 #include "miscextensions.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iomanip>
 #include <chrono>
@@ -49,6 +50,7 @@
 
 #include "interpretercontext.hpp"
 #include "ref.hpp"
+#include "scriptprofiler.hpp"
 
 namespace
 {
@@ -1519,6 +1521,43 @@ namespace MWScript
             }
         };
 
+        class OpShowScriptProfile : public Interpreter::Opcode1
+        {
+        public:
+            void execute(Interpreter::Runtime &runtime, unsigned int arg0) override
+            {
+                int count = 10;
+                if (arg0==1)
+                {
+                    count = runtime[0].mInteger;
+                    runtime.pop();
+                }
+
+                MWScript::ScriptProfiler& profiler = MWBase::Environment::get().getScriptManager()->getProfiler();
+                if (!profiler.isTimingEnabled())
+                {
+                    profiler.setTimingEnabled(true);
+                    runtime.getContext().report("Script timing enabled, times are measured from now on");
+                }
+
+                const auto scripts = profiler.getSlowest(static_cast<std::size_t>(std::max(count, 0)));
+                if (scripts.empty())
+                {
+                    runtime.getContext().report("No scripts have been run");
+                    return;
+                }
+
+                for (const auto& [name, profile] : scripts)
+                {
+                    std::ostringstream message;
+                    message << name << ": " << profile.mRuns << " runs, " << profile.mInstructions << " instructions, "
+                            << std::fixed << std::setprecision(3) << profile.mTime * 1000 << " ms, "
+                            << profile.mDeferred << " deferred";
+                    runtime.getContext().report(message.str());
+                }
+            }
+        };
+
         class OpToggleNavMesh : public Interpreter::Opcode0
         {
             public:
@@ -1731,6 +1770,7 @@ namespace MWScript
             interpreter.installSegment5<OpRemoveFromLevItem>(Compiler::Misc::opcodeRemoveFromLevItem);
             interpreter.installSegment3<OpShowSceneGraph<ImplicitRef>>(Compiler::Misc::opcodeShowSceneGraph);
             interpreter.installSegment3<OpShowSceneGraph<ExplicitRef>>(Compiler::Misc::opcodeShowSceneGraphExplicit);
+            interpreter.installSegment3<OpShowScriptProfile>(Compiler::Misc::opcodeShowScriptProfile);
             interpreter.installSegment5<OpToggleBorders>(Compiler::Misc::opcodeToggleBorders);
             interpreter.installSegment5<OpToggleNavMesh>(Compiler::Misc::opcodeToggleNavMesh);
             interpreter.installSegment5<OpToggleActorsPaths>(Compiler::Misc::opcodeToggleActorsPaths);
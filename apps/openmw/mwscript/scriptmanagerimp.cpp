@@ -4,6 +4,7 @@
 #include <sstream>
 #include <exception>
 #include <algorithm>
+#include <chrono>
 
 #include <components/debug/debuglog.hpp>
 
@@ -119,7 +120,22 @@ namespace MWScript
                     mOpcodesInstalled = true;
                 }
 
-                mInterpreter.run (&iter->second.mByteCode[0], iter->second.mByteCode.size(), interpreterContext);
+                CompiledScript& script = iter->second;
+                if (script.mInstructions.empty())
+                    script.mInstructions = mInterpreter.decode (&script.mByteCode[0], script.mByteCode.size());
+
+                if (script.mProfile == nullptr)
+                    script.mProfile = &mProfiler.getProfile (name);
+
+                const std::size_t instructionCount = mInterpreter.getInstructionCount();
+                const bool timed = mProfiler.isTimingEnabled();
+                const auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+                mInterpreter.run (&script.mByteCode[0], script.mByteCode.size(), script.mInstructions, interpreterContext);
+
+                const std::chrono::duration<double> time = timed ? std::chrono::steady_clock::now() - start
+                    : std::chrono::duration<double>::zero();
+                mProfiler.add (*script.mProfile, mInterpreter.getInstructionCount() - instructionCount, time.count());
                 return true;
             }
             catch (const MissingImplicitRefError& e)
@@ -143,6 +159,7 @@ namespace MWScript
         }
 
         mGlobalScripts.clear();
+        mProfiler.clear();
     }
 
     std::pair<int, int> ScriptManager::compileAll()
@@ -224,4 +241,9 @@ namespace MWScript
     {
         return *mCompilerContext.getExtensions();
     }
+
+    ScriptProfiler& ScriptManager::getProfiler()
+    {
+        return mProfiler;
+    }
 }
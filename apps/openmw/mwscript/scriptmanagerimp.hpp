@@ -14,6 +14,7 @@
 #include "../mwbase/scriptmanager.hpp"
 
 #include "globalscripts.hpp"
+#include "scriptprofiler.hpp"
 
 namespace MWWorld
 {
@@ -45,8 +46,10 @@ namespace MWScript
             struct CompiledScript
             {
                 std::vector<Interpreter::Type_Code> mByteCode;
+                std::vector<Interpreter::Instruction> mInstructions;
                 Compiler::Locals mLocals;
                 std::set<std::string> mInactive;
+                ScriptProfile* mProfile = nullptr;
 
                 CompiledScript(const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals):
                     mByteCode(code), mLocals(locals)
@@ -59,6 +62,7 @@ namespace MWScript
             GlobalScripts mGlobalScripts;
             std::map<std::string, Compiler::Locals> mOtherLocals;
             std::vector<std::string> mScriptBlacklist;
+            ScriptProfiler mProfiler;
 
         public:
 
@@ -85,6 +89,8 @@ namespace MWScript
             GlobalScripts& getGlobalScripts() override;
 
             const Compiler::Extensions& getExtensions() const override;
+
+            ScriptProfiler& getProfiler() override;
     };
 }
 
@@ -0,0 +1,74 @@
+#include "scriptprofiler.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+#include <osg/Stats>
+
+namespace MWScript
+{
+    ScriptProfile& ScriptProfiler::getProfile (const std::string& name)
+    {
+        return mScripts[name];
+    }
+
+    void ScriptProfiler::startFrame()
+    {
+        mFrame = ScriptProfile();
+    }
+
+    void ScriptProfiler::add (ScriptProfile& profile, std::size_t instructions, double time)
+    {
+        for (ScriptProfile* target : {&profile, &mFrame})
+        {
+            ++target->mRuns;
+            target->mInstructions += instructions;
+            target->mTime += time;
+        }
+    }
+
+    void ScriptProfiler::addDeferred (const std::string& name)
+    {
+        ++mScripts[name].mDeferred;
+        ++mFrame.mDeferred;
+    }
+
+    void ScriptProfiler::clear()
+    {
+        // Keep the entries, references to them are held by the script manager
+        for (auto& [name, profile] : mScripts)
+            profile = ScriptProfile();
+    }
+
+    std::vector<std::pair<std::string, ScriptProfile>> ScriptProfiler::getSlowest (std::size_t count) const
+    {
+        std::vector<std::pair<std::string, ScriptProfile>> result;
+        for (const auto& [name, profile] : mScripts)
+            if (profile.mRuns > 0 || profile.mDeferred > 0)
+                result.emplace_back (name, profile);
+
+        const auto slower = [] (const auto& lhs, const auto& rhs) { return lhs.second.mTime > rhs.second.mTime; };
+        count = std::min (count, result.size());
+        std::partial_sort (result.begin(), result.begin() + count, result.end(), slower);
+        result.resize (count);
+
+        return result;
+    }
+
+    void ScriptProfiler::writeCsv (std::ostream& stream) const
+    {
+        stream << "script,runs,instructions,time_us,deferred\n";
+        for (const auto& [name, profile] : getSlowest (mScripts.size()))
+            stream << name << ',' << profile.mRuns << ',' << profile.mInstructions << ','
+                   << static_cast<long long> (profile.mTime * 1e6) << ',' << profile.mDeferred << '\n';
+    }
+
+    void ScriptProfiler::reportStats (unsigned int frameNumber, osg::Stats& stats) const
+    {
+        stats.setAttribute (frameNumber, "Script Runs", mFrame.mRuns);
+        stats.setAttribute (frameNumber, "Script Instructions", mFrame.mInstructions);
+        stats.setAttribute (frameNumber, "Script Deferred", mFrame.mDeferred);
+        if (mTimingEnabled)
+            stats.setAttribute (frameNumber, "Script Time", mFrame.mTime * 1e6);
+    }
+}
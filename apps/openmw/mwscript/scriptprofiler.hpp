@@ -0,0 +1,69 @@
+#ifndef GAME_SCRIPT_SCRIPTPROFILER_H
+#define GAME_SCRIPT_SCRIPTPROFILER_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace MWScript
+{
+    struct ScriptProfile
+    {
+        std::size_t mRuns = 0;
+        std::size_t mInstructions = 0;
+        double mTime = 0; // in seconds
+        std::size_t mDeferred = 0;
+    };
+
+    /// \brief Instructions executed by and time spent in each script
+    ///
+    /// \note Runs of scripts started by another script are also counted for the outer one.
+    class ScriptProfiler
+    {
+            std::map<std::string, ScriptProfile> mScripts;
+            ScriptProfile mFrame;
+            bool mTimingEnabled = false;
+
+        public:
+
+            void setTimingEnabled (bool enabled) { mTimingEnabled = enabled; }
+
+            bool isTimingEnabled() const { return mTimingEnabled; }
+            ///< Reading the clock around every script run isn't free, so times stay 0 unless enabled.
+
+            ScriptProfile& getProfile (const std::string& name);
+            ///< The returned reference stays valid for the lifetime of the profiler.
+
+            void startFrame();
+            ///< Reset the totals of the current frame.
+
+            const ScriptProfile& getFrameProfile() const { return mFrame; }
+            ///< Totals of all scripts since startFrame.
+
+            void add (ScriptProfile& profile, std::size_t instructions, double time);
+
+            void addDeferred (const std::string& name);
+            ///< Count a run of a local script that was postponed to stay within the frame budget.
+
+            void clear();
+            ///< Reset the totals of all scripts.
+
+            std::vector<std::pair<std::string, ScriptProfile>> getSlowest (std::size_t count) const;
+            ///< Scripts with the highest total time, slowest first.
+
+            void writeCsv (std::ostream& stream) const;
+
+            void reportStats (unsigned int frameNumber, osg::Stats& stats) const;
+            ///< Totals of the current frame, the time in microseconds only if timing is enabled.
+    };
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "decodedsoundcache.hpp"
+
+#include <components/sceneutil/workqueue.hpp>
+
+#include <atomic>
+
+namespace MWSound
+{
+    /// Worker thread item: decode a sound file to PCM.
+    class DecodeSoundItem : public SceneUtil::WorkItem
+    {
+    public:
+        DecodeSoundItem(const DecodedSoundCache::Decode& decode, const std::string& resourceName)
+            : mDecode(decode)
+            , mResourceName(resourceName)
+        {
+        }
+
+        void doWork() override
+        {
+            if (tryStart())
+                decode();
+        }
+
+        /// Claim the item if no worker has started it yet, the claiming thread is responsible to decode it.
+        bool tryStart()
+        {
+            bool started = false;
+            return mStarted.compare_exchange_strong(started, true);
+        }
+
+        void decode()
+        {
+            mResult = mDecode(mResourceName);
+            mDecoded = true;
+        }
+
+        bool isDecoded() const { return mDecoded; }
+
+        DecodedSound& getResult() { return mResult; }
+
+    private:
+        const DecodedSoundCache::Decode& mDecode;
+        const std::string mResourceName;
+        std::atomic_bool mStarted {false};
+        std::atomic_bool mDecoded {false};
+        DecodedSound mResult;
+    };
+
+    DecodedSoundCache::DecodedSoundCache(Decode decode, std::size_t maxSize, std::size_t threads)
+        : mDecode(std::move(decode))
+        , mMaxSize(maxSize)
+    {
+        if (threads > 0 && mMaxSize > 0)
+            mQueue = new SceneUtil::WorkQueue(threads);
+    }
+
+    DecodedSoundCache::~DecodedSoundCache()
+    {
+        clear();
+    }
+
+    void DecodedSoundCache::preload(const std::string& resourceName)
+    {
+        if (mQueue == nullptr)
+            return;
+
+        const auto it = mSounds.find(resourceName);
+        if (it != mSounds.end())
+        {
+            mOrder.splice(mOrder.begin(), mOrder, it->second.mOrder);
+            return;
+        }
+
+        osg::ref_ptr<DecodeSoundItem> item(new DecodeSoundItem(mDecode, resourceName));
+        mQueue->addWorkItem(item);
+        mOrder.push_front(resourceName);
+        mSounds.emplace(resourceName, Entry {std::move(item), mOrder.begin(), std::nullopt});
+    }
+
+    DecodedSound DecodedSoundCache::take(const std::string& resourceName)
+    {
+        const auto it = mSounds.find(resourceName);
+        if (it == mSounds.end())
+            return mDecode(resourceName);
+
+        DecodeSoundItem& item = *it->second.mItem;
+        // Don't wait for the whole queue when the sound is needed right now
+        if (item.tryStart())
+            item.decode();
+        else
+            item.waitTillDone();
+
+        DecodedSound result = std::move(item.getResult());
+        if (it->second.mSize.has_value())
+            mSize -= *it->second.mSize;
+        mOrder.erase(it->second.mOrder);
+        mSounds.erase(it);
+        return result;
+    }
+
+    void DecodedSoundCache::update()
+    {
+        for (auto& [resourceName, entry] : mSounds)
+        {
+            if (!entry.mSize.has_value() && entry.mItem->isDecoded())
+            {
+                entry.mSize = entry.mItem->getResult().mData.size();
+                mSize += *entry.mSize;
+            }
+        }
+
+        for (auto it = mOrder.end(); it != mOrder.begin() && mSize > mMaxSize;)
+        {
+            --it;
+            const auto entry = mSounds.find(*it);
+            if (!entry->second.mSize.has_value())
+                continue;
+            mSize -= *entry->second.mSize;
+            mSounds.erase(entry);
+            it = mOrder.erase(it);
+        }
+    }
+
+    void DecodedSoundCache::clear()
+    {
+        // Items not started yet are claimed here so workers skip them, the ones being decoded use mDecode
+        for (auto& [resourceName, entry] : mSounds)
+        {
+            if (!entry.mItem->tryStart())
+                entry.mItem->waitTillDone();
+        }
+        mSounds.clear();
+        mOrder.clear();
+        mSize = 0;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef GAME_SOUND_DECODEDSOUNDCACHE_H
+#define GAME_SOUND_DECODEDSOUNDCACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <osg/ref_ptr>
+
+#include "sound_output.hpp"
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
+namespace MWSound
+{
+    class DecodeSoundItem;
+
+    /// Sounds decoded to PCM by background threads ahead of use, limited by the total size of decoded data.
+    class DecodedSoundCache
+    {
+    public:
+        /// Called from the worker threads and the thread taking a sound.
+        using Decode = std::function<DecodedSound(const std::string& resourceName)>;
+
+        /// Preloading is disabled when there are no threads or no memory for the cache.
+        DecodedSoundCache(Decode decode, std::size_t maxSize, std::size_t threads);
+
+        DecodedSoundCache(const DecodedSoundCache&) = delete;
+
+        ~DecodedSoundCache();
+
+        /// Decode a sound in background. A sound preloaded already becomes the most recently preloaded.
+        void preload(const std::string& resourceName);
+
+        /// Take the decoded sound out of the cache. A sound no worker has started yet is decoded by the
+        /// calling thread instead of waiting for the queue, a sound being decoded is waited for.
+        DecodedSound take(const std::string& resourceName);
+
+        /// Account memory of sounds decoded since the last call and free the least recently preloaded ones
+        /// above the limit.
+        void update();
+
+        /// Drop all sounds, waiting for the ones being decoded.
+        void clear();
+
+        bool contains(const std::string& resourceName) const { return mSounds.count(resourceName) != 0; }
+
+        /// Size of the decoded data accounted by the last update.
+        std::size_t getSize() const { return mSize; }
+
+    private:
+        struct Entry
+        {
+            osg::ref_ptr<DecodeSoundItem> mItem;
+            std::list<std::string>::iterator mOrder;
+            std::optional<std::size_t> mSize;
+        };
+
+        const Decode mDecode;
+        const std::size_t mMaxSize;
+        osg::ref_ptr<SceneUtil::WorkQueue> mQueue;
+        std::size_t mSize = 0;
+        // NOTE: decoded sounds are stored in front-newest order.
+        std::list<std::string> mOrder;
+        std::unordered_map<std::string, Entry> mSounds;
+    };
+}
+
+#endif
@@ -1,10 +1,11 @@
 #include "loudness.hpp"
 
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <algorithm>
 
-#include "soundmanagerimp.hpp"
+#include "sound_decoder.hpp"
 
 namespace MWSound
 {
@@ -51,13 +52,19 @@ void Sound_Loudness::analyzeLoudness(const std::vector< char >& data)
         float rms = 0; // root mean square
         if (samplesAdded > 0)
             rms = std::sqrt(sum / samplesAdded);
-        mSamples.push_back(rms);
+        mSamples.push_back(static_cast<std::uint8_t>(std::lround(std::min(rms, 1.f) * std::numeric_limits<std::uint8_t>::max())));
         ++segment;
     }
 
     mQueue.erase(mQueue.begin(), mQueue.begin() + sample*advance);
 }
 
+void Sound_Loudness::finish()
+{
+    mQueue = std::vector<char>();
+    mSamples.shrink_to_fit();
+}
+
 
 float Sound_Loudness::getLoudnessAtTime(float sec) const
 {
@@ -65,7 +72,14 @@ float Sound_Loudness::getLoudnessAtTime(float sec) const
         return 0.0f;
 
     size_t index = std::clamp<size_t>(sec * mSamplesPerSec, 0, mSamples.size() - 1);
-    return mSamples[index];
+    return mSamples[index] / static_cast<float>(std::numeric_limits<std::uint8_t>::max());
+}
+
+float Sound_Loudness::getDuration() const
+{
+    if (mSamplesPerSec <= 0.0f)
+        return 0.0f;
+    return mSamples.size() / mSamplesPerSec;
 }
 
 }
@@ -1,8 +1,8 @@
 #ifndef GAME_SOUND_LOUDNESS_H
 #define GAME_SOUND_LOUDNESS_H
 
+#include <cstdint>
 #include <vector>
-#include <deque>
 
 #include "sound_decoder.hpp"
 
@@ -15,10 +15,10 @@ class Sound_Loudness {
     ChannelConfig mChannelConfig;
     SampleType mSampleType;
 
-    // Loudness sample info
-    std::vector<float> mSamples;
+    // Loudness sample info, quantized to a byte to keep analyzed sounds compact
+    std::vector<std::uint8_t> mSamples;
 
-    std::deque<char> mQueue;
+    std::vector<char> mQueue;
 
 public:
     /**
@@ -46,10 +46,20 @@ public:
      */
     void analyzeLoudness(const std::vector<char>& data);
 
+    /**
+     * Release memory used by the analysis. Call when the whole audio file is processed.
+     */
+    void finish();
+
     /**
      * Get loudness at a particular time. Before calling this, the stream has to be analyzed up to that point in time (see analyzeLoudness()).
      */
     float getLoudnessAtTime(float sec) const;
+
+    /**
+     * Get duration of the audio analyzed so far, in seconds.
+     */
+    float getDuration() const;
 };
 
 }
@@ -0,0 +1,90 @@
+#include "loudnesscache.hpp"
+
+#include <vector>
+
+#include <components/debug/debuglog.hpp>
+
+#include "soundmanagerimp.hpp"
+
+namespace MWSound
+{
+    namespace
+    {
+        constexpr float sLoudnessFPS = 20; // loudness values per second of audio
+        constexpr std::size_t sChunkSize = 64 * 1024;
+    }
+
+    VoiceLoudness::VoiceLoudness(DecoderPtr decoder, const std::string& file)
+        : mDecoder(std::move(decoder))
+        , mFile(file)
+    {
+    }
+
+    void VoiceLoudness::doWork()
+    {
+        try
+        {
+            mDecoder->open(mFile);
+
+            int sampleRate;
+            ChannelConfig chans;
+            SampleType type;
+            mDecoder->getInfo(&sampleRate, &chans, &type);
+
+            {
+                const std::lock_guard lock(mMutex);
+                mLoudness.emplace(sLoudnessFPS, sampleRate, chans, type);
+            }
+
+            std::vector<char> data(sChunkSize);
+            while (data.size() == sChunkSize)
+            {
+                data.resize(mDecoder->read(data.data(), data.size()));
+                // Publish each chunk, a voice played for the first time shouldn't wait for the whole file
+                const std::lock_guard lock(mMutex);
+                mLoudness->analyzeLoudness(data);
+            }
+
+            const std::lock_guard lock(mMutex);
+            mLoudness->finish();
+            mFinished = true;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to analyze loudness of " << mFile << ": " << e.what();
+        }
+
+        mDecoder->close();
+        mDecoder = nullptr;
+    }
+
+    float VoiceLoudness::getLoudnessAtTime(float sec) const
+    {
+        const std::lock_guard lock(mMutex);
+        if (!mLoudness.has_value())
+            return 0.0f;
+        // The last analyzed value doesn't belong to the time the worker hasn't reached yet
+        if (!mFinished && sec >= mLoudness->getDuration())
+            return 0.0f;
+        return mLoudness->getLoudnessAtTime(sec);
+    }
+
+    LoudnessCache::LoudnessCache(SoundManager& manager)
+        : mManager(manager)
+        , mWorkQueue(new SceneUtil::WorkQueue(1))
+    {
+    }
+
+    osg::ref_ptr<const VoiceLoudness> LoudnessCache::get(const std::string& file)
+    {
+        const auto it = mVoices.find(file);
+        if (it != mVoices.end())
+            return it->second;
+
+        osg::ref_ptr<VoiceLoudness> voice(new VoiceLoudness(mManager.getDecoder(), file));
+        // Voice is about to play, analyze it before voices requested earlier
+        mWorkQueue->addWorkItem(voice, true);
+        mVoices.emplace(file, voice);
+        return voice;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef GAME_SOUND_LOUDNESSCACHE_H
+#define GAME_SOUND_LOUDNESSCACHE_H
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <osg/ref_ptr>
+
+#include <components/sceneutil/workqueue.hpp>
+
+#include "../mwbase/soundmanager.hpp"
+
+#include "loudness.hpp"
+#include "sound_decoder.hpp"
+
+namespace MWSound
+{
+    class SoundManager;
+
+    /// Worker thread item: analyze loudness of a whole voice file, publishing it chunk by chunk.
+    class VoiceLoudness : public SceneUtil::WorkItem
+    {
+    public:
+        VoiceLoudness(DecoderPtr decoder, const std::string& file);
+
+        void doWork() override;
+
+        /// Get loudness at a particular time, 0 for the time not analyzed yet.
+        float getLoudnessAtTime(float sec) const;
+
+    private:
+        DecoderPtr mDecoder;
+        const std::string mFile;
+        mutable std::mutex mMutex;
+        std::optional<Sound_Loudness> mLoudness;
+        bool mFinished = false;
+    };
+
+    /// Keeps loudness of voice files by VFS path, so a voice line is analyzed once
+    /// and not by the streaming thread each time it's played.
+    class LoudnessCache
+    {
+    public:
+        explicit LoudnessCache(SoundManager& manager);
+
+        /// Get loudness of a voice file, start the analysis in background on the first request.
+        osg::ref_ptr<const VoiceLoudness> get(const std::string& file);
+
+    private:
+        SoundManager& mManager;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        std::unordered_map<std::string, osg::ref_ptr<VoiceLoudness>> mVoices;
+    };
+}
+
+#endif
@@ -19,7 +19,7 @@
 #include "sound_decoder.hpp"
 #include "sound.hpp"
 #include "soundmanagerimp.hpp"
-#include "loudness.hpp"
+#include "loudnesscache.hpp"
 
 #include "efx-presets.h"
 
@@ -34,7 +34,6 @@
 namespace
 {
 
-const int sLoudnessFPS = 20; // loudness values per second of audio
 
 ALCenum checkALCError(ALCdevice *device, const char *func, int line)
 {
@@ -276,7 +275,7 @@ private:
 
     DecoderPtr mDecoder;
 
-    std::unique_ptr<Sound_Loudness> mLoudnessAnalyzer;
+    osg::ref_ptr<const VoiceLoudness> mLoudness;
 
     std::atomic<bool> mIsFinished;
 
@@ -288,10 +287,10 @@ private:
     friend class OpenAL_Output;
 
 public:
-    OpenAL_SoundStream(ALuint src, DecoderPtr decoder);
+    OpenAL_SoundStream(ALuint src, DecoderPtr decoder, osg::ref_ptr<const VoiceLoudness> loudness);
     ~OpenAL_SoundStream();
 
-    bool init(bool getLoudnessData=false);
+    bool init();
 
     bool isPlaying();
     double getStreamDelay() const;
@@ -379,10 +378,10 @@ private:
 };
 
 
-OpenAL_SoundStream::OpenAL_SoundStream(ALuint src, DecoderPtr decoder)
+OpenAL_SoundStream::OpenAL_SoundStream(ALuint src, DecoderPtr decoder, osg::ref_ptr<const VoiceLoudness> loudness)
   : mSource(src), mCurrentBufIdx(0), mFormat(AL_NONE), mSampleRate(0)
   , mBufferSize(0), mFrameSize(0), mSilence(0), mDecoder(std::move(decoder))
-  , mLoudnessAnalyzer(nullptr), mIsFinished(true)
+  , mLoudness(std::move(loudness)), mIsFinished(true)
 {
     mBuffers.fill(0);
 }
@@ -396,7 +395,7 @@ OpenAL_SoundStream::~OpenAL_SoundStream()
     mDecoder->close();
 }
 
-bool OpenAL_SoundStream::init(bool getLoudnessData)
+bool OpenAL_SoundStream::init()
 {
     alGenBuffers(mBuffers.size(), mBuffers.data());
     ALenum err = getALError();
@@ -427,9 +426,6 @@ bool OpenAL_SoundStream::init(bool getLoudnessData)
     mBufferSize = static_cast<ALuint>(sBufferLength*mSampleRate);
     mBufferSize *= mFrameSize;
 
-    if (getLoudnessData)
-        mLoudnessAnalyzer = std::make_unique<Sound_Loudness>(sLoudnessFPS, mSampleRate, chans, type);
-
     mIsFinished = false;
     return true;
 }
@@ -494,11 +490,11 @@ double OpenAL_SoundStream::getStreamOffset() const
 
 float OpenAL_SoundStream::getCurrentLoudness() const
 {
-    if (!mLoudnessAnalyzer.get())
+    if (mLoudness == nullptr)
         return 0.f;
 
     float time = getStreamOffset();
-    return mLoudnessAnalyzer->getLoudnessAtTime(time);
+    return mLoudness->getLoudnessAtTime(time);
 }
 
 bool OpenAL_SoundStream::process()
@@ -550,9 +546,6 @@ ALint OpenAL_SoundStream::refillQueue()
             }
             if(got > 0)
             {
-                if (mLoudnessAnalyzer.get())
-                    mLoudnessAnalyzer->analyzeLoudness(data);
-
                 ALuint bufid = mBuffers[mCurrentBufIdx];
                 alBufferData(bufid, mFormat, data.data(), data.size(), mSampleRate);
                 alSourceQueueBuffers(mSource, 1, &bufid);
@@ -943,42 +936,51 @@ void OpenAL_Output::setHrtf(const std::string &hrtfname, HrtfMode hrtfmode)
 }
 
 
-std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(const std::string &fname)
+DecodedSound OpenAL_Output::decodeSound(const std::string &fname)
 {
-    getALError();
-
-    std::vector<char> data;
-    ALenum format = AL_NONE;
-    int srate = 0;
+    DecodedSound result;
 
     try
     {
         DecoderPtr decoder = mManager.getDecoder();
         decoder->open(Misc::ResourceHelpers::correctSoundPath(fname, decoder->mResourceMgr));
-
-        ChannelConfig chans;
-        SampleType type;
-        decoder->getInfo(&srate, &chans, &type);
-        format = getALFormat(chans, type);
-        if(format) decoder->readAll(data);
+        decoder->getInfo(&result.mSampleRate, &result.mChannelConfig, &result.mSampleType);
+        decoder->readAll(result.mData);
     }
     catch(std::exception &e)
     {
         Log(Debug::Error) << "Failed to load audio from " << fname << ": " << e.what();
+        result.mData.clear();
     }
 
-    if(data.empty())
+    return result;
+}
+
+std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(const DecodedSound &sound)
+{
+    getALError();
+
+    const std::vector<char>* data = &sound.mData;
+    ALenum format = AL_NONE;
+    int srate = sound.mSampleRate;
+
+    if(!data->empty())
+        format = getALFormat(sound.mChannelConfig, sound.mSampleType);
+
+    std::vector<char> silence;
+    if(format == AL_NONE)
     {
         // If we failed to get any usable audio, substitute with silence.
         format = AL_FORMAT_MONO8;
         srate = 8000;
-        data.assign(8000, -128);
+        silence.assign(8000, -128);
+        data = &silence;
     }
 
     ALint size;
     ALuint buf = 0;
     alGenBuffers(1, &buf);
-    alBufferData(buf, format, data.data(), data.size(), srate);
+    alBufferData(buf, format, data->data(), data->size(), srate);
     alGetBufferi(buf, AL_SIZE, &size);
     if(getALError() != AL_NO_ERROR)
     {
@@ -1233,7 +1235,7 @@ void OpenAL_Output::updateSound(Sound *sound)
 }
 
 
-bool OpenAL_Output::streamSound(DecoderPtr decoder, Stream *sound, bool getLoudnessData)
+bool OpenAL_Output::streamSound(DecoderPtr decoder, Stream *sound, osg::ref_ptr<const VoiceLoudness> loudness)
 {
     if(mFreeSources.empty())
     {
@@ -1250,8 +1252,8 @@ bool OpenAL_Output::streamSound(DecoderPtr decoder, Stream *sound, bool getLoudn
     if(getALError() != AL_NO_ERROR)
         return false;
 
-    OpenAL_SoundStream *stream = new OpenAL_SoundStream(source, std::move(decoder));
-    if(!stream->init(getLoudnessData))
+    OpenAL_SoundStream *stream = new OpenAL_SoundStream(source, std::move(decoder), std::move(loudness));
+    if(!stream->init())
     {
         delete stream;
         return false;
@@ -1264,7 +1266,7 @@ bool OpenAL_Output::streamSound(DecoderPtr decoder, Stream *sound, bool getLoudn
     return true;
 }
 
-bool OpenAL_Output::streamSound3D(DecoderPtr decoder, Stream *sound, bool getLoudnessData)
+bool OpenAL_Output::streamSound3D(DecoderPtr decoder, Stream *sound, osg::ref_ptr<const VoiceLoudness> loudness)
 {
     if(mFreeSources.empty())
     {
@@ -1281,8 +1283,8 @@ bool OpenAL_Output::streamSound3D(DecoderPtr decoder, Stream *sound, bool getLou
     if(getALError() != AL_NO_ERROR)
         return false;
 
-    OpenAL_SoundStream *stream = new OpenAL_SoundStream(source, std::move(decoder));
-    if(!stream->init(getLoudnessData))
+    OpenAL_SoundStream *stream = new OpenAL_SoundStream(source, std::move(decoder), std::move(loudness));
+    if(!stream->init())
     {
         delete stream;
         return false;
@@ -69,7 +69,8 @@ namespace MWSound
         std::vector<std::string> enumerateHrtf() override;
         void setHrtf(const std::string &hrtfname, HrtfMode hrtfmode) override;
 
-        std::pair<Sound_Handle,size_t> loadSound(const std::string &fname) override;
+        DecodedSound decodeSound(const std::string &fname) override;
+        std::pair<Sound_Handle,size_t> loadSound(const DecodedSound &sound) override;
         size_t unloadSound(Sound_Handle data) override;
 
         bool playSound(Sound *sound, Sound_Handle data, float offset) override;
@@ -78,8 +79,8 @@ namespace MWSound
         bool isSoundPlaying(Sound *sound) override;
         void updateSound(Sound *sound) override;
 
-        bool streamSound(DecoderPtr decoder, Stream *sound, bool getLoudnessData=false) override;
-        bool streamSound3D(DecoderPtr decoder, Stream *sound, bool getLoudnessData) override;
+        bool streamSound(DecoderPtr decoder, Stream *sound, osg::ref_ptr<const VoiceLoudness> loudness=nullptr) override;
+        bool streamSound3D(DecoderPtr decoder, Stream *sound, osg::ref_ptr<const VoiceLoudness> loudness) override;
         void finishStream(Stream *sound) override;
         double getStreamDelay(Stream *sound) override;
         double getStreamOffset(Stream *sound) override;
@@ -39,7 +39,10 @@ namespace MWSound
         mVfs(&vfs),
         mOutput(&output),
         mBufferCacheMax(std::max(Settings::Manager::getInt("buffer cache max", "Sound"), 1) * 1024 * 1024),
-        mBufferCacheMin(std::min(static_cast<std::size_t>(std::max(Settings::Manager::getInt("buffer cache min", "Sound"), 1)) * 1024 * 1024, mBufferCacheMax))
+        mBufferCacheMin(std::min(static_cast<std::size_t>(std::max(Settings::Manager::getInt("buffer cache min", "Sound"), 1)) * 1024 * 1024, mBufferCacheMax)),
+        mDecodedSounds([&output] (const std::string& resourceName) { return output.decodeSound(resourceName); },
+            static_cast<std::size_t>(std::max(Settings::Manager::getInt("decoded cache max", "Sound"), 0)) * 1024 * 1024,
+            static_cast<std::size_t>(std::max(Settings::Manager::getInt("decoding threads", "Sound"), 0)))
     {
     }
 
@@ -62,27 +65,13 @@ namespace MWSound
 
     Sound_Buffer* SoundBufferPool::load(const std::string& soundId)
     {
-        if (mBufferNameMap.empty())
-        {
-            for (const ESM::Sound& sound : MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>())
-                insertSound(Misc::StringUtils::lowerCase(sound.mId), sound);
-        }
-
-        Sound_Buffer* sfx;
-        const auto it = mBufferNameMap.find(soundId);
-        if (it != mBufferNameMap.end())
-            sfx = it->second;
-        else
-        {
-            const ESM::Sound *sound = MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>().search(soundId);
-            if (sound == nullptr)
-                return {};
-            sfx = insertSound(soundId, *sound);
-        }
+        Sound_Buffer* const sfx = find(soundId);
+        if (sfx == nullptr)
+            return {};
 
         if (sfx->getHandle() == nullptr)
         {
-            auto [handle, size] = mOutput->loadSound(sfx->getResourceName());
+            auto [handle, size] = mOutput->loadSound(mDecodedSounds.take(sfx->getResourceName()));
             if (handle == nullptr)
                 return {};
 
@@ -101,8 +90,25 @@ namespace MWSound
         return sfx;
     }
 
+    void SoundBufferPool::preload(const std::vector<std::string>& soundIds)
+    {
+        for (const std::string& soundId : soundIds)
+        {
+            const Sound_Buffer* const sfx = find(soundId);
+            if (sfx != nullptr && sfx->getHandle() == nullptr)
+                mDecodedSounds.preload(sfx->getResourceName());
+        }
+    }
+
+    void SoundBufferPool::update()
+    {
+        mDecodedSounds.update();
+    }
+
     void SoundBufferPool::clear()
     {
+        mDecodedSounds.clear();
+
         for (auto &sfx : mSoundBuffers)
         {
             if(sfx.mHandle)
@@ -137,6 +143,24 @@ namespace MWSound
         return &sfx;
     }
 
+    Sound_Buffer* SoundBufferPool::find(const std::string& soundId)
+    {
+        if (mBufferNameMap.empty())
+        {
+            for (const ESM::Sound& sound : MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>())
+                insertSound(Misc::StringUtils::lowerCase(sound.mId), sound);
+        }
+
+        const auto it = mBufferNameMap.find(soundId);
+        if (it != mBufferNameMap.end())
+            return it->second;
+
+        const ESM::Sound *sound = MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>().search(soundId);
+        if (sound == nullptr)
+            return nullptr;
+        return insertSound(soundId, *sound);
+    }
+
     void SoundBufferPool::unloadUnused()
     {
         while (!mUnusedBuffers.empty() && mBufferCacheSize > mBufferCacheMin)
@@ -5,7 +5,9 @@
 #include <string>
 #include <deque>
 #include <unordered_map>
+#include <vector>
 
+#include "decodedsoundcache.hpp"
 #include "sound_output.hpp"
 
 namespace ESM
@@ -65,9 +67,17 @@ namespace MWSound
             Sound_Buffer* lookup(const std::string& soundId) const;
 
             /// Lookup a soundId for its sound data (resource name, local volume,
-            /// minRange, and maxRange), and ensure it's ready for use.
+            /// minRange, and maxRange), and ensure it's ready for use. Sound data
+            /// decoded in background is used when available.
             Sound_Buffer* load(const std::string& soundId);
 
+            /// Decode sounds in background threads to make the following load fast.
+            void preload(const std::vector<std::string>& soundIds);
+
+            /// Account memory of sounds decoded since the last call and free the least
+            /// recently preloaded ones above the limit. Called from the main thread.
+            void update();
+
             void use(Sound_Buffer& sfx)
             {
                 if (sfx.mUses++ == 0)
@@ -96,9 +106,12 @@ namespace MWSound
             std::size_t mBufferCacheSize = 0;
             // NOTE: unused buffers are stored in front-newest order.
             std::deque<Sound_Buffer*> mUnusedBuffers;
+            DecodedSoundCache mDecodedSounds;
 
             inline Sound_Buffer* insertSound(const std::string& soundId, const ESM::Sound& sound);
 
+            inline Sound_Buffer* find(const std::string& soundId);
+
             inline void unloadUnused();
     };
 }
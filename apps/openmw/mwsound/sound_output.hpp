@@ -5,14 +5,19 @@
 #include <memory>
 #include <vector>
 
+#include <osg/ref_ptr>
+
 #include "../mwbase/soundmanager.hpp"
 
+#include "sound_decoder.hpp"
+
 namespace MWSound
 {
     class SoundManager;
     struct Sound_Decoder;
     class Sound;
     class Stream;
+    class VoiceLoudness;
 
     // An opaque handle for the implementation's sound buffers.
     typedef void *Sound_Handle;
@@ -31,6 +36,15 @@ namespace MWSound
         Env_Underwater
     };
 
+    // PCM audio decoded from a file, empty data if decoding has failed
+    struct DecodedSound
+    {
+        int mSampleRate = 0;
+        ChannelConfig mChannelConfig = ChannelConfig_Mono;
+        SampleType mSampleType = SampleType_UInt8;
+        std::vector<char> mData;
+    };
+
     class Sound_Output
     {
         SoundManager &mManager;
@@ -42,7 +56,9 @@ namespace MWSound
         virtual std::vector<std::string> enumerateHrtf() = 0;
         virtual void setHrtf(const std::string &hrtfname, HrtfMode hrtfmode) = 0;
 
-        virtual std::pair<Sound_Handle,size_t> loadSound(const std::string &fname) = 0;
+        /// Can be called from any thread.
+        virtual DecodedSound decodeSound(const std::string &fname) = 0;
+        virtual std::pair<Sound_Handle,size_t> loadSound(const DecodedSound &sound) = 0;
         virtual size_t unloadSound(Sound_Handle data) = 0;
 
         virtual bool playSound(Sound *sound, Sound_Handle data, float offset) = 0;
@@ -51,8 +67,9 @@ namespace MWSound
         virtual bool isSoundPlaying(Sound *sound) = 0;
         virtual void updateSound(Sound *sound) = 0;
 
-        virtual bool streamSound(DecoderPtr decoder, Stream *sound, bool getLoudnessData=false) = 0;
-        virtual bool streamSound3D(DecoderPtr decoder, Stream *sound, bool getLoudnessData) = 0;
+        /// @param loudness Loudness of the streamed voice to report by getStreamLoudness
+        virtual bool streamSound(DecoderPtr decoder, Stream *sound, osg::ref_ptr<const VoiceLoudness> loudness=nullptr) = 0;
+        virtual bool streamSound3D(DecoderPtr decoder, Stream *sound, osg::ref_ptr<const VoiceLoudness> loudness) = 0;
         virtual void finishStream(Stream *sound) = 0;
         virtual double getStreamDelay(Stream *sound) = 0;
         virtual double getStreamOffset(Stream *sound) = 0;
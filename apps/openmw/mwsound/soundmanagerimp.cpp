@@ -79,6 +79,7 @@ namespace MWSound
         , mOutput(new OpenAL_Output(*this))
         , mWaterSoundUpdater(makeWaterSoundUpdaterSettings())
         , mSoundBuffers(*vfs, *mOutput)
+        , mVoiceLoudness(*this)
         , mListenerUnderwater(false)
         , mListenerPos(0,0,0)
         , mListenerDir(1,0,0)
@@ -147,7 +148,7 @@ namespace MWSound
         try
         {
             DecoderPtr decoder = getDecoder();
-            decoder->open(Misc::ResourceHelpers::correctSoundPath(voicefile, decoder->mResourceMgr));
+            decoder->open(voicefile);
             return decoder;
         }
         catch(std::exception &e)
@@ -168,7 +169,7 @@ namespace MWSound
         return mStreams.get();
     }
 
-    StreamPtr SoundManager::playVoice(DecoderPtr decoder, const osg::Vec3f &pos, bool playlocal)
+    StreamPtr SoundManager::playVoice(DecoderPtr decoder, const std::string &voicefile, const osg::Vec3f &pos, bool playlocal)
     {
         MWBase::World* world = MWBase::Environment::get().getWorld();
         static const float fAudioMinDistanceMult = world->getStore().get<ESM::GameSetting>().find("fAudioMinDistanceMult")->mValue.getFloat();
@@ -189,7 +190,7 @@ namespace MWSound
                 params.mFlags = PlayMode::NoEnv | Type::Voice | Play_2D;
                 return params;
             } ());
-            played = mOutput->streamSound(decoder, sound.get(), true);
+            played = mOutput->streamSound(decoder, sound.get(), mVoiceLoudness.get(voicefile));
         }
         else
         {
@@ -202,7 +203,7 @@ namespace MWSound
                 params.mFlags = PlayMode::Normal | Type::Voice | Play_3D;
                 return params;
             } ());
-            played = mOutput->streamSound3D(decoder, sound.get(), true);
+            played = mOutput->streamSound3D(decoder, sound.get(), mVoiceLoudness.get(voicefile));
         }
         if(!played)
             return nullptr;
@@ -361,7 +362,8 @@ namespace MWSound
         if(!mOutput->isInitialized())
             return;
 
-        DecoderPtr decoder = loadVoice(mVFS->normalizeFilename("Sound/" + filename));
+        const std::string voicefile = Misc::ResourceHelpers::correctSoundPath(mVFS->normalizeFilename("Sound/" + filename), mVFS);
+        DecoderPtr decoder = loadVoice(voicefile);
         if (!decoder)
             return;
 
@@ -369,7 +371,7 @@ namespace MWSound
         const osg::Vec3f pos = world->getActorHeadTransform(ptr).getTrans();
 
         stopSay(ptr);
-        StreamPtr sound = playVoice(decoder, pos, (ptr == MWMechanics::getPlayer()));
+        StreamPtr sound = playVoice(decoder, voicefile, pos, (ptr == MWMechanics::getPlayer()));
         if(!sound) return;
 
         mSaySoundsQueue.emplace(ptr.mRef, SaySound {ptr.mCell, std::move(sound)});
@@ -392,12 +394,13 @@ namespace MWSound
         if(!mOutput->isInitialized())
             return;
 
-        DecoderPtr decoder = loadVoice(mVFS->normalizeFilename("Sound/" + filename));
+        const std::string voicefile = Misc::ResourceHelpers::correctSoundPath(mVFS->normalizeFilename("Sound/" + filename), mVFS);
+        DecoderPtr decoder = loadVoice(voicefile);
         if (!decoder)
             return;
 
         stopSay(MWWorld::ConstPtr());
-        StreamPtr sound = playVoice(decoder, osg::Vec3f(), true);
+        StreamPtr sound = playVoice(decoder, voicefile, osg::Vec3f(), true);
         if(!sound) return;
 
         mActiveSaySounds.emplace(nullptr, SaySound {nullptr, std::move(sound)});
@@ -716,6 +719,18 @@ namespace MWSound
         return false;
     }
 
+    void SoundManager::preloadSounds(const std::vector<std::string>& soundIds)
+    {
+        if(!mOutput->isInitialized())
+            return;
+
+        std::vector<std::string> lowerCaseIds;
+        lowerCaseIds.reserve(soundIds.size());
+        for (const std::string& soundId : soundIds)
+            lowerCaseIds.push_back(Misc::StringUtils::lowerCase(soundId));
+        mSoundBuffers.preload(lowerCaseIds);
+    }
+
     void SoundManager::pauseSounds(BlockerType blocker, int types)
     {
         if(mOutput->isInitialized())
@@ -1033,6 +1048,7 @@ namespace MWSound
             return;
 
         updateSounds(duration);
+        mSoundBuffers.update();
         if (MWBase::Environment::get().getStateManager()->getState()!=
             MWBase::StateManager::State_NoGame)
         {
@@ -1107,71 +1123,6 @@ namespace MWSound
             it->second.mCell = updated.mCell;
     }
 
-    // Default readAll implementation, for decoders that can't do anything
-    // better
-    void Sound_Decoder::readAll(std::vector<char> &output)
-    {
-        size_t total = output.size();
-        size_t got;
-
-        output.resize(total+32768);
-        while((got=read(&output[total], output.size()-total)) > 0)
-        {
-            total += got;
-            output.resize(total*2);
-        }
-        output.resize(total);
-    }
-
-
-    const char *getSampleTypeName(SampleType type)
-    {
-        switch(type)
-        {
-            case SampleType_UInt8: return "U8";
-            case SampleType_Int16: return "S16";
-            case SampleType_Float32: return "Float32";
-        }
-        return "(unknown sample type)";
-    }
-
-    const char *getChannelConfigName(ChannelConfig config)
-    {
-        switch(config)
-        {
-            case ChannelConfig_Mono:    return "Mono";
-            case ChannelConfig_Stereo:  return "Stereo";
-            case ChannelConfig_Quad:    return "Quad";
-            case ChannelConfig_5point1: return "5.1 Surround";
-            case ChannelConfig_7point1: return "7.1 Surround";
-        }
-        return "(unknown channel config)";
-    }
-
-    size_t framesToBytes(size_t frames, ChannelConfig config, SampleType type)
-    {
-        switch(config)
-        {
-            case ChannelConfig_Mono:    frames *= 1; break;
-            case ChannelConfig_Stereo:  frames *= 2; break;
-            case ChannelConfig_Quad:    frames *= 4; break;
-            case ChannelConfig_5point1: frames *= 6; break;
-            case ChannelConfig_7point1: frames *= 8; break;
-        }
-        switch(type)
-        {
-            case SampleType_UInt8: frames *= 1; break;
-            case SampleType_Int16: frames *= 2; break;
-            case SampleType_Float32: frames *= 4; break;
-        }
-        return frames;
-    }
-
-    size_t bytesToFrames(size_t bytes, ChannelConfig config, SampleType type)
-    {
-        return bytes / framesToBytes(1, config, type);
-    }
-
     void SoundManager::clear()
     {
         SoundManager::stopMusic();
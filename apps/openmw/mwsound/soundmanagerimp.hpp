@@ -18,6 +18,7 @@
 #include "type.hpp"
 #include "volumesettings.hpp"
 #include "sound_buffer.hpp"
+#include "loudnesscache.hpp"
 
 namespace VFS
 {
@@ -58,6 +59,8 @@ namespace MWSound
 
         SoundBufferPool mSoundBuffers;
 
+        LoudnessCache mVoiceLoudness;
+
         Misc::ObjectPool<Sound> mSounds;
 
         Misc::ObjectPool<Stream> mStreams;
@@ -119,7 +122,7 @@ namespace MWSound
         SoundPtr getSoundRef();
         StreamPtr getStreamRef();
 
-        StreamPtr playVoice(DecoderPtr decoder, const osg::Vec3f &pos, bool playlocal);
+        StreamPtr playVoice(DecoderPtr decoder, const std::string &voicefile, const osg::Vec3f &pos, bool playlocal);
 
         void streamMusicFull(const std::string& filename);
         void advanceMusic(const std::string& filename);
@@ -151,6 +154,7 @@ namespace MWSound
     protected:
         DecoderPtr getDecoder();
         friend class OpenAL_Output;
+        friend class LoudnessCache;
 
         void stopSound(Sound_Buffer *sfx, const MWWorld::ConstPtr &ptr);
         ///< Stop the given object from playing given sound buffer.
@@ -248,6 +252,9 @@ namespace MWSound
         bool getSoundPlaying(const MWWorld::ConstPtr &reference, std::string_view soundId) const override;
         ///< Is the given sound currently playing on the given object?
 
+        void preloadSounds(const std::vector<std::string>& soundIds) override;
+        ///< Decode given sounds in background so they can be played without delay.
+
         void pauseSounds(MWSound::BlockerType blocker, int types=int(Type::Mask)) override;
         ///< Pauses all currently playing sounds, including music.
 
@@ -1,10 +1,12 @@
 #include "character.hpp"
 
 #include <cctype>
+#include <set>
 #include <sstream>
 
 #include <boost/filesystem.hpp>
 
+#include <components/debug/debuglog.hpp>
 #include <components/esm3/esmreader.hpp>
 #include <components/esm/defs.hpp>
 
@@ -25,26 +27,44 @@ std::string MWState::getFirstGameFile(const std::vector<std::string>& contentFil
     return "";
 }
 
-void MWState::Character::addSlot (const boost::filesystem::path& path, const std::string& game)
+bool MWState::Character::addSlot (const boost::filesystem::path& path, const std::string& game)
 {
     Slot slot;
     slot.mPath = path;
     slot.mTimeStamp = boost::filesystem::last_write_time (path);
 
-    ESM::ESMReader reader;
-    reader.open (slot.mPath.string());
+    const std::uintmax_t fileSize = boost::filesystem::file_size (path);
+    const std::int64_t writeTime = getWriteTime (path);
+    const std::string fileName = path.filename().string();
+    bool parsed = false;
 
-    if (reader.getRecName()!=ESM::REC_SAVE)
-        return; // invalid save file -> ignore
+    const auto indexed = mIndex.find (fileName);
+    if (indexed!=mIndex.end() && isCurrent (indexed->second, fileSize, slot.mTimeStamp, writeTime))
+    {
+        slot.mProfile = indexed->second.mProfile;
+    }
+    else
+    {
+        ESM::ESMReader reader;
+        reader.open (slot.mPath.string());
 
-    reader.getRecHeader();
+        if (reader.getRecName()!=ESM::REC_SAVE)
+            return false; // invalid save file -> ignore
 
-    slot.mProfile.load (reader);
+        reader.getRecHeader();
+
+        slot.mProfile.load (reader);
+
+        mIndex[fileName] = SlotIndexEntry {fileSize, slot.mTimeStamp, writeTime, slot.mProfile};
+        parsed = true;
+    }
 
     if (!Misc::StringUtils::ciEqual(getFirstGameFile(slot.mProfile.mContentFiles), game))
-        return; // this file is for a different game -> ignore
+        return parsed; // this file is for a different game -> ignore
 
     mSlots.push_back (slot);
+
+    return parsed;
 }
 
 void MWState::Character::addSlot (const ESM::SavedGame& profile)
@@ -90,22 +110,73 @@ MWState::Character::Character (const boost::filesystem::path& saves, const std::
     }
     else
     {
+        const boost::filesystem::path indexPath = mPath / slotIndexFileName;
+        std::size_t recordCount = 0;
+
+        try
+        {
+            mIndex = readSlotIndex (indexPath, &recordCount);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to read saved game index " << indexPath << ": " << e.what();
+        }
+
+        std::set<std::string> fileNames;
+        bool indexChanged = false;
+
         for (boost::filesystem::directory_iterator iter (mPath);
             iter!=boost::filesystem::directory_iterator(); ++iter)
         {
             boost::filesystem::path slotPath = *iter;
 
+            if (slotPath.filename()==slotIndexFileName)
+                continue;
+
+            fileNames.insert (slotPath.filename().string());
+
             try
             {
-                addSlot (slotPath, game);
+                if (addSlot (slotPath, game))
+                    indexChanged = true;
             }
             catch (...) {} // ignoring bad saved game files for now
         }
 
+        // Forget saved games removed outside of the game
+        for (auto iter = mIndex.begin(); iter!=mIndex.end();)
+        {
+            if (fileNames.count (iter->first)==0)
+            {
+                iter = mIndex.erase (iter);
+                indexChanged = true;
+            }
+            else
+                ++iter;
+        }
+
+        // Saving and deleting append to the index, compact it when listing the saved games anyway
+        if (indexChanged || recordCount!=mIndex.size())
+            writeIndex();
+
         std::sort (mSlots.begin(), mSlots.end());
     }
 }
 
+void MWState::Character::writeIndex() const
+{
+    const boost::filesystem::path indexPath = mPath / slotIndexFileName;
+
+    try
+    {
+        writeSlotIndex (indexPath, mIndex);
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Failed to write saved game index " << indexPath << ": " << e.what();
+    }
+}
+
 void MWState::Character::cleanup()
 {
     if (mSlots.size() == 0)
@@ -113,6 +184,10 @@ void MWState::Character::cleanup()
         // All slots are gone, no need to keep the empty directory
         if (boost::filesystem::is_directory (mPath))
         {
+            // The index may still list saved games of other games, in which case it is rebuilt next time
+            boost::system::error_code error;
+            boost::filesystem::remove(mPath / slotIndexFileName, error);
+
             // Extra safety check to make sure the directory is empty (e.g. slots failed to parse header)
             boost::filesystem::directory_iterator it(mPath);
             if (it == boost::filesystem::directory_iterator())
@@ -140,6 +215,21 @@ void MWState::Character::deleteSlot (const Slot *slot)
 
     boost::filesystem::remove(slot->mPath);
 
+    const std::string fileName = slot->mPath.filename().string();
+    if (mIndex.erase (fileName)!=0)
+    {
+        const boost::filesystem::path indexPath = mPath / slotIndexFileName;
+
+        try
+        {
+            removeFromSlotIndex (indexPath, fileName);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to update saved game index " << indexPath << ": " << e.what();
+        }
+    }
+
     mSlots.erase (mSlots.begin()+index);
 }
 
@@ -164,6 +254,26 @@ const MWState::Slot *MWState::Character::updateSlot (const Slot *slot, const ESM
     return &mSlots.back();
 }
 
+void MWState::Character::setProfile (const Slot *slot, const ESM::SavedGame& profile,
+    const std::optional<SlotIndexEntry>& indexEntry)
+{
+    int index = slot - &mSlots[0];
+
+    if (index<0 || index>=static_cast<int> (mSlots.size()))
+    {
+        // sanity check; not entirely reliable
+        throw std::logic_error ("slot not found");
+    }
+
+    mSlots[index].mProfile = profile;
+
+    const std::string fileName = mSlots[index].mPath.filename().string();
+    if (indexEntry.has_value())
+        mIndex[fileName] = *indexEntry;
+    else
+        mIndex.erase (fileName); // an outdated entry would be ignored anyway, as the file changed
+}
+
 MWState::Character::SlotIterator MWState::Character::begin() const
 {
     return mSlots.rbegin();
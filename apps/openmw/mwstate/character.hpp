@@ -1,10 +1,14 @@
 #ifndef GAME_STATE_CHARACTER_H
 #define GAME_STATE_CHARACTER_H
 
+#include <optional>
+
 #include <boost/filesystem/path.hpp>
 
 #include <components/esm3/savedgame.hpp>
 
+#include "slotindex.hpp"
+
 namespace MWState
 {
     struct Slot
@@ -28,11 +32,15 @@ namespace MWState
 
             boost::filesystem::path mPath;
             std::vector<Slot> mSlots;
+            SlotIndex mIndex;
 
-            void addSlot (const boost::filesystem::path& path, const std::string& game);
+            bool addSlot (const boost::filesystem::path& path, const std::string& game);
+            ///< \return Was the saved game header parsed, because the index entry of the file is missing or outdated?
 
             void addSlot (const ESM::SavedGame& profile);
 
+            void writeIndex() const;
+
         public:
 
             Character (const boost::filesystem::path& saves, const std::string& game);
@@ -55,6 +63,15 @@ namespace MWState
             ///
             /// \attention The \a slot pointer will be invalidated by this call.
 
+            void setProfile (const Slot *slot, const ESM::SavedGame& profile,
+                const std::optional<SlotIndexEntry>& indexEntry);
+            ///< Replace the profile of a slot without changing its position or time stamp. Call once the saved game
+            /// file is written.
+            ///
+            /// \param indexEntry Entry already appended to the index file by the saved game writer, if any.
+            ///
+            /// \note Slot must belong to this character.
+
             SlotIterator begin() const;
             ///<  Any call to createSlot and updateSlot can invalidate the returned iterator.
 
@@ -0,0 +1,123 @@
+#include "savegamewriter.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <osgDB/Registry>
+
+#include <components/debug/debuglog.hpp>
+#include <components/esm/defs.hpp>
+#include <components/esm3/esmwriter.hpp>
+#include <components/files/compressedstream.hpp>
+
+namespace
+{
+    std::vector<char> encodeScreenshot (const osg::Image& screenshot)
+    {
+        osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
+        if (!readerwriter)
+        {
+            Log(Debug::Error) << "Error: Unable to write screenshot, can't find a jpg ReaderWriter";
+            return {};
+        }
+
+        std::ostringstream ostream;
+        osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(screenshot, ostream);
+        if (!result.success())
+        {
+            Log(Debug::Error) << "Error: Unable to write screenshot: " << result.message() << " code " << result.status();
+            return {};
+        }
+
+        std::string data = ostream.str();
+        return std::vector<char>(data.begin(), data.end());
+    }
+}
+
+void MWState::initSaveGameWriter (ESM::ESMWriter& writer, const std::vector<std::string>& contentFiles, int recordCount)
+{
+    for (const std::string& contentFile : contentFiles)
+        writer.addMaster(contentFile, 0); // not using the size information anyway -> use value of 0
+
+    writer.setFormat (ESM::SavedGame::sCurrentFormat);
+
+    // all unused
+    writer.setVersion(0);
+    writer.setType(0);
+    writer.setAuthor("");
+    writer.setDescription("");
+
+    writer.setRecordCount (recordCount);
+}
+
+MWState::SaveGameWriter::SaveGameWriter (const std::vector<std::string>& contentFiles, int recordCount,
+    const ESM::SavedGame& profile, osg::ref_ptr<osg::Image> screenshot, std::string records,
+    const boost::filesystem::path& path, const boost::filesystem::path& indexPath, bool compress)
+: mContentFiles (contentFiles), mRecordCount (recordCount), mProfile (profile), mScreenshot (std::move (screenshot)),
+  mRecords (std::move (records)), mPath (path), mIndexPath (indexPath), mCompress (compress)
+{}
+
+void MWState::SaveGameWriter::doWork()
+{
+    try
+    {
+        if (mScreenshot)
+            mProfile.mScreenshot = encodeScreenshot(*mScreenshot);
+        mScreenshot = nullptr;
+
+        std::stringstream stream;
+
+        ESM::ESMWriter writer;
+        initSaveGameWriter(writer, mContentFiles, mRecordCount);
+        writer.save (stream);
+
+        writer.startRecord (ESM::REC_SAVE);
+        mProfile.save (writer);
+        writer.endRecord (ESM::REC_SAVE);
+
+        writer.close();
+
+        stream.write(mRecords.data(), static_cast<std::streamsize>(mRecords.size()));
+        mRecords = std::string();
+
+        if (stream.fail())
+            throw std::runtime_error("Write operation failed (memory stream)");
+
+        // Write to a temporary file first, so a failure doesn't trash the existing save file we are overwriting
+        const boost::filesystem::path tmpPath = mPath.parent_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.tmp");
+        {
+            boost::filesystem::ofstream filestream (tmpPath, std::ios::binary);
+            if (mCompress)
+                Files::writeCompressedStream(filestream, stream.str());
+            else
+                filestream << stream.rdbuf();
+
+            if (filestream.fail())
+            {
+                filestream.close();
+                boost::filesystem::remove(tmpPath);
+                throw std::runtime_error("Write operation failed (file stream)");
+            }
+        }
+        boost::filesystem::rename(tmpPath, mPath);
+    }
+    catch (const std::exception& e)
+    {
+        mError = e.what();
+        return;
+    }
+
+    // Only this entry is appended, so the index of a character with many saved games isn't rewritten on every save
+    try
+    {
+        mIndexEntry = makeSlotIndexEntry(mPath, mProfile);
+        appendSlotIndex(mIndexPath, mPath.filename().string(), *mIndexEntry);
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Failed to index saved game " << mPath << ": " << e.what();
+    }
+}
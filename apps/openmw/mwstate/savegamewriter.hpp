@@ -0,0 +1,73 @@
+#ifndef GAME_STATE_SAVEGAMEWRITER_H
+#define GAME_STATE_SAVEGAMEWRITER_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+#include <osg/Image>
+#include <osg/ref_ptr>
+
+#include <components/esm3/savedgame.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include "slotindex.hpp"
+
+namespace ESM
+{
+    class ESMWriter;
+}
+
+namespace MWState
+{
+    void initSaveGameWriter (ESM::ESMWriter& writer, const std::vector<std::string>& contentFiles, int recordCount);
+    ///< Set up the file header of a saved game.
+
+    class SaveGameWriter : public SceneUtil::WorkItem
+    {
+            std::vector<std::string> mContentFiles;
+            int mRecordCount;
+            ESM::SavedGame mProfile;
+            osg::ref_ptr<osg::Image> mScreenshot;
+            std::string mRecords;
+            boost::filesystem::path mPath;
+            boost::filesystem::path mIndexPath;
+            bool mCompress;
+            std::string mError;
+            std::optional<SlotIndexEntry> mIndexEntry;
+
+        public:
+
+            SaveGameWriter (const std::vector<std::string>& contentFiles, int recordCount, const ESM::SavedGame& profile,
+                osg::ref_ptr<osg::Image> screenshot, std::string records, const boost::filesystem::path& path,
+                const boost::filesystem::path& indexPath, bool compress);
+            ///< Write a saved game in the background.
+            ///
+            /// \param records All records after the saved game header, which is written by the work item once the
+            /// screenshot is encoded.
+            ///
+            /// \param recordCount Number of records including the saved game header.
+            ///
+            /// \param indexPath Saved game index of the character, the entry of the saved game is appended to it once the
+            /// file is written.
+            ///
+            /// \param compress Write the saved game as a compressed container (see Files::writeCompressedStream).
+
+            void doWork() override;
+
+            const ESM::SavedGame& getProfile() const { return mProfile; }
+            ///< Includes the encoded screenshot once done.
+
+            const boost::filesystem::path& getPath() const { return mPath; }
+
+            const std::string& getError() const { return mError; }
+            ///< Empty unless writing the saved game failed.
+
+            const std::optional<SlotIndexEntry>& getIndexEntry() const { return mIndexEntry; }
+            ///< Empty if the saved game couldn't be indexed.
+    };
+}
+
+#endif
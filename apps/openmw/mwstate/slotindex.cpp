@@ -0,0 +1,188 @@
+#include "slotindex.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/esm/defs.hpp>
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+
+const char* const MWState::slotIndexFileName = "slots.omwsaveindex";
+
+namespace
+{
+    void startSlotIndex (ESM::ESMWriter& writer, std::ostream& stream, std::size_t recordCount)
+    {
+        writer.setFormat (ESM::SavedGame::sCurrentFormat);
+        writer.setVersion (0);
+        writer.setType (0);
+        writer.setAuthor ("");
+        writer.setDescription ("");
+        writer.setRecordCount (static_cast<int> (recordCount));
+        writer.save (stream);
+    }
+
+    /// \param entry Write a record removing the entry if null.
+    void writeEntry (ESM::ESMWriter& writer, const std::string& fileName, const MWState::SlotIndexEntry* entry)
+    {
+        writer.startRecord (ESM::REC_SAVE);
+        writer.writeHNString ("FNAM", fileName);
+        if (entry==nullptr)
+        {
+            writer.writeHNT ("DELE", static_cast<std::int32_t> (0));
+        }
+        else
+        {
+            writer.writeHNT ("SIZE", static_cast<std::uint64_t> (entry->mFileSize));
+            writer.writeHNT ("MTIM", static_cast<std::int64_t> (entry->mTimeStamp));
+            writer.writeHNT ("WTIM", entry->mWriteTime);
+            entry->mProfile.save (writer);
+        }
+        writer.endRecord (ESM::REC_SAVE);
+    }
+
+    void appendEntry (const boost::filesystem::path& path, const std::string& fileName, const MWState::SlotIndexEntry* entry)
+    {
+        if (!boost::filesystem::exists (path))
+        {
+            MWState::SlotIndex index;
+            if (entry!=nullptr)
+                index.emplace (fileName, *entry);
+            MWState::writeSlotIndex (path, index);
+            return;
+        }
+
+        // ESMWriter seeks back to fill in record sizes, so serialize the record first and append the bytes after the
+        // header. The record count in the header of the file becomes outdated, the reader doesn't rely on it.
+        std::ostringstream buffer;
+        ESM::ESMWriter writer;
+        startSlotIndex (writer, buffer, 1);
+        const std::streamoff headerSize = buffer.tellp();
+        writeEntry (writer, fileName, entry);
+        writer.close();
+        const std::string data = buffer.str();
+
+        boost::filesystem::ofstream stream (path, std::ios::binary | std::ios::app);
+        stream.write (data.data() + headerSize, static_cast<std::streamsize> (data.size() - headerSize));
+        stream.close();
+
+        if (stream.fail())
+            throw std::runtime_error ("Failed to append to saved game index " + path.string());
+    }
+}
+
+std::int64_t MWState::getWriteTime (const boost::filesystem::path& path)
+{
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time (std::filesystem::path (path.native()));
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (time.time_since_epoch()).count();
+}
+
+MWState::SlotIndexEntry MWState::makeSlotIndexEntry (const boost::filesystem::path& path, const ESM::SavedGame& profile)
+{
+    return SlotIndexEntry {boost::filesystem::file_size (path), boost::filesystem::last_write_time (path),
+        getWriteTime (path), profile};
+}
+
+bool MWState::isCurrent (const SlotIndexEntry& entry, std::uintmax_t fileSize, std::time_t timeStamp, std::int64_t writeTime)
+{
+    return entry.mFileSize==fileSize && entry.mTimeStamp==timeStamp && entry.mWriteTime==writeTime;
+}
+
+MWState::SlotIndex MWState::readSlotIndex (const boost::filesystem::path& path, std::size_t* recordCount)
+{
+    SlotIndex index;
+
+    if (recordCount!=nullptr)
+        *recordCount = 0;
+
+    if (!boost::filesystem::exists (path))
+        return index;
+
+    ESM::ESMReader reader;
+    reader.open (path.string());
+
+    // The profiles would have to be converted, so it is easier to start over
+    if (reader.getFormat() != ESM::SavedGame::sCurrentFormat)
+        return index;
+
+    while (reader.hasMoreRecs())
+    {
+        if (reader.getRecName() != ESM::REC_SAVE)
+        {
+            reader.skipRecord();
+            continue;
+        }
+
+        reader.getRecHeader();
+
+        if (recordCount!=nullptr)
+            ++*recordCount;
+
+        std::string fileName = reader.getHNString ("FNAM");
+
+        if (reader.isNextSub ("DELE"))
+        {
+            reader.skipHSub();
+            index.erase (fileName);
+            continue;
+        }
+
+        std::uint64_t fileSize = 0;
+        reader.getHNT (fileSize, "SIZE");
+
+        std::int64_t timeStamp = 0;
+        reader.getHNT (timeStamp, "MTIM");
+
+        // Missing in indexes written by earlier versions, which then never match
+        std::int64_t writeTime = 0;
+        reader.getHNOT (writeTime, "WTIM");
+
+        SlotIndexEntry& entry = index[fileName];
+        entry.mFileSize = static_cast<std::uintmax_t> (fileSize);
+        entry.mTimeStamp = static_cast<std::time_t> (timeStamp);
+        entry.mWriteTime = writeTime;
+        entry.mProfile.load (reader);
+    }
+
+    return index;
+}
+
+void MWState::writeSlotIndex (const boost::filesystem::path& path, const SlotIndex& index)
+{
+    // Write to a temporary file first, so a failure leaves the previous index intact
+    const boost::filesystem::path tmpPath = path.parent_path() / boost::filesystem::unique_path ("%%%%-%%%%-%%%%.tmp");
+    {
+        boost::filesystem::ofstream stream (tmpPath, std::ios::binary);
+
+        ESM::ESMWriter writer;
+        startSlotIndex (writer, stream, index.size());
+
+        for (const auto& [fileName, entry] : index)
+            writeEntry (writer, fileName, &entry);
+
+        writer.close();
+
+        if (stream.fail())
+        {
+            stream.close();
+            boost::filesystem::remove (tmpPath);
+            throw std::runtime_error ("Failed to write saved game index " + path.string());
+        }
+    }
+    boost::filesystem::rename (tmpPath, path);
+}
+
+void MWState::appendSlotIndex (const boost::filesystem::path& path, const std::string& fileName, const SlotIndexEntry& entry)
+{
+    appendEntry (path, fileName, &entry);
+}
+
+void MWState::removeFromSlotIndex (const boost::filesystem::path& path, const std::string& fileName)
+{
+    appendEntry (path, fileName, nullptr);
+}
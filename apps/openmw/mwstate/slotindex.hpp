@@ -0,0 +1,53 @@
+#ifndef GAME_STATE_SLOTINDEX_H
+#define GAME_STATE_SLOTINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include <components/esm3/savedgame.hpp>
+
+namespace MWState
+{
+    /// Name of the file in a character directory caching the headers of its saved games.
+    extern const char* const slotIndexFileName;
+
+    struct SlotIndexEntry
+    {
+        std::uintmax_t mFileSize;
+        std::time_t mTimeStamp;
+        std::int64_t mWriteTime; ///< Modification time in nanoseconds, as precise as the file system keeps it
+        ESM::SavedGame mProfile;
+    };
+
+    /// Saved game headers by file name. An entry is only valid while the file size and modification time match.
+    typedef std::map<std::string, SlotIndexEntry> SlotIndex;
+
+    std::int64_t getWriteTime (const boost::filesystem::path& path);
+    ///< \return Modification time of a file in nanoseconds since the file clock's epoch.
+
+    SlotIndexEntry makeSlotIndexEntry (const boost::filesystem::path& path, const ESM::SavedGame& profile);
+    ///< Create an entry for a saved game file, which must exist.
+
+    bool isCurrent (const SlotIndexEntry& entry, std::uintmax_t fileSize, std::time_t timeStamp, std::int64_t writeTime);
+
+    SlotIndex readSlotIndex (const boost::filesystem::path& path, std::size_t* recordCount = nullptr);
+    ///< \note Returns an empty index if the file doesn't exist or was written with a different saved game format.
+    ///
+    /// \param recordCount Set to the number of records read, which is larger than the size of the index if entries
+    /// were replaced or removed by appending.
+
+    void writeSlotIndex (const boost::filesystem::path& path, const SlotIndex& index);
+
+    void appendSlotIndex (const boost::filesystem::path& path, const std::string& fileName, const SlotIndexEntry& entry);
+    ///< Add or replace a single entry, without rewriting the entries of the other saved games.
+
+    void removeFromSlotIndex (const boost::filesystem::path& path, const std::string& fileName);
+    ///< Remove a single entry, without rewriting the entries of the other saved games.
+}
+
+#endif
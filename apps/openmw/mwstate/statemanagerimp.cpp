@@ -11,13 +11,12 @@
 
 #include <components/loadinglistener/loadinglistener.hpp>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include <components/settings/settings.hpp>
 
 #include <osg/Image>
 
-#include <osgDB/Registry>
-
-#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -42,6 +41,7 @@
 #include "../mwscript/globalscripts.hpp"
 
 #include "quicksavemanager.hpp"
+#include "savegamewriter.hpp"
 
 void MWState::StateManager::cleanup (bool force)
 {
@@ -92,10 +92,17 @@ std::map<int, int> MWState::StateManager::buildContentFileIndexMap (const ESM::E
 
 MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::vector<std::string>& contentFiles)
 : mQuitRequest (false), mAskLoadRecent(false), mState (State_NoGame), mCharacterManager (saves, contentFiles), mTimePlayed (0)
+, mSaveQueue (new SceneUtil::WorkQueue(1)), mPendingSaveCharacter (nullptr), mPendingSaveSlot (nullptr)
 {
 
 }
 
+MWState::StateManager::~StateManager()
+{
+    if (mPendingSave)
+        mPendingSave->waitTillDone();
+}
+
 void MWState::StateManager::requestQuit()
 {
     mQuitRequest = true;
@@ -186,6 +193,8 @@ void MWState::StateManager::resumeGame()
 
 void MWState::StateManager::saveGame (const std::string& description, const Slot *slot)
 {
+    finishSaving();
+
     MWState::Character* character = getCurrentCharacter();
 
     try
@@ -226,7 +235,7 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         profile.mDescription = description;
 
         Log(Debug::Info) << "Making a screenshot for saved game '" << description << "'";
-        writeScreenshot(profile.mScreenshot);
+        osg::ref_ptr<osg::Image> screenshot = takeScreenshot();
 
         if (!slot)
             slot = character->createSlot (profile);
@@ -238,23 +247,12 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         Log(Debug::Info) << "Writing saved game '" << description << "' for character '" << profile.mPlayerName << "'";
 
-        // Write to a memory stream first. If there is an exception during the save process, we don't want to trash the
-        // existing save file we are overwriting.
+        // Serialize the game state into a memory stream, which is a snapshot the background writer can use while the
+        // game goes on. The file header and the saved game header go in front of it once the screenshot is encoded.
         std::stringstream stream;
 
         ESM::ESMWriter writer;
 
-        for (const std::string& contentFile : MWBase::Environment::get().getWorld()->getContentFiles())
-            writer.addMaster(contentFile, 0); // not using the size information anyway -> use value of 0
-
-        writer.setFormat (ESM::SavedGame::sCurrentFormat);
-
-        // all unused
-        writer.setVersion(0);
-        writer.setType(0);
-        writer.setAuthor("");
-        writer.setDescription("");
-
         int recordCount =         1 // saved game header
                 +MWBase::Environment::get().getJournal()->countSavedGameRecords()
                 +MWBase::Environment::get().getLuaManager()->countSavedGameRecords()
@@ -264,9 +262,10 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
                 +MWBase::Environment::get().getMechanicsManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getInputManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getWindowManager()->countSavedGameRecords();
-        writer.setRecordCount (recordCount);
+        initSaveGameWriter(writer, profile.mContentFiles, recordCount);
 
         writer.save (stream);
+        const std::streamoff headerSize = stream.tellp();
 
         Loading::Listener& listener = *MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         // Using only Cells for progress information, since they typically have the largest records by far
@@ -275,10 +274,6 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         Loading::ScopedLoad load(&listener);
 
-        writer.startRecord (ESM::REC_SAVE);
-        slot->mProfile.save (writer);
-        writer.endRecord (ESM::REC_SAVE);
-
         MWBase::Environment::get().getJournal()->write (writer, listener);
         MWBase::Environment::get().getDialogueManager()->write (writer, listener);
         // LuaManager::write should be called before World::write because world also saves
@@ -291,28 +286,32 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         MWBase::Environment::get().getWindowManager()->write(writer, listener);
 
         // Ensure we have written the number of records that was estimated
-        if (writer.getRecordCount() != recordCount+1) // 1 extra for TES3 record
-            Log(Debug::Warning) << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount();
+        // 1 extra for TES3 record, 1 less for the saved game header written in the background
+        if (writer.getRecordCount() != recordCount)
+            Log(Debug::Warning) << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount()+1;
 
         writer.close();
 
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
-
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
-
         Settings::Manager::setString ("character", "Saves",
             slot->mPath.parent_path().filename().string());
 
+        std::string records = stream.str();
+        records.erase(0, static_cast<std::size_t>(headerSize));
+
+        mPendingSave = new SaveGameWriter(profile.mContentFiles, recordCount, slot->mProfile, std::move(screenshot),
+            std::move(records), slot->mPath, character->getPath() / slotIndexFileName,
+            Settings::Manager::getBool("compress", "Saves"));
+        mPendingSaveCharacter = character;
+        mPendingSaveSlot = slot;
+        mSaveQueue->addWorkItem(mPendingSave);
+
         const auto finish = std::chrono::steady_clock::now();
 
-        Log(Debug::Info) << '\'' << description << "' is saved in "
-            << std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(finish - start).count() << "ms";
+        Log(Debug::Info) << '\'' << description << "' is serialized in "
+            << std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(finish - start).count() << "ms, writing it in the background";
     }
     catch (const std::exception& e)
     {
@@ -368,6 +367,8 @@ void MWState::StateManager::quickSave (std::string name)
 
 void MWState::StateManager::loadGame(const std::string& filepath)
 {
+    finishSaving();
+
     for (const auto& character : mCharacterManager)
     {
         for (const auto& slot : character)
@@ -386,6 +387,8 @@ void MWState::StateManager::loadGame(const std::string& filepath)
 
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
+    finishSaving();
+
     try
     {
         cleanup();
@@ -601,6 +604,8 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
+    finishSaving();
+
     mCharacterManager.deleteSlot(character, slot);
 }
 
@@ -623,6 +628,9 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    if (mPendingSave && mPendingSave->isDone())
+        finishSaving();
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -670,7 +678,7 @@ bool MWState::StateManager::verifyProfile(const ESM::SavedGame& profile) const
     return true;
 }
 
-void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
+osg::ref_ptr<osg::Image> MWState::StateManager::takeScreenshot() const
 {
     int screenshotW = 259*2, screenshotH = 133*2; // *2 to get some nice antialiasing
 
@@ -678,22 +686,45 @@ void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
 
     MWBase::Environment::get().getWorld()->screenshot(screenshot.get(), screenshotW, screenshotH);
 
-    osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
-    if (!readerwriter)
-    {
-        Log(Debug::Error) << "Error: Unable to write screenshot, can't find a jpg ReaderWriter";
+    return screenshot;
+}
+
+void MWState::StateManager::finishSaving()
+{
+    if (!mPendingSave)
         return;
-    }
 
-    std::ostringstream ostream;
-    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*screenshot, ostream);
-    if (!result.success())
+    mPendingSave->waitTillDone();
+
+    const osg::ref_ptr<SaveGameWriter> save = mPendingSave;
+    Character* character = mPendingSaveCharacter;
+    const Slot* slot = mPendingSaveSlot;
+    mPendingSave = nullptr;
+    mPendingSaveCharacter = nullptr;
+    mPendingSaveSlot = nullptr;
+
+    if (!save->getError().empty())
     {
-        Log(Debug::Error) << "Error: Unable to write screenshot: " << result.message() << " code " << result.status();
+        std::stringstream error;
+        error << "Failed to save game: " << save->getError();
+
+        Log(Debug::Error) << error.str();
+
+        std::vector<std::string> buttons;
+        buttons.emplace_back("#{sOk}");
+        MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+
+        // If no file was written, clean up the slot
+        if (!boost::filesystem::exists(save->getPath()))
+        {
+            character->deleteSlot(slot);
+            character->cleanup();
+        }
         return;
     }
 
-    std::string data = ostream.str();
-    imageData = std::vector<char>(data.begin(), data.end());
+    // The slot was created without the screenshot, which is only encoded in the background
+    character->setProfile(slot, save->getProfile(), save->getIndexEntry());
 
+    Log(Debug::Info) << '\'' << save->getProfile().mDescription << "' is saved";
 }
@@ -7,10 +7,24 @@
 
 #include <boost/filesystem/path.hpp>
 
+#include <osg/ref_ptr>
+
 #include "charactermanager.hpp"
 
+namespace osg
+{
+    class Image;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWState
 {
+    class SaveGameWriter;
+
     class StateManager : public MWBase::StateManager
     {
             bool mQuitRequest;
@@ -19,13 +33,23 @@ namespace MWState
             CharacterManager mCharacterManager;
             double mTimePlayed;
 
+            osg::ref_ptr<SceneUtil::WorkQueue> mSaveQueue;
+            osg::ref_ptr<SaveGameWriter> mPendingSave;
+            Character *mPendingSaveCharacter;
+            const Slot *mPendingSaveSlot;
+
         private:
 
             void cleanup (bool force = false);
 
             bool verifyProfile (const ESM::SavedGame& profile) const;
 
-            void writeScreenshot (std::vector<char>& imageData) const;
+            osg::ref_ptr<osg::Image> takeScreenshot() const;
+
+            void finishSaving();
+            ///< Wait until the saved game being written in the background, if any, is done and report errors.
+            ///
+            /// \note Must be called before slots are created, updated or deleted.
 
             std::map<int, int> buildContentFileIndexMap (const ESM::ESMReader& reader) const;
 
@@ -33,6 +57,8 @@ namespace MWState
 
             StateManager (const boost::filesystem::path& saves, const std::vector<std::string>& contentFiles);
 
+            ~StateManager() override;
+
             void requestQuit() override;
 
             bool hasQuitRequest() const override;
@@ -57,6 +83,9 @@ namespace MWState
             ///< Write a saved game to \a slot or create a new slot if \a slot == 0.
             ///
             /// \note Slot must belong to the current character.
+            ///
+            /// \note The game state is serialized right away, the screenshot is encoded and the file is written in
+            /// the background.
 
             ///Saves a file, using supplied filename, overwritting if needed
             /** This is mostly used for quicksaving and autosaving, for they use the same name over and over again
@@ -16,6 +16,9 @@
 #include <components/esm3/loadcell.hpp>
 #include <components/loadinglistener/reporter.hpp>
 
+#include "../mwbase/environment.hpp"
+#include "../mwbase/soundmanager.hpp"
+
 #include "../mwrender/landmanager.hpp"
 
 #include "cellstore.hpp"
@@ -66,6 +69,18 @@ namespace MWWorld
         std::vector<std::string>& mOut;
     };
 
+    struct ListSoundsVisitor
+    {
+        bool operator()(const MWWorld::Ptr& ptr)
+        {
+            ptr.getClass().getSoundsToPreload(ptr, mOut);
+
+            return true;
+        }
+
+        std::vector<std::string>& mOut;
+    };
+
     /// Worker thread item: preload models in a cell.
     class PreloadItem : public SceneUtil::WorkItem
     {
@@ -315,6 +330,11 @@ namespace MWWorld
         mWorkQueue->addWorkItem(item);
 
         mPreloadCells[cell] = PreloadEntry(timestamp, item);
+
+        std::vector<std::string> sounds;
+        ListSoundsVisitor soundsVisitor {sounds};
+        cell->forEach(soundsVisitor);
+        MWBase::Environment::get().getSoundManager()->preloadSounds(sounds);
     }
 
     void CellPreloader::notifyLoaded(CellStore *cell)
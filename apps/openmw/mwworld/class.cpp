@@ -315,6 +315,13 @@ namespace MWWorld
             models.push_back(model);
     }
 
+    void Class::getSoundsToPreload(const Ptr &ptr, std::vector<std::string> &sounds) const
+    {
+        std::string sound = getSound(ptr);
+        if (!sound.empty())
+            sounds.push_back(std::move(sound));
+    }
+
     std::string Class::applyEnchantment(const MWWorld::ConstPtr &ptr, const std::string& enchId, int enchCharge, const std::string& newName) const
     {
         throw std::runtime_error ("class can't be enchanted");
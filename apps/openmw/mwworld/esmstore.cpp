@@ -271,6 +271,11 @@ void ESMStore::setUp()
     mMagicEffects.setUp();
     mAttributes.setUp();
     mDialogs.setUp();
+
+    mCreatureSounds.clear();
+    for (const ESM::SoundGenerator& soundGen : mSoundGens)
+        if (!soundGen.mCreature.empty())
+            mCreatureSounds[soundGen.mCreature].push_back(soundGen.mSound);
 }
 
 void ESMStore::validateRecords(ESM::ReadersCache& readers)
@@ -527,4 +532,13 @@ void ESMStore::removeMissingObjects(Store<T>& store)
         }
         return {ptr, true};
     }
+
+    const std::vector<std::string>& ESMStore::getCreatureSounds(const std::string& creatureId) const
+    {
+        static const std::vector<std::string> empty;
+        const auto it = mCreatureSounds.find(creatureId);
+        if (it == mCreatureSounds.end())
+            return empty;
+        return it->second;
+    }
 } // end namespace
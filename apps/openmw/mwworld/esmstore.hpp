@@ -91,6 +91,9 @@ namespace MWWorld
 
         mutable std::unordered_map<std::string, std::weak_ptr<MWMechanics::SpellList>, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> mSpellListCache;
 
+        // Sounds of sound generators by creature ID, to not scan all sound generators per creature
+        std::unordered_map<std::string, std::vector<std::string>, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> mCreatureSounds;
+
         /// Validate entries in store after setup
         void validate();
 
@@ -289,6 +292,9 @@ namespace MWWorld
         /// Actors with the same ID share spells, abilities, etc.
         /// @return The shared spell list to use for this actor and whether or not it has already been initialized.
         std::pair<std::shared_ptr<MWMechanics::SpellList>, bool> getSpellList(const std::string& id) const;
+
+        /// @return Sounds of the sound generators made for the creature.
+        const std::vector<std::string>& getCreatureSounds(const std::string& creatureId) const;
     };
 
     template <>
@@ -1,5 +1,9 @@
 #include "localscripts.hpp"
 
+#include <cassert>
+#include <iterator>
+#include <utility>
+
 #include <components/debug/debuglog.hpp>
 
 #include "esmstore.hpp"
@@ -78,13 +82,27 @@ bool MWWorld::LocalScripts::getNext(std::pair<std::string, Ptr>& script)
 {
     if (mIter!=mScripts.end())
     {
-        std::list<std::pair<std::string, Ptr> >::iterator iter = mIter++;
-        script = *iter;
+        std::list<Script>::iterator iter = mIter++;
+        script = std::make_pair (iter->mName, iter->mPtr);
         return true;
     }
     return false;
 }
 
+void MWWorld::LocalScripts::deferCurrent (float frameDuration)
+{
+    assert (mIter!=mScripts.begin());
+    const std::list<Script>::iterator current = std::prev (mIter);
+    current->mDeferredTime += frameDuration;
+    mScripts.splice (mScripts.begin(), mScripts, current);
+}
+
+float MWWorld::LocalScripts::takeDeferredTime()
+{
+    assert (mIter!=mScripts.begin());
+    return std::exchange (std::prev (mIter)->mDeferredTime, 0.f);
+}
+
 void MWWorld::LocalScripts::add (const std::string& scriptName, const Ptr& ptr)
 {
     if (const ESM::Script *script = mStore.get<ESM::Script>().search (scriptName))
@@ -93,15 +111,15 @@ void MWWorld::LocalScripts::add (const std::string& scriptName, const Ptr& ptr)
         {
             ptr.getRefData().setLocals (*script);
 
-            for (std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin(); iter!=mScripts.end(); ++iter)
-                if (iter->second==ptr)
+            for (std::list<Script>::iterator iter = mScripts.begin(); iter!=mScripts.end(); ++iter)
+                if (iter->mPtr==ptr)
                 {
                     Log(Debug::Warning) << "Error: tried to add local script twice for " << ptr.getCellRef().getRefId();
                     remove(ptr);
                     break;
                 }
 
-            mScripts.emplace_back (scriptName, ptr);
+            mScripts.push_back (Script {scriptName, ptr});
         }
         catch (const std::exception& exception)
         {
@@ -134,11 +152,11 @@ void MWWorld::LocalScripts::clear()
 
 void MWWorld::LocalScripts::clearCell (CellStore *cell)
 {
-    std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin();
+    std::list<Script>::iterator iter = mScripts.begin();
 
     while (iter!=mScripts.end())
     {
-        if (iter->second.mCell==cell)
+        if (iter->mPtr.mCell==cell)
         {
             if (iter==mIter)
                ++mIter;
@@ -152,9 +170,9 @@ void MWWorld::LocalScripts::clearCell (CellStore *cell)
 
 void MWWorld::LocalScripts::remove (RefData *ref)
 {
-    for (std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin();
+    for (std::list<Script>::iterator iter = mScripts.begin();
         iter!=mScripts.end(); ++iter)
-        if (&(iter->second.getRefData()) == ref)
+        if (&(iter->mPtr.getRefData()) == ref)
         {
             if (iter==mIter)
                 ++mIter;
@@ -166,9 +184,9 @@ void MWWorld::LocalScripts::remove (RefData *ref)
 
 void MWWorld::LocalScripts::remove (const Ptr& ptr)
 {
-    for (std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin();
+    for (std::list<Script>::iterator iter = mScripts.begin();
         iter!=mScripts.end(); ++iter)
-        if (iter->second==ptr)
+        if (iter->mPtr==ptr)
         {
             if (iter==mIter)
                 ++mIter;
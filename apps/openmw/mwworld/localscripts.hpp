@@ -15,8 +15,15 @@ namespace MWWorld
     /// \brief List of active local scripts
     class LocalScripts
     {
-            std::list<std::pair<std::string, Ptr> > mScripts;
-            std::list<std::pair<std::string, Ptr> >::iterator mIter;
+            struct Script
+            {
+                std::string mName;
+                Ptr mPtr;
+                float mDeferredTime = 0; ///< Frame time missed by postponing the script
+            };
+
+            std::list<Script> mScripts;
+            std::list<Script>::iterator mIter;
             const MWWorld::ESMStore& mStore;
 
         public:
@@ -30,6 +37,16 @@ namespace MWWorld
             ///< Get next local script
             /// @return Did we get a script?
 
+            void deferCurrent (float frameDuration);
+            ///< Move the script last returned by getNext to the begin of the list, so it is run first by the next
+            /// iteration.
+            ///
+            /// \param frameDuration Time of the current frame the script misses, see takeDeferredTime.
+
+            float takeDeferredTime();
+            ///< Get and reset the time the script last returned by getNext missed by being postponed, to add it to the
+            /// frame time while it runs.
+
             void add (const std::string& scriptName, const Ptr& ptr);
             ///< Add script to collection of active local scripts.
 
@@ -1010,6 +1010,7 @@ namespace MWWorld
         std::sort(mShared.begin(), mShared.end(), [](const ESM::Dialogue* l, const ESM::Dialogue* r) -> bool { return l->mId < r->mId; });
 
         mKeywordSearchModFlag = true;
+        mInfoIndexes.clear();
     }
 
     const ESM::Dialogue *Store<ESM::Dialogue>::search(const std::string &id) const
@@ -1068,6 +1069,7 @@ namespace MWWorld
         }
         
         mKeywordSearchModFlag = true;
+        mInfoIndexes.clear();
 
         return RecordId(dialogue.mId, isDeleted);
     }
@@ -1075,7 +1077,10 @@ namespace MWWorld
     bool Store<ESM::Dialogue>::eraseStatic(const std::string &id)
     {
         if (mStatic.erase(id))
+        {
             mKeywordSearchModFlag = true;
+            mInfoIndexes.clear();
+        }
 
         return true;
     }
@@ -1107,6 +1112,14 @@ namespace MWWorld
 
         return mKeywordSearch;
     }
+
+    const MWDialogue::InfoIndex& Store<ESM::Dialogue>::getInfoIndex(const ESM::Dialogue& dialogue) const
+    {
+        auto it = mInfoIndexes.find(&dialogue);
+        if (it == mInfoIndexes.end())
+            it = mInfoIndexes.emplace(&dialogue, MWDialogue::InfoIndex(dialogue)).first;
+        return it->second;
+    }
 }
 
 template class MWWorld::Store<ESM::Activator>;
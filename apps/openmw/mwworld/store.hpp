@@ -12,6 +12,7 @@
 #include <components/misc/stringops.hpp>
 #include <components/misc/rng.hpp>
 
+#include "../mwdialogue/infoindex.hpp"
 #include "../mwdialogue/keywordsearch.hpp"
 
 namespace ESM
@@ -463,6 +464,8 @@ namespace MWWorld
         mutable bool mKeywordSearchModFlag;
         mutable MWDialogue::KeywordSearch<std::string, int /*unused*/> mKeywordSearch;
 
+        mutable std::unordered_map<const ESM::Dialogue*, MWDialogue::InfoIndex> mInfoIndexes;
+
     public:
         Store();
 
@@ -485,6 +488,9 @@ namespace MWWorld
         void listIdentifier(std::vector<std::string> &list) const override;
 
         const MWDialogue::KeywordSearch<std::string, int>& getDialogIdKeywordSearch() const;
+
+        const MWDialogue::InfoIndex& getInfoIndex(const ESM::Dialogue& dialogue) const;
+        ///< Built on first use, stays valid until the store is modified.
     };
 
 } //end namespace
@@ -1,5 +1,7 @@
 #include "worldimp.hpp"
 
+#include <sstream>
+
 #include <osg/Group>
 #include <osg/ComputeBoundsVisitor>
 #include <osg/Timer>
@@ -139,6 +141,32 @@ namespace MWWorld
         }
     };
 
+    namespace
+    {
+        /// Identifies the loaded content for caches of data generated from it.
+        std::string getContentFilesVersion(const Files::Collections& fileCollections, const std::vector<std::string>& contentFiles)
+        {
+            std::ostringstream stream;
+            for (const boost::filesystem::path& path : fileCollections.getPaths())
+                stream << "data=" << path.string() << '\n';
+            for (const std::string& file : contentFiles)
+            {
+                stream << "content=" << file;
+                const Files::MultiDirCollection& col = fileCollections.getCollection(boost::filesystem::path(file).extension().string());
+                if (col.doesExist(file))
+                {
+                    boost::system::error_code ec;
+                    const boost::filesystem::path path = col.getPath(file);
+                    const auto size = boost::filesystem::file_size(path, ec);
+                    const auto time = boost::filesystem::last_write_time(path, ec);
+                    stream << ' ' << path.string() << ' ' << size << ' ' << time;
+                }
+                stream << '\n';
+            }
+            return stream.str();
+        }
+    }
+
     void World::adjustSky()
     {
         if (mSky && (isCellExterior() || isCellQuasiExterior()))
@@ -206,7 +234,7 @@ namespace MWWorld
         }
 
         mRendering = std::make_unique<MWRender::RenderingManager>(viewer, rootNode, std::move(camera), resourceSystem, workQueue,
-            resourcePath, *mNavigator, mGroundcoverStore, unrefQueue);
+            resourcePath, userDataPath, getContentFilesVersion(fileCollections, contentFiles), *mNavigator, mGroundcoverStore, unrefQueue);
         mProjectileManager = std::make_unique<ProjectileManager>(mRendering->getLightRoot()->asGroup(), resourceSystem, mRendering.get(), mPhysics.get());
         mRendering->preloadCommonAssets();
 
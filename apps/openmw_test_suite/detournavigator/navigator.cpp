@@ -16,6 +16,8 @@
 #include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
 #include <BulletCollision/CollisionShapes/btBoxShape.h>
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -119,6 +121,25 @@ namespace
         return BulletHelpers::getHeightfieldShift(cellPosition.x(), cellPosition.x(), cellSize, minHeight, maxHeight);
     }
 
+    // Side faces of a box without top and bottom, so the object has nothing to walk on
+    void addWalls(btTriangleMesh& mesh, const btVector3& halfExtents)
+    {
+        const btVector3 corners[] = {
+            btVector3(-halfExtents.x(), -halfExtents.y(), 0),
+            btVector3(halfExtents.x(), -halfExtents.y(), 0),
+            btVector3(halfExtents.x(), halfExtents.y(), 0),
+            btVector3(-halfExtents.x(), halfExtents.y(), 0),
+        };
+        const btVector3 height(0, 0, halfExtents.z() * 2);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            const btVector3& a = corners[i];
+            const btVector3& b = corners[(i + 1) % 4];
+            mesh.addTriangle(a, b, b + height);
+            mesh.addTriangle(a, b + height, a + height);
+        }
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, find_path_for_empty_should_return_empty)
     {
         EXPECT_EQ(findPath(*mNavigator, mAgentBounds, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance, mOut),
@@ -1085,6 +1106,66 @@ namespace
         )) << mPath;
     }
 
+    TEST_F(DetourNavigatorNavigatorTest, moved_object_with_enabled_obstacles_should_be_carved_out_of_navmesh)
+    {
+        mSettings.mRecast.mEnableObstacles = true;
+        mNavigator.reset(new NavigatorImpl(mSettings, std::make_unique<NavMeshDb>(":memory:", std::numeric_limits<std::uint64_t>::max())));
+
+        const HeightfieldPlane plane {0};
+        const int cellSize = mHeightfieldTileSize * 4;
+        btTriangleMesh mesh;
+        addWalls(mesh, btVector3(8, 64, 100));
+        CollisionShapeInstance walls(std::make_unique<btBvhTriangleMeshShape>(&mesh, true));
+        const osg::Vec3f end(256, 256, 0);
+
+        mNavigator->addAgent(mAgentBounds);
+        mNavigator->addHeightfield(mCellPosition, cellSize, plane);
+        mNavigator->addObject(ObjectId(&walls.shape()), ObjectShapes(walls.instance(), mObjectTransform),
+            btTransform(btMatrix3x3::getIdentity(), btVector3(176, 256, 0)));
+        // Both positions are covered by the obstacle until the nav mesh is updated
+        mNavigator->updateObject(ObjectId(&walls.shape()), ObjectShapes(walls.instance(), mObjectTransform),
+            btTransform(btMatrix3x3::getIdentity(), btVector3(336, 256, 0)));
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        const Status status = findPath(*mNavigator, mAgentBounds, mStepSize, mStart, end, Flag_walk, mAreaCosts,
+            mEndTolerance, mOut);
+        ASSERT_THAT(status, AnyOf(Status::Success, Status::PartialPath));
+        ASSERT_FALSE(mPath.empty());
+        const osg::Vec2f last(mPath.back().x(), mPath.back().y());
+        EXPECT_GT((last - osg::Vec2f(end.x(), end.y())).length(), 64) << mPath;
+    }
+
+    TEST_F(DetourNavigatorNavigatorTest, moved_door_with_enabled_obstacles_should_keep_off_mesh_connection_reachable)
+    {
+        mSettings.mRecast.mEnableObstacles = true;
+        mNavigator.reset(new NavigatorImpl(mSettings, std::make_unique<NavMeshDb>(":memory:", std::numeric_limits<std::uint64_t>::max())));
+
+        const HeightfieldPlane plane {0};
+        const int cellSize = mHeightfieldTileSize * 4;
+        btTriangleMesh mesh;
+        addWalls(mesh, btVector3(8, 64, 100));
+        CollisionShapeInstance door(std::make_unique<btBvhTriangleMeshShape>(&mesh, true));
+        const osg::Vec3f connectionStart(256, 256, 0);
+        const osg::Vec3f connectionEnd(256, 128, 0);
+        const DoorShapes shapes(door.instance(), mObjectTransform, connectionStart, connectionEnd);
+
+        mNavigator->addAgent(mAgentBounds);
+        mNavigator->addHeightfield(mCellPosition, cellSize, plane);
+        mNavigator->addObject(ObjectId(&door.shape()), shapes,
+            btTransform(btMatrix3x3::getIdentity(), btVector3(176, 256, 0)));
+        mNavigator->updateObject(ObjectId(&door.shape()), shapes,
+            btTransform(btMatrix3x3::getIdentity(), btVector3(336, 256, 0)));
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        EXPECT_EQ(findPath(*mNavigator, mAgentBounds, mStepSize, mStart, connectionStart, Flag_walk, mAreaCosts,
+            mEndTolerance, mOut), Status::Success);
+        ASSERT_FALSE(mPath.empty());
+        EXPECT_NEAR(mPath.back().x(), connectionStart.x(), 1) << mPath;
+        EXPECT_NEAR(mPath.back().y(), connectionStart.y(), 1) << mPath;
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, end_tolerance_should_extent_available_destinations)
     {
         const std::array<float, 5 * 5> heightfieldData {{
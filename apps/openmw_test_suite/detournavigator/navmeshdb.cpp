@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <array>
 #include <numeric>
 #include <random>
 #include <limits>
@@ -178,4 +179,41 @@ namespace
         };
         EXPECT_THROW(f(), std::runtime_error);
     }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_tiles_data_should_return_tiles_after_given_id_ordered_by_id)
+    {
+        const TileVersion version {1};
+        const std::array<Tile, 3> tiles {
+            insertTile(TileId {3}, version),
+            insertTile(TileId {1}, version),
+            insertTile(TileId {2}, version),
+        };
+        const std::vector<TileData> result = mDb.getTilesData(TileId {1}, 10);
+        ASSERT_EQ(result.size(), 2);
+        EXPECT_EQ(result[0].mTileId, TileId {2});
+        EXPECT_EQ(result[0].mData, tiles[2].mData);
+        EXPECT_EQ(result[1].mTileId, TileId {3});
+        EXPECT_EQ(result[1].mData, tiles[0].mData);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_tiles_data_should_return_not_more_than_limit)
+    {
+        for (std::int64_t i = 1; i <= 5; ++i)
+            insertTile(TileId {i}, TileVersion {1});
+        EXPECT_EQ(mDb.getTilesData(TileId {0}, 3).size(), 3);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, tile_written_with_compression_level_should_be_read_by_db_without_it)
+    {
+        const TileId tileId {13};
+        const TileVersion version {1};
+        mDb = NavMeshDb(":memory:", std::numeric_limits<std::uint64_t>::max(), 9, 1024 * 1024);
+        auto [worldspace, tilePosition, input, data] = insertTile(tileId, version);
+        const auto row = mDb.getTileData(worldspace, tilePosition, input);
+        ASSERT_TRUE(row.has_value());
+        EXPECT_EQ(row->mData, data);
+        const std::vector<TileData> tiles = mDb.getTilesData(TileId {0}, 1);
+        ASSERT_EQ(tiles.size(), 1);
+        EXPECT_EQ(tiles[0].mData, data);
+    }
 }
@@ -0,0 +1,101 @@
+#include "settings.hpp"
+
+#include <components/detournavigator/navmeshlayerscache.hpp>
+#include <components/detournavigator/makenavmesh.hpp>
+#include <components/detournavigator/recastmesh.hpp>
+#include <components/detournavigator/preparednavmeshdata.hpp>
+#include <components/esm3/loadland.hpp>
+
+#include <Recast.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Tests;
+
+    struct DetourNavigatorNavMeshLayersCacheTest : Test
+    {
+        const Settings mSettings = makeSettings();
+        const AgentBounds mAgentBounds {CollisionShapeType::Aabb, {29, 29, 66}};
+        const TilePosition mTilePosition {0, 0};
+        const std::size_t mGeneration = 0;
+        const std::size_t mRevision = 0;
+        const Mesh mMesh {{}, {}, {}};
+        const std::vector<FlatHeightfield> mFlatHeightfields {FlatHeightfield {osg::Vec2i(0, 0), ESM::Land::REAL_SIZE, 0}};
+        const std::shared_ptr<const RecastMesh> mRecastMesh = std::make_shared<RecastMesh>(mGeneration, mRevision,
+            mMesh, std::vector<CellWater>(), std::vector<Heightfield>(), mFlatHeightfields, std::vector<MeshSource>());
+        rcCompactHeightfield mLayer;
+
+        DetourNavigatorNavMeshLayersCacheTest()
+        {
+            if (!prepareNavMeshLayer(*mRecastMesh, mTilePosition, mAgentBounds, mSettings.mRecast, mLayer))
+                throw std::logic_error("Failed to prepare navmesh layer");
+        }
+    };
+
+    TEST_F(DetourNavigatorNavMeshLayersCacheTest, get_for_empty_cache_should_return_false)
+    {
+        NavMeshLayersCache cache(1024 * 1024);
+        rcCompactHeightfield layer;
+        EXPECT_FALSE(cache.get(mAgentBounds, mTilePosition, *mRecastMesh, layer));
+    }
+
+    TEST_F(DetourNavigatorNavMeshLayersCacheTest, get_should_return_cached_layer)
+    {
+        NavMeshLayersCache cache(1024 * 1024);
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, mLayer);
+        rcCompactHeightfield layer;
+        ASSERT_TRUE(cache.get(mAgentBounds, mTilePosition, *mRecastMesh, layer));
+        EXPECT_EQ(layer.width, mLayer.width);
+        EXPECT_EQ(layer.height, mLayer.height);
+        ASSERT_EQ(layer.spanCount, mLayer.spanCount);
+        EXPECT_TRUE(std::equal(layer.areas, layer.areas + layer.spanCount, mLayer.areas));
+        EXPECT_EQ(layer.dist, nullptr);
+    }
+
+    TEST_F(DetourNavigatorNavMeshLayersCacheTest, get_for_recast_mesh_with_other_obstacles_should_return_cached_layer)
+    {
+        NavMeshLayersCache cache(1024 * 1024);
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, mLayer);
+        const RecastMesh withObstacle(mGeneration, mRevision, mMesh, std::vector<CellWater>(), std::vector<Heightfield>(),
+            mFlatHeightfields, std::vector<MeshSource>(), {Obstacle {osg::Vec3f(-10, -10, 0), osg::Vec3f(10, 10, 100)}});
+        rcCompactHeightfield layer;
+        EXPECT_TRUE(cache.get(mAgentBounds, mTilePosition, withObstacle, layer));
+    }
+
+    TEST_F(DetourNavigatorNavMeshLayersCacheTest, get_for_recast_mesh_with_other_geometry_should_return_false)
+    {
+        NavMeshLayersCache cache(1024 * 1024);
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, mLayer);
+        const std::vector<FlatHeightfield> flatHeightfields {FlatHeightfield {osg::Vec2i(0, 0), ESM::Land::REAL_SIZE, 1}};
+        const RecastMesh other(mGeneration, mRevision, mMesh, std::vector<CellWater>(), std::vector<Heightfield>(),
+            flatHeightfields, std::vector<MeshSource>());
+        rcCompactHeightfield layer;
+        EXPECT_FALSE(cache.get(mAgentBounds, mTilePosition, other, layer));
+    }
+
+    TEST_F(DetourNavigatorNavMeshLayersCacheTest, set_for_not_enough_cache_size_should_not_store_layer)
+    {
+        NavMeshLayersCache cache(1);
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, mLayer);
+        EXPECT_EQ(cache.getStats().mLayers, 0);
+    }
+
+    TEST_F(DetourNavigatorNavMeshLayersCacheTest, tile_data_from_layer_without_obstacles_should_be_equal_to_generated)
+    {
+        NavMeshLayersCache cache(1024 * 1024);
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, mLayer);
+        rcCompactHeightfield layer;
+        ASSERT_TRUE(cache.get(mAgentBounds, mTilePosition, *mRecastMesh, layer));
+        const auto fromLayer = prepareNavMeshTileData(layer, {}, mAgentBounds, mSettings.mRecast);
+        const auto generated = prepareNavMeshTileData(*mRecastMesh, mTilePosition, mAgentBounds, mSettings.mRecast);
+        ASSERT_NE(fromLayer, nullptr);
+        ASSERT_NE(generated, nullptr);
+        EXPECT_EQ(*fromLayer, *generated);
+    }
+}
@@ -380,4 +380,52 @@ namespace
         EXPECT_FALSE(cache.set(mAgentBounds, mTilePosition, anotherRecastMesh, std::move(anotherData)));
         EXPECT_TRUE(cache.get(mAgentBounds, mTilePosition, mRecastMesh));
     }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, recast_meshes_with_same_geometry_should_have_same_hash)
+    {
+        const RecastMesh other(mGeneration + 1, mRevision + 1, mMesh, mWater, mHeightfields, mFlatHeightfields, mSources);
+        EXPECT_EQ(mRecastMesh.getHash(), other.getHash());
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, recast_meshes_with_different_geometry_should_have_different_hash)
+    {
+        const std::vector<CellWater> water(1, CellWater {osg::Vec2i(), Water {1, 0.0f}});
+        const RecastMesh other(mGeneration, mRevision, mMesh, water, mHeightfields, mFlatHeightfields, mSources);
+        EXPECT_NE(mRecastMesh.getHash(), other.getHash());
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_stats_should_return_cache_size_per_agent)
+    {
+        const std::size_t maxSize = 2 * (mRecastMeshSize + mPreparedNavMeshDataSize);
+        NavMeshTilesCache cache(maxSize);
+        const AgentBounds anotherAgentBounds {CollisionShapeType::Cylinder, {1, 2, 3}};
+        const std::size_t itemSize = mRecastMeshSize + mPreparedNavMeshDataSize;
+
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        cache.set(anotherAgentBounds, mTilePosition, mRecastMesh, makePeparedNavMeshData(3));
+
+        const NavMeshTilesCache::Stats stats = cache.getStats();
+        EXPECT_EQ(stats.mNavMeshCacheSize, 2 * itemSize);
+        EXPECT_EQ(stats.mAgentsNavMeshCacheSize, (std::map<AgentBounds, std::size_t> {
+            {mAgentBounds, itemSize},
+            {anotherAgentBounds, itemSize},
+        }));
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, removed_item_should_be_subtracted_from_agent_cache_size)
+    {
+        const std::size_t maxSize = mRecastMeshWithWaterSize + mPreparedNavMeshDataSize;
+        NavMeshTilesCache cache(maxSize);
+        const AgentBounds anotherAgentBounds {CollisionShapeType::Cylinder, {1, 2, 3}};
+        const std::vector<CellWater> water(1, CellWater {osg::Vec2i(), Water {1, 0.0f}});
+        const RecastMesh anotherRecastMesh(mGeneration, mRevision, mMesh, water, mHeightfields, mFlatHeightfields, mSources);
+
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        ASSERT_TRUE(cache.set(anotherAgentBounds, mTilePosition, anotherRecastMesh, makePeparedNavMeshData(3)));
+
+        const NavMeshTilesCache::Stats stats = cache.getStats();
+        EXPECT_EQ(stats.mAgentsNavMeshCacheSize, (std::map<AgentBounds, std::size_t> {
+            {anotherAgentBounds, mRecastMeshWithWaterSize + mPreparedNavMeshDataSize},
+        }));
+    }
 }
@@ -0,0 +1,68 @@
+#include <components/detournavigator/playertrajectory.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorPlayerTrajectoryTest : Test
+    {
+        const std::chrono::steady_clock::time_point mStart = std::chrono::steady_clock::now();
+        PlayerTrajectory mTrajectory {std::chrono::milliseconds(2000)};
+    };
+
+    TEST_F(DetourNavigatorPlayerTrajectoryTest, predicted_tile_without_movement_should_be_current)
+    {
+        mTrajectory.update(TilePosition(1, 2), mStart);
+        EXPECT_EQ(mTrajectory.getPredictedTile(mStart), TilePosition(1, 2));
+    }
+
+    TEST_F(DetourNavigatorPlayerTrajectoryTest, predicted_tile_should_follow_movement)
+    {
+        mTrajectory.update(TilePosition(0, 0), mStart);
+        mTrajectory.update(TilePosition(1, 0), mStart + std::chrono::seconds(1));
+        mTrajectory.update(TilePosition(2, 0), mStart + std::chrono::seconds(2));
+        EXPECT_EQ(mTrajectory.getVelocity(), osg::Vec2f(1, 0));
+        EXPECT_EQ(mTrajectory.getPredictedTile(mStart + std::chrono::seconds(2)), TilePosition(4, 0));
+    }
+
+    TEST_F(DetourNavigatorPlayerTrajectoryTest, predicted_distance_should_be_limited)
+    {
+        mTrajectory.update(TilePosition(0, 0), mStart);
+        mTrajectory.update(TilePosition(0, 1), mStart + std::chrono::milliseconds(100));
+        EXPECT_EQ(mTrajectory.getPredictedTile(mStart + std::chrono::milliseconds(100)), TilePosition(0, 5));
+    }
+
+    TEST_F(DetourNavigatorPlayerTrajectoryTest, predicted_tile_after_stop_should_be_current)
+    {
+        mTrajectory.update(TilePosition(0, 0), mStart);
+        mTrajectory.update(TilePosition(1, 0), mStart + std::chrono::seconds(1));
+        EXPECT_EQ(mTrajectory.getPredictedTile(mStart + std::chrono::seconds(4)), TilePosition(1, 0));
+    }
+
+    TEST_F(DetourNavigatorPlayerTrajectoryTest, teleport_should_reset_velocity)
+    {
+        mTrajectory.update(TilePosition(0, 0), mStart);
+        mTrajectory.update(TilePosition(1, 0), mStart + std::chrono::seconds(1));
+        mTrajectory.update(TilePosition(10, 10), mStart + std::chrono::seconds(2));
+        EXPECT_EQ(mTrajectory.getVelocity(), osg::Vec2f(0, 0));
+        EXPECT_EQ(mTrajectory.getPredictedTile(mStart + std::chrono::seconds(2)), TilePosition(10, 10));
+    }
+
+    TEST_F(DetourNavigatorPlayerTrajectoryTest, long_pause_should_reset_velocity)
+    {
+        mTrajectory.update(TilePosition(0, 0), mStart);
+        mTrajectory.update(TilePosition(1, 0), mStart + std::chrono::seconds(10));
+        EXPECT_EQ(mTrajectory.getVelocity(), osg::Vec2f(0, 0));
+    }
+
+    TEST_F(DetourNavigatorPlayerTrajectoryTest, zero_prediction_time_should_disable_prediction)
+    {
+        PlayerTrajectory trajectory(std::chrono::milliseconds(0));
+        trajectory.update(TilePosition(0, 0), mStart);
+        trajectory.update(TilePosition(1, 0), mStart + std::chrono::seconds(1));
+        EXPECT_EQ(trajectory.getPredictedTile(mStart + std::chrono::seconds(1)), TilePosition(1, 0));
+    }
+}
@@ -48,6 +48,12 @@ namespace DetourNavigator
         };
         return tie(lhs) == tie(rhs);
     }
+
+    static inline bool operator==(const Obstacle& lhs, const Obstacle& rhs)
+    {
+        const auto tie = [] (const Obstacle& v) { return std::tie(v.mMin, v.mMax); };
+        return tie(lhs) == tie(rhs);
+    }
 }
 
 namespace
@@ -568,4 +574,21 @@ namespace
         expected.mMinY = 1;
         EXPECT_EQ(recastMesh->getHeightfields(), std::vector<Heightfield>({expected}));
     }
+
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, add_obstacle_should_add_obstacle)
+    {
+        RecastMeshBuilder builder(mBounds);
+        builder.addObstacle(Obstacle {osg::Vec3f(-1, -2, -3), osg::Vec3f(1, 2, 3)});
+        const auto recastMesh = std::move(builder).create(mGeneration, mRevision);
+        EXPECT_EQ(recastMesh->getObstacles(), std::vector<Obstacle>({Obstacle {osg::Vec3f(-1, -2, -3), osg::Vec3f(1, 2, 3)}}));
+    }
+
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, add_obstacle_should_not_change_hash)
+    {
+        RecastMeshBuilder builder(mBounds);
+        builder.addObstacle(Obstacle {osg::Vec3f(-1, -2, -3), osg::Vec3f(1, 2, 3)});
+        const auto withObstacle = std::move(builder).create(mGeneration, mRevision);
+        const auto withoutObstacle = RecastMeshBuilder(mBounds).create(mGeneration, mRevision);
+        EXPECT_EQ(withObstacle->getHash(), withoutObstacle->getHash());
+    }
 }
@@ -4,6 +4,8 @@
 #include <components/detournavigator/settingsutils.hpp>
 
 #include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -13,6 +15,25 @@ namespace
     using namespace testing;
     using namespace DetourNavigator;
 
+    // Side faces of a box without top and bottom, nothing to walk on
+    void addWalls(btTriangleMesh& mesh, const btVector3& halfExtents)
+    {
+        const btVector3 corners[] = {
+            btVector3(-halfExtents.x(), -halfExtents.y(), 0),
+            btVector3(halfExtents.x(), -halfExtents.y(), 0),
+            btVector3(halfExtents.x(), halfExtents.y(), 0),
+            btVector3(-halfExtents.x(), halfExtents.y(), 0),
+        };
+        const btVector3 height(0, 0, halfExtents.z() * 2);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            const btVector3& a = corners[i];
+            const btVector3& b = corners[(i + 1) % 4];
+            mesh.addTriangle(a, b, b + height);
+            mesh.addTriangle(a, b + height, a + height);
+        }
+    }
+
     struct DetourNavigatorTileCachedRecastMeshManagerTest : Test
     {
         RecastSettings mSettings;
@@ -187,6 +208,88 @@ namespace
         EXPECT_NE(manager.getMesh("worldspace", TilePosition(0, 0)), nullptr);
     }
 
+    TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, get_mesh_for_moved_object_with_enabled_obstacles_should_return_recast_mesh_with_obstacle)
+    {
+        mSettings.mEnableObstacles = true;
+        mSettings.mMaxSlope = 49;
+        TileCachedRecastMeshManager manager(mSettings);
+        TileBounds bounds;
+        bounds.mMin = osg::Vec2f(-1000, -1000);
+        bounds.mMax = osg::Vec2f(1000, 1000);
+        manager.setBounds(bounds);
+        manager.setWorldspace("worldspace");
+
+        btTriangleMesh mesh;
+        addWalls(mesh, btVector3(20, 20, 100));
+        const btBvhTriangleMeshShape wallsShape(&mesh, true);
+        const btTransform transform(btMatrix3x3::getIdentity(), btVector3(getTileSize(mSettings) / mSettings.mRecastScaleFactor, 0, 0));
+        const CollisionShape shape(mInstance, wallsShape, mObjectTransform);
+
+        manager.addObject(ObjectId(&wallsShape), shape, transform, AreaType::AreaType_ground, [] (auto) {});
+        const auto added = manager.getMesh("worldspace", TilePosition(0, 0));
+        ASSERT_NE(added, nullptr);
+        EXPECT_FALSE(added->getMesh().getIndices().empty());
+        EXPECT_TRUE(added->getObstacles().empty());
+
+        manager.updateObject(ObjectId(&wallsShape), shape, btTransform::getIdentity(), AreaType::AreaType_ground, [] (auto, auto) {});
+        const auto moved = manager.getMesh("worldspace", TilePosition(0, 0));
+        ASSERT_NE(moved, nullptr);
+        EXPECT_TRUE(moved->getMesh().getIndices().empty());
+        ASSERT_EQ(moved->getObstacles().size(), 1);
+        EXPECT_LE(moved->getObstacles()[0].mMin.x(), -20);
+        EXPECT_LE(moved->getObstacles()[0].mMin.y(), -20);
+        EXPECT_GE(moved->getObstacles()[0].mMax.x(), 20);
+        EXPECT_GE(moved->getObstacles()[0].mMax.y(), 20);
+    }
+
+    TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, get_mesh_for_moved_object_with_walkable_top_should_return_recast_mesh_without_obstacle)
+    {
+        mSettings.mEnableObstacles = true;
+        mSettings.mMaxSlope = 49;
+        TileCachedRecastMeshManager manager(mSettings);
+        TileBounds bounds;
+        bounds.mMin = osg::Vec2f(-1000, -1000);
+        bounds.mMax = osg::Vec2f(1000, 1000);
+        manager.setBounds(bounds);
+        manager.setWorldspace("worldspace");
+
+        const btBoxShape boxShape(btVector3(20, 20, 100));
+        const btTransform transform(btMatrix3x3::getIdentity(), btVector3(getTileSize(mSettings) / mSettings.mRecastScaleFactor, 0, 0));
+        const CollisionShape shape(mInstance, boxShape, mObjectTransform);
+
+        manager.addObject(ObjectId(&boxShape), shape, transform, AreaType::AreaType_ground, [] (auto) {});
+        manager.updateObject(ObjectId(&boxShape), shape, btTransform::getIdentity(), AreaType::AreaType_ground, [] (auto, auto) {});
+        const auto moved = manager.getMesh("worldspace", TilePosition(0, 0));
+        ASSERT_NE(moved, nullptr);
+        EXPECT_FALSE(moved->getMesh().getIndices().empty());
+        EXPECT_TRUE(moved->getObstacles().empty());
+    }
+
+    TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, get_mesh_for_moved_object_not_allowed_to_be_obstacle_should_return_recast_mesh_without_obstacle)
+    {
+        mSettings.mEnableObstacles = true;
+        mSettings.mMaxSlope = 49;
+        TileCachedRecastMeshManager manager(mSettings);
+        TileBounds bounds;
+        bounds.mMin = osg::Vec2f(-1000, -1000);
+        bounds.mMax = osg::Vec2f(1000, 1000);
+        manager.setBounds(bounds);
+        manager.setWorldspace("worldspace");
+
+        btTriangleMesh mesh;
+        addWalls(mesh, btVector3(20, 20, 100));
+        const btBvhTriangleMeshShape wallsShape(&mesh, true);
+        const btTransform transform(btMatrix3x3::getIdentity(), btVector3(getTileSize(mSettings) / mSettings.mRecastScaleFactor, 0, 0));
+        const CollisionShape shape(mInstance, wallsShape, mObjectTransform, false);
+
+        manager.addObject(ObjectId(&wallsShape), shape, transform, AreaType::AreaType_ground, [] (auto) {});
+        manager.updateObject(ObjectId(&wallsShape), shape, btTransform::getIdentity(), AreaType::AreaType_ground, [] (auto, auto) {});
+        const auto moved = manager.getMesh("worldspace", TilePosition(0, 0));
+        ASSERT_NE(moved, nullptr);
+        EXPECT_FALSE(moved->getMesh().getIndices().empty());
+        EXPECT_TRUE(moved->getObstacles().empty());
+    }
+
     TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, get_mesh_for_moved_object_should_return_nullptr_for_unused_tile)
     {
         TileCachedRecastMeshManager manager(mSettings);
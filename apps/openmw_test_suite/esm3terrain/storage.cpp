@@ -0,0 +1,298 @@
+#include <components/esm3/loadland.hpp>
+#include <components/esm3/loadltex.hpp>
+#include <components/esm3terrain/storage.hpp>
+#include <components/misc/constants.hpp>
+
+#include <osg/Vec3f>
+#include <osg/Vec4ub>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+
+    constexpr int sLandSize = ESM::Land::LAND_SIZE;
+
+    class TestStorage final : public ESMTerrain::Storage
+    {
+    public:
+        TestStorage()
+            : ESMTerrain::Storage(nullptr)
+        {
+            std::minstd_rand random;
+            std::uniform_real_distribution<float> heights(-1024.0f, 4096.0f);
+            std::uniform_int_distribution<int> normals(-127, 127);
+            std::uniform_int_distribution<int> colours(0, 255);
+
+            for (int x = -1; x < 3; ++x)
+            {
+                for (int y = -1; y < 3; ++y)
+                {
+                    // Leave a hole in the world, and cells lacking normals or colours
+                    if (x == 2 && y == 0)
+                        continue;
+                    int dataTypes = ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML | ESM::Land::DATA_VCLR;
+                    if (x == 0 && y == 2)
+                        dataTypes &= ~ESM::Land::DATA_VNML;
+                    if (x == 1 && y == -1)
+                        dataTypes &= ~(ESM::Land::DATA_VCLR | ESM::Land::DATA_VHGT);
+
+                    auto land = std::make_unique<ESM::Land>();
+                    land->blank();
+                    ESM::Land::LandData& data = *land->getLandData();
+                    for (float& height : data.mHeights)
+                        height = heights(random);
+                    // Corner normals may point downwards in vanilla data as well
+                    for (signed char& normal : data.mNormals)
+                        normal = static_cast<signed char>(normals(random));
+                    for (unsigned char& colour : data.mColours)
+                        colour = static_cast<unsigned char>(colours(random));
+                    data.mDataLoaded = dataTypes;
+                    land->mDataTypes = dataTypes;
+
+                    mLandObjects.emplace(std::make_pair(x, y), new ESMTerrain::LandObject(land.get(), dataTypes));
+                    mLands.push_back(std::move(land));
+                }
+            }
+        }
+
+        osg::ref_ptr<const ESMTerrain::LandObject> getLand(int cellX, int cellY) override
+        {
+            const auto it = mLandObjects.find(std::make_pair(cellX, cellY));
+            if (it == mLandObjects.end())
+                return nullptr;
+            return it->second;
+        }
+
+        const ESM::LandTexture* getLandTexture(int /*index*/, short /*plugin*/) override
+        {
+            return nullptr;
+        }
+
+        void getBounds(float& minX, float& maxX, float& minY, float& maxY) override
+        {
+            minX = -1;
+            minY = -1;
+            maxX = 3;
+            maxY = 3;
+        }
+
+    private:
+        std::vector<std::unique_ptr<ESM::Land>> mLands;
+        std::map<std::pair<int, int>, osg::ref_ptr<const ESMTerrain::LandObject>> mLandObjects;
+    };
+
+    // The straightforward per vertex implementation fillVertexBuffers used to have, kept as a reference
+
+    const ESM::Land::LandData* getData(TestStorage& storage, int cellX, int cellY, int dataType)
+    {
+        const osg::ref_ptr<const ESMTerrain::LandObject> land = storage.getLand(cellX, cellY);
+        return land ? land->getData(dataType) : nullptr;
+    }
+
+    osg::Vec3f getNormal(TestStorage& storage, int cellX, int cellY, int col, int row)
+    {
+        while (col >= sLandSize - 1)
+        {
+            ++cellY;
+            col -= sLandSize - 1;
+        }
+        while (row >= sLandSize - 1)
+        {
+            ++cellX;
+            row -= sLandSize - 1;
+        }
+        while (col < 0)
+        {
+            --cellY;
+            col += sLandSize - 1;
+        }
+        while (row < 0)
+        {
+            --cellX;
+            row += sLandSize - 1;
+        }
+
+        const ESM::Land::LandData* data = getData(storage, cellX, cellY, ESM::Land::DATA_VNML);
+        if (data == nullptr)
+            return osg::Vec3f(0, 0, 1);
+        osg::Vec3f normal(data->mNormals[col * sLandSize * 3 + row * 3], data->mNormals[col * sLandSize * 3 + row * 3 + 1],
+            data->mNormals[col * sLandSize * 3 + row * 3 + 2]);
+        normal.normalize();
+        return normal;
+    }
+
+    osg::Vec3f getAverageNormal(TestStorage& storage, int cellX, int cellY, int col, int row)
+    {
+        osg::Vec3f normal = getNormal(storage, cellX, cellY, col + 1, row) + getNormal(storage, cellX, cellY, col - 1, row)
+            + getNormal(storage, cellX, cellY, col, row + 1) + getNormal(storage, cellX, cellY, col, row - 1);
+        normal.normalize();
+        return normal;
+    }
+
+    osg::Vec4ub getColour(TestStorage& storage, int cellX, int cellY, int col, int row)
+    {
+        if (col == sLandSize - 1)
+        {
+            ++cellY;
+            col = 0;
+        }
+        if (row == sLandSize - 1)
+        {
+            ++cellX;
+            row = 0;
+        }
+
+        const ESM::Land::LandData* data = getData(storage, cellX, cellY, ESM::Land::DATA_VCLR);
+        if (data == nullptr)
+            return osg::Vec4ub(255, 255, 255, 255);
+        return osg::Vec4ub(data->mColours[col * sLandSize * 3 + row * 3], data->mColours[col * sLandSize * 3 + row * 3 + 1],
+            data->mColours[col * sLandSize * 3 + row * 3 + 2], 255);
+    }
+
+    void fillVertexBuffersReference(TestStorage& storage, int lodLevel, float size, const osg::Vec2f& center,
+        osg::Vec3Array& positions, osg::Vec3Array& normals, osg::Vec4ubArray& colours)
+    {
+        const int increment = 1 << lodLevel;
+        const osg::Vec2f origin = center - osg::Vec2f(size / 2.f, size / 2.f);
+        const int startCellX = static_cast<int>(std::floor(origin.x()));
+        const int startCellY = static_cast<int>(std::floor(origin.y()));
+        const std::size_t numVerts = static_cast<std::size_t>(size * (sLandSize - 1) / increment + 1);
+
+        positions.resize(numVerts * numVerts);
+        normals.resize(numVerts * numVerts);
+        colours.resize(numVerts * numVerts);
+
+        float vertY = 0;
+        float vertX = 0;
+        float cellVertY = 0;
+        for (int cellY = startCellY; cellY < startCellY + std::ceil(size); ++cellY)
+        {
+            float cellVertX = 0;
+            for (int cellX = startCellX; cellX < startCellX + std::ceil(size); ++cellX)
+            {
+                const ESM::Land::LandData* heightData = getData(storage, cellX, cellY, ESM::Land::DATA_VHGT);
+                const ESM::Land::LandData* normalData = getData(storage, cellX, cellY, ESM::Land::DATA_VNML);
+                const ESM::Land::LandData* colourData = getData(storage, cellX, cellY, ESM::Land::DATA_VCLR);
+
+                // The first row and column are contained in the previous cell already, unless at the chunk edge
+                int rowStart = cellVertX != 0 ? increment : 0;
+                int colStart = cellVertY != 0 ? increment : 0;
+                rowStart += (origin.x() - startCellX) * sLandSize;
+                colStart += (origin.y() - startCellY) * sLandSize;
+                const int rowEnd = std::min(static_cast<int>(rowStart + std::min(1.f, size) * (sLandSize - 1) + 1), sLandSize);
+                const int colEnd = std::min(static_cast<int>(colStart + std::min(1.f, size) * (sLandSize - 1) + 1), sLandSize);
+
+                vertY = cellVertY;
+                for (int col = colStart; col < colEnd; col += increment)
+                {
+                    vertX = cellVertX;
+                    for (int row = rowStart; row < rowEnd; row += increment)
+                    {
+                        const int srcArrayIndex = col * sLandSize * 3 + row * 3;
+                        const std::size_t index = static_cast<std::size_t>(vertX * numVerts + vertY);
+
+                        const float height = heightData != nullptr ? heightData->mHeights[col * sLandSize + row] : ESM::Land::DEFAULT_HEIGHT;
+                        positions[index] = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
+                            (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits, height);
+
+                        osg::Vec3f normal(0, 0, 1);
+                        if (normalData != nullptr)
+                        {
+                            for (int i = 0; i < 3; ++i)
+                                normal[i] = normalData->mNormals[srcArrayIndex + i];
+                            normal.normalize();
+                        }
+                        if (col == sLandSize - 1 || row == sLandSize - 1)
+                            normal = getNormal(storage, cellX, cellY, col, row);
+                        if ((row == 0 || row == sLandSize - 1) && (col == 0 || col == sLandSize - 1))
+                            normal = getAverageNormal(storage, cellX, cellY, col, row);
+                        normals[index] = normal;
+
+                        osg::Vec4ub colour(255, 255, 255, 255);
+                        if (colourData != nullptr)
+                        {
+                            for (int i = 0; i < 3; ++i)
+                                colour[i] = colourData->mColours[srcArrayIndex + i];
+                        }
+                        if (col == sLandSize - 1 || row == sLandSize - 1)
+                            colour = getColour(storage, cellX, cellY, col, row);
+                        colours[index] = colour;
+
+                        ++vertX;
+                    }
+                    ++vertY;
+                }
+                cellVertX = vertX;
+            }
+            cellVertY = vertY;
+        }
+    }
+
+    struct ESM3TerrainStorageFillVertexBuffersTest : TestWithParam<std::tuple<float, int>>
+    {
+        TestStorage mStorage;
+    };
+
+    TEST_P(ESM3TerrainStorageFillVertexBuffersTest, should_match_reference_implementation)
+    {
+        const float size = std::get<0>(GetParam());
+        const int lodLevel = std::get<1>(GetParam());
+
+        // Chunks covering every cell of the world, so borders with missing cells and data are included
+        for (float y = -1 + size / 2; y < 3; y += size)
+        {
+            for (float x = -1 + size / 2; x < 3; x += size)
+            {
+                const osg::Vec2f center(x, y);
+                osg::ref_ptr<osg::Vec3Array> positions(new osg::Vec3Array);
+                osg::ref_ptr<osg::Vec3Array> normals(new osg::Vec3Array);
+                osg::ref_ptr<osg::Vec4ubArray> colours(new osg::Vec4ubArray);
+                mStorage.fillVertexBuffers(lodLevel, size, center, positions, normals, colours);
+
+                osg::Vec3Array expectedPositions;
+                osg::Vec3Array expectedNormals;
+                osg::Vec4ubArray expectedColours;
+                fillVertexBuffersReference(mStorage, lodLevel, size, center, expectedPositions, expectedNormals, expectedColours);
+
+                ASSERT_EQ(positions->size(), expectedPositions.size());
+                ASSERT_EQ(normals->size(), expectedNormals.size());
+                ASSERT_EQ(colours->size(), expectedColours.size());
+                for (std::size_t i = 0; i < expectedPositions.size(); ++i)
+                {
+                    SCOPED_TRACE("center " + std::to_string(x) + ", " + std::to_string(y) + " vertex " + std::to_string(i));
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        EXPECT_EQ((*positions)[i][j], expectedPositions[i][j]);
+                        EXPECT_FLOAT_EQ((*normals)[i][j], expectedNormals[i][j]);
+                    }
+                    for (int j = 0; j < 4; ++j)
+                        EXPECT_EQ((*colours)[i][j], expectedColours[i][j]);
+                }
+            }
+        }
+    }
+
+    std::vector<std::tuple<float, int>> getChunkSizesAndLods()
+    {
+        std::vector<std::tuple<float, int>> result;
+        for (float size : {0.25f, 0.5f, 1.0f, 2.0f, 4.0f})
+            // Every LOD level that still has a vertex per cell corner and at least one quad per chunk side
+            for (int lodLevel = 0; (1 << lodLevel) <= std::min(size, 1.0f) * (sLandSize - 1); ++lodLevel)
+                result.emplace_back(size, lodLevel);
+        return result;
+    }
+
+    INSTANTIATE_TEST_SUITE_P(ChunkSizesAndLods, ESM3TerrainStorageFillVertexBuffersTest, ValuesIn(getChunkSizesAndLods()));
+}
@@ -0,0 +1,118 @@
+#include <components/files/compressedstream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    using namespace testing;
+    using namespace Files;
+
+    std::string makeData(std::size_t size)
+    {
+        std::string result(size, '\0');
+        for (std::size_t i = 0; i < size; ++i)
+            result[i] = static_cast<char>('a' + (i * 7 + i / 13) % 26);
+        return result;
+    }
+
+    std::string compress(const std::string& data, std::size_t frameSize)
+    {
+        std::ostringstream stream;
+        writeCompressedStream(stream, data, frameSize);
+        return stream.str();
+    }
+
+    IStreamPtr open(const std::string& data)
+    {
+        return openCompressedStream(std::make_unique<std::istringstream>(data));
+    }
+
+    std::string readAll(std::istream& stream)
+    {
+        std::ostringstream result;
+        result << stream.rdbuf();
+        return result.str();
+    }
+
+    TEST(FilesCompressedStreamTest, isCompressedStreamShouldDetectMagic)
+    {
+        std::istringstream compressed(compress("data", 16));
+        EXPECT_TRUE(isCompressedStream(compressed));
+        EXPECT_EQ(compressed.tellg(), 0);
+        std::istringstream plain("TES3");
+        EXPECT_FALSE(isCompressedStream(plain));
+        std::istringstream empty;
+        EXPECT_FALSE(isCompressedStream(empty));
+        EXPECT_TRUE(empty.good());
+    }
+
+    TEST(FilesCompressedStreamTest, openCompressedStreamShouldReturnUncompressedStreamAsIs)
+    {
+        const IStreamPtr stream = open("TES3 data");
+        EXPECT_EQ(readAll(*stream), "TES3 data");
+    }
+
+    TEST(FilesCompressedStreamTest, shouldReadEmptyData)
+    {
+        const IStreamPtr stream = open(compress("", 16));
+        EXPECT_EQ(stream->peek(), std::char_traits<char>::eof());
+    }
+
+    TEST(FilesCompressedStreamTest, shouldReadDataSplitIntoFrames)
+    {
+        const std::string data = makeData(1000);
+        const std::string compressed = compress(data, 64);
+        EXPECT_LT(compressed.size(), data.size());
+        const IStreamPtr stream = open(compressed);
+        EXPECT_EQ(readAll(*stream), data);
+    }
+
+    TEST(FilesCompressedStreamTest, shouldReportUncompressedSizeAndPosition)
+    {
+        const std::string data = makeData(1000);
+        const IStreamPtr stream = open(compress(data, 64));
+        stream->seekg(0, std::ios_base::end);
+        EXPECT_EQ(stream->tellg(), 1000);
+        stream->seekg(0, std::ios_base::beg);
+        char buffer[100];
+        stream->read(buffer, sizeof(buffer));
+        EXPECT_EQ(stream->tellg(), 100);
+        EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(0, sizeof(buffer)));
+    }
+
+    TEST(FilesCompressedStreamTest, shouldSeekForwardAndBackward)
+    {
+        const std::string data = makeData(1000);
+        const IStreamPtr stream = open(compress(data, 64));
+        for (const std::streamoff position : {700, 710, 100, 999, 0, 64, 63})
+        {
+            stream->seekg(position);
+            EXPECT_EQ(stream->get(), data[static_cast<std::size_t>(position)]) << position;
+            EXPECT_EQ(stream->tellg(), position + 1) << position;
+        }
+        stream->seekg(-10, std::ios_base::cur);
+        EXPECT_EQ(stream->tellg(), 54);
+        EXPECT_EQ(readAll(*stream), data.substr(54));
+    }
+
+    TEST(FilesCompressedStreamTest, shouldFailToSeekOutOfRange)
+    {
+        const IStreamPtr stream = open(compress(makeData(100), 64));
+        stream->seekg(101);
+        EXPECT_TRUE(stream->fail());
+    }
+
+    TEST(FilesCompressedStreamTest, shouldFailToReadTruncatedData)
+    {
+        const std::string compressed = compress(makeData(1000), 64);
+        const IStreamPtr stream = open(compressed.substr(0, compressed.size() - 10));
+        stream->exceptions(std::ios_base::badbit);
+        std::string data(1000, '\0');
+        EXPECT_THROW(stream->read(data.data(), static_cast<std::streamsize>(data.size())), std::exception);
+    }
+}
@@ -28,4 +28,20 @@ namespace
         const std::vector<std::byte> decompressed = decompress(compressed);
         EXPECT_EQ(decompressed, data);
     }
+
+    TEST(MiscCompressionTest, decompressIsInverseToCompressWithLevel)
+    {
+        std::vector<std::byte> data(1024);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<std::byte>(i % 7);
+        const std::vector<std::byte> compressed = compress(data, 9);
+        EXPECT_LT(compressed.size(), data.size());
+        EXPECT_EQ(decompress(compressed), data);
+    }
+
+    TEST(MiscCompressionTest, decompressForTooSmallDataShouldThrowException)
+    {
+        const std::vector<std::byte> data(2);
+        EXPECT_THROW(decompress(data), std::runtime_error);
+    }
 }
@@ -0,0 +1,112 @@
+#include "apps/openmw/mwdialogue/infoindex.hpp"
+
+#include <components/esm3/loaddial.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWDialogue;
+
+    ESM::DialInfo makeInfo(const std::string& id)
+    {
+        ESM::DialInfo result;
+        result.blank();
+        result.mId = id;
+        return result;
+    }
+
+    std::vector<std::string> getCandidateIds(const InfoIndex& index, const InfoIndex::Speaker& speaker)
+    {
+        std::vector<std::string> result;
+        for (const InfoIndex::Entry* entry : index.getCandidates(speaker))
+            result.push_back(entry->mInfo->mId);
+        return result;
+    }
+
+    struct MWDialogueInfoIndexTest : Test
+    {
+        ESM::Dialogue mDialogue;
+
+        MWDialogueInfoIndexTest()
+        {
+            ESM::DialInfo byActor = makeInfo("actor");
+            byActor.mActor = "Fargoth";
+            ESM::DialInfo byRace = makeInfo("race");
+            byRace.mRace = "Wood Elf";
+            ESM::DialInfo byOtherRace = makeInfo("other race");
+            byOtherRace.mRace = "Nord";
+            ESM::DialInfo byClass = makeInfo("class");
+            byClass.mClass = "Commoner";
+            ESM::DialInfo byFaction = makeInfo("faction");
+            byFaction.mFaction = "Mages Guild";
+            ESM::DialInfo factionLess = makeInfo("factionless");
+            factionLess.mFactionLess = true;
+            ESM::DialInfo generic = makeInfo("generic");
+            generic.mCell = "Seyda Neen";
+
+            mDialogue.mInfo = {byRace, generic, byActor, byOtherRace, byClass, byFaction, factionLess};
+        }
+    };
+
+    TEST_F(MWDialogueInfoIndexTest, getCandidatesShouldKeepInfosMatchingNpcInDialogueOrder)
+    {
+        const InfoIndex index(mDialogue);
+        InfoIndex::Speaker speaker;
+        speaker.mId = "fargoth";
+        speaker.mRace = "wood elf";
+        speaker.mClass = "commoner";
+
+        EXPECT_EQ(getCandidateIds(index, speaker),
+            std::vector<std::string>({"race", "generic", "actor", "class", "factionless"}));
+    }
+
+    TEST_F(MWDialogueInfoIndexTest, getCandidatesShouldMatchNpcFaction)
+    {
+        const InfoIndex index(mDialogue);
+        InfoIndex::Speaker speaker;
+        speaker.mId = "someone";
+        speaker.mRace = "nord";
+        speaker.mFaction = "mages guild";
+
+        EXPECT_EQ(getCandidateIds(index, speaker),
+            std::vector<std::string>({"generic", "other race", "faction", "factionless"}));
+    }
+
+    TEST_F(MWDialogueInfoIndexTest, getCandidatesShouldReturnOnlyActorSpecificInfosForCreature)
+    {
+        const InfoIndex index(mDialogue);
+        InfoIndex::Speaker speaker;
+        speaker.mIsCreature = true;
+        speaker.mId = "fargoth";
+
+        EXPECT_EQ(getCandidateIds(index, speaker), std::vector<std::string>({"actor"}));
+    }
+
+    TEST_F(MWDialogueInfoIndexTest, selectsShouldBeDecoded)
+    {
+        ESM::DialInfo::SelectStruct select;
+        select.mSelectRule = "02AX0LocalVar";
+        select.mValue.setType(ESM::VT_Int);
+        select.mValue.setInteger(3);
+
+        ESM::DialInfo info = makeInfo("info");
+        info.mSelects.push_back(select);
+
+        ESM::Dialogue dialogue;
+        dialogue.mInfo.push_back(info);
+
+        const InfoIndex index(dialogue);
+        const auto candidates = index.getCandidates(InfoIndex::Speaker());
+        ASSERT_EQ(candidates.size(), 1);
+        ASSERT_EQ(candidates[0]->mSelects.size(), 1);
+
+        const SelectWrapper& wrapper = candidates[0]->mSelects[0];
+        EXPECT_EQ(wrapper.getFunction(), SelectWrapper::Function_Global);
+        EXPECT_EQ(wrapper.getType(), SelectWrapper::Type_Numeric);
+        EXPECT_EQ(wrapper.getName(), "localvar");
+        EXPECT_TRUE(wrapper.selectCompare(3));
+        EXPECT_FALSE(wrapper.selectCompare(4));
+    }
+}
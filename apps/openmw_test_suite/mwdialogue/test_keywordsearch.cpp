@@ -134,3 +134,69 @@ TEST_F(KeywordSearchTest, keyword_test_russian_ascii_before)
     EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "Доложить Каю Косадесу");
 }
 
+
+TEST_F(KeywordSearchTest, keyword_test_case_insensitive)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("caius cosades", 1);
+
+    std::string text = "Report to Caius Cosades";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    EXPECT_EQ(matches.size(), 1);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "Caius Cosades");
+    EXPECT_EQ(matches[0].mValue, 1);
+}
+
+TEST_F(KeywordSearchTest, keyword_test_keyword_within_another_keyword)
+{
+    // a keyword contained in a longer, not matching keyword must still be found
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("abcd", 0);
+    search.seed("bc", 0);
+
+    std::string text = "abce";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    EXPECT_EQ(matches.size(), 1);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "bc");
+}
+
+TEST_F(KeywordSearchTest, keyword_test_seed_after_search)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("dwemer", 0);
+
+    std::string text = "the dwemer ruins";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+    EXPECT_EQ(matches.size(), 1);
+
+    search.seed("ruins", 1);
+
+    matches.clear();
+    search.highlightKeywords(text.begin(), text.end(), matches);
+    EXPECT_EQ(matches.size(), 2);
+    EXPECT_EQ(std::string(matches[1].mBeg, matches[1].mEnd), "ruins");
+    EXPECT_EQ(matches[1].mValue, 1);
+}
+
+TEST_F(KeywordSearchTest, keyword_test_contains_keyword)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("dwemer", 1);
+    search.seed("dwemer ruins", 2);
+
+    int value = 0;
+    EXPECT_TRUE(search.containsKeyword("Dwemer", value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(search.containsKeyword("dwemer ruins", value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(search.containsKeyword("dwe", value));
+    EXPECT_FALSE(search.containsKeyword("dwemers", value));
+}
@@ -0,0 +1,84 @@
+#include "apps/openmw/mwrender/groundcoverinstances.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWRender;
+
+    GroundcoverEntry makeEntry(const osg::Vec3f& position, const osg::Vec3f& rotation, float scale)
+    {
+        GroundcoverEntry entry;
+        for (int i = 0; i < 3; ++i)
+        {
+            entry.mPos.pos[i] = position[i];
+            entry.mPos.rot[i] = rotation[i];
+        }
+        entry.mScale = scale;
+        return entry;
+    }
+
+    struct MWRenderGroundcoverInstancesTest : Test
+    {
+        const osg::Vec3f mChunkPosition {8192, -4096, 0};
+        const std::vector<GroundcoverEntry> mEntries {
+            makeEntry(osg::Vec3f(8200, -4000, 10), osg::Vec3f(0, 0, 1.5f), 1),
+            makeEntry(osg::Vec3f(9000, -5000, -20), osg::Vec3f(0.25f, 0, 3), 0.5f),
+        };
+    };
+
+    TEST_F(MWRenderGroundcoverInstancesTest, should_store_positions_relative_to_chunk_with_scale)
+    {
+        const GroundcoverInstances instances = makeGroundcoverInstances(mEntries, mChunkPosition);
+        ASSERT_EQ(instances.mOffsets->size(), 2u);
+        EXPECT_EQ((*instances.mOffsets)[0], osg::Vec4f(8, 96, 10, 1));
+        EXPECT_EQ((*instances.mOffsets)[1], osg::Vec4f(808, -904, -20, 0.5f));
+    }
+
+    TEST_F(MWRenderGroundcoverInstancesTest, should_store_rotations)
+    {
+        const GroundcoverInstances instances = makeGroundcoverInstances(mEntries, mChunkPosition);
+        ASSERT_EQ(instances.mRotations->size(), 2u);
+        EXPECT_EQ((*instances.mRotations)[0], osg::Vec3f(0, 0, 1.5f));
+        EXPECT_EQ((*instances.mRotations)[1], osg::Vec3f(0.25f, 0, 3));
+    }
+
+    TEST_F(MWRenderGroundcoverInstancesTest, arrays_should_have_own_buffer_object)
+    {
+        const GroundcoverInstances instances = makeGroundcoverInstances(mEntries, mChunkPosition);
+        ASSERT_NE(instances.mOffsets->getVertexBufferObject(), nullptr);
+        EXPECT_EQ(instances.mOffsets->getVertexBufferObject(), instances.mRotations->getVertexBufferObject());
+    }
+
+    TEST_F(MWRenderGroundcoverInstancesTest, bound_should_contain_scaled_instances_with_margin)
+    {
+        const GroundcoverInstances instances = makeGroundcoverInstances(mEntries, mChunkPosition);
+        const osg::BoundingBox box = getGroundcoverInstancesBound(instances, 10);
+        EXPECT_FLOAT_EQ(box.xMin(), 8 - 11.0f);
+        EXPECT_FLOAT_EQ(box.xMax(), 808 + 5.5f);
+        EXPECT_FLOAT_EQ(box.yMin(), -904 - 5.5f);
+        EXPECT_FLOAT_EQ(box.yMax(), 96 + 11.0f);
+        EXPECT_FLOAT_EQ(box.zMin(), -20 - 5.5f);
+        EXPECT_FLOAT_EQ(box.zMax(), 10 + 11.0f);
+    }
+
+    TEST_F(MWRenderGroundcoverInstancesTest, bound_of_no_instances_should_be_invalid)
+    {
+        const GroundcoverInstances instances = makeGroundcoverInstances({}, mChunkPosition);
+        EXPECT_FALSE(getGroundcoverInstancesBound(instances, 10).valid());
+    }
+
+    TEST_F(MWRenderGroundcoverInstancesTest, dump_should_write_line_per_instance)
+    {
+        const GroundcoverInstances instances = makeGroundcoverInstances(mEntries, mChunkPosition);
+        std::ostringstream stream;
+        dumpGroundcoverInstances(stream, "meshes/grass.nif", mChunkPosition, instances);
+        EXPECT_EQ(stream.str(),
+            "model meshes/grass.nif chunk 8192 -4096 0 instances 2\n"
+            "  offset 8 96 10 scale 1 rotation 0 0 1.5\n"
+            "  offset 808 -904 -20 scale 0.5 rotation 0.25 0 3\n");
+    }
+}
@@ -0,0 +1,86 @@
+#include "apps/openmw/mwscript/scriptprofiler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <osg/Stats>
+
+#include <sstream>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWScript;
+
+    TEST(MWScriptScriptProfilerTest, getSlowestShouldReturnScriptsOrderedByTotalTime)
+    {
+        ScriptProfiler profiler;
+        profiler.add(profiler.getProfile("fast"), 10, 0.001);
+        profiler.add(profiler.getProfile("slow"), 20, 0.002);
+        profiler.add(profiler.getProfile("slow"), 20, 0.002);
+        profiler.add(profiler.getProfile("medium"), 30, 0.003);
+
+        const auto slowest = profiler.getSlowest(2);
+        ASSERT_EQ(slowest.size(), 2);
+        EXPECT_EQ(slowest[0].first, "slow");
+        EXPECT_EQ(slowest[0].second.mRuns, 2);
+        EXPECT_EQ(slowest[0].second.mInstructions, 40);
+        EXPECT_EQ(slowest[1].first, "medium");
+    }
+
+    TEST(MWScriptScriptProfilerTest, startFrameShouldResetOnlyFrameTotals)
+    {
+        ScriptProfiler profiler;
+        profiler.add(profiler.getProfile("script"), 10, 0.001);
+        profiler.addDeferred("script");
+        EXPECT_EQ(profiler.getFrameProfile().mRuns, 1);
+        EXPECT_EQ(profiler.getFrameProfile().mDeferred, 1);
+
+        profiler.startFrame();
+        EXPECT_EQ(profiler.getFrameProfile().mRuns, 0);
+        EXPECT_EQ(profiler.getFrameProfile().mDeferred, 0);
+        EXPECT_EQ(profiler.getProfile("script").mRuns, 1);
+        EXPECT_EQ(profiler.getProfile("script").mDeferred, 1);
+    }
+
+    TEST(MWScriptScriptProfilerTest, clearShouldKeepProfileReferencesValid)
+    {
+        ScriptProfiler profiler;
+        ScriptProfile& profile = profiler.getProfile("script");
+        profiler.add(profile, 10, 0.001);
+
+        profiler.clear();
+        EXPECT_TRUE(profiler.getSlowest(10).empty());
+
+        profiler.add(profile, 5, 0.001);
+        EXPECT_EQ(profiler.getProfile("script").mInstructions, 5);
+    }
+
+    TEST(MWScriptScriptProfilerTest, writeCsvShouldWriteHeaderAndOneLinePerScript)
+    {
+        ScriptProfiler profiler;
+        profiler.add(profiler.getProfile("script"), 10, 0.5);
+        profiler.addDeferred("script");
+
+        std::ostringstream stream;
+        profiler.writeCsv(stream);
+        EXPECT_EQ(stream.str(), "script,runs,instructions,time_us,deferred\nscript,1,10,500000,1\n");
+    }
+
+    TEST(MWScriptScriptProfilerTest, reportStatsShouldReportFrameTimeInMicrosecondsOnlyWhenTimingIsEnabled)
+    {
+        ScriptProfiler profiler;
+        profiler.add(profiler.getProfile("script"), 10, 0.5);
+        osg::ref_ptr<osg::Stats> stats = new osg::Stats("test");
+        double value = 0;
+
+        profiler.reportStats(0, *stats);
+        EXPECT_TRUE(stats->getAttribute(0, "Script Runs", value));
+        EXPECT_EQ(value, 1);
+        EXPECT_FALSE(stats->getAttribute(0, "Script Time", value));
+
+        profiler.setTimingEnabled(true);
+        profiler.reportStats(0, *stats);
+        EXPECT_TRUE(stats->getAttribute(0, "Script Time", value));
+        EXPECT_EQ(value, 500000);
+    }
+}
@@ -49,6 +49,16 @@ namespace
             mInterpreter.run(&script.mByteCode[0], static_cast<int>(script.mByteCode.size()), context);
         }
 
+        std::vector<Interpreter::Instruction> decode(const CompiledScript& script)
+        {
+            return mInterpreter.decode(&script.mByteCode[0], static_cast<int>(script.mByteCode.size()));
+        }
+
+        void run(const CompiledScript& script, const std::vector<Interpreter::Instruction>& instructions, TestInterpreterContext& context)
+        {
+            mInterpreter.run(&script.mByteCode[0], static_cast<int>(script.mByteCode.size()), instructions, context);
+        }
+
         template<typename T, typename ...TArgs>
         void installOpcode(int code, TArgs&& ...args)
         {
@@ -848,4 +858,42 @@ messagebox,"this is a %g",a
     {
         EXPECT_FALSE(!compile(sIssue6380));
     }
-}
\ No newline at end of file
+
+    TEST_F(MWScriptTest, mwscript_test_decoded)
+    {
+        if(const auto script = compile(sScript3))
+        {
+            const std::vector<Interpreter::Instruction> instructions = decode(*script);
+            TestInterpreterContext context;
+            for(int i = 1; i < 100; ++i)
+            {
+                context.setLocalShort(0, i);
+                run(*script, instructions, context);
+                EXPECT_EQ(context.getLocalShort(1), i + 1);
+                EXPECT_EQ(context.getLocalShort(4), (i + 1) * (i - 1) / i);
+            }
+        }
+        else
+        {
+            FAIL();
+        }
+    }
+
+    TEST_F(MWScriptTest, mwscript_test_unknown_opcode)
+    {
+        registerExtensions();
+        if(const auto script = compile(sIssue6363))
+        {
+            const std::vector<Interpreter::Instruction> instructions = decode(*script);
+            TestInterpreterContext context;
+            context.setLocalShort(0, 0);
+            EXPECT_NO_THROW(run(*script, instructions, context));
+            context.setLocalShort(0, 1);
+            EXPECT_THROW(run(*script, instructions, context), std::runtime_error);
+        }
+        else
+        {
+            FAIL();
+        }
+    }
+}
@@ -0,0 +1,212 @@
+#include "apps/openmw/mwsound/decodedsoundcache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWSound;
+
+    constexpr std::size_t sDecodedSize = 100;
+
+    class StubDecoder
+    {
+    public:
+        DecodedSound decode(const std::string& resourceName)
+        {
+            std::unique_lock lock(mMutex);
+            ++mCalls[resourceName];
+            mThreads[resourceName] = std::this_thread::get_id();
+            mCondition.notify_all();
+            mCondition.wait(lock, [&] { return mBlocked.count(resourceName) == 0; });
+            DecodedSound result;
+            result.mData.resize(sDecodedSize);
+            return result;
+        }
+
+        void block(const std::string& resourceName)
+        {
+            const std::lock_guard lock(mMutex);
+            mBlocked.insert(resourceName);
+        }
+
+        void unblock(const std::string& resourceName)
+        {
+            const std::lock_guard lock(mMutex);
+            mBlocked.erase(resourceName);
+            mCondition.notify_all();
+        }
+
+        void waitStarted(const std::string& resourceName)
+        {
+            std::unique_lock lock(mMutex);
+            mCondition.wait(lock, [&] { return mCalls.count(resourceName) != 0; });
+        }
+
+        std::size_t getCalls(const std::string& resourceName) const
+        {
+            const std::lock_guard lock(mMutex);
+            const auto it = mCalls.find(resourceName);
+            return it == mCalls.end() ? 0 : it->second;
+        }
+
+        std::thread::id getThread(const std::string& resourceName) const
+        {
+            const std::lock_guard lock(mMutex);
+            return mThreads.at(resourceName);
+        }
+
+    private:
+        mutable std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::set<std::string> mBlocked;
+        std::map<std::string, std::size_t> mCalls;
+        std::map<std::string, std::thread::id> mThreads;
+    };
+
+    // Workers report decoded sounds asynchronously, update the cache until it reaches the expected state
+    template <class Predicate>
+    bool updateUntil(DecodedSoundCache& cache, Predicate&& predicate)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (true)
+        {
+            cache.update();
+            if (predicate())
+                return true;
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    struct MWSoundDecodedSoundCacheTest : Test
+    {
+        StubDecoder mDecoder;
+        const DecodedSoundCache::Decode mDecode = [this] (const std::string& resourceName)
+        {
+            return mDecoder.decode(resourceName);
+        };
+    };
+
+    TEST_F(MWSoundDecodedSoundCacheTest, takeShouldDecodeNotPreloadedSoundOnCallingThread)
+    {
+        DecodedSoundCache cache(mDecode, 1000, 1);
+        EXPECT_EQ(cache.take("a").mData.size(), sDecodedSize);
+        EXPECT_EQ(mDecoder.getCalls("a"), 1);
+        EXPECT_EQ(mDecoder.getThread("a"), std::this_thread::get_id());
+    }
+
+    TEST_F(MWSoundDecodedSoundCacheTest, preloadShouldDoNothingWithoutThreads)
+    {
+        DecodedSoundCache cache(mDecode, 1000, 0);
+        cache.preload("a");
+        EXPECT_FALSE(cache.contains("a"));
+        EXPECT_EQ(mDecoder.getCalls("a"), 0);
+    }
+
+    TEST_F(MWSoundDecodedSoundCacheTest, takeShouldDecodeQueuedSoundOnCallingThreadWhenWorkerIsBusy)
+    {
+        {
+            DecodedSoundCache cache(mDecode, 1000, 1);
+            mDecoder.block("a");
+            cache.preload("a");
+            cache.preload("b");
+            mDecoder.waitStarted("a");
+
+            EXPECT_EQ(cache.take("b").mData.size(), sDecodedSize);
+            EXPECT_EQ(mDecoder.getThread("b"), std::this_thread::get_id());
+            EXPECT_FALSE(cache.contains("b"));
+
+            mDecoder.unblock("a");
+            EXPECT_EQ(cache.take("a").mData.size(), sDecodedSize);
+            EXPECT_NE(mDecoder.getThread("a"), std::this_thread::get_id());
+        }
+        // The worker reaching the claimed item must skip it
+        EXPECT_EQ(mDecoder.getCalls("a"), 1);
+        EXPECT_EQ(mDecoder.getCalls("b"), 1);
+    }
+
+    TEST_F(MWSoundDecodedSoundCacheTest, takeShouldWaitForSoundBeingDecodedByWorker)
+    {
+        DecodedSoundCache cache(mDecode, 1000, 1);
+        mDecoder.block("a");
+        cache.preload("a");
+        mDecoder.waitStarted("a");
+
+        std::future<DecodedSound> taken = std::async(std::launch::async, [&] { return cache.take("a"); });
+        EXPECT_EQ(taken.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+
+        mDecoder.unblock("a");
+        EXPECT_EQ(taken.get().mData.size(), sDecodedSize);
+        EXPECT_EQ(mDecoder.getCalls("a"), 1);
+    }
+
+    TEST_F(MWSoundDecodedSoundCacheTest, updateShouldAccountDecodedSounds)
+    {
+        DecodedSoundCache cache(mDecode, 1000, 1);
+        cache.preload("a");
+        cache.preload("b");
+        EXPECT_TRUE(updateUntil(cache, [&] { return cache.getSize() == 2 * sDecodedSize; }));
+        cache.take("a");
+        EXPECT_EQ(cache.getSize(), sDecodedSize);
+        EXPECT_EQ(mDecoder.getCalls("a"), 1);
+    }
+
+    TEST_F(MWSoundDecodedSoundCacheTest, updateShouldEvictLeastRecentlyPreloadedSoundsAboveLimit)
+    {
+        DecodedSoundCache cache(mDecode, 2 * sDecodedSize + sDecodedSize / 2, 1);
+        cache.preload("a");
+        cache.preload("b");
+        cache.preload("c");
+        EXPECT_TRUE(updateUntil(cache, [&] { return !cache.contains("a"); }));
+        EXPECT_TRUE(cache.contains("b"));
+        EXPECT_TRUE(cache.contains("c"));
+        EXPECT_EQ(cache.getSize(), 2 * sDecodedSize);
+    }
+
+    TEST_F(MWSoundDecodedSoundCacheTest, preloadShouldMakePreloadedSoundMostRecent)
+    {
+        DecodedSoundCache cache(mDecode, 2 * sDecodedSize + sDecodedSize / 2, 1);
+        cache.preload("a");
+        cache.preload("b");
+        cache.preload("a");
+        cache.preload("c");
+        EXPECT_TRUE(updateUntil(cache, [&] { return !cache.contains("b"); }));
+        EXPECT_TRUE(cache.contains("a"));
+        EXPECT_TRUE(cache.contains("c"));
+        EXPECT_EQ(mDecoder.getCalls("a"), 1);
+    }
+
+    TEST_F(MWSoundDecodedSoundCacheTest, clearShouldWaitForSoundsBeingDecoded)
+    {
+        {
+            DecodedSoundCache cache(mDecode, 1000, 1);
+            mDecoder.block("a");
+            cache.preload("a");
+            cache.preload("b");
+            mDecoder.waitStarted("a");
+
+            std::future<void> cleared = std::async(std::launch::async, [&] { cache.clear(); });
+            EXPECT_EQ(cleared.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+
+            mDecoder.unblock("a");
+            cleared.get();
+            EXPECT_FALSE(cache.contains("a"));
+            EXPECT_FALSE(cache.contains("b"));
+            EXPECT_EQ(cache.getSize(), 0);
+        }
+        // Not started sounds are dropped without decoding
+        EXPECT_EQ(mDecoder.getCalls("a"), 1);
+        EXPECT_EQ(mDecoder.getCalls("b"), 0);
+    }
+}
@@ -0,0 +1,92 @@
+#include "apps/openmw/mwsound/loudness.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWSound;
+
+    constexpr int sSampleRate = 100;
+    constexpr float sSamplesPerSecond = 10;
+    constexpr std::size_t sSegmentFrames = 10;
+    constexpr float sQuantizationError = 0.5f / std::numeric_limits<std::uint8_t>::max();
+
+    template <class T>
+    std::vector<char> makeData(T value, std::size_t frames)
+    {
+        std::vector<char> result(frames * sizeof(T));
+        for (std::size_t i = 0; i < frames; ++i)
+            std::memcpy(result.data() + i * sizeof(T), &value, sizeof(T));
+        return result;
+    }
+
+    TEST(MWSoundLoudnessTest, getLoudnessAtTimeShouldReturnZeroForNotAnalyzedSound)
+    {
+        const Sound_Loudness loudness(sSamplesPerSecond, sSampleRate, ChannelConfig_Mono, SampleType_Int16);
+        EXPECT_EQ(loudness.getLoudnessAtTime(0), 0);
+        EXPECT_EQ(loudness.getDuration(), 0);
+    }
+
+    TEST(MWSoundLoudnessTest, silenceShouldHaveZeroLoudness)
+    {
+        Sound_Loudness loudness(sSamplesPerSecond, sSampleRate, ChannelConfig_Mono, SampleType_Int16);
+        loudness.analyzeLoudness(makeData<std::int16_t>(0, sSegmentFrames));
+        EXPECT_EQ(loudness.getLoudnessAtTime(0), 0);
+    }
+
+    TEST(MWSoundLoudnessTest, loudnessShouldBeQuantizedToByte)
+    {
+        Sound_Loudness loudness(sSamplesPerSecond, sSampleRate, ChannelConfig_Mono, SampleType_Int16);
+        loudness.analyzeLoudness(makeData<std::int16_t>(16384, sSegmentFrames));
+        // 16384 / 32767 * 255 = 127.5039 is rounded to 128
+        EXPECT_EQ(loudness.getLoudnessAtTime(0), 128 / 255.0f);
+    }
+
+    TEST(MWSoundLoudnessTest, quantizationErrorShouldBeAtMostHalfStep)
+    {
+        for (int i = 0; i <= 1000; ++i)
+        {
+            const float amplitude = i / 1000.0f;
+            Sound_Loudness loudness(sSamplesPerSecond, sSampleRate, ChannelConfig_Mono, SampleType_Float32);
+            loudness.analyzeLoudness(makeData<float>(amplitude, sSegmentFrames));
+            EXPECT_NEAR(loudness.getLoudnessAtTime(0), amplitude, sQuantizationError * 1.001f) << amplitude;
+        }
+    }
+
+    TEST(MWSoundLoudnessTest, loudnessShouldBeClampedToOne)
+    {
+        Sound_Loudness loudness(sSamplesPerSecond, sSampleRate, ChannelConfig_Mono, SampleType_Float32);
+        loudness.analyzeLoudness(makeData<float>(2, sSegmentFrames));
+        EXPECT_EQ(loudness.getLoudnessAtTime(0), 1);
+    }
+
+    TEST(MWSoundLoudnessTest, unsignedBytesShouldBeCenteredAtZero)
+    {
+        Sound_Loudness loudness(sSamplesPerSecond, sSampleRate, ChannelConfig_Mono, SampleType_UInt8);
+        loudness.analyzeLoudness(makeData<std::uint8_t>(0x80, sSegmentFrames));
+        loudness.analyzeLoudness(makeData<std::uint8_t>(0xc0, sSegmentFrames));
+        EXPECT_EQ(loudness.getLoudnessAtTime(0.05f), 0);
+        EXPECT_EQ(loudness.getLoudnessAtTime(0.15f), 128 / 255.0f);
+    }
+
+    TEST(MWSoundLoudnessTest, partialSegmentShouldBeAnalyzedWithNextData)
+    {
+        Sound_Loudness loudness(sSamplesPerSecond, sSampleRate, ChannelConfig_Mono, SampleType_Int16);
+        loudness.analyzeLoudness(makeData<std::int16_t>(0, sSegmentFrames + sSegmentFrames / 2));
+        EXPECT_FLOAT_EQ(loudness.getDuration(), 0.1f);
+        loudness.analyzeLoudness(makeData<std::int16_t>(std::numeric_limits<std::int16_t>::max(), sSegmentFrames / 2));
+        EXPECT_FLOAT_EQ(loudness.getDuration(), 0.2f);
+        EXPECT_EQ(loudness.getLoudnessAtTime(0.05f), 0);
+        // Half of the segment is silent
+        EXPECT_NEAR(loudness.getLoudnessAtTime(0.15f), std::sqrt(0.5f), sQuantizationError);
+        // Time after the analyzed audio gets the last value
+        EXPECT_EQ(loudness.getLoudnessAtTime(1), loudness.getLoudnessAtTime(0.15f));
+    }
+}
@@ -0,0 +1,139 @@
+#include "apps/openmw/mwstate/slotindex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "../testing_util.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWState;
+
+    struct MWStateSlotIndexTest : Test
+    {
+        const boost::filesystem::path mPath = TestingOpenMW::outputFilePath("slots.omwsaveindex");
+
+        void SetUp() override
+        {
+            boost::filesystem::remove(mPath);
+        }
+    };
+
+    ESM::SavedGame makeProfile(const std::string& playerName)
+    {
+        ESM::SavedGame result;
+        result.mPlayerName = playerName;
+        result.mPlayerLevel = 3;
+        result.mPlayerClassId = "warrior";
+        result.mPlayerCell = "Seyda Neen";
+        result.mInGameTime = ESM::EpochTimeStamp {12, 1, 2, 427};
+        result.mTimePlayed = 42;
+        result.mDescription = "Seyda Neen";
+        result.mContentFiles = {"Morrowind.esm"};
+        result.mScreenshot = {'j', 'p', 'g'};
+        return result;
+    }
+
+    TEST_F(MWStateSlotIndexTest, readSlotIndexShouldReturnEmptyIndexForMissingFile)
+    {
+        EXPECT_TRUE(readSlotIndex(mPath).empty());
+    }
+
+    TEST_F(MWStateSlotIndexTest, readSlotIndexShouldReturnWrittenIndex)
+    {
+        SlotIndex index;
+        index["first.omwsave"] = SlotIndexEntry {1234, 1000, 1000000000123, makeProfile("first")};
+        index["second.omwsave"] = SlotIndexEntry {5678, 2000, 2000000000456, makeProfile("second")};
+
+        writeSlotIndex(mPath, index);
+        const SlotIndex result = readSlotIndex(mPath);
+
+        ASSERT_EQ(result.size(), 2);
+        for (const auto& [fileName, entry] : index)
+        {
+            const auto found = result.find(fileName);
+            ASSERT_NE(found, result.end()) << fileName;
+            EXPECT_EQ(found->second.mFileSize, entry.mFileSize);
+            EXPECT_EQ(found->second.mTimeStamp, entry.mTimeStamp);
+            EXPECT_EQ(found->second.mWriteTime, entry.mWriteTime);
+            EXPECT_EQ(found->second.mProfile.mPlayerName, entry.mProfile.mPlayerName);
+            EXPECT_EQ(found->second.mProfile.mPlayerLevel, entry.mProfile.mPlayerLevel);
+            EXPECT_EQ(found->second.mProfile.mPlayerCell, entry.mProfile.mPlayerCell);
+            EXPECT_EQ(found->second.mProfile.mTimePlayed, entry.mProfile.mTimePlayed);
+            EXPECT_EQ(found->second.mProfile.mContentFiles, entry.mProfile.mContentFiles);
+            EXPECT_EQ(found->second.mProfile.mScreenshot, entry.mProfile.mScreenshot);
+        }
+    }
+
+    TEST_F(MWStateSlotIndexTest, writeSlotIndexShouldReplaceExistingIndex)
+    {
+        SlotIndex index;
+        index["first.omwsave"] = SlotIndexEntry {1234, 1000, 1000000000123, makeProfile("first")};
+        writeSlotIndex(mPath, index);
+
+        index.erase("first.omwsave");
+        index["second.omwsave"] = SlotIndexEntry {5678, 2000, 2000000000456, makeProfile("second")};
+        writeSlotIndex(mPath, index);
+
+        const SlotIndex result = readSlotIndex(mPath);
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result.begin()->first, "second.omwsave");
+    }
+
+    TEST_F(MWStateSlotIndexTest, appendSlotIndexShouldCreateMissingFile)
+    {
+        appendSlotIndex(mPath, "first.omwsave", SlotIndexEntry {1234, 1000, 1000000000123, makeProfile("first")});
+
+        const SlotIndex result = readSlotIndex(mPath);
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result.begin()->first, "first.omwsave");
+        EXPECT_EQ(result.begin()->second.mWriteTime, 1000000000123);
+    }
+
+    TEST_F(MWStateSlotIndexTest, appendSlotIndexShouldAddAndReplaceEntries)
+    {
+        SlotIndex index;
+        index["first.omwsave"] = SlotIndexEntry {1234, 1000, 1000000000123, makeProfile("first")};
+        index["second.omwsave"] = SlotIndexEntry {5678, 2000, 2000000000456, makeProfile("second")};
+        writeSlotIndex(mPath, index);
+
+        appendSlotIndex(mPath, "first.omwsave", SlotIndexEntry {4321, 3000, 3000000000789, makeProfile("replaced")});
+        appendSlotIndex(mPath, "third.omwsave", SlotIndexEntry {8765, 4000, 4000000000000, makeProfile("third")});
+
+        std::size_t recordCount = 0;
+        const SlotIndex result = readSlotIndex(mPath, &recordCount);
+        EXPECT_EQ(recordCount, 4);
+        ASSERT_EQ(result.size(), 3);
+        EXPECT_EQ(result.at("first.omwsave").mFileSize, 4321);
+        EXPECT_EQ(result.at("first.omwsave").mWriteTime, 3000000000789);
+        EXPECT_EQ(result.at("first.omwsave").mProfile.mPlayerName, "replaced");
+        EXPECT_EQ(result.at("second.omwsave").mProfile.mPlayerName, "second");
+        EXPECT_EQ(result.at("third.omwsave").mProfile.mPlayerName, "third");
+    }
+
+    TEST_F(MWStateSlotIndexTest, removeFromSlotIndexShouldRemoveEntry)
+    {
+        SlotIndex index;
+        index["first.omwsave"] = SlotIndexEntry {1234, 1000, 1000000000123, makeProfile("first")};
+        index["second.omwsave"] = SlotIndexEntry {5678, 2000, 2000000000456, makeProfile("second")};
+        writeSlotIndex(mPath, index);
+
+        removeFromSlotIndex(mPath, "first.omwsave");
+
+        std::size_t recordCount = 0;
+        const SlotIndex result = readSlotIndex(mPath, &recordCount);
+        EXPECT_EQ(recordCount, 3);
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result.begin()->first, "second.omwsave");
+    }
+
+    TEST_F(MWStateSlotIndexTest, isCurrentShouldCompareSubsecondWriteTime)
+    {
+        const SlotIndexEntry entry {1234, 1000, 1000000000123, makeProfile("first")};
+        EXPECT_TRUE(isCurrent(entry, 1234, 1000, 1000000000123));
+        EXPECT_FALSE(isCurrent(entry, 1234, 1000, 1000000000124));
+        EXPECT_FALSE(isCurrent(entry, 1235, 1000, 1000000000123));
+    }
+}
@@ -0,0 +1,180 @@
+#include <components/sceneutil/occlusionculling.hpp>
+
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct SceneUtilOcclusionBufferTest : Test
+    {
+        OcclusionBuffer mBuffer {64, 64};
+        // Looking along +Y with Z up
+        const osg::Matrixf mViewProjection = osg::Matrixf::lookAt(osg::Vec3f(0, 0, 0), osg::Vec3f(0, 1, 0), osg::Vec3f(0, 0, 1))
+            * osg::Matrixf::perspective(90, 1, 1, 10000);
+
+        // Quad at y = 100 covering x and z in [-50, 50], that is the central half of the screen
+        const std::vector<osg::Vec3f> mWall {
+            osg::Vec3f(-50, 100, -50), osg::Vec3f(50, 100, -50), osg::Vec3f(50, 100, 50),
+            osg::Vec3f(-50, 100, -50), osg::Vec3f(50, 100, 50), osg::Vec3f(-50, 100, 50),
+        };
+
+        static osg::BoundingBox makeBox(const osg::Vec3f& center, float halfSize)
+        {
+            const osg::Vec3f extents(halfSize, halfSize, halfSize);
+            return osg::BoundingBox(center - extents, center + extents);
+        }
+    };
+
+    TEST_F(SceneUtilOcclusionBufferTest, emptyBufferShouldNotOccludeAnything)
+    {
+        mBuffer.clear(mViewProjection);
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 200, 0), 10)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxBehindOccluderShouldBeOccluded)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), mWall, OcclusionBuffer::findAdjacentVertices(mWall));
+        EXPECT_EQ(mBuffer.getNumRasterizedTriangles(), 2u);
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 200, 0), 10)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxInFrontOfOccluderShouldNotBeOccluded)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), mWall, OcclusionBuffer::findAdjacentVertices(mWall));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 50, 0), 10)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxIntersectingOccluderShouldNotBeOccluded)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), mWall, OcclusionBuffer::findAdjacentVertices(mWall));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 100, 0), 10)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxPartiallyBehindOccluderEdgeShouldNotBeOccluded)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), mWall, OcclusionBuffer::findAdjacentVertices(mWall));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(100, 200, 0), 20)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxBehindEyeShouldNotBeOccluded)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), mWall, OcclusionBuffer::findAdjacentVertices(mWall));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, -200, 0), 10)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, occluderShouldBeTransformedByGivenMatrix)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf::translate(1000, 0, 0), mWall, OcclusionBuffer::findAdjacentVertices(mWall));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 200, 0), 10)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, trianglesCrossingNearPlaneShouldBeSkipped)
+    {
+        mBuffer.clear(mViewProjection);
+        const std::vector<osg::Vec3f> triangle {osg::Vec3f(-200, -10, -200), osg::Vec3f(200, 100, -200), osg::Vec3f(0, 100, 200)};
+        mBuffer.rasterizeTriangles(osg::Matrixf(), triangle, {});
+        EXPECT_EQ(mBuffer.getNumRasterizedTriangles(), 0u);
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, findAdjacentVerticesShouldReturnOppositeVertexOfSharedEdge)
+    {
+        EXPECT_EQ(OcclusionBuffer::findAdjacentVertices(mWall), std::vector<int>({-1, 5, -1, -1, -1, 1}));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, partiallyCoveredPixelsShouldStayEmpty)
+    {
+        // Shifted by half a pixel, so wall edges cross pixel columns 16 and 48 in the middle
+        const float shift = 100.f / 64;
+        std::vector<osg::Vec3f> wall;
+        for (const osg::Vec3f& vertex : mWall)
+            wall.push_back(vertex + osg::Vec3f(shift, 0, 0));
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), wall, OcclusionBuffer::findAdjacentVertices(wall));
+        EXPECT_EQ(mBuffer.getDepth(16, 32), 0.f);
+        EXPECT_GT(mBuffer.getDepth(17, 32), 0.f);
+        EXPECT_GT(mBuffer.getDepth(47, 32), 0.f);
+        EXPECT_EQ(mBuffer.getDepth(48, 32), 0.f);
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxVisibleThroughPartiallyCoveredPixelsShouldNotBeOccluded)
+    {
+        const float shift = 100.f / 64;
+        std::vector<osg::Vec3f> wall;
+        for (const osg::Vec3f& vertex : mWall)
+            wall.push_back(vertex + osg::Vec3f(shift, 0, 0));
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), wall, OcclusionBuffer::findAdjacentVertices(wall));
+        // Projects into the left half of pixel column 16 that is not behind the wall
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(-98.4375f, 200, 0), 0.5f)));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, sharedEdgeShouldNotLeaveGaps)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), mWall, OcclusionBuffer::findAdjacentVertices(mWall));
+        for (unsigned int i = 16; i < 48; ++i)
+            EXPECT_GT(mBuffer.getDepth(i, i), 0.f) << i;
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, edgesWithoutAdjacentTrianglesShouldBeConservative)
+    {
+        mBuffer.clear(mViewProjection);
+        mBuffer.rasterizeTriangles(osg::Matrixf(), mWall, {});
+        EXPECT_EQ(mBuffer.getDepth(32, 32), 0.f);
+        EXPECT_GT(mBuffer.getDepth(20, 40), 0.f);
+    }
+
+    osg::ref_ptr<osg::Geometry> makeQuad(float halfSize)
+    {
+        osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+        vertices->push_back(osg::Vec3f(-halfSize, 0, -halfSize));
+        vertices->push_back(osg::Vec3f(halfSize, 0, -halfSize));
+        vertices->push_back(osg::Vec3f(halfSize, 0, halfSize));
+        vertices->push_back(osg::Vec3f(-halfSize, 0, halfSize));
+        osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+        geometry->setVertexArray(vertices);
+        geometry->addPrimitiveSet(new osg::DrawArrays(GL_QUADS, 0, 4));
+        return geometry;
+    }
+
+    TEST(SceneUtilOcclusionCullerTest, addOccluderShouldRejectSmallNodes)
+    {
+        OcclusionCuller culler(64, 64, ~0u, 100);
+        osg::ref_ptr<osg::MatrixTransform> node = new osg::MatrixTransform;
+        node->addChild(makeQuad(10));
+        EXPECT_FALSE(culler.addOccluder(node));
+        EXPECT_EQ(culler.getNumOccluders(), 0u);
+    }
+
+    TEST(SceneUtilOcclusionCullerTest, addOccluderShouldAcceptLargeOpaqueNodes)
+    {
+        OcclusionCuller culler(64, 64, ~0u, 100);
+        osg::ref_ptr<osg::MatrixTransform> node = new osg::MatrixTransform;
+        node->addChild(makeQuad(200));
+        EXPECT_TRUE(culler.addOccluder(node));
+        EXPECT_EQ(culler.getNumOccluders(), 1u);
+        culler.removeOccluder(node);
+        EXPECT_EQ(culler.getNumOccluders(), 0u);
+    }
+
+    TEST(SceneUtilOcclusionCullerTest, addOccluderShouldRejectBlendedGeometry)
+    {
+        OcclusionCuller culler(64, 64, ~0u, 100);
+        osg::ref_ptr<osg::MatrixTransform> node = new osg::MatrixTransform;
+        osg::ref_ptr<osg::Geometry> quad = makeQuad(200);
+        quad->getOrCreateStateSet()->setMode(GL_BLEND, osg::StateAttribute::ON);
+        node->addChild(quad);
+        EXPECT_FALSE(culler.addOccluder(node));
+    }
+}
@@ -0,0 +1,220 @@
+#include <components/sceneutil/staticgeometry.hpp>
+
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/UserDataContainer>
+#include <osg/ValueObject>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct SceneUtilStaticGeometryTest : Test
+    {
+        osg::ref_ptr<osg::StateSet> mStateSet = new osg::StateSet;
+
+        const WriteStateSetFunc mWriteStateSet = [this] (const osg::StateSet& stateSet, std::ostream& stream)
+        {
+            if (&stateSet != mStateSet.get())
+                return false;
+            stream.put('s');
+            return true;
+        };
+
+        const ReadStateSetFunc mReadStateSet = [this] (std::istream& stream) -> osg::ref_ptr<osg::StateSet>
+        {
+            if (stream.get() != 's')
+                throw std::runtime_error("Invalid StateSet");
+            return mStateSet;
+        };
+
+        const WriteUserObjectFunc mWriteUserObject = [] (const osg::Object& object, std::ostream& stream)
+        {
+            const auto* value = dynamic_cast<const osg::UIntValueObject*>(&object);
+            if (!value)
+                return false;
+            const unsigned int v = value->getValue();
+            stream.write(reinterpret_cast<const char*>(&v), sizeof(v));
+            return true;
+        };
+
+        const ReadUserObjectFunc mReadUserObject = [] (std::istream& stream) -> osg::ref_ptr<osg::Object>
+        {
+            unsigned int v = 0;
+            stream.read(reinterpret_cast<char*>(&v), sizeof(v));
+            return new osg::UIntValueObject("", v);
+        };
+
+        osg::ref_ptr<osg::Geometry> makeGeometry()
+        {
+            osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+            geometry->setUseDisplayList(false);
+            geometry->setUseVertexBufferObjects(true);
+            osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+            vertices->push_back(osg::Vec3f(0, 0, 0));
+            vertices->push_back(osg::Vec3f(1, 0, 0));
+            vertices->push_back(osg::Vec3f(0, 1, 0));
+            vertices->push_back(osg::Vec3f(1, 1, 0));
+            geometry->setVertexArray(vertices);
+            osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+            normals->push_back(osg::Vec3f(0, 0, 1));
+            geometry->setNormalArray(normals, osg::Array::BIND_OVERALL);
+            osg::ref_ptr<osg::Vec4ubArray> colors = new osg::Vec4ubArray(4);
+            colors->setNormalize(true);
+            osg::ref_ptr<osg::Vec2Array> texCoords = new osg::Vec2Array(4);
+            for (unsigned int i = 0; i < 4; ++i)
+            {
+                (*colors)[i] = osg::Vec4ub(i, 2 * i, 3 * i, 255);
+                (*texCoords)[i] = osg::Vec2f((*vertices)[i].x(), (*vertices)[i].y());
+            }
+            geometry->setColorArray(colors, osg::Array::BIND_PER_VERTEX);
+            geometry->setTexCoordArray(1, texCoords, osg::Array::BIND_PER_VERTEX);
+            geometry->addPrimitiveSet(new osg::DrawArrays(GL_TRIANGLES, 0, 3));
+            osg::ref_ptr<osg::DrawElementsUShort> elements = new osg::DrawElementsUShort(GL_TRIANGLES);
+            elements->push_back(1);
+            elements->push_back(3);
+            elements->push_back(2);
+            geometry->addPrimitiveSet(elements);
+            geometry->setStateSet(mStateSet);
+            geometry->getOrCreateUserDataContainer()->addUserObject(new osg::UIntValueObject("", 42));
+            return geometry;
+        }
+
+        // Serialized indices of the DrawElements made by makeGeometry, preceded by their count
+        static std::string makeElementsData(std::uint32_t count, GLushort index)
+        {
+            const GLushort indices[] = {1, index, 2};
+            std::string result(reinterpret_cast<const char*>(&count), sizeof(count));
+            result.append(reinterpret_cast<const char*>(indices), sizeof(indices));
+            return result;
+        }
+
+        std::stringstream makeCorruptedData(const std::string& replacement)
+        {
+            std::stringstream stream;
+            EXPECT_TRUE(writeStaticGeometry(*makeGeometry(), stream, mWriteStateSet, mWriteUserObject));
+            std::string data = stream.str();
+            const std::string original = makeElementsData(3, 3);
+            const std::size_t position = data.find(original);
+            EXPECT_NE(position, std::string::npos);
+            if (position != std::string::npos)
+                data.replace(position, original.size(), replacement);
+            return std::stringstream(data);
+        }
+
+        osg::ref_ptr<osg::Node> roundtrip(const osg::Node& node)
+        {
+            std::stringstream stream;
+            EXPECT_TRUE(writeStaticGeometry(node, stream, mWriteStateSet, mWriteUserObject));
+            return readStaticGeometry(stream, mReadStateSet, mReadUserObject);
+        }
+    };
+
+    TEST_F(SceneUtilStaticGeometryTest, roundtrip_should_preserve_graph_and_geometry)
+    {
+        osg::ref_ptr<osg::Group> root = new osg::Group;
+        osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(osg::Matrix::translate(1, 2, 3));
+        transform->setNodeMask(0x10);
+        transform->addChild(makeGeometry());
+        root->addChild(transform);
+
+        const osg::ref_ptr<osg::Node> result = roundtrip(*root);
+        ASSERT_NE(result.get(), nullptr);
+        ASSERT_NE(result->asGroup(), nullptr);
+        ASSERT_EQ(result->asGroup()->getNumChildren(), 1u);
+
+        const osg::MatrixTransform* resultTransform = dynamic_cast<const osg::MatrixTransform*>(result->asGroup()->getChild(0));
+        ASSERT_NE(resultTransform, nullptr);
+        EXPECT_EQ(resultTransform->getMatrix(), transform->getMatrix());
+        EXPECT_EQ(resultTransform->getNodeMask(), 0x10u);
+        ASSERT_EQ(resultTransform->getNumChildren(), 1u);
+
+        const osg::Geometry* expected = transform->getChild(0)->asGeometry();
+        const osg::Geometry* geometry = resultTransform->getChild(0)->asGeometry();
+        ASSERT_NE(geometry, nullptr);
+        EXPECT_EQ(geometry->getStateSet(), mStateSet.get());
+        EXPECT_TRUE(geometry->getUseVertexBufferObjects());
+        EXPECT_FALSE(geometry->getUseDisplayList());
+
+        const osg::Vec3Array* vertices = dynamic_cast<const osg::Vec3Array*>(geometry->getVertexArray());
+        ASSERT_NE(vertices, nullptr);
+        EXPECT_EQ(vertices->asVector(), static_cast<const osg::Vec3Array*>(expected->getVertexArray())->asVector());
+        EXPECT_NE(vertices->getVertexBufferObject(), nullptr);
+
+        ASSERT_NE(geometry->getNormalArray(), nullptr);
+        EXPECT_EQ(geometry->getNormalArray()->getBinding(), osg::Array::BIND_OVERALL);
+        EXPECT_EQ(geometry->getNormalArray()->getNumElements(), 1u);
+
+        const osg::Vec4ubArray* colors = dynamic_cast<const osg::Vec4ubArray*>(geometry->getColorArray());
+        ASSERT_NE(colors, nullptr);
+        EXPECT_TRUE(colors->getNormalize());
+        EXPECT_EQ(colors->asVector(), static_cast<const osg::Vec4ubArray*>(expected->getColorArray())->asVector());
+
+        ASSERT_EQ(geometry->getNumTexCoordArrays(), 2u);
+        EXPECT_EQ(geometry->getTexCoordArray(0), nullptr);
+        ASSERT_NE(geometry->getTexCoordArray(1), nullptr);
+        EXPECT_EQ(geometry->getTexCoordArray(1)->getNumElements(), 4u);
+
+        ASSERT_EQ(geometry->getNumPrimitiveSets(), 2u);
+        const osg::DrawArrays* drawArrays = dynamic_cast<const osg::DrawArrays*>(geometry->getPrimitiveSet(0));
+        ASSERT_NE(drawArrays, nullptr);
+        EXPECT_EQ(drawArrays->getFirst(), 0);
+        EXPECT_EQ(drawArrays->getCount(), 3);
+        const osg::DrawElementsUShort* elements = dynamic_cast<const osg::DrawElementsUShort*>(geometry->getPrimitiveSet(1));
+        ASSERT_NE(elements, nullptr);
+        EXPECT_EQ(elements->getMode(), static_cast<GLenum>(GL_TRIANGLES));
+        EXPECT_EQ(elements->asVector(), std::vector<GLushort>({1, 3, 2}));
+
+        ASSERT_NE(geometry->getUserDataContainer(), nullptr);
+        ASSERT_EQ(geometry->getUserDataContainer()->getNumUserObjects(), 1u);
+        const osg::UIntValueObject* value = dynamic_cast<const osg::UIntValueObject*>(geometry->getUserDataContainer()->getUserObject(0));
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(value->getValue(), 42u);
+    }
+
+    TEST_F(SceneUtilStaticGeometryTest, write_should_reject_unknown_state_set)
+    {
+        osg::ref_ptr<osg::Geometry> geometry = makeGeometry();
+        geometry->setStateSet(new osg::StateSet);
+        std::stringstream stream;
+        EXPECT_FALSE(writeStaticGeometry(*geometry, stream, mWriteStateSet, mWriteUserObject));
+    }
+
+    TEST_F(SceneUtilStaticGeometryTest, write_should_reject_nodes_with_callbacks)
+    {
+        osg::ref_ptr<osg::Group> group = new osg::Group;
+        group->addCullCallback(new osg::Callback);
+        std::stringstream stream;
+        EXPECT_FALSE(writeStaticGeometry(*group, stream, mWriteStateSet, mWriteUserObject));
+    }
+
+    TEST_F(SceneUtilStaticGeometryTest, read_should_throw_on_truncated_data)
+    {
+        std::stringstream stream;
+        ASSERT_TRUE(writeStaticGeometry(*makeGeometry(), stream, mWriteStateSet, mWriteUserObject));
+        const std::string data = stream.str();
+        std::stringstream truncated(data.substr(0, data.size() / 2));
+        EXPECT_THROW(readStaticGeometry(truncated, mReadStateSet, mReadUserObject), std::runtime_error);
+    }
+
+    TEST_F(SceneUtilStaticGeometryTest, read_should_throw_on_count_exceeding_data)
+    {
+        std::stringstream stream = makeCorruptedData(makeElementsData(std::numeric_limits<std::uint32_t>::max(), 3));
+        EXPECT_THROW(readStaticGeometry(stream, mReadStateSet, mReadUserObject), std::runtime_error);
+    }
+
+    TEST_F(SceneUtilStaticGeometryTest, read_should_throw_on_out_of_range_index)
+    {
+        std::stringstream stream = makeCorruptedData(makeElementsData(3, 1000));
+        EXPECT_THROW(readStaticGeometry(stream, mReadStateSet, mReadUserObject), std::runtime_error);
+    }
+}
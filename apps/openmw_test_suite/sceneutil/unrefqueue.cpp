@@ -0,0 +1,116 @@
+#include <components/sceneutil/unrefqueue.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct Counted : osg::Referenced
+    {
+        int& mDeleted;
+
+        explicit Counted(int& deleted) : mDeleted(deleted) {}
+
+        ~Counted() override { ++mDeleted; }
+    };
+
+    struct SceneUtilUnrefQueueTest : Test
+    {
+        int mDeleted = 0;
+
+        void push(UnrefQueue& queue, int count)
+        {
+            for (int i = 0; i < count; ++i)
+                queue.push(osg::ref_ptr<osg::Referenced>(new Counted(mDeleted)));
+        }
+    };
+
+    TEST_F(SceneUtilUnrefQueueTest, flush_without_limits_should_unreference_all_objects)
+    {
+        osg::ref_ptr<WorkQueue> workQueue = new WorkQueue(1);
+        UnrefQueue queue;
+        push(queue, 100);
+        const osg::ref_ptr<WorkItem> item = queue.flush(*workQueue);
+        ASSERT_NE(item, nullptr);
+        item->waitTillDone();
+        EXPECT_EQ(mDeleted, 100);
+        EXPECT_EQ(queue.getSize(), 0u);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, flush_should_hand_out_at_most_max_objects)
+    {
+        osg::ref_ptr<WorkQueue> workQueue = new WorkQueue(1);
+        UnrefQueue queue(30);
+        push(queue, 100);
+        const osg::ref_ptr<WorkItem> item = queue.flush(*workQueue);
+        ASSERT_NE(item, nullptr);
+        item->waitTillDone();
+        EXPECT_EQ(mDeleted, 30);
+        EXPECT_EQ(queue.getSize(), 70u);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, flush_should_do_nothing_while_previous_batch_is_pending)
+    {
+        osg::ref_ptr<WorkQueue> workQueue = new WorkQueue(0);
+        UnrefQueue queue(30);
+        push(queue, 100);
+        EXPECT_NE(queue.flush(*workQueue), nullptr);
+        EXPECT_EQ(queue.flush(*workQueue), nullptr);
+        EXPECT_EQ(queue.getSize(), 70u);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, flush_with_empty_queue_should_do_nothing)
+    {
+        osg::ref_ptr<WorkQueue> workQueue = new WorkQueue(0);
+        UnrefQueue queue;
+        EXPECT_EQ(queue.flush(*workQueue), nullptr);
+        EXPECT_EQ(workQueue->getNumItems(), 0u);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, flush_with_time_limit_should_start_with_small_batches)
+    {
+        osg::ref_ptr<WorkQueue> workQueue = new WorkQueue(1);
+        UnrefQueue queue(0, 1);
+        push(queue, 1000);
+        const osg::ref_ptr<WorkItem> item = queue.flush(*workQueue);
+        ASSERT_NE(item, nullptr);
+        item->waitTillDone();
+        EXPECT_EQ(mDeleted, 64);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, flush_should_unreference_oldest_objects_first)
+    {
+        osg::ref_ptr<WorkQueue> workQueue = new WorkQueue(1);
+        UnrefQueue queue(1);
+        int firstDeleted = 0;
+        queue.push(osg::ref_ptr<osg::Referenced>(new Counted(firstDeleted)));
+        push(queue, 1);
+        const osg::ref_ptr<WorkItem> item = queue.flush(*workQueue);
+        ASSERT_NE(item, nullptr);
+        item->waitTillDone();
+        EXPECT_EQ(firstDeleted, 1);
+        EXPECT_EQ(mDeleted, 0);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, push_from_several_threads_should_keep_all_objects)
+    {
+        osg::ref_ptr<WorkQueue> workQueue = new WorkQueue(1);
+        UnrefQueue queue;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+            threads.emplace_back([&] { push(queue, 1000); });
+        for (std::thread& thread : threads)
+            thread.join();
+        EXPECT_EQ(queue.getSize(), 4000u);
+        const osg::ref_ptr<WorkItem> item = queue.flush(*workQueue);
+        ASSERT_NE(item, nullptr);
+        item->waitTillDone();
+        EXPECT_EQ(mDeleted, 4000);
+    }
+}
@@ -0,0 +1,146 @@
+#include <components/terrain/quadtreenode.hpp>
+#include <components/terrain/viewdata.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace Terrain;
+
+    constexpr float sCellWorldSize = 100;
+
+    class TestLodCallback : public LodCallback
+    {
+    public:
+        ReturnValue isSufficientDetail(QuadTreeNode* node, float dist) override
+        {
+            ++mNumCalls;
+            if (dist > sViewDistance)
+                return StopTraversal;
+            return dist >= getThreshold(node) ? StopTraversalAndUse : Deeper;
+        }
+
+        float getDetailMargin(QuadTreeNode* node, float dist) override
+        {
+            return std::max(0.f, std::min(std::abs(dist - sViewDistance), std::abs(dist - getThreshold(node))) - 1.f);
+        }
+
+        int mNumCalls = 0;
+
+    private:
+        static constexpr float sViewDistance = 3000;
+
+        static float getThreshold(const QuadTreeNode* node)
+        {
+            return node->getSize() * sCellWorldSize * 2;
+        }
+    };
+
+    void addChildren(QuadTreeNode* node)
+    {
+        const float halfSize = node->getSize() / 2;
+        const osg::Vec2f& center = node->getCenter();
+        const osg::Vec3f extents(halfSize * sCellWorldSize, halfSize * sCellWorldSize, 0);
+        const osg::Vec3f worldCenter(center.x() * sCellWorldSize, center.y() * sCellWorldSize, 0);
+        node->setBoundingBox(osg::BoundingBox(worldCenter - extents + osg::Vec3f(0, 0, -10), worldCenter + extents + osg::Vec3f(0, 0, 10)));
+        if (node->getSize() <= 1)
+            return;
+        const float quarterSize = halfSize / 2;
+        const osg::Vec2f offsets[] = {
+            osg::Vec2f(-quarterSize, quarterSize), osg::Vec2f(quarterSize, quarterSize),
+            osg::Vec2f(-quarterSize, -quarterSize), osg::Vec2f(quarterSize, -quarterSize),
+        };
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            QuadTreeNode* child = new QuadTreeNode(node, static_cast<ChildDirection>(i), halfSize, center + offsets[i]);
+            node->addChildNode(child);
+            addChildren(child);
+        }
+    }
+
+    std::vector<QuadTreeNode*> getNodes(ViewData& vd)
+    {
+        std::vector<QuadTreeNode*> result;
+        for (unsigned int i = 0; i < vd.getNumEntries(); ++i)
+            result.push_back(vd.getEntry(i).mNode);
+        return result;
+    }
+
+    struct TerrainQuadTreeNodeTest : Test
+    {
+        osg::ref_ptr<QuadTreeNode> mRoot {new QuadTreeNode(nullptr, Root, 32, osg::Vec2f(0, 0))};
+        TestLodCallback mLodCallback;
+
+        TerrainQuadTreeNodeTest()
+        {
+            addChildren(mRoot);
+        }
+
+        std::vector<QuadTreeNode*> update(ViewData& vd, const osg::Vec3f& viewPoint)
+        {
+            vd.reset();
+            mRoot->updateNodes(&vd, viewPoint, &mLodCallback);
+            return getNodes(vd);
+        }
+
+        std::vector<QuadTreeNode*> traverse(const osg::Vec3f& viewPoint)
+        {
+            ViewData vd;
+            mRoot->traverseNodes(&vd, viewPoint, &mLodCallback);
+            return getNodes(vd);
+        }
+    };
+
+    TEST_F(TerrainQuadTreeNodeTest, updateNodesShouldSelectSameNodesAsTraverseNodes)
+    {
+        ViewData vd;
+        std::minstd_rand random;
+        std::uniform_real_distribution<float> step(-300, 300);
+        osg::Vec3f viewPoint(0, 0, 50);
+        for (int i = 0; i < 200; ++i)
+        {
+            viewPoint += osg::Vec3f(step(random), step(random), step(random) / 10);
+            EXPECT_EQ(update(vd, viewPoint), traverse(viewPoint)) << i;
+        }
+    }
+
+    TEST_F(TerrainQuadTreeNodeTest, updateNodesShouldNotMakeDecisionsAgainForSameViewPoint)
+    {
+        ViewData vd;
+        const osg::Vec3f viewPoint(123, 456, 50);
+        const std::vector<QuadTreeNode*> nodes = update(vd, viewPoint);
+        ASSERT_FALSE(nodes.empty());
+        mLodCallback.mNumCalls = 0;
+        EXPECT_EQ(update(vd, viewPoint), nodes);
+        EXPECT_EQ(mLodCallback.mNumCalls, 0);
+    }
+
+    TEST_F(TerrainQuadTreeNodeTest, updateNodesShouldOnlyMakeDecisionsAgainNearChangedBoundaries)
+    {
+        ViewData vd;
+        update(vd, osg::Vec3f(0, 0, 50));
+        mLodCallback.mNumCalls = 0;
+        traverse(osg::Vec3f(0, 0, 50));
+        const int numFullTraversalCalls = mLodCallback.mNumCalls;
+        mLodCallback.mNumCalls = 0;
+        update(vd, osg::Vec3f(20, 0, 50));
+        EXPECT_LT(mLodCallback.mNumCalls, numFullTraversalCalls);
+    }
+
+    TEST_F(TerrainQuadTreeNodeTest, viewDataContainsShouldFindSelectedNodes)
+    {
+        ViewData vd;
+        const std::vector<QuadTreeNode*> nodes = update(vd, osg::Vec3f(0, 0, 50));
+        for (QuadTreeNode* node : nodes)
+            EXPECT_TRUE(vd.contains(node));
+        EXPECT_FALSE(vd.contains(mRoot));
+        vd.getEntry(0).mNode = nullptr;
+        EXPECT_FALSE(vd.contains(nodes.front()));
+    }
+}
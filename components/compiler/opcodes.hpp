@@ -298,6 +298,7 @@ namespace Compiler
         const int opcodeRemoveFromLevItem = 0x20002fe;
         const int opcodeShowSceneGraph = 0x2002f;
         const int opcodeShowSceneGraphExplicit = 0x20030;
+        const int opcodeShowScriptProfile = 0x20031;
         const int opcodeToggleBorders = 0x2000307;
         const int opcodeToggleNavMesh = 0x2000308;
         const int opcodeToggleActorsPaths = 0x2000309;
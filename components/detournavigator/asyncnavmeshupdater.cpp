@@ -14,6 +14,7 @@
 #include <BulletCollision/CollisionShapes/btBoxShape.h>
 
 #include <DetourNavMesh.h>
+#include <Recast.h>
 
 #include <osg/Stats>
 #include <osg/io_utils>
@@ -22,6 +23,7 @@
 #include <numeric>
 #include <set>
 #include <type_traits>
+#include <utility>
 
 namespace DetourNavigator
 {
@@ -46,7 +48,8 @@ namespace DetourNavigator
         auto getPriority(const Job& job) noexcept
         {
             return std::make_tuple(-static_cast<std::underlying_type_t<JobState>>(job.mState), job.mProcessTime,
-                                   job.mChangeType, job.mTryNumber, job.mDistanceToPlayer, job.mDistanceToOrigin);
+                                   job.mChangeType, !job.mAgentPresent, job.mTryNumber, job.mDistanceToPlayer,
+                                   job.mDistanceToOrigin);
         }
 
         struct LessByJobPriority
@@ -66,7 +69,7 @@ namespace DetourNavigator
         auto getDbPriority(const Job& job) noexcept
         {
             return std::make_tuple(static_cast<std::underlying_type_t<JobState>>(job.mState),
-                                   job.mChangeType, job.mDistanceToPlayer, job.mDistanceToOrigin);
+                                   job.mChangeType, !job.mAgentPresent, job.mDistanceToPlayer, job.mDistanceToOrigin);
         }
 
         struct LessByJobDbPriority
@@ -96,11 +99,11 @@ namespace DetourNavigator
                                               settings.mRecast, settings.mWriteToNavMeshDb);
         }
 
-        void updateJobs(std::deque<JobIt>& jobs, TilePosition playerTile, int maxTiles)
+        void updateJobs(std::deque<JobIt>& jobs, TilePosition playerTile, TilePosition predictedPlayerTile, int maxTiles)
         {
             for (JobIt job : jobs)
             {
-                job->mDistanceToPlayer = getManhattanDistance(job->mChangedTile, playerTile);
+                job->mDistanceToPlayer = getManhattanDistance(job->mChangedTile, predictedPlayerTile);
                 if (!shouldAddTile(job->mChangedTile, playerTile, maxTiles))
                     job->mChangeType = ChangeType::remove;
             }
@@ -133,6 +136,7 @@ namespace DetourNavigator
         , mWorldspace(worldspace)
         , mChangedTile(changedTile)
         , mProcessTime(processTime)
+        , mEnqueueTime(std::chrono::steady_clock::now())
         , mChangeType(changeType)
         , mDistanceToPlayer(distanceToPlayer)
         , mDistanceToOrigin(getManhattanDistance(changedTile, TilePosition {0, 0}))
@@ -145,7 +149,9 @@ namespace DetourNavigator
         , mRecastMeshManager(recastMeshManager)
         , mOffMeshConnectionsManager(offMeshConnectionsManager)
         , mShouldStop()
+        , mPlayerTrajectory(settings.mPlayerTilePredictionTime)
         , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize)
+        , mNavMeshLayersCache(settings.mMaxNavMeshLayersCacheSize)
         , mDbWorker(makeDbWorker(*this, std::move(db), mSettings))
     {
         for (std::size_t i = 0; i < mSettings.get().mAsyncNavMeshUpdaterThreads; ++i)
@@ -161,11 +167,15 @@ namespace DetourNavigator
         const TilePosition& playerTile, std::string_view worldspace,
         const std::map<TilePosition, ChangeType>& changedTiles)
     {
+        const auto now = std::chrono::steady_clock::now();
         bool playerTileChanged = false;
+        TilePosition predictedPlayerTile;
         {
             auto locked = mPlayerTile.lock();
             playerTileChanged = *locked != playerTile;
             *locked = playerTile;
+            mPlayerTrajectory.update(playerTile, now);
+            predictedPlayerTile = mPlayerTrajectory.getPredictedTile(now);
         }
 
         if (!playerTileChanged && changedTiles.empty())
@@ -176,8 +186,16 @@ namespace DetourNavigator
 
         std::unique_lock lock(mMutex);
 
-        if (playerTileChanged)
-            updateJobs(mWaiting, playerTile, maxTiles);
+        // Jobs are ordered by distance to the predicted player tile but range is checked for the current one
+        const bool shouldUpdateJobs = playerTileChanged
+            || std::exchange(mPredictedPlayerTile, predictedPlayerTile) != predictedPlayerTile;
+
+        if (shouldUpdateJobs)
+        {
+            Log(Debug::Debug) << "Update navigator jobs for playerTile=(" << playerTile << ")"
+                << " predictedPlayerTile=(" << predictedPlayerTile << ")";
+            updateJobs(mWaiting, playerTile, predictedPlayerTile, maxTiles);
+        }
 
         for (const auto& [changedTile, changeType] : changedTiles)
         {
@@ -188,19 +206,20 @@ namespace DetourNavigator
                     : std::chrono::steady_clock::time_point();
 
                 const JobIt it = mJobs.emplace(mJobs.end(), agentBounds, navMeshCacheItem, worldspace,
-                    changedTile, changeType, getManhattanDistance(changedTile, playerTile), processTime);
+                    changedTile, changeType, getManhattanDistance(changedTile, predictedPlayerTile), processTime);
+                it->mAgentPresent = mAbsentAgents.find(agentBounds) == mAbsentAgents.end();
 
                 Log(Debug::Debug) << "Post job " << it->mId << " for agent=(" << it->mAgentBounds << ")"
                     << " changedTile=(" << it->mChangedTile << ")";
 
-                if (playerTileChanged)
+                if (shouldUpdateJobs)
                     mWaiting.push_back(it);
                 else
                     insertPrioritizedJob(it, mWaiting);
             }
         }
 
-        if (playerTileChanged)
+        if (shouldUpdateJobs)
             std::sort(mWaiting.begin(), mWaiting.end(), LessByJobPriority {});
 
         Log(Debug::Debug) << "Posted " << mJobs.size() << " navigator jobs";
@@ -210,8 +229,23 @@ namespace DetourNavigator
 
         lock.unlock();
 
-        if (playerTileChanged && mDbWorker != nullptr)
-            mDbWorker->updateJobs(playerTile, maxTiles);
+        if (shouldUpdateJobs && mDbWorker != nullptr)
+            mDbWorker->updateJobs(playerTile, predictedPlayerTile, maxTiles);
+    }
+
+    void AsyncNavMeshUpdater::setAbsentAgents(std::set<AgentBounds>&& agents)
+    {
+        const std::lock_guard lock(mMutex);
+
+        if (mAbsentAgents == agents)
+            return;
+
+        mAbsentAgents = std::move(agents);
+
+        for (JobIt job : mWaiting)
+            job->mAgentPresent = mAbsentAgents.find(job->mAgentBounds) == mAbsentAgents.end();
+
+        std::sort(mWaiting.begin(), mWaiting.end(), LessByJobPriority {});
     }
 
     void AsyncNavMeshUpdater::wait(Loading::Listener& listener, WaitConditionType waitConditionType)
@@ -311,12 +345,15 @@ namespace DetourNavigator
             result.mJobs = mJobs.size();
             result.mWaiting = mWaiting.size();
             result.mPushed = mPushed.size();
+            result.mQueueLatency = mQueueLatency;
         }
         result.mProcessing = mProcessingTiles.lockConst()->size();
         if (mDbWorker != nullptr)
             result.mDb = mDbWorker->getStats();
         result.mCache = mNavMeshTilesCache.getStats();
+        result.mLayersCache = mNavMeshLayersCache.getStats();
         result.mDbGetTileHits = mDbGetTileHits.load(std::memory_order_relaxed);
+        result.mCancelled = mCancelledJobs.load(std::memory_order_relaxed);
         return result;
     }
 
@@ -326,6 +363,8 @@ namespace DetourNavigator
         out.setAttribute(frameNumber, "NavMesh Waiting", static_cast<double>(stats.mWaiting));
         out.setAttribute(frameNumber, "NavMesh Pushed", static_cast<double>(stats.mPushed));
         out.setAttribute(frameNumber, "NavMesh Processing", static_cast<double>(stats.mProcessing));
+        out.setAttribute(frameNumber, "NavMesh Cancelled", static_cast<double>(stats.mCancelled));
+        out.setAttribute(frameNumber, "NavMesh QueueLatency", stats.mQueueLatency.count());
 
         if (stats.mDb.has_value())
         {
@@ -337,6 +376,7 @@ namespace DetourNavigator
         }
 
         reportStats(stats.mCache, frameNumber, out);
+        reportStats(stats.mLayersCache, frameNumber, out);
     }
 
     void AsyncNavMeshUpdater::process() noexcept
@@ -390,11 +430,11 @@ namespace DetourNavigator
         if (!navMeshCacheItem)
             return JobStatus::Done;
 
-        const auto playerTile = *mPlayerTile.lockConst();
-        const auto params = *navMeshCacheItem->lockConst()->getImpl().getParams();
-
-        if (!shouldAddTile(job.mChangedTile, playerTile, std::min(mSettings.get().mMaxTilesNumber, params.maxTiles)))
+        if (!isInRange(job, *navMeshCacheItem))
         {
+            // Job has been started before and the tile left range while it was waiting for db
+            if (job.mState != JobState::Initial)
+                return cancelJob(job, *navMeshCacheItem);
             Log(Debug::Debug) << "Ignore add tile by job " << job.mId << ": too far from player";
             navMeshCacheItem->lock()->removeTile(job.mChangedTile);
             return JobStatus::Done;
@@ -441,13 +481,14 @@ namespace DetourNavigator
         }
         else
         {
-            if (job.mChangeType != ChangeType::update && mDbWorker != nullptr)
+            // Obstacles are not a part of the db key, tiles with them are always generated
+            if (job.mChangeType != ChangeType::update && mDbWorker != nullptr && recastMesh->getObstacles().empty())
             {
                 job.mRecastMesh = std::move(recastMesh);
                 return JobStatus::MemoryCacheMiss;
             }
 
-            preparedNavMeshData = prepareNavMeshTileData(*recastMesh, job.mChangedTile, job.mAgentBounds, mSettings.get().mRecast);
+            preparedNavMeshData = prepareTileData(job, recastMesh);
 
             if (preparedNavMeshData == nullptr)
             {
@@ -468,6 +509,10 @@ namespace DetourNavigator
             }
         }
 
+        // Generation can't be interrupted, the result stays in the cache when player has gone too far meanwhile
+        if (!isInRange(job, navMeshCacheItem))
+            return cancelJob(job, navMeshCacheItem);
+
         const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
 
         const UpdateNavMeshStatus status = navMeshCacheItem.lock()->updateTile(job.mChangedTile, std::move(cachedNavMeshData),
@@ -508,23 +553,74 @@ namespace DetourNavigator
         auto cachedNavMeshData = mNavMeshTilesCache.set(job.mAgentBounds, job.mChangedTile, *job.mRecastMesh,
                                                         std::move(preparedNavMeshData));
 
-        const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
-
         const PreparedNavMeshData* preparedNavMeshDataPtr = cachedNavMeshData ? &cachedNavMeshData.get() : preparedNavMeshData.get();
         assert (preparedNavMeshDataPtr != nullptr);
 
+        const bool shouldWriteToDb = generatedNavMeshData && job.mChangeType != ChangeType::update
+            && mDbWorker != nullptr && mSettings.get().mWriteToNavMeshDb;
+
+        if (!isInRange(job, navMeshCacheItem))
+        {
+            if (shouldWriteToDb)
+                job.mGeneratedNavMeshData = std::make_unique<PreparedNavMeshData>(*preparedNavMeshDataPtr);
+            return cancelJob(job, navMeshCacheItem);
+        }
+
+        const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
+
         const UpdateNavMeshStatus status = navMeshCacheItem.lock()->updateTile(job.mChangedTile, std::move(cachedNavMeshData),
             makeNavMeshTileData(*preparedNavMeshDataPtr, offMeshConnections, job.mAgentBounds, job.mChangedTile, mSettings.get().mRecast));
 
         const JobStatus result = handleUpdateNavMeshStatus(status, job, navMeshCacheItem, *job.mRecastMesh);
 
-        if (result == JobStatus::Done && job.mChangeType != ChangeType::update
-                && mDbWorker != nullptr && mSettings.get().mWriteToNavMeshDb && generatedNavMeshData)
+        if (result == JobStatus::Done && shouldWriteToDb)
             job.mGeneratedNavMeshData = std::make_unique<PreparedNavMeshData>(*preparedNavMeshDataPtr);
 
         return result;
     }
 
+    std::unique_ptr<PreparedNavMeshData> AsyncNavMeshUpdater::prepareTileData(const Job& job,
+        const std::shared_ptr<RecastMesh>& recastMesh)
+    {
+        const RecastSettings& settings = mSettings.get().mRecast;
+
+        if (recastMesh->getObstacles().empty())
+            return prepareNavMeshTileData(*recastMesh, job.mChangedTile, job.mAgentBounds, settings);
+
+        // Moving obstacles doesn't change the layer, so only polygons are built again
+        rcCompactHeightfield layer;
+        if (!mNavMeshLayersCache.get(job.mAgentBounds, job.mChangedTile, *recastMesh, layer))
+        {
+            if (!prepareNavMeshLayer(*recastMesh, job.mChangedTile, job.mAgentBounds, settings, layer))
+                return nullptr;
+            mNavMeshLayersCache.set(job.mAgentBounds, job.mChangedTile, recastMesh, layer);
+        }
+
+        return prepareNavMeshTileData(layer, recastMesh->getObstacles(), job.mAgentBounds, settings);
+    }
+
+    bool AsyncNavMeshUpdater::isInRange(const Job& job) const
+    {
+        const auto navMeshCacheItem = job.mNavMeshCacheItem.lock();
+        return navMeshCacheItem != nullptr && isInRange(job, *navMeshCacheItem);
+    }
+
+    bool AsyncNavMeshUpdater::isInRange(const Job& job, const GuardedNavMeshCacheItem& navMeshCacheItem) const
+    {
+        const TilePosition playerTile = *mPlayerTile.lockConst();
+        const int maxTiles = std::min(mSettings.get().mMaxTilesNumber,
+                                      navMeshCacheItem.lockConst()->getImpl().getParams()->maxTiles);
+        return shouldAddTile(job.mChangedTile, playerTile, maxTiles);
+    }
+
+    JobStatus AsyncNavMeshUpdater::cancelJob(const Job& job, GuardedNavMeshCacheItem& navMeshCacheItem)
+    {
+        Log(Debug::Debug) << "Cancel job " << job.mId << ": too far from player";
+        navMeshCacheItem.lock()->removeTile(job.mChangedTile);
+        ++mCancelledJobs;
+        return JobStatus::Done;
+    }
+
     JobStatus AsyncNavMeshUpdater::handleUpdateNavMeshStatus(UpdateNavMeshStatus status,
         const Job& job, const GuardedNavMeshCacheItem& navMeshCacheItem, const RecastMesh& recastMesh)
     {
@@ -586,10 +682,15 @@ namespace DetourNavigator
             return mJobs.end();
         }
 
+        const auto now = std::chrono::steady_clock::now();
         if (job->mChangeType == ChangeType::update)
-            mLastUpdates[getAgentAndTile(*job)] = std::chrono::steady_clock::now();
+            mLastUpdates[getAgentAndTile(*job)] = now;
         mPushed.erase(getAgentAndTile(*job));
 
+        // Smoothed to be readable on the stats HUD
+        const auto latency = now - std::max(job->mEnqueueTime, job->mProcessTime);
+        mQueueLatency += (std::chrono::duration<double, std::milli>(latency) - mQueueLatency) * 0.1;
+
         return job;
     }
 
@@ -628,6 +729,7 @@ namespace DetourNavigator
         if (mPushed.emplace(job->mAgentBounds, job->mChangedTile).second)
         {
             ++job->mTryNumber;
+            job->mEnqueueTime = std::chrono::steady_clock::now();
             insertPrioritizedJob(job, mWaiting);
             mHasJob.notify_all();
             return;
@@ -705,10 +807,10 @@ namespace DetourNavigator
         return job;
     }
 
-    void DbJobQueue::update(TilePosition playerTile, int maxTiles)
+    void DbJobQueue::update(TilePosition playerTile, TilePosition predictedPlayerTile, int maxTiles)
     {
         const std::lock_guard lock(mMutex);
-        updateJobs(mJobs, playerTile, maxTiles);
+        updateJobs(mJobs, playerTile, predictedPlayerTile, maxTiles);
         std::sort(mJobs.begin(), mJobs.end(), LessByJobDbPriority {});
     }
 
@@ -826,6 +928,13 @@ namespace DetourNavigator
     {
         Log(Debug::Debug) << "Processing db read job " << job->mId;
 
+        // Updater cancels the job when it comes back
+        if (!mUpdater.isInRange(*job))
+        {
+            Log(Debug::Debug) << "Ignore db read job " << job->mId << ": too far from player";
+            return;
+        }
+
         if (job->mInput.empty())
         {
             Log(Debug::Debug) << "Serializing input for job " << job->mId;
@@ -6,10 +6,12 @@
 #include "tilecachedrecastmeshmanager.hpp"
 #include "tileposition.hpp"
 #include "navmeshtilescache.hpp"
+#include "navmeshlayerscache.hpp"
 #include "waitconditiontype.hpp"
 #include "navmeshdb.hpp"
 #include "changetype.hpp"
 #include "agentbounds.hpp"
+#include "playertrajectory.hpp"
 
 #include <osg/Vec3f>
 
@@ -49,8 +51,10 @@ namespace DetourNavigator
         const std::string mWorldspace;
         const TilePosition mChangedTile;
         const std::chrono::steady_clock::time_point mProcessTime;
+        std::chrono::steady_clock::time_point mEnqueueTime;
         unsigned mTryNumber = 0;
         ChangeType mChangeType;
+        bool mAgentPresent = true;
         int mDistanceToPlayer;
         const int mDistanceToOrigin;
         JobState mState = JobState::Initial;
@@ -82,7 +86,7 @@ namespace DetourNavigator
 
         std::optional<JobIt> pop();
 
-        void update(TilePosition playerTile, int maxTiles);
+        void update(TilePosition playerTile, TilePosition predictedPlayerTile, int maxTiles);
 
         void stop();
 
@@ -115,7 +119,10 @@ namespace DetourNavigator
 
         void enqueueJob(JobIt job);
 
-        void updateJobs(TilePosition playerTile, int maxTiles) { mQueue.update(playerTile, maxTiles); }
+        void updateJobs(TilePosition playerTile, TilePosition predictedPlayerTile, int maxTiles)
+        {
+            mQueue.update(playerTile, predictedPlayerTile, maxTiles);
+        }
 
         void stop();
 
@@ -151,8 +158,11 @@ namespace DetourNavigator
             std::size_t mPushed = 0;
             std::size_t mProcessing = 0;
             std::size_t mDbGetTileHits = 0;
+            std::size_t mCancelled = 0;
+            std::chrono::duration<double, std::milli> mQueueLatency {0};
             std::optional<DbWorker::Stats> mDb;
             NavMeshTilesCache::Stats mCache;
+            NavMeshLayersCache::Stats mLayersCache;
         };
 
         AsyncNavMeshUpdater(const Settings& settings, TileCachedRecastMeshManager& recastMeshManager,
@@ -163,6 +173,9 @@ namespace DetourNavigator
             const TilePosition& playerTile, std::string_view worldspace,
             const std::map<TilePosition, ChangeType>& changedTiles);
 
+        /// Jobs for agents without actors are processed after jobs for present agents.
+        void setAbsentAgents(std::set<AgentBounds>&& agents);
+
         void wait(Loading::Listener& listener, WaitConditionType waitConditionType);
 
         void stop();
@@ -173,6 +186,8 @@ namespace DetourNavigator
 
         void removeJob(JobIt job);
 
+        bool isInRange(const Job& job) const;
+
     private:
         std::reference_wrapper<const Settings> mSettings;
         std::reference_wrapper<TileCachedRecastMeshManager> mRecastMeshManager;
@@ -186,13 +201,19 @@ namespace DetourNavigator
         std::deque<JobIt> mWaiting;
         std::set<std::tuple<AgentBounds, TilePosition>> mPushed;
         Misc::ScopeGuarded<TilePosition> mPlayerTile;
+        PlayerTrajectory mPlayerTrajectory;
+        TilePosition mPredictedPlayerTile;
+        std::set<AgentBounds> mAbsentAgents;
+        std::chrono::duration<double, std::milli> mQueueLatency {0};
         NavMeshTilesCache mNavMeshTilesCache;
+        NavMeshLayersCache mNavMeshLayersCache;
         Misc::ScopeGuarded<std::set<std::tuple<AgentBounds, TilePosition>>> mProcessingTiles;
         std::map<std::tuple<AgentBounds, TilePosition>, std::chrono::steady_clock::time_point> mLastUpdates;
         std::set<std::tuple<AgentBounds, TilePosition>> mPresentTiles;
         std::vector<std::thread> mThreads;
         std::unique_ptr<DbWorker> mDbWorker;
         std::atomic_size_t mDbGetTileHits {0};
+        std::atomic_size_t mCancelledJobs {0};
 
         void process() noexcept;
 
@@ -202,6 +223,13 @@ namespace DetourNavigator
 
         inline JobStatus processJobWithDbResult(Job& job, GuardedNavMeshCacheItem& navMeshCacheItem);
 
+        inline std::unique_ptr<PreparedNavMeshData> prepareTileData(const Job& job,
+            const std::shared_ptr<RecastMesh>& recastMesh);
+
+        inline bool isInRange(const Job& job, const GuardedNavMeshCacheItem& navMeshCacheItem) const;
+
+        inline JobStatus cancelJob(const Job& job, GuardedNavMeshCacheItem& navMeshCacheItem);
+
         inline JobStatus handleUpdateNavMeshStatus(UpdateNavMeshStatus status, const Job& job,
             const GuardedNavMeshCacheItem& navMeshCacheItem, const RecastMesh& recastMesh);
 
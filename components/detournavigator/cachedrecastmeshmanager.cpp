@@ -3,8 +3,9 @@
 
 namespace DetourNavigator
 {
-    CachedRecastMeshManager::CachedRecastMeshManager(const TileBounds& bounds, std::size_t generation)
-        : mImpl(bounds, generation)
+    CachedRecastMeshManager::CachedRecastMeshManager(const TileBounds& bounds, std::size_t generation,
+            bool enableObstacles, float maxSlope)
+        : mImpl(bounds, generation, enableObstacles, maxSlope)
     {}
 
     bool CachedRecastMeshManager::addObject(const ObjectId id, const CollisionShape& shape,
@@ -14,7 +14,8 @@ namespace DetourNavigator
     class CachedRecastMeshManager
     {
     public:
-        explicit CachedRecastMeshManager(const TileBounds& bounds, std::size_t generation);
+        explicit CachedRecastMeshManager(const TileBounds& bounds, std::size_t generation, bool enableObstacles = false,
+            float maxSlope = 0);
 
         bool addObject(const ObjectId id, const CollisionShape& shape, const btTransform& transform,
                        const AreaType areaType);
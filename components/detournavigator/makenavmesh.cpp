@@ -355,13 +355,24 @@ namespace
             polyMesh.flags[i] = getFlag(static_cast<AreaType>(polyMesh.areas[i]));
     }
 
+    void markObstacles(rcContext& context, const std::vector<Obstacle>& obstacles, const RecastSettings& settings,
+        const AgentBounds& agentBounds, rcCompactHeightfield& compact)
+    {
+        // The walkable area is already eroded, so obstacles are expanded by the agent radius to keep the clearance.
+        // The bottom is lowered by the max climb to cover the spans an obstacle stands on.
+        const float radius = getRadius(settings, agentBounds);
+        const float climb = getMaxClimb(settings);
+        for (const Obstacle& obstacle : obstacles)
+        {
+            const osg::Vec3f min = toNavMeshCoordinates(settings, obstacle.mMin) - osg::Vec3f(radius, climb, radius);
+            const osg::Vec3f max = toNavMeshCoordinates(settings, obstacle.mMax) + osg::Vec3f(radius, 0, radius);
+            rcMarkBoxArea(&context, min.ptr(), max.ptr(), AreaType_null, compact);
+        }
+    }
+
     bool fillPolyMesh(rcContext& context, const RecastSettings& settings, const RecastParams& params,
-        rcHeightfield& solid, rcPolyMesh& polyMesh, rcPolyMeshDetail& polyMeshDetail)
+        rcCompactHeightfield& compact, rcPolyMesh& polyMesh, rcPolyMeshDetail& polyMeshDetail)
     {
-        rcCompactHeightfield compact;
-        buildCompactHeightfield(context, params.mWalkableHeight, params.mWalkableClimb, solid, compact);
-
-        erodeWalkableArea(context, params.mWalkableRadius, compact);
         buildDistanceField(context, compact);
         buildRegions(context, compact, settings.mBorderSize, settings.mRegionMinArea, settings.mRegionMergeArea);
 
@@ -430,8 +441,8 @@ namespace
 
 namespace DetourNavigator
 {
-    std::unique_ptr<PreparedNavMeshData> prepareNavMeshTileData(const RecastMesh& recastMesh,
-        const TilePosition& tilePosition, const AgentBounds& agentBounds, const RecastSettings& settings)
+    bool prepareNavMeshLayer(const RecastMesh& recastMesh, const TilePosition& tilePosition,
+        const AgentBounds& agentBounds, const RecastSettings& settings, rcCompactHeightfield& layer)
     {
         rcContext context;
 
@@ -444,15 +455,31 @@ namespace DetourNavigator
         const RecastParams params = makeRecastParams(settings, agentBounds);
 
         if (!rasterizeTriangles(context, tilePosition, agentBounds.mHalfExtents.z(), recastMesh, settings, params, solid))
-            return nullptr;
+            return false;
 
         rcFilterLowHangingWalkableObstacles(&context, params.mWalkableClimb, solid);
         rcFilterLedgeSpans(&context, params.mWalkableHeight, params.mWalkableClimb, solid);
         rcFilterWalkableLowHeightSpans(&context, params.mWalkableHeight, solid);
 
+        buildCompactHeightfield(context, params.mWalkableHeight, params.mWalkableClimb, solid, layer);
+
+        erodeWalkableArea(context, params.mWalkableRadius, layer);
+
+        return true;
+    }
+
+    std::unique_ptr<PreparedNavMeshData> prepareNavMeshTileData(rcCompactHeightfield& layer,
+        const std::vector<Obstacle>& obstacles, const AgentBounds& agentBounds, const RecastSettings& settings)
+    {
+        rcContext context;
+
+        const RecastParams params = makeRecastParams(settings, agentBounds);
+
+        markObstacles(context, obstacles, settings, agentBounds, layer);
+
         std::unique_ptr<PreparedNavMeshData> result = std::make_unique<PreparedNavMeshData>();
 
-        if (!fillPolyMesh(context, settings, params, solid, result->mPolyMesh, result->mPolyMeshDetail))
+        if (!fillPolyMesh(context, settings, params, layer, result->mPolyMesh, result->mPolyMeshDetail))
             return nullptr;
 
         result->mCellSize = settings.mCellSize;
@@ -461,6 +488,17 @@ namespace DetourNavigator
         return result;
     }
 
+    std::unique_ptr<PreparedNavMeshData> prepareNavMeshTileData(const RecastMesh& recastMesh,
+        const TilePosition& tilePosition, const AgentBounds& agentBounds, const RecastSettings& settings)
+    {
+        rcCompactHeightfield layer;
+
+        if (!prepareNavMeshLayer(recastMesh, tilePosition, agentBounds, settings, layer))
+            return nullptr;
+
+        return prepareNavMeshTileData(layer, recastMesh.getObstacles(), agentBounds, settings);
+    }
+
     NavMeshData makeNavMeshTileData(const PreparedNavMeshData& data,
         const std::vector<OffMeshConnection>& offMeshConnections, const AgentBounds& agentBounds,
         const TilePosition& tile, const RecastSettings& settings)
@@ -18,6 +18,7 @@
 
 class dtNavMesh;
 struct rcConfig;
+struct rcCompactHeightfield;
 
 namespace DetourNavigator
 {
@@ -50,6 +51,15 @@ namespace DetourNavigator
                 && recastMesh.getFlatHeightfields().empty();
     }
 
+    /// Rasterizes the static geometry of the tile into an eroded compact heightfield. This is the most expensive part
+    /// of the tile generation and doesn't depend on obstacles.
+    bool prepareNavMeshLayer(const RecastMesh& recastMesh, const TilePosition& tilePosition,
+        const AgentBounds& agentBounds, const RecastSettings& settings, rcCompactHeightfield& layer);
+
+    /// Carves obstacles out of the layer and builds polygons from it. The layer is modified.
+    std::unique_ptr<PreparedNavMeshData> prepareNavMeshTileData(rcCompactHeightfield& layer,
+        const std::vector<Obstacle>& obstacles, const AgentBounds& agentBounds, const RecastSettings& settings);
+
     std::unique_ptr<PreparedNavMeshData> prepareNavMeshTileData(const RecastMesh& recastMesh,
         const TilePosition& tilePosition, const AgentBounds& agentBounds, const RecastSettings& settings);
 
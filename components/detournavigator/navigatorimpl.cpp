@@ -7,6 +7,8 @@
 #include <components/misc/coordinateconverter.hpp>
 #include <components/misc/convert.hpp>
 
+#include <set>
+
 namespace DetourNavigator
 {
     NavigatorImpl::NavigatorImpl(const Settings& settings, std::unique_ptr<NavMeshDb>&& db)
@@ -46,24 +48,12 @@ namespace DetourNavigator
 
     bool NavigatorImpl::addObject(const ObjectId id, const ObjectShapes& shapes, const btTransform& transform)
     {
-        const CollisionShape collisionShape(shapes.mShapeInstance, *shapes.mShapeInstance->mCollisionShape, shapes.mTransform);
-        bool result = mNavMeshManager.addObject(id, collisionShape, transform, AreaType_ground);
-        if (const btCollisionShape* const avoidShape = shapes.mShapeInstance->mAvoidCollisionShape.get())
-        {
-            const ObjectId avoidId(avoidShape);
-            const CollisionShape avoidCollisionShape(shapes.mShapeInstance, *avoidShape, shapes.mTransform);
-            if (mNavMeshManager.addObject(avoidId, avoidCollisionShape, transform, AreaType_null))
-            {
-                updateAvoidShapeId(id, avoidId);
-                result = true;
-            }
-        }
-        return result;
+        return addObject(id, shapes, transform, true);
     }
 
     bool NavigatorImpl::addObject(const ObjectId id, const DoorShapes& shapes, const btTransform& transform)
     {
-        if (addObject(id, static_cast<const ObjectShapes&>(shapes), transform))
+        if (addObject(id, shapes, transform, false))
         {
             const osg::Vec3f start = toNavMeshCoordinates(mSettings.mRecast, shapes.mConnectionStart);
             const osg::Vec3f end = toNavMeshCoordinates(mSettings.mRecast, shapes.mConnectionEnd);
@@ -76,24 +66,12 @@ namespace DetourNavigator
 
     bool NavigatorImpl::updateObject(const ObjectId id, const ObjectShapes& shapes, const btTransform& transform)
     {
-        const CollisionShape collisionShape(shapes.mShapeInstance, *shapes.mShapeInstance->mCollisionShape, shapes.mTransform);
-        bool result = mNavMeshManager.updateObject(id, collisionShape, transform, AreaType_ground);
-        if (const btCollisionShape* const avoidShape = shapes.mShapeInstance->mAvoidCollisionShape.get())
-        {
-            const ObjectId avoidId(avoidShape);
-            const CollisionShape avoidCollisionShape(shapes.mShapeInstance, *avoidShape, shapes.mTransform);
-            if (mNavMeshManager.updateObject(avoidId, avoidCollisionShape, transform, AreaType_null))
-            {
-                updateAvoidShapeId(id, avoidId);
-                result = true;
-            }
-        }
-        return result;
+        return updateObject(id, shapes, transform, true);
     }
 
     bool NavigatorImpl::updateObject(const ObjectId id, const DoorShapes& shapes, const btTransform& transform)
     {
-        return updateObject(id, static_cast<const ObjectShapes&>(shapes), transform);
+        return updateObject(id, shapes, transform, false);
     }
 
     bool NavigatorImpl::removeObject(const ObjectId id)
@@ -155,6 +133,11 @@ namespace DetourNavigator
         if (!mUpdatesEnabled)
             return;
         removeUnusedNavMeshes();
+        std::set<AgentBounds> absentAgents;
+        for (const auto& [agentBounds, count] : mAgents)
+            if (count == 0)
+                absentAgents.insert(agentBounds);
+        mNavMeshManager.setAbsentAgents(std::move(absentAgents));
         for (const auto& v : mAgents)
             mNavMeshManager.update(playerPosition, v.first);
     }
@@ -204,6 +187,46 @@ namespace DetourNavigator
         return mNavMeshManager.getRecastMeshTiles();
     }
 
+    bool NavigatorImpl::addObject(const ObjectId id, const ObjectShapes& shapes, const btTransform& transform,
+        bool canBeObstacle)
+    {
+        const CollisionShape collisionShape(shapes.mShapeInstance, *shapes.mShapeInstance->mCollisionShape,
+            shapes.mTransform, canBeObstacle);
+        bool result = mNavMeshManager.addObject(id, collisionShape, transform, AreaType_ground);
+        if (const btCollisionShape* const avoidShape = shapes.mShapeInstance->mAvoidCollisionShape.get())
+        {
+            const ObjectId avoidId(avoidShape);
+            const CollisionShape avoidCollisionShape(shapes.mShapeInstance, *avoidShape, shapes.mTransform,
+                canBeObstacle);
+            if (mNavMeshManager.addObject(avoidId, avoidCollisionShape, transform, AreaType_null))
+            {
+                updateAvoidShapeId(id, avoidId);
+                result = true;
+            }
+        }
+        return result;
+    }
+
+    bool NavigatorImpl::updateObject(const ObjectId id, const ObjectShapes& shapes, const btTransform& transform,
+        bool canBeObstacle)
+    {
+        const CollisionShape collisionShape(shapes.mShapeInstance, *shapes.mShapeInstance->mCollisionShape,
+            shapes.mTransform, canBeObstacle);
+        bool result = mNavMeshManager.updateObject(id, collisionShape, transform, AreaType_ground);
+        if (const btCollisionShape* const avoidShape = shapes.mShapeInstance->mAvoidCollisionShape.get())
+        {
+            const ObjectId avoidId(avoidShape);
+            const CollisionShape avoidCollisionShape(shapes.mShapeInstance, *avoidShape, shapes.mTransform,
+                canBeObstacle);
+            if (mNavMeshManager.updateObject(avoidId, avoidCollisionShape, transform, AreaType_null))
+            {
+                updateAvoidShapeId(id, avoidId);
+                result = true;
+            }
+        }
+        return result;
+    }
+
     void NavigatorImpl::updateAvoidShapeId(const ObjectId id, const ObjectId avoidId)
     {
         updateId(id, avoidId, mWaterIds);
@@ -77,6 +77,10 @@ namespace DetourNavigator
         std::unordered_map<ObjectId, ObjectId> mAvoidIds;
         std::unordered_map<ObjectId, ObjectId> mWaterIds;
 
+        bool addObject(const ObjectId id, const ObjectShapes& shapes, const btTransform& transform,
+            bool canBeObstacle);
+        bool updateObject(const ObjectId id, const ObjectShapes& shapes, const btTransform& transform,
+            bool canBeObstacle);
         void updateAvoidShapeId(const ObjectId id, const ObjectId avoidId);
         void updateWaterShapeId(const ObjectId id, const ObjectId waterId);
         void updateId(const ObjectId id, const ObjectId waterId, std::unordered_map<ObjectId, ObjectId>& ids);
@@ -11,7 +11,10 @@
 #include <sqlite3.h>
 
 #include <cstddef>
+#include <iterator>
+#include <limits>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 namespace DetourNavigator
@@ -73,6 +76,14 @@ namespace DetourNavigator
                AND input = :input
         )";
 
+        constexpr std::string_view getTilesDataQuery = R"(
+            SELECT tile_id, version, data
+              FROM tiles
+             WHERE tile_id > :after_tile_id
+             ORDER BY tile_id
+             LIMIT :limit
+        )";
+
         constexpr std::string_view insertTileQuery = R"(
             INSERT INTO tiles ( tile_id,  worldspace,  version,  tile_position_x,  tile_position_y,  input,  data)
                    VALUES     (:tile_id, :worldspace, :version, :tile_position_x, :tile_position_y, :input, :data)
@@ -152,6 +163,13 @@ namespace DetourNavigator
             if (const int ec = sqlite3_exec(&db, query.c_str(), nullptr, nullptr, nullptr); ec != SQLITE_OK)
                 throw std::runtime_error("Failed set max page count: " + std::string(sqlite3_errmsg(&db)));
         }
+
+        void setMmapSize(sqlite3& db, std::uint64_t value)
+        {
+            const auto query = Misc::StringUtils::format("pragma mmap_size = %lu;", value);
+            if (const int ec = sqlite3_exec(&db, query.c_str(), nullptr, nullptr, nullptr); ec != SQLITE_OK)
+                throw std::runtime_error("Failed set mmap size: " + std::string(sqlite3_errmsg(&db)));
+        }
     }
 
     std::ostream& operator<<(std::ostream& stream, ShapeType value)
@@ -164,11 +182,14 @@ namespace DetourNavigator
         return stream << "unknown shape type (" << static_cast<std::underlying_type_t<ShapeType>>(value) << ")";
     }
 
-    NavMeshDb::NavMeshDb(std::string_view path, std::uint64_t maxFileSize)
-        : mDb(Sqlite3::makeDb(path, schema))
+    NavMeshDb::NavMeshDb(std::string_view path, std::uint64_t maxFileSize, int compressionLevel,
+        std::uint64_t mmapSize)
+        : mCompressionLevel(compressionLevel)
+        , mDb(Sqlite3::makeDb(path, schema))
         , mGetMaxTileId(*mDb, DbQueries::GetMaxTileId {})
         , mFindTile(*mDb, DbQueries::FindTile {})
         , mGetTileData(*mDb, DbQueries::GetTileData {})
+        , mGetTilesData(*mDb, DbQueries::GetTilesData {})
         , mInsertTile(*mDb, DbQueries::InsertTile {})
         , mUpdateTile(*mDb, DbQueries::UpdateTile {})
         , mDeleteTilesAt(*mDb, DbQueries::DeleteTilesAt {})
@@ -183,6 +204,8 @@ namespace DetourNavigator
         if (dbPageSize == 0)
             throw std::runtime_error("NavMeshDb page size is zero");
         setMaxPageCount(*mDb, maxFileSize / dbPageSize + static_cast<std::uint64_t>((maxFileSize % dbPageSize) != 0));
+        if (mmapSize > 0)
+            setMmapSize(*mDb, mmapSize);
     }
 
     Sqlite3::Transaction NavMeshDb::startTransaction(Sqlite3::TransactionMode mode)
@@ -212,11 +235,25 @@ namespace DetourNavigator
         const TilePosition& tilePosition, const std::vector<std::byte>& input)
     {
         TileData result;
-        auto row = std::tie(result.mTileId, result.mVersion, result.mData);
+        // Decompress directly from the statement memory to avoid copying compressed data
+        Sqlite3::ConstBlob data {nullptr, 0};
+        auto row = std::tie(result.mTileId, result.mVersion, data);
         const std::vector<std::byte> compressedInput = Misc::compress(input);
         if (&row == request(*mDb, mGetTileData, &row, 1, worldspace, tilePosition, compressedInput))
             return {};
-        result.mData = Misc::decompress(result.mData);
+        result.mData = Misc::decompress(reinterpret_cast<const std::byte*>(data.mData), static_cast<std::size_t>(data.mSize));
+        return result;
+    }
+
+    std::vector<TileData> NavMeshDb::getTilesData(TileId afterTileId, int limit)
+    {
+        std::vector<TileData> result;
+        std::vector<std::tuple<TileId, TileVersion, std::vector<std::byte>>> rows;
+        request(*mDb, mGetTilesData, std::back_inserter(rows), std::numeric_limits<std::size_t>::max(),
+            afterTileId, limit);
+        result.reserve(rows.size());
+        for (auto& [tileId, version, data] : rows)
+            result.push_back(TileData {tileId, version, Misc::decompress(data)});
         return result;
     }
 
@@ -224,13 +261,13 @@ namespace DetourNavigator
         TileVersion version, const std::vector<std::byte>& input, const std::vector<std::byte>& data)
     {
         const std::vector<std::byte> compressedInput = Misc::compress(input);
-        const std::vector<std::byte> compressedData = Misc::compress(data);
+        const std::vector<std::byte> compressedData = Misc::compress(data, mCompressionLevel);
         return execute(*mDb, mInsertTile, tileId, worldspace, tilePosition, version, compressedInput, compressedData);
     }
 
     int NavMeshDb::updateTile(TileId tileId, TileVersion version, const std::vector<std::byte>& data)
     {
-        const std::vector<std::byte> compressedData = Misc::compress(data);
+        const std::vector<std::byte> compressedData = Misc::compress(data, mCompressionLevel);
         return execute(*mDb, mUpdateTile, tileId, version, compressedData);
     }
 
@@ -311,6 +348,17 @@ namespace DetourNavigator
             Sqlite3::bindParameter(db, statement, ":input", input);
         }
 
+        std::string_view GetTilesData::text() noexcept
+        {
+            return getTilesDataQuery;
+        }
+
+        void GetTilesData::bind(sqlite3& db, sqlite3_stmt& statement, TileId afterTileId, int limit)
+        {
+            Sqlite3::bindParameter(db, statement, ":after_tile_id", afterTileId);
+            Sqlite3::bindParameter(db, statement, ":limit", limit);
+        }
+
         std::string_view InsertTile::text() noexcept
         {
             return insertTileQuery;
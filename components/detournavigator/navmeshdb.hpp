@@ -75,6 +75,12 @@ namespace DetourNavigator
                 const TilePosition& tilePosition, const std::vector<std::byte>& input);
         };
 
+        struct GetTilesData
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, TileId afterTileId, int limit);
+        };
+
         struct InsertTile
         {
             static std::string_view text() noexcept;
@@ -141,7 +147,11 @@ namespace DetourNavigator
     class NavMeshDb
     {
     public:
-        explicit NavMeshDb(std::string_view path, std::uint64_t maxFileSize);
+        /// \param compressionLevel LZ4 HC level for written tiles, 0 to use fast LZ4. Tiles are read the same way
+        /// for any level.
+        /// \param mmapSize Max number of bytes of the db file to access with memory-mapped I/O, 0 to disable.
+        explicit NavMeshDb(std::string_view path, std::uint64_t maxFileSize, int compressionLevel = 0,
+            std::uint64_t mmapSize = 0);
 
         Sqlite3::Transaction startTransaction(Sqlite3::TransactionMode mode = Sqlite3::TransactionMode::Default);
 
@@ -153,6 +163,9 @@ namespace DetourNavigator
         std::optional<TileData> getTileData(std::string_view worldspace,
             const TilePosition& tilePosition, const std::vector<std::byte>& input);
 
+        /// Returns up to limit tiles with id greater than afterTileId ordered by id.
+        std::vector<TileData> getTilesData(TileId afterTileId, int limit);
+
         int insertTile(TileId tileId, std::string_view worldspace, const TilePosition& tilePosition,
             TileVersion version, const std::vector<std::byte>& input, const std::vector<std::byte>& data);
 
@@ -173,10 +186,12 @@ namespace DetourNavigator
         void vacuum();
 
     private:
+        int mCompressionLevel;
         Sqlite3::Db mDb;
         Sqlite3::Statement<DbQueries::GetMaxTileId> mGetMaxTileId;
         Sqlite3::Statement<DbQueries::FindTile> mFindTile;
         Sqlite3::Statement<DbQueries::GetTileData> mGetTileData;
+        Sqlite3::Statement<DbQueries::GetTilesData> mGetTilesData;
         Sqlite3::Statement<DbQueries::InsertTile> mInsertTile;
         Sqlite3::Statement<DbQueries::UpdateTile> mUpdateTile;
         Sqlite3::Statement<DbQueries::DeleteTilesAt> mDeleteTilesAt;
@@ -0,0 +1,224 @@
+#include "navmeshlayerscache.hpp"
+#include "recast.hpp"
+
+#include <Recast.h>
+
+#include <lz4.h>
+
+#include <osg/Stats>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        struct LayerHeader
+        {
+            int mWidth;
+            int mHeight;
+            int mSpanCount;
+            int mWalkableHeight;
+            int mWalkableClimb;
+            int mBorderSize;
+            unsigned short mMaxDistance;
+            unsigned short mMaxRegions;
+            float mBmin[3];
+            float mBmax[3];
+            float mCellSize;
+            float mCellHeight;
+            std::uint32_t mCompressedSize;
+        };
+
+        std::size_t getCellsSize(const LayerHeader& header)
+        {
+            return static_cast<std::size_t>(header.mWidth) * static_cast<std::size_t>(header.mHeight)
+                * sizeof(rcCompactCell);
+        }
+
+        std::size_t getSpansSize(const LayerHeader& header)
+        {
+            return static_cast<std::size_t>(header.mSpanCount) * sizeof(rcCompactSpan);
+        }
+
+        std::size_t getAreasSize(const LayerHeader& header)
+        {
+            return static_cast<std::size_t>(header.mSpanCount) * sizeof(unsigned char);
+        }
+
+        std::vector<char> compress(const rcCompactHeightfield& layer)
+        {
+            LayerHeader header;
+            header.mWidth = layer.width;
+            header.mHeight = layer.height;
+            header.mSpanCount = layer.spanCount;
+            header.mWalkableHeight = layer.walkableHeight;
+            header.mWalkableClimb = layer.walkableClimb;
+            header.mBorderSize = layer.borderSize;
+            header.mMaxDistance = layer.maxDistance;
+            header.mMaxRegions = layer.maxRegions;
+            rcVcopy(header.mBmin, layer.bmin);
+            rcVcopy(header.mBmax, layer.bmax);
+            header.mCellSize = layer.cs;
+            header.mCellHeight = layer.ch;
+
+            const std::size_t cellsSize = getCellsSize(header);
+            const std::size_t spansSize = getSpansSize(header);
+            const std::size_t areasSize = getAreasSize(header);
+
+            std::vector<char> raw(cellsSize + spansSize + areasSize);
+            std::memcpy(raw.data(), layer.cells, cellsSize);
+            std::memcpy(raw.data() + cellsSize, layer.spans, spansSize);
+            std::memcpy(raw.data() + cellsSize + spansSize, layer.areas, areasSize);
+
+            std::vector<char> result(sizeof(header) + static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(raw.size()))));
+            const int compressedSize = LZ4_compress_default(raw.data(), result.data() + sizeof(header),
+                static_cast<int>(raw.size()), static_cast<int>(result.size() - sizeof(header)));
+            if (compressedSize <= 0)
+                throw std::runtime_error("Failed to compress navmesh layer");
+
+            header.mCompressedSize = static_cast<std::uint32_t>(compressedSize);
+            std::memcpy(result.data(), &header, sizeof(header));
+            result.resize(sizeof(header) + header.mCompressedSize);
+            result.shrink_to_fit();
+            return result;
+        }
+
+        void decompress(const std::vector<char>& data, rcCompactHeightfield& layer)
+        {
+            LayerHeader header;
+            std::memcpy(&header, data.data(), sizeof(header));
+
+            const std::size_t cellsSize = getCellsSize(header);
+            const std::size_t spansSize = getSpansSize(header);
+            const std::size_t areasSize = getAreasSize(header);
+
+            std::vector<char> raw(cellsSize + spansSize + areasSize);
+            const int decompressedSize = LZ4_decompress_safe(data.data() + sizeof(header), raw.data(),
+                static_cast<int>(header.mCompressedSize), static_cast<int>(raw.size()));
+            if (decompressedSize < 0 || static_cast<std::size_t>(decompressedSize) != raw.size())
+                throw std::runtime_error("Failed to decompress navmesh layer");
+
+            layer.width = header.mWidth;
+            layer.height = header.mHeight;
+            layer.spanCount = header.mSpanCount;
+            layer.walkableHeight = header.mWalkableHeight;
+            layer.walkableClimb = header.mWalkableClimb;
+            layer.borderSize = header.mBorderSize;
+            layer.maxDistance = header.mMaxDistance;
+            layer.maxRegions = header.mMaxRegions;
+            rcVcopy(layer.bmin, header.mBmin);
+            rcVcopy(layer.bmax, header.mBmax);
+            layer.cs = header.mCellSize;
+            layer.ch = header.mCellHeight;
+
+            // Freed by rcCompactHeightfield destructor
+            layer.cells = static_cast<rcCompactCell*>(permRecastAlloc(cellsSize));
+            layer.spans = static_cast<rcCompactSpan*>(permRecastAlloc(spansSize));
+            layer.areas = static_cast<unsigned char*>(permRecastAlloc(areasSize));
+
+            std::memcpy(layer.cells, raw.data(), cellsSize);
+            std::memcpy(layer.spans, raw.data() + cellsSize, spansSize);
+            std::memcpy(layer.areas, raw.data() + cellsSize + spansSize, areasSize);
+        }
+
+        bool hasSameGeometry(const RecastMesh& lhs, const RecastMesh& rhs)
+        {
+            const auto tie = [] (const RecastMesh& v)
+            {
+                return std::tie(v.getMesh(), v.getWater(), v.getHeightfields(), v.getFlatHeightfields());
+            };
+            return !(tie(lhs) < tie(rhs)) && !(tie(rhs) < tie(lhs));
+        }
+    }
+
+    NavMeshLayersCache::NavMeshLayersCache(std::size_t maxSize)
+        : mMaxSize(maxSize)
+    {
+    }
+
+    bool NavMeshLayersCache::get(const AgentBounds& agentBounds, const TilePosition& tilePosition,
+        const RecastMesh& recastMesh, rcCompactHeightfield& layer)
+    {
+        std::vector<char> data;
+        {
+            const std::lock_guard lock(mMutex);
+
+            ++mGetCount;
+
+            const auto value = mValues.find(Key(agentBounds, tilePosition, recastMesh.getHash()));
+            if (value == mValues.end())
+                return false;
+
+            if (&recastMesh != value->second->mRecastMesh.get()
+                    && !hasSameGeometry(recastMesh, *value->second->mRecastMesh))
+                return false;
+
+            mItems.splice(mItems.begin(), mItems, value->second);
+            data = value->second->mData;
+
+            ++mHitCount;
+        }
+
+        decompress(data, layer);
+
+        return true;
+    }
+
+    void NavMeshLayersCache::set(const AgentBounds& agentBounds, const TilePosition& tilePosition,
+        const std::shared_ptr<const RecastMesh>& recastMesh, const rcCompactHeightfield& layer)
+    {
+        std::vector<char> data = compress(layer);
+        const std::size_t size = sizeof(Item) + data.size() + sizeof(RecastMesh) + getSize(*recastMesh);
+
+        const std::lock_guard lock(mMutex);
+
+        if (size > mMaxSize)
+            return;
+
+        const Key key(agentBounds, tilePosition, recastMesh->getHash());
+
+        if (const auto value = mValues.find(key); value != mValues.end())
+            remove(value);
+
+        while (!mItems.empty() && mSize + size > mMaxSize)
+        {
+            const Item& item = mItems.back();
+            remove(mValues.find(Key(item.mAgentBounds, item.mTilePosition, item.mRecastMesh->getHash())));
+        }
+
+        mItems.push_front(Item {agentBounds, tilePosition, recastMesh, std::move(data), size});
+        mValues.emplace(key, mItems.begin());
+        mSize += size;
+    }
+
+    NavMeshLayersCache::Stats NavMeshLayersCache::getStats() const
+    {
+        Stats result;
+        {
+            const std::lock_guard lock(mMutex);
+            result.mSize = mSize;
+            result.mLayers = mItems.size();
+            result.mHitCount = mHitCount;
+            result.mGetCount = mGetCount;
+        }
+        return result;
+    }
+
+    void NavMeshLayersCache::remove(std::map<Key, std::list<Item>::iterator>::iterator value)
+    {
+        mSize -= value->second->mSize;
+        mItems.erase(value->second);
+        mValues.erase(value);
+    }
+
+    void reportStats(const NavMeshLayersCache::Stats& stats, unsigned int frameNumber, osg::Stats& out)
+    {
+        out.setAttribute(frameNumber, "NavMesh LayersCacheSize", static_cast<double>(stats.mSize));
+        out.setAttribute(frameNumber, "NavMesh CachedLayers", static_cast<double>(stats.mLayers));
+        if (stats.mGetCount > 0)
+            out.setAttribute(frameNumber, "NavMesh LayersCacheHitRate",
+                static_cast<double>(stats.mHitCount) / stats.mGetCount * 100.0);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHLAYERSCACHE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHLAYERSCACHE_H
+
+#include "recastmesh.hpp"
+#include "tileposition.hpp"
+#include "agentbounds.hpp"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+struct rcCompactHeightfield;
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace DetourNavigator
+{
+    /// Keeps LZ4 compressed layers, eroded compact heightfields of the static geometry of tiles, so tiles with obstacles
+    /// are rebuilt from a layer instead of being rasterized again when only obstacles change. Layers are keyed by the
+    /// recast mesh hash, the geometry is compared only when hashes are equal. Least recently used layers are dropped
+    /// when the cache is full.
+    class NavMeshLayersCache
+    {
+    public:
+        struct Stats
+        {
+            std::size_t mSize;
+            std::size_t mLayers;
+            std::size_t mHitCount;
+            std::size_t mGetCount;
+        };
+
+        explicit NavMeshLayersCache(std::size_t maxSize);
+
+        /// Decompresses the layer into a default constructed compact heightfield, returns false when not cached.
+        bool get(const AgentBounds& agentBounds, const TilePosition& tilePosition, const RecastMesh& recastMesh,
+            rcCompactHeightfield& layer);
+
+        void set(const AgentBounds& agentBounds, const TilePosition& tilePosition,
+            const std::shared_ptr<const RecastMesh>& recastMesh, const rcCompactHeightfield& layer);
+
+        Stats getStats() const;
+
+    private:
+        struct Item
+        {
+            AgentBounds mAgentBounds;
+            TilePosition mTilePosition;
+            std::shared_ptr<const RecastMesh> mRecastMesh;
+            std::vector<char> mData;
+            std::size_t mSize;
+        };
+
+        using Key = std::tuple<AgentBounds, TilePosition, RecastMeshHash>;
+
+        mutable std::mutex mMutex;
+        std::size_t mMaxSize;
+        std::size_t mSize = 0;
+        std::size_t mHitCount = 0;
+        std::size_t mGetCount = 0;
+        std::list<Item> mItems;
+        std::map<Key, std::list<Item>::iterator> mValues;
+
+        void remove(std::map<Key, std::list<Item>::iterator>::iterator value);
+    };
+
+    void reportStats(const NavMeshLayersCache::Stats& stats, unsigned int frameNumber, osg::Stats& out);
+}
+
+#endif
@@ -257,6 +257,11 @@ namespace DetourNavigator
             " recastMeshManagerRevision=" << lastRevision;
     }
 
+    void NavMeshManager::setAbsentAgents(std::set<AgentBounds>&& agents)
+    {
+        mAsyncNavMeshUpdater.setAbsentAgents(std::move(agents));
+    }
+
     void NavMeshManager::wait(Loading::Listener& listener, WaitConditionType waitConditionType)
     {
         mAsyncNavMeshUpdater.wait(listener, waitConditionType);
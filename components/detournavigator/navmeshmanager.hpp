@@ -13,6 +13,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 
 class dtNavMesh;
 
@@ -53,6 +54,8 @@ namespace DetourNavigator
 
         void update(const osg::Vec3f& playerPosition, const AgentBounds& agentBounds);
 
+        void setAbsentAgents(std::set<AgentBounds>&& agents);
+
         void wait(Loading::Listener& listener, WaitConditionType waitConditionType);
 
         SharedNavMeshCacheItem getNavMesh(const AgentBounds& agentBounds) const;
@@ -42,8 +42,8 @@ namespace DetourNavigator
         while (!mFreeItems.empty() && mUsedNavMeshDataSize + itemSize > mMaxNavMeshDataSize)
             removeLeastRecentlyUsed();
 
-        RecastMeshData key {recastMesh.getMesh(), recastMesh.getWater(),
-                    recastMesh.getHeightfields(), recastMesh.getFlatHeightfields()};
+        RecastMeshData key {recastMesh.getHash(), recastMesh.getMesh(), recastMesh.getWater(),
+                    recastMesh.getHeightfields(), recastMesh.getFlatHeightfields(), recastMesh.getObstacles()};
 
         const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentBounds, changedTile, std::move(key), itemSize);
         const auto emplaced = mValues.emplace(std::make_tuple(agentBounds, changedTile, std::cref(iterator->mRecastMeshData)), iterator);
@@ -60,6 +60,7 @@ namespace DetourNavigator
         iterator->mPreparedNavMeshData = std::move(value);
         ++iterator->mUseCount;
         mUsedNavMeshDataSize += itemSize;
+        mAgentsNavMeshDataSize[agentBounds] += itemSize;
         mBusyItems.splice(mBusyItems.end(), mFreeItems, iterator);
 
         return Value(*this, iterator);
@@ -75,6 +76,7 @@ namespace DetourNavigator
             result.mCachedNavMeshTiles = mFreeItems.size();
             result.mHitCount = mHitCount;
             result.mGetCount = mGetCount;
+            result.mAgentsNavMeshCacheSize = mAgentsNavMeshDataSize;
         }
         return result;
     }
@@ -84,6 +86,7 @@ namespace DetourNavigator
         out.setAttribute(frameNumber, "NavMesh CacheSize", static_cast<double>(stats.mNavMeshCacheSize));
         out.setAttribute(frameNumber, "NavMesh UsedTiles", static_cast<double>(stats.mUsedNavMeshTiles));
         out.setAttribute(frameNumber, "NavMesh CachedTiles", static_cast<double>(stats.mCachedNavMeshTiles));
+        out.setAttribute(frameNumber, "NavMesh CacheAgents", static_cast<double>(stats.mAgentsNavMeshCacheSize.size()));
         if (stats.mGetCount > 0)
             out.setAttribute(frameNumber, "NavMesh CacheHitRate", static_cast<double>(stats.mHitCount) / stats.mGetCount * 100.0);
     }
@@ -99,6 +102,10 @@ namespace DetourNavigator
         mUsedNavMeshDataSize -= item.mSize;
         mFreeNavMeshDataSize -= item.mSize;
 
+        const auto agent = mAgentsNavMeshDataSize.find(item.mAgentBounds);
+        if (agent != mAgentsNavMeshDataSize.end() && (agent->second -= item.mSize) == 0)
+            mAgentsNavMeshDataSize.erase(agent);
+
         mValues.erase(value);
         mFreeItems.pop_back();
     }
@@ -23,28 +23,34 @@ namespace DetourNavigator
 {
     struct RecastMeshData
     {
+        RecastMeshHash mHash;
         Mesh mMesh;
         std::vector<CellWater> mWater;
         std::vector<Heightfield> mHeightfields;
         std::vector<FlatHeightfield> mFlatHeightfields;
+        std::vector<Obstacle> mObstacles;
     };
 
+    // Keys are ordered by the content hash first, so the full geometry is compared only when hashes are equal. Tiles
+    // of the same cell share most of their heightfields, which makes a lexicographic comparison walk deep into them.
     inline bool operator <(const RecastMeshData& lhs, const RecastMeshData& rhs)
     {
-        return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-                < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
+        return std::tie(lhs.mHash, lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields, lhs.mObstacles)
+                < std::tie(rhs.mHash, rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields, rhs.mObstacles);
     }
 
     inline bool operator <(const RecastMeshData& lhs, const RecastMesh& rhs)
     {
-        return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-                < std::tie(rhs.getMesh(), rhs.getWater(), rhs.getHeightfields(), rhs.getFlatHeightfields());
+        return std::tie(lhs.mHash, lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields, lhs.mObstacles)
+                < std::tie(rhs.getHash(), rhs.getMesh(), rhs.getWater(), rhs.getHeightfields(), rhs.getFlatHeightfields(),
+                           rhs.getObstacles());
     }
 
     inline bool operator <(const RecastMesh& lhs, const RecastMeshData& rhs)
     {
-        return std::tie(lhs.getMesh(), lhs.getWater(), lhs.getHeightfields(), lhs.getFlatHeightfields())
-                < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
+        return std::tie(lhs.getHash(), lhs.getMesh(), lhs.getWater(), lhs.getHeightfields(), lhs.getFlatHeightfields(),
+                        lhs.getObstacles())
+                < std::tie(rhs.mHash, rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields, rhs.mObstacles);
     }
 
     class NavMeshTilesCache
@@ -133,6 +139,7 @@ namespace DetourNavigator
             std::size_t mCachedNavMeshTiles;
             std::size_t mHitCount;
             std::size_t mGetCount;
+            std::map<AgentBounds, std::size_t> mAgentsNavMeshCacheSize; ///< Size of cached tiles per agent.
         };
 
         NavMeshTilesCache(const std::size_t maxNavMeshDataSize);
@@ -152,6 +159,7 @@ namespace DetourNavigator
         std::size_t mFreeNavMeshDataSize;
         std::size_t mHitCount;
         std::size_t mGetCount;
+        std::map<AgentBounds, std::size_t> mAgentsNavMeshDataSize;
         std::list<Item> mBusyItems;
         std::list<Item> mFreeItems;
         std::map<std::tuple<AgentBounds, TilePosition, std::reference_wrapper<const RecastMeshData>>, ItemIterator, std::less<>> mValues;
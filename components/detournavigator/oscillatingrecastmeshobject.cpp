@@ -40,6 +40,7 @@ namespace DetourNavigator
             return false;
         if (transform == oldTransform)
             return true;
+        mMoved = true;
         if (mLastChangeRevision != lastChangeRevision)
         {
             mLastChangeRevision = lastChangeRevision;
@@ -21,10 +21,17 @@ namespace DetourNavigator
 
             const RecastMeshObject& getImpl() const { return mImpl; }
 
+            /// Bounds covering all positions since the last reported navmesh change.
+            const btAABB& getAabb() const { return mAabb; }
+
+            /// Whether the transform has ever been changed.
+            bool isMoved() const { return mMoved; }
+
         private:
             RecastMeshObject mImpl;
             std::size_t mLastChangeRevision;
             btAABB mAabb;
+            bool mMoved = false;
     };
 }
 
@@ -0,0 +1,74 @@
+#include "playertrajectory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        // Longer jumps are teleports or cell changes and don't define velocity
+        constexpr int maxTileShift = 2;
+        constexpr std::chrono::seconds maxTileChangeInterval(5);
+        // Player is considered to stop when there is no tile change for the time to pass this number of tiles
+        constexpr float maxTilesWithoutChange = 2;
+        constexpr float maxPredictedDistance = 4;
+        constexpr float smoothFactor = 0.5f;
+
+        float toSeconds(std::chrono::steady_clock::duration value)
+        {
+            return std::chrono::duration_cast<std::chrono::duration<float>>(value).count();
+        }
+    }
+
+    PlayerTrajectory::PlayerTrajectory(std::chrono::milliseconds predictionTime)
+        : mPredictionTime(predictionTime)
+        , mVelocity(0, 0)
+    {
+    }
+
+    void PlayerTrajectory::update(const TilePosition& playerTile, std::chrono::steady_clock::time_point now)
+    {
+        if (mTile == playerTile)
+            return;
+
+        const std::chrono::steady_clock::duration elapsed = now - mLastChange;
+
+        if (!mTile.has_value() || elapsed <= std::chrono::steady_clock::duration::zero()
+                || elapsed > maxTileChangeInterval
+                || std::max(std::abs(playerTile.x() - mTile->x()), std::abs(playerTile.y() - mTile->y())) > maxTileShift)
+        {
+            mVelocity = osg::Vec2f(0, 0);
+        }
+        else
+        {
+            const float seconds = toSeconds(elapsed);
+            const osg::Vec2f velocity(static_cast<float>(playerTile.x() - mTile->x()) / seconds,
+                                      static_cast<float>(playerTile.y() - mTile->y()) / seconds);
+            if (mVelocity.length2() == 0)
+                mVelocity = velocity;
+            else
+                mVelocity = mVelocity * (1 - smoothFactor) + velocity * smoothFactor;
+        }
+
+        mTile = playerTile;
+        mLastChange = now;
+    }
+
+    TilePosition PlayerTrajectory::getPredictedTile(std::chrono::steady_clock::time_point now) const
+    {
+        if (!mTile.has_value())
+            return TilePosition(0, 0);
+
+        const float speed = mVelocity.length();
+
+        if (speed == 0 || mPredictionTime.count() <= 0 || toSeconds(now - mLastChange) * speed > maxTilesWithoutChange)
+            return *mTile;
+
+        const float distance = std::min(speed * toSeconds(mPredictionTime), maxPredictedDistance);
+        const osg::Vec2f shift = mVelocity * (distance / speed);
+
+        return *mTile + TilePosition(static_cast<int>(std::round(shift.x())), static_cast<int>(std::round(shift.y())));
+    }
+}
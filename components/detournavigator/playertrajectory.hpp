@@ -0,0 +1,33 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_PLAYERTRAJECTORY_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_PLAYERTRAJECTORY_H
+
+#include "tileposition.hpp"
+
+#include <osg/Vec2f>
+
+#include <chrono>
+#include <optional>
+
+namespace DetourNavigator
+{
+    // Estimates player velocity in tiles per second from tile changes to predict where the player will be
+    class PlayerTrajectory
+    {
+    public:
+        explicit PlayerTrajectory(std::chrono::milliseconds predictionTime);
+
+        void update(const TilePosition& playerTile, std::chrono::steady_clock::time_point now);
+
+        TilePosition getPredictedTile(std::chrono::steady_clock::time_point now) const;
+
+        osg::Vec2f getVelocity() const { return mVelocity; }
+
+    private:
+        const std::chrono::milliseconds mPredictionTime;
+        std::optional<TilePosition> mTile;
+        std::chrono::steady_clock::time_point mLastChange;
+        osg::Vec2f mVelocity;
+    };
+}
+
+#endif
@@ -3,8 +3,88 @@
 
 #include <Recast.h>
 
+#include <extern/smhasher/MurmurHash3.h>
+
+#include <type_traits>
+
 namespace DetourNavigator
 {
+    namespace
+    {
+        struct HashWriter
+        {
+            std::vector<char> mData;
+
+            template <class T>
+            void write(const T* values, std::size_t count)
+            {
+                static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+                const char* const data = reinterpret_cast<const char*>(values);
+                mData.insert(mData.end(), data, data + count * sizeof(T));
+            }
+
+            template <class T>
+            void write(const T& value)
+            {
+                write(&value, 1);
+            }
+
+            template <class T>
+            void write(const std::vector<T>& values)
+            {
+                write(values.size());
+                write(values.data(), values.size());
+            }
+
+            void write(const osg::Vec2i& value)
+            {
+                write(value.x());
+                write(value.y());
+            }
+        };
+    }
+
+    RecastMeshHash makeRecastMeshHash(const Mesh& mesh, const std::vector<CellWater>& water,
+        const std::vector<Heightfield>& heightfields, const std::vector<FlatHeightfield>& flatHeightfields)
+    {
+        HashWriter writer;
+        writer.write(mesh.getIndices());
+        writer.write(mesh.getVertices());
+        writer.write(mesh.getAreaTypes());
+        writer.write(water.size());
+        for (const CellWater& v : water)
+        {
+            writer.write(v.mCellPosition);
+            writer.write(v.mWater.mCellSize);
+            writer.write(v.mWater.mLevel);
+        }
+        writer.write(heightfields.size());
+        for (const Heightfield& v : heightfields)
+        {
+            writer.write(v.mCellPosition);
+            writer.write(v.mCellSize);
+            writer.write(v.mLength);
+            writer.write(v.mMinHeight);
+            writer.write(v.mMaxHeight);
+            writer.write(v.mHeights);
+            writer.write(v.mOriginalSize);
+            writer.write(v.mMinX);
+            writer.write(v.mMinY);
+        }
+        writer.write(flatHeightfields.size());
+        for (const FlatHeightfield& v : flatHeightfields)
+        {
+            writer.write(v.mCellPosition);
+            writer.write(v.mCellSize);
+            writer.write(v.mHeight);
+        }
+
+        const RecastMeshHash seed {0, 0};
+        RecastMeshHash result;
+        MurmurHash3_x64_128(writer.mData.data(), static_cast<int>(writer.mData.size()), seed.data(), result.data());
+        return result;
+    }
+
     Mesh::Mesh(std::vector<int>&& indices, std::vector<float>&& vertices, std::vector<AreaType>&& areaTypes)
     {
         if (indices.size() / 3 != areaTypes.size())
@@ -20,7 +100,7 @@ namespace DetourNavigator
 
     RecastMesh::RecastMesh(std::size_t generation, std::size_t revision, Mesh mesh, std::vector<CellWater> water,
         std::vector<Heightfield> heightfields, std::vector<FlatHeightfield> flatHeightfields,
-        std::vector<MeshSource> meshSources)
+        std::vector<MeshSource> meshSources, std::vector<Obstacle> obstacles)
         : mGeneration(generation)
         , mRevision(revision)
         , mMesh(std::move(mesh))
@@ -28,10 +108,12 @@ namespace DetourNavigator
         , mHeightfields(std::move(heightfields))
         , mFlatHeightfields(std::move(flatHeightfields))
         , mMeshSources(std::move(meshSources))
+        , mObstacles(std::move(obstacles))
     {
         mWater.shrink_to_fit();
         mHeightfields.shrink_to_fit();
         for (Heightfield& v : mHeightfields)
             v.mHeights.shrink_to_fit();
+        mHash = makeRecastMeshHash(mMesh, mWater, mHeightfields, mFlatHeightfields);
     }
 }
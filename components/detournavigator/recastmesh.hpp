@@ -12,6 +12,7 @@
 #include <osg/Vec3f>
 #include <osg/Vec2i>
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -122,6 +123,27 @@ namespace DetourNavigator
         return tie(lhs) < tie(rhs);
     }
 
+    /// Axis aligned bounds of a moving object. Obstacles are carved out of the walkable area of a tile instead of being
+    /// rasterized, so moving them doesn't require to rasterize the tile again.
+    struct Obstacle
+    {
+        osg::Vec3f mMin;
+        osg::Vec3f mMax;
+    };
+
+    inline bool operator<(const Obstacle& lhs, const Obstacle& rhs) noexcept
+    {
+        const auto tie = [] (const Obstacle& v) { return std::tie(v.mMin, v.mMax); };
+        return tie(lhs) < tie(rhs);
+    }
+
+    /// 128 bit content hash of the geometry of a recast mesh: mesh, water, heightfields and flat heightfields. Obstacles
+    /// are not included, so meshes which differ only by obstacles share the hash.
+    using RecastMeshHash = std::array<std::uint64_t, 2>;
+
+    RecastMeshHash makeRecastMeshHash(const Mesh& mesh, const std::vector<CellWater>& water,
+        const std::vector<Heightfield>& heightfields, const std::vector<FlatHeightfield>& flatHeightfields);
+
     struct MeshSource
     {
         osg::ref_ptr<const Resource::BulletShape> mShape;
@@ -134,7 +156,7 @@ namespace DetourNavigator
     public:
         RecastMesh(std::size_t generation, std::size_t revision, Mesh mesh, std::vector<CellWater> water,
             std::vector<Heightfield> heightfields, std::vector<FlatHeightfield> flatHeightfields,
-            std::vector<MeshSource> sources);
+            std::vector<MeshSource> sources, std::vector<Obstacle> obstacles = {});
 
         std::size_t getGeneration() const
         {
@@ -165,6 +187,10 @@ namespace DetourNavigator
 
         const std::vector<MeshSource>& getMeshSources() const noexcept { return mMeshSources; }
 
+        const std::vector<Obstacle>& getObstacles() const noexcept { return mObstacles; }
+
+        const RecastMeshHash& getHash() const noexcept { return mHash; }
+
     private:
         std::size_t mGeneration;
         std::size_t mRevision;
@@ -173,6 +199,8 @@ namespace DetourNavigator
         std::vector<Heightfield> mHeightfields;
         std::vector<FlatHeightfield> mFlatHeightfields;
         std::vector<MeshSource> mMeshSources;
+        std::vector<Obstacle> mObstacles;
+        RecastMeshHash mHash;
 
         friend inline std::size_t getSize(const RecastMesh& value) noexcept
         {
@@ -180,7 +208,8 @@ namespace DetourNavigator
                 + value.mHeightfields.size() * sizeof(Heightfield)
                 + std::accumulate(value.mHeightfields.begin(), value.mHeightfields.end(), std::size_t {0},
                                   [] (std::size_t r, const Heightfield& v) { return r + v.mHeights.size() * sizeof(float); })
-                + value.mFlatHeightfields.size() * sizeof(FlatHeightfield);
+                + value.mFlatHeightfields.size() * sizeof(FlatHeightfield)
+                + value.mObstacles.size() * sizeof(Obstacle);
         }
     };
 }
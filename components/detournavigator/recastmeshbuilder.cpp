@@ -224,6 +224,11 @@ namespace DetourNavigator
         }
     }
 
+    void RecastMeshBuilder::addObstacle(const Obstacle& obstacle)
+    {
+        mObstacles.push_back(obstacle);
+    }
+
     void RecastMeshBuilder::addWater(const osg::Vec2i& cellPosition, const Water& water)
     {
         mWater.push_back(CellWater {cellPosition, water});
@@ -278,10 +283,11 @@ namespace DetourNavigator
         mTriangles.erase(std::remove_if(mTriangles.begin(), mTriangles.end(), isNan), mTriangles.end());
         std::sort(mTriangles.begin(), mTriangles.end());
         std::sort(mWater.begin(), mWater.end());
+        std::sort(mObstacles.begin(), mObstacles.end());
         Mesh mesh = makeMesh(std::move(mTriangles));
         return std::make_shared<RecastMesh>(generation, revision, std::move(mesh), std::move(mWater),
                                             std::move(mHeightfields), std::move(mFlatHeightfields),
-                                            std::move(mSources));
+                                            std::move(mSources), std::move(mObstacles));
     }
 
     void RecastMeshBuilder::addObject(const btConcaveShape& shape, const btTransform& transform,
@@ -6,6 +6,9 @@
 #include <components/debug/debuglog.hpp>
 #include <components/misc/convert.hpp>
 
+#include <osg/Math>
+
+#include <cmath>
 #include <utility>
 
 namespace
@@ -26,13 +29,38 @@ namespace
             mBuilder.addHeightfield(mCellPosition, mCellSize, v.mHeight);
         }
     };
+
+    // Same test as rcMarkWalkableTriangles does, vertices are swapped to the recast coordinates
+    bool hasWalkableTriangles(const DetourNavigator::Mesh& mesh, float maxSlope)
+    {
+        const float walkableThreshold = std::cos(osg::DegreesToRadians(maxSlope));
+        const std::vector<int>& indices = mesh.getIndices();
+        const std::vector<float>& vertices = mesh.getVertices();
+        const auto getVertex = [&] (int index)
+        {
+            const std::size_t i = static_cast<std::size_t>(index) * 3;
+            return osg::Vec3f(vertices[i], vertices[i + 2], vertices[i + 1]);
+        };
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+        {
+            const osg::Vec3f v0 = getVertex(indices[i]);
+            osg::Vec3f normal = (getVertex(indices[i + 1]) - v0) ^ (getVertex(indices[i + 2]) - v0);
+            normal.normalize();
+            if (normal.y() > walkableThreshold)
+                return true;
+        }
+        return false;
+    }
 }
 
 namespace DetourNavigator
 {
-    RecastMeshManager::RecastMeshManager(const TileBounds& bounds, std::size_t generation)
+    RecastMeshManager::RecastMeshManager(const TileBounds& bounds, std::size_t generation, bool enableObstacles,
+            float maxSlope)
         : mGeneration(generation)
         , mTileBounds(bounds)
+        , mEnableObstacles(enableObstacles)
+        , mMaxSlope(maxSlope)
     {
     }
 
@@ -129,6 +157,7 @@ namespace DetourNavigator
             AreaType
         >;
         std::vector<Object> objects;
+        std::vector<std::pair<Object, btAABB>> movedObjects;
         std::size_t revision;
         {
             const std::lock_guard lock(mMutex);
@@ -140,11 +169,32 @@ namespace DetourNavigator
             for (const auto& [k, object] : mObjects)
             {
                 const RecastMeshObject& impl = object.getImpl();
-                objects.emplace_back(impl.getInstance(), impl.getObjectTransform(), impl.getShape(),
-                                     impl.getTransform(), impl.getAreaType());
+                Object value(impl.getInstance(), impl.getObjectTransform(), impl.getShape(), impl.getTransform(),
+                             impl.getAreaType());
+                // Moved objects are likely to move again, don't make them a part of the static geometry
+                if (mEnableObstacles && impl.canBeObstacle() && object.isMoved())
+                    movedObjects.emplace_back(std::move(value), object.getAabb());
+                else
+                    objects.push_back(std::move(value));
             }
             revision = mRevision;
         }
+        for (auto& [object, aabb] : movedObjects)
+        {
+            const auto& [instance, objectTransform, shape, transform, areaType] = object;
+            // Actors stand on lifts and platforms, carving them out would leave no navmesh under them
+            if (areaType != AreaType_null)
+            {
+                RecastMeshBuilder objectBuilder(mTileBounds);
+                objectBuilder.addObject(shape, transform, areaType, instance->getSource(), objectTransform);
+                if (hasWalkableTriangles(std::move(objectBuilder).create(0, 0)->getMesh(), mMaxSlope))
+                {
+                    objects.push_back(std::move(object));
+                    continue;
+                }
+            }
+            builder.addObstacle(Obstacle {Misc::Convert::toOsg(aabb.m_min), Misc::Convert::toOsg(aabb.m_max)});
+        }
         for (const auto& [instance, objectTransform, shape, transform, areaType] : objects)
             builder.addObject(shape, transform, areaType, instance->getSource(), objectTransform);
         return std::move(builder).create(mGeneration, revision);
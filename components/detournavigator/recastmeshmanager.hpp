@@ -38,7 +38,8 @@ namespace DetourNavigator
     class RecastMeshManager
     {
     public:
-        explicit RecastMeshManager(const TileBounds& bounds, std::size_t generation);
+        explicit RecastMeshManager(const TileBounds& bounds, std::size_t generation, bool enableObstacles = false,
+            float maxSlope = 0);
 
         bool addObject(const ObjectId id, const CollisionShape& shape, const btTransform& transform,
                        const AreaType areaType);
@@ -72,6 +73,8 @@ namespace DetourNavigator
 
         const std::size_t mGeneration;
         const TileBounds mTileBounds;
+        const bool mEnableObstacles;
+        const float mMaxSlope;
         mutable std::mutex mMutex;
         std::size_t mRevision = 0;
         std::map<ObjectId, OscillatingRecastMeshObject> mObjects;
@@ -77,6 +77,7 @@ namespace DetourNavigator
             const AreaType areaType)
         : mInstance(shape.getInstance())
         , mObjectTransform(shape.getObjectTransform())
+        , mCanBeObstacle(shape.canBeObstacle())
         , mImpl(shape.getShape(), transform, areaType)
     {
     }
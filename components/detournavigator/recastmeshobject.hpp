@@ -23,20 +23,24 @@ namespace DetourNavigator
     {
     public:
         CollisionShape(osg::ref_ptr<const Resource::BulletShapeInstance> instance, const btCollisionShape& shape,
-                       const ObjectTransform& transform)
+                       const ObjectTransform& transform, bool canBeObstacle = true)
             : mInstance(std::move(instance))
             , mShape(shape)
             , mObjectTransform(transform)
+            , mCanBeObstacle(canBeObstacle)
         {}
 
         const osg::ref_ptr<const Resource::BulletShapeInstance>& getInstance() const { return mInstance; }
         const btCollisionShape& getShape() const { return mShape; }
         const ObjectTransform& getObjectTransform() const { return mObjectTransform; }
+        // Doors have off-mesh connections with ends next to them, carving them out would make the connections unreachable
+        bool canBeObstacle() const { return mCanBeObstacle; }
 
     private:
         osg::ref_ptr<const Resource::BulletShapeInstance> mInstance;
         std::reference_wrapper<const btCollisionShape> mShape;
         ObjectTransform mObjectTransform;
+        bool mCanBeObstacle;
     };
 
     class ChildRecastMeshObject
@@ -77,9 +81,12 @@ namespace DetourNavigator
 
             const ObjectTransform& getObjectTransform() const { return mObjectTransform; }
 
+            bool canBeObstacle() const { return mCanBeObstacle; }
+
         private:
             osg::ref_ptr<const Resource::BulletShapeInstance> mInstance;
             ObjectTransform mObjectTransform;
+            bool mCanBeObstacle;
             ChildRecastMeshObject mImpl;
     };
 }
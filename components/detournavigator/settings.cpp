@@ -28,6 +28,7 @@ namespace DetourNavigator
         result.mRegionMergeArea = std::max(0, ::Settings::Manager::getInt("region merge area", "Navigator"));
         result.mRegionMinArea = std::max(0, ::Settings::Manager::getInt("region min area", "Navigator"));
         result.mTileSize = std::max(1, ::Settings::Manager::getInt("tile size", "Navigator"));
+        result.mEnableObstacles = ::Settings::Manager::getBool("enable obstacles", "Navigator");
 
         return result;
     }
@@ -54,6 +55,7 @@ namespace DetourNavigator
         result.mWaitUntilMinDistanceToPlayer = ::Settings::Manager::getInt("wait until min distance to player", "Navigator");
         result.mAsyncNavMeshUpdaterThreads = static_cast<std::size_t>(std::max(0, ::Settings::Manager::getInt("async nav mesh updater threads", "Navigator")));
         result.mMaxNavMeshTilesCacheSize = static_cast<std::size_t>(std::max(std::int64_t {0}, ::Settings::Manager::getInt64("max nav mesh tiles cache size", "Navigator")));
+        result.mMaxNavMeshLayersCacheSize = static_cast<std::size_t>(std::max(std::int64_t {0}, ::Settings::Manager::getInt64("max nav mesh layers cache size", "Navigator")));
         result.mEnableWriteRecastMeshToFile = ::Settings::Manager::getBool("enable write recast mesh to file", "Navigator");
         result.mEnableWriteNavMeshToFile = ::Settings::Manager::getBool("enable write nav mesh to file", "Navigator");
         result.mRecastMeshPathPrefix = ::Settings::Manager::getString("recast mesh path prefix", "Navigator");
@@ -61,9 +63,12 @@ namespace DetourNavigator
         result.mEnableRecastMeshFileNameRevision = ::Settings::Manager::getBool("enable recast mesh file name revision", "Navigator");
         result.mEnableNavMeshFileNameRevision = ::Settings::Manager::getBool("enable nav mesh file name revision", "Navigator");
         result.mMinUpdateInterval = std::chrono::milliseconds(::Settings::Manager::getInt("min update interval ms", "Navigator"));
+        result.mPlayerTilePredictionTime = std::chrono::milliseconds(std::max(0, ::Settings::Manager::getInt("player tile prediction time ms", "Navigator")));
         result.mEnableNavMeshDiskCache = ::Settings::Manager::getBool("enable nav mesh disk cache", "Navigator");
         result.mWriteToNavMeshDb = ::Settings::Manager::getBool("write to navmeshdb", "Navigator");
         result.mMaxDbFileSize = static_cast<std::uint64_t>(::Settings::Manager::getInt64("max navmeshdb file size", "Navigator"));
+        result.mDbCompressionLevel = std::clamp(::Settings::Manager::getInt("navmeshdb compression level", "Navigator"), 0, 12);
+        result.mDbMmapSize = static_cast<std::uint64_t>(std::max(std::int64_t {0}, ::Settings::Manager::getInt64("navmeshdb mmap size", "Navigator")));
 
         return result;
     }
@@ -23,6 +23,7 @@ namespace DetourNavigator
         int mRegionMergeArea = 0;
         int mRegionMinArea = 0;
         int mTileSize = 0;
+        bool mEnableObstacles = false;
     };
 
     struct DetourSettings
@@ -47,10 +48,14 @@ namespace DetourNavigator
         int mMaxTilesNumber = 0;
         std::size_t mAsyncNavMeshUpdaterThreads = 0;
         std::size_t mMaxNavMeshTilesCacheSize = 0;
+        std::size_t mMaxNavMeshLayersCacheSize = 0;
         std::string mRecastMeshPathPrefix;
         std::string mNavMeshPathPrefix;
         std::chrono::milliseconds mMinUpdateInterval;
+        std::chrono::milliseconds mPlayerTilePredictionTime {0};
         std::uint64_t mMaxDbFileSize = 0;
+        int mDbCompressionLevel = 0;
+        std::uint64_t mDbMmapSize = 0;
     };
 
     inline constexpr std::int64_t navMeshFormatVersion = 2;
@@ -159,7 +159,8 @@ namespace DetourNavigator
                     {
                         const TileBounds tileBounds = makeRealTileBoundsWithBorder(mSettings, tilePosition);
                         tile = locked->mTiles.emplace_hint(tile, tilePosition,
-                                std::make_shared<CachedRecastMeshManager>(tileBounds, mTilesGeneration));
+                                std::make_shared<CachedRecastMeshManager>(tileBounds, mTilesGeneration,
+                                    mSettings.mEnableObstacles, mSettings.mMaxSlope));
                     }
                     if (tile->second->addWater(cellPosition, cellSize, level))
                     {
@@ -224,7 +225,8 @@ namespace DetourNavigator
                 {
                     const TileBounds tileBounds = makeRealTileBoundsWithBorder(mSettings, tilePosition);
                     tile = locked->mTiles.emplace_hint(tile, tilePosition,
-                            std::make_shared<CachedRecastMeshManager>(tileBounds, mTilesGeneration));
+                            std::make_shared<CachedRecastMeshManager>(tileBounds, mTilesGeneration,
+                                mSettings.mEnableObstacles, mSettings.mMaxSlope));
                 }
                 if (tile->second->addHeightfield(cellPosition, cellSize, shape))
                 {
@@ -310,7 +312,8 @@ namespace DetourNavigator
         {
             const TileBounds tileBounds = makeRealTileBoundsWithBorder(mSettings, tilePosition);
             tile = tiles.emplace_hint(tile, tilePosition,
-                    std::make_shared<CachedRecastMeshManager>(tileBounds, mTilesGeneration));
+                    std::make_shared<CachedRecastMeshManager>(tileBounds, mTilesGeneration,
+                        mSettings.mEnableObstacles, mSettings.mMaxSlope));
         }
         return tile->second->addObject(id, shape, transform, areaType);
     }
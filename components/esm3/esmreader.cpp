@@ -5,6 +5,7 @@
 #include <boost/filesystem/path.hpp>
 #include <components/misc/stringops.hpp>
 #include <components/files/openfile.hpp>
+#include <components/files/compressedstream.hpp>
 
 #include <stdexcept>
 #include <sstream>
@@ -135,7 +136,7 @@ void ESMReader::openRaw(std::unique_ptr<std::istream>&& stream, std::string_view
 
 void ESMReader::openRaw(std::string_view filename)
 {
-    openRaw(Files::openBinaryInputFileStream(std::string(filename)), filename);
+    openRaw(Files::openCompressedStream(Files::openBinaryInputFileStream(std::string(filename))), filename);
 }
 
 void ESMReader::open(std::unique_ptr<std::istream>&& stream, const std::string &name)
@@ -152,7 +153,7 @@ void ESMReader::open(std::unique_ptr<std::istream>&& stream, const std::string &
 
 void ESMReader::open(const std::string &file)
 {
-    open(Files::openBinaryInputFileStream(file), file);
+    open(Files::openCompressedStream(Files::openBinaryInputFileStream(file)), file);
 }
 
 std::string ESMReader::getHNOString(NAME name)
@@ -73,6 +73,8 @@ public:
   /// currently open file first, if any.
   void open(std::unique_ptr<std::istream>&& stream, const std::string &name);
 
+  /// Files written as a compressed container (see Files::writeCompressedStream) are
+  /// decompressed transparently.
   void open(const std::string &file);
 
   void openRaw(std::string_view filename);
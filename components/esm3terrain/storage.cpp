@@ -1,6 +1,11 @@
 #include "storage.hpp"
 
-#include <set>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
 
 #include <osg/Image>
 #include <osg/Plane>
@@ -13,13 +18,6 @@
 namespace ESMTerrain
 {
 
-    class LandCache
-    {
-    public:
-        typedef std::map<std::pair<int, int>, osg::ref_ptr<const LandObject> > Map;
-        Map mMap;
-    };
-
     LandObject::LandObject()
         : mLand(nullptr)
         , mLoadFlags(0)
@@ -95,79 +93,144 @@ namespace ESMTerrain
         return false;
     }
 
-    void Storage::fixNormal (osg::Vec3f& normal, int cellX, int cellY, int col, int row, LandCache& cache)
+    namespace
     {
-        while (col >= ESM::Land::LAND_SIZE-1)
+        /// Index range of samples along one axis that lie within the same cell.
+        struct SampleRun
         {
-            ++cellY;
-            col -= ESM::Land::LAND_SIZE-1;
-        }
-        while (row >= ESM::Land::LAND_SIZE-1)
-        {
-            ++cellX;
-            row -= ESM::Land::LAND_SIZE-1;
-        }
-        while (col < 0)
+            int mCell;
+            int mFirstLocal;
+            int mBegin;
+            int mEnd;
+        };
+
+        int floorDiv(int value, int divisor)
         {
-            --cellY;
-            col += ESM::Land::LAND_SIZE-1;
+            return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
         }
-        while (row < 0)
+
+        /// Splits the samples first + i * increment, i in [0, count), into runs of samples within the same cell.
+        /// @param cellSize Number of samples per cell, not counting the one shared with the next cell.
+        /// @param ownedByPreviousCell Take samples on a cell border from the end of the previous cell rather than from
+        /// the start of the next one.
+        std::vector<SampleRun> makeSampleRuns(int first, int increment, int count, int cellSize, bool ownedByPreviousCell)
         {
-            --cellX;
-            row += ESM::Land::LAND_SIZE-1;
+            std::vector<SampleRun> runs;
+            for (int i = 0; i < count; ++i)
+            {
+                const int sample = first + i * increment;
+                const int cell = (ownedByPreviousCell && sample > 0) ? floorDiv(sample - 1, cellSize) : floorDiv(sample, cellSize);
+                if (runs.empty() || runs.back().mCell != cell)
+                    runs.push_back(SampleRun {cell, sample - cell * cellSize, i, i});
+                runs.back().mEnd = i + 1;
+            }
+            return runs;
         }
 
-        const LandObject* land = getLand(cellX, cellY, cache);
-        const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VNML) : nullptr;
-        if (data)
+        /// Lands of a rectangular range of cells, fetched once per chunk.
+        class LandGrid
         {
-            normal.x() = data->mNormals[col*ESM::Land::LAND_SIZE*3+row*3];
-            normal.y() = data->mNormals[col*ESM::Land::LAND_SIZE*3+row*3+1];
-            normal.z() = data->mNormals[col*ESM::Land::LAND_SIZE*3+row*3+2];
-            normal.normalize();
-        }
-        else
-            normal = osg::Vec3f(0,0,1);
-    }
+        public:
+            LandGrid(Storage& storage, int minCellX, int minCellY, int maxCellX, int maxCellY)
+                : mStorage(storage)
+                , mMinCellX(minCellX)
+                , mMinCellY(minCellY)
+                , mWidth(maxCellX - minCellX + 1)
+                , mLands(static_cast<std::size_t>(mWidth * (maxCellY - minCellY + 1)))
+                , mFetched(mLands.size(), false)
+            {
+            }
 
-    void Storage::averageNormal(osg::Vec3f &normal, int cellX, int cellY, int col, int row, LandCache& cache)
-    {
-        osg::Vec3f n1,n2,n3,n4;
-        fixNormal(n1, cellX, cellY, col+1, row, cache);
-        fixNormal(n2, cellX, cellY, col-1, row, cache);
-        fixNormal(n3, cellX, cellY, col, row+1, cache);
-        fixNormal(n4, cellX, cellY, col, row-1, cache);
-        normal = (n1+n2+n3+n4);
-        normal.normalize();
-    }
+            const LandObject* get(int cellX, int cellY)
+            {
+                const std::size_t index = static_cast<std::size_t>((cellY - mMinCellY) * mWidth + cellX - mMinCellX);
+                assert(index < mLands.size());
+                if (!mFetched[index])
+                {
+                    mLands[index] = mStorage.getLand(cellX, cellY);
+                    mFetched[index] = true;
+                }
+                return mLands[index];
+            }
 
-    void Storage::fixColour (osg::Vec4ub& color, int cellX, int cellY, int col, int row, LandCache& cache)
-    {
-        if (col == ESM::Land::LAND_SIZE-1)
+            const ESM::Land::LandData* getData(int cellX, int cellY, int flags)
+            {
+                const LandObject* land = get(cellX, cellY);
+                return land ? land->getData(flags) : nullptr;
+            }
+
+        private:
+            Storage& mStorage;
+            int mMinCellX;
+            int mMinCellY;
+            int mWidth;
+            std::vector<osg::ref_ptr<const LandObject>> mLands;
+            std::vector<bool> mFetched;
+        };
+
+        constexpr int sCellQuads = ESM::Land::LAND_SIZE - 1;
+
+        /// Normal of the given vertex in coordinates relative to the given cell, as stored in the cell that contains it.
+        osg::Vec3f getNormal(LandGrid& grid, int cellX, int cellY, int row, int col)
         {
-            ++cellY;
-            col = 0;
+            cellX += floorDiv(row, sCellQuads);
+            cellY += floorDiv(col, sCellQuads);
+            row -= floorDiv(row, sCellQuads) * sCellQuads;
+            col -= floorDiv(col, sCellQuads) * sCellQuads;
+            osg::Vec3f normal(0, 0, 1);
+            if (const ESM::Land::LandData* data = grid.getData(cellX, cellY, ESM::Land::DATA_VNML))
+            {
+                const ESM::Land::VNML* source = &data->mNormals[(col * ESM::Land::LAND_SIZE + row) * 3];
+                normal = osg::Vec3f(source[0], source[1], source[2]);
+                normal.normalize();
+            }
+            return normal;
         }
-        if (row == ESM::Land::LAND_SIZE-1)
+
+        /// Inverse lengths of VNML normals indexed by squared length, computed the same way as osg::Vec3f::normalize.
+        /// Normals are stored as signed bytes, so this replaces a square root and a division per vertex by a lookup.
+        class InverseNormalLengths
         {
-            ++cellX;
-            row = 0;
-        }
+        public:
+            static constexpr int sMaxLengthSquared = 3 * 128 * 128;
 
-        const LandObject* land = getLand(cellX, cellY, cache);
-        const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VCLR) : nullptr;
-        if (data)
+            InverseNormalLengths()
+                : mValues(sMaxLengthSquared + 1)
+            {
+                mValues[0] = 1.0f;
+                for (int i = 1; i <= sMaxLengthSquared; ++i)
+                    mValues[i] = 1.0f / std::sqrt(static_cast<float>(i));
+            }
+
+            static const InverseNormalLengths& get()
+            {
+                static const InverseNormalLengths instance;
+                return instance;
+            }
+
+            float operator[](int lengthSquared) const { return mValues[lengthSquared]; }
+
+        private:
+            std::vector<float> mValues;
+        };
+
+        void convertNormals(const ESM::Land::VNML* source, int stride, int count, osg::Vec3f* out)
         {
-            color.r() = data->mColours[col*ESM::Land::LAND_SIZE*3+row*3];
-            color.g() = data->mColours[col*ESM::Land::LAND_SIZE*3+row*3+1];
-            color.b() = data->mColours[col*ESM::Land::LAND_SIZE*3+row*3+2];
+            const InverseNormalLengths& inverseLengths = InverseNormalLengths::get();
+            for (int i = 0; i < count; ++i, source += stride)
+            {
+                const int x = source[0];
+                const int y = source[1];
+                const int z = source[2];
+                const float inverseLength = inverseLengths[x * x + y * y + z * z];
+                out[i].set(x * inverseLength, y * inverseLength, z * inverseLength);
+            }
         }
-        else
+
+        void convertColours(const unsigned char* source, int stride, int count, osg::Vec4ub* out)
         {
-            color.r() = 255;
-            color.g() = 255;
-            color.b() = 255;
+            for (int i = 0; i < count; ++i, source += stride)
+                out[i].set(source[0], source[1], source[2], 255);
         }
     }
 
@@ -177,179 +240,138 @@ namespace ESMTerrain
                                             osg::ref_ptr<osg::Vec4ubArray> colours)
     {
         // LOD level n means every 2^n-th vertex is kept
-        size_t increment = static_cast<size_t>(1) << lodLevel;
+        const int increment = 1 << lodLevel;
 
         osg::Vec2f origin = center - osg::Vec2f(size/2.f, size/2.f);
 
         int startCellX = static_cast<int>(std::floor(origin.x()));
         int startCellY = static_cast<int>(std::floor(origin.y()));
 
-        size_t numVerts = static_cast<size_t>(size*(ESM::Land::LAND_SIZE - 1) / increment + 1);
+        const int numVerts = static_cast<int>(size*(ESM::Land::LAND_SIZE - 1) / increment + 1);
+        const std::size_t numTotalVerts = static_cast<std::size_t>(numVerts) * numVerts;
+
+        positions->resize(numTotalVerts);
+        normals->resize(numTotalVerts);
+        colours->resize(numTotalVerts);
 
-        positions->resize(numVerts*numVerts);
-        normals->resize(numVerts*numVerts);
-        colours->resize(numVerts*numVerts);
+        // Vertex indices of the first vertex, relative to the start cell. Only non-zero for chunks smaller than one cell.
+        const int firstRow = static_cast<int>((origin.x() - startCellX) * ESM::Land::LAND_SIZE);
+        const int firstCol = static_cast<int>((origin.y() - startCellY) * ESM::Land::LAND_SIZE);
 
-        osg::Vec3f normal;
-        osg::Vec4ub color;
+        // Heights are taken from the cell that ends at a cell border, normals and colours from the cell that starts
+        // there, because they do not always connect seamlessly between cells.
+        const std::vector<SampleRun> heightRunsX = makeSampleRuns(firstRow, increment, numVerts, sCellQuads, true);
+        const std::vector<SampleRun> heightRunsY = makeSampleRuns(firstCol, increment, numVerts, sCellQuads, true);
+        const std::vector<SampleRun> runsX = makeSampleRuns(firstRow, increment, numVerts, sCellQuads, false);
+        const std::vector<SampleRun> runsY = makeSampleRuns(firstCol, increment, numVerts, sCellQuads, false);
 
-        float vertY = 0;
-        float vertX = 0;
+        // Include neighbours for averaging corner normals
+        LandGrid grid(*this, startCellX + std::min(0, runsX.front().mCell - 1), startCellY + std::min(0, runsY.front().mCell - 1),
+            startCellX + runsX.back().mCell + 1, startCellY + runsY.back().mCell + 1);
 
-        LandCache cache;
+        std::vector<float> coords(numVerts);
+        for (int i = 0; i < numVerts; ++i)
+            coords[i] = (static_cast<float>(i) / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits;
 
-        bool alteration = useAlteration();
+        // Vertices are stored with x as the major index
+        osg::Vec3f* const positionData = &positions->front();
+        osg::Vec3f* const normalData = &normals->front();
+        osg::Vec4ub* const colourData = &colours->front();
 
-        float vertY_ = 0; // of current cell corner
-        for (int cellY = startCellY; cellY < startCellY + std::ceil(size); ++cellY)
+        for (const SampleRun& runX : heightRunsX)
         {
-            float vertX_ = 0; // of current cell corner
-            for (int cellX = startCellX; cellX < startCellX + std::ceil(size); ++cellX)
+            for (const SampleRun& runY : heightRunsY)
             {
-                const LandObject* land = getLand(cellX, cellY, cache);
-                const ESM::Land::LandData *heightData = nullptr;
-                const ESM::Land::LandData *normalData = nullptr;
-                const ESM::Land::LandData *colourData = nullptr;
-                if (land)
+                const ESM::Land::LandData* data = grid.getData(startCellX + runX.mCell, startCellY + runY.mCell, ESM::Land::DATA_VHGT);
+                for (int x = runX.mBegin; x < runX.mEnd; ++x)
                 {
-                    heightData = land->getData(ESM::Land::DATA_VHGT);
-                    normalData = land->getData(ESM::Land::DATA_VNML);
-                    colourData = land->getData(ESM::Land::DATA_VCLR);
-                }
-
-                int rowStart = 0;
-                int colStart = 0;
-                // Skip the first row / column unless we're at a chunk edge,
-                // since this row / column is already contained in a previous cell
-                // This is only relevant if we're creating a chunk spanning multiple cells
-                if (vertY_ != 0)
-                    colStart += increment;
-                if (vertX_ != 0)
-                    rowStart += increment;
-
-                // Only relevant for chunks smaller than (contained in) one cell
-                rowStart += (origin.x() - startCellX) * ESM::Land::LAND_SIZE;
-                colStart += (origin.y() - startCellY) * ESM::Land::LAND_SIZE;
-                int rowEnd = std::min(static_cast<int>(rowStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE-1) + 1), static_cast<int>(ESM::Land::LAND_SIZE));
-                int colEnd = std::min(static_cast<int>(colStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE-1) + 1), static_cast<int>(ESM::Land::LAND_SIZE));
-
-                vertY = vertY_;
-                for (int col=colStart; col<colEnd; col += increment)
-                {
-                    vertX = vertX_;
-                    for (int row=rowStart; row<rowEnd; row += increment)
+                    const int row = runX.mFirstLocal + (x - runX.mBegin) * increment;
+                    osg::Vec3f* out = positionData + static_cast<std::size_t>(x) * numVerts;
+                    if (data)
                     {
-                        int srcArrayIndex = col*ESM::Land::LAND_SIZE*3+row*3;
-
-                        assert(row >= 0 && row < ESM::Land::LAND_SIZE);
-                        assert(col >= 0 && col < ESM::Land::LAND_SIZE);
-
-                        assert (vertX < numVerts);
-                        assert (vertY < numVerts);
-
-                        float height = defaultHeight;
-                        if (heightData)
-                            height = heightData->mHeights[col*ESM::Land::LAND_SIZE + row];
-                        if (alteration)
-                            height += getAlteredHeight(col, row);
-                        (*positions)[static_cast<unsigned int>(vertX*numVerts + vertY)]
-                            = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         height);
-
-                        if (normalData)
-                        {
-                            for (int i=0; i<3; ++i)
-                                normal[i] = normalData->mNormals[srcArrayIndex+i];
-
-                            normal.normalize();
-                        }
-                        else
-                            normal = osg::Vec3f(0,0,1);
-
-                        // Normals apparently don't connect seamlessly between cells
-                        if (col == ESM::Land::LAND_SIZE-1 || row == ESM::Land::LAND_SIZE-1)
-                            fixNormal(normal, cellX, cellY, col, row, cache);
-
-                        // some corner normals appear to be complete garbage (z < 0)
-                        if ((row == 0 || row == ESM::Land::LAND_SIZE-1) && (col == 0 || col == ESM::Land::LAND_SIZE-1))
-                            averageNormal(normal, cellX, cellY, col, row, cache);
-
-                        assert(normal.z() > 0);
-
-                        (*normals)[static_cast<unsigned int>(vertX*numVerts + vertY)] = normal;
-
-                        if (colourData)
-                        {
-                            for (int i=0; i<3; ++i)
-                                color[i] = colourData->mColours[srcArrayIndex+i];
-                        }
-                        else
-                        {
-                            color.r() = 255;
-                            color.g() = 255;
-                            color.b() = 255;
-                        }
-                        if (alteration)
-                            adjustColor(col, row, heightData, color); //Does nothing by default, override in OpenMW-CS
-
-                        // Unlike normals, colors mostly connect seamlessly between cells, but not always...
-                        if (col == ESM::Land::LAND_SIZE-1 || row == ESM::Land::LAND_SIZE-1)
-                            fixColour(color, cellX, cellY, col, row, cache);
-
-                        color.a() = 255;
-
-                        (*colours)[static_cast<unsigned int>(vertX*numVerts + vertY)] = color;
-
-                        ++vertX;
+                        const float* heights = data->mHeights + runY.mFirstLocal * ESM::Land::LAND_SIZE + row;
+                        const int stride = increment * ESM::Land::LAND_SIZE;
+                        for (int y = runY.mBegin; y < runY.mEnd; ++y)
+                            out[y].set(coords[x], coords[y], heights[(y - runY.mBegin) * stride]);
+                    }
+                    else
+                    {
+                        for (int y = runY.mBegin; y < runY.mEnd; ++y)
+                            out[y].set(coords[x], coords[y], defaultHeight);
                     }
-                    ++vertY;
                 }
-                vertX_ = vertX;
             }
-            vertY_ = vertY;
-
-            assert(vertX_ == numVerts); // Ensure we covered whole area
         }
-        assert(vertY_ == numVerts);  // Ensure we covered whole area
-    }
 
-    Storage::UniqueTextureId Storage::getVtexIndexAt(int cellX, int cellY,
-                                           int x, int y, LandCache& cache)
-    {
-        // For the first/last row/column, we need to get the texture from the neighbour cell
-        // to get consistent blending at the borders
-        --x;
-        if (x < 0)
+        for (const SampleRun& runX : runsX)
         {
-            --cellX;
-            x += ESM::Land::LAND_TEXTURE_SIZE;
-        }
-        while (x >= ESM::Land::LAND_TEXTURE_SIZE)
-        {
-            ++cellX;
-            x -= ESM::Land::LAND_TEXTURE_SIZE;
+            for (const SampleRun& runY : runsY)
+            {
+                const int cellX = startCellX + runX.mCell;
+                const int cellY = startCellY + runY.mCell;
+                const ESM::Land::LandData* normalSource = grid.getData(cellX, cellY, ESM::Land::DATA_VNML);
+                const ESM::Land::LandData* colourSource = grid.getData(cellX, cellY, ESM::Land::DATA_VCLR);
+                const int count = runY.mEnd - runY.mBegin;
+                const int stride = increment * ESM::Land::LAND_SIZE * 3;
+                for (int x = runX.mBegin; x < runX.mEnd; ++x)
+                {
+                    const int row = runX.mFirstLocal + (x - runX.mBegin) * increment;
+                    const int sourceIndex = (runY.mFirstLocal * ESM::Land::LAND_SIZE + row) * 3;
+                    const std::size_t index = static_cast<std::size_t>(x) * numVerts + runY.mBegin;
+                    if (normalSource)
+                        convertNormals(normalSource->mNormals + sourceIndex, stride, count, normalData + index);
+                    else
+                        std::fill_n(normalData + index, count, osg::Vec3f(0, 0, 1));
+                    if (colourSource)
+                        convertColours(colourSource->mColours + sourceIndex, stride, count, colourData + index);
+                    else
+                        std::fill_n(colourData + index, count, osg::Vec4ub(255, 255, 255, 255));
+                }
+            }
         }
-        while (y >= ESM::Land::LAND_TEXTURE_SIZE) // Y appears to be wrapped from the other side because why the hell not?
+
+        // Some corner normals appear to be complete garbage (z < 0), replace them with the average of their neighbours
+        for (const SampleRun& runX : runsX)
         {
-            ++cellY;
-            y -= ESM::Land::LAND_TEXTURE_SIZE;
+            for (const SampleRun& runY : runsY)
+            {
+                if (runX.mFirstLocal != 0 || runY.mFirstLocal != 0)
+                    continue;
+                const int cellX = startCellX + runX.mCell;
+                const int cellY = startCellY + runY.mCell;
+                osg::Vec3f normal = getNormal(grid, cellX, cellY, 0, 1) + getNormal(grid, cellX, cellY, 0, -1)
+                    + getNormal(grid, cellX, cellY, 1, 0) + getNormal(grid, cellX, cellY, -1, 0);
+                normal.normalize();
+                normalData[static_cast<std::size_t>(runX.mBegin) * numVerts + runY.mBegin] = normal;
+            }
         }
 
-        assert(x<ESM::Land::LAND_TEXTURE_SIZE);
-        assert(y<ESM::Land::LAND_TEXTURE_SIZE);
-
-        const LandObject* land = getLand(cellX, cellY, cache);
-
-        const ESM::Land::LandData *data = land ? land->getData(ESM::Land::DATA_VTEX) : nullptr;
-        if (data)
+        if (useAlteration())
         {
-            int tex = data->mTextures[y * ESM::Land::LAND_TEXTURE_SIZE + x];
-            if (tex == 0)
-                return std::make_pair(0,0); // vtex 0 is always the base texture, regardless of plugin
-            return std::make_pair(tex, land->getPlugin());
+            for (const SampleRun& runX : heightRunsX)
+            {
+                for (const SampleRun& runY : heightRunsY)
+                {
+                    const ESM::Land::LandData* heightData = grid.getData(startCellX + runX.mCell, startCellY + runY.mCell, ESM::Land::DATA_VHGT);
+                    for (int x = runX.mBegin; x < runX.mEnd; ++x)
+                    {
+                        const int row = runX.mFirstLocal + (x - runX.mBegin) * increment;
+                        for (int y = runY.mBegin; y < runY.mEnd; ++y)
+                        {
+                            const int col = runY.mFirstLocal + (y - runY.mBegin) * increment;
+                            const std::size_t index = static_cast<std::size_t>(x) * numVerts + y;
+                            positionData[index].z() += getAlteredHeight(col, row);
+                            // Colours on the far borders of a cell are taken from the neighbour
+                            if (col < ESM::Land::LAND_SIZE - 1 && row < ESM::Land::LAND_SIZE - 1)
+                            {
+                                adjustColor(col, row, heightData, colourData[index]); //Does nothing by default, override in OpenMW-CS
+                                colourData[index].a() = 255;
+                            }
+                        }
+                    }
+                }
+            }
         }
-        return std::make_pair(0,0);
     }
 
     std::string Storage::getTextureName(UniqueTextureId id)
@@ -388,55 +410,104 @@ namespace ESMTerrain
         const int imageScaleFactor = 2;
         const int blendmapImageSize = blendmapSize * imageScaleFactor;
 
-        LandCache cache;
-        std::map<UniqueTextureId, unsigned int> textureIndicesMap;
+        // For the first/last row/column, we need to get the texture from the neighbour cell
+        // to get consistent blending at the borders, so the texture grid is shifted by one texel in x direction.
+        // Y appears to be wrapped from the other side because why the hell not?
+        const std::vector<SampleRun> runsX = makeSampleRuns(rowStart - 1, 1, blendmapSize, ESM::Land::LAND_TEXTURE_SIZE, false);
+        const std::vector<SampleRun> runsY = makeSampleRuns(colStart, 1, blendmapSize, ESM::Land::LAND_TEXTURE_SIZE, false);
 
-        for (int y=0; y<blendmapSize; y++)
+        LandGrid grid(*this, cellX + runsX.front().mCell, cellY + runsY.front().mCell, cellX + runsX.back().mCell, cellY + runsY.back().mCell);
+
+        const std::size_t numTexels = static_cast<std::size_t>(blendmapSize) * blendmapSize;
+        std::vector<UniqueTextureId> textureIds(numTexels);
+        for (const SampleRun& runY : runsY)
         {
-            for (int x=0; x<blendmapSize; x++)
+            for (const SampleRun& runX : runsX)
             {
-                UniqueTextureId id = getVtexIndexAt(cellX, cellY, x+rowStart, y+colStart, cache);
-                std::map<UniqueTextureId, unsigned int>::iterator found = textureIndicesMap.find(id);
-                if (found == textureIndicesMap.end())
+                const LandObject* land = grid.get(cellX + runX.mCell, cellY + runY.mCell);
+                const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VTEX) : nullptr;
+                for (int y = runY.mBegin; y < runY.mEnd; ++y)
                 {
-                    unsigned int layerIndex = layerList.size();
-                    Terrain::LayerInfo info = getLayerInfo(getTextureName(id));
-
-                    // look for existing diffuse map, which may be present when several plugins use the same texture
-                    for (unsigned int i=0; i<layerList.size(); ++i)
+                    UniqueTextureId* out = textureIds.data() + static_cast<std::size_t>(y) * blendmapSize;
+                    if (!data)
                     {
-                        if (layerList[i].mDiffuseMap == info.mDiffuseMap)
-                        {
-                            layerIndex = i;
-                            break;
-                        }
+                        std::fill(out + runX.mBegin, out + runX.mEnd, UniqueTextureId(0, 0));
+                        continue;
+                    }
+                    const short plugin = static_cast<short>(land->getPlugin());
+                    const std::uint16_t* textures = data->mTextures + (runY.mFirstLocal + y - runY.mBegin) * ESM::Land::LAND_TEXTURE_SIZE
+                        + runX.mFirstLocal;
+                    for (int x = runX.mBegin; x < runX.mEnd; ++x)
+                    {
+                        const short texture = static_cast<short>(textures[x - runX.mBegin]);
+                        // vtex 0 is always the base texture, regardless of plugin
+                        out[x] = texture == 0 ? UniqueTextureId(0, 0) : UniqueTextureId(texture, plugin);
                     }
+                }
+            }
+        }
 
-                    found = textureIndicesMap.emplace(id, layerIndex).first;
+        // Layers are assigned in the order their textures first appear
+        std::vector<unsigned int> layers(numTexels);
+        std::map<UniqueTextureId, unsigned int> textureIndicesMap;
+        std::map<UniqueTextureId, unsigned int>::const_iterator found = textureIndicesMap.end();
+        for (std::size_t i = 0; i < numTexels; ++i)
+        {
+            const UniqueTextureId& id = textureIds[i];
+            if (found == textureIndicesMap.end() || found->first != id)
+                found = textureIndicesMap.find(id);
+            if (found == textureIndicesMap.end())
+            {
+                unsigned int layerIndex = layerList.size();
+                Terrain::LayerInfo info = getLayerInfo(getTextureName(id));
 
-                    if (layerIndex >= layerList.size())
+                // look for existing diffuse map, which may be present when several plugins use the same texture
+                for (unsigned int j=0; j<layerList.size(); ++j)
+                {
+                    if (layerList[j].mDiffuseMap == info.mDiffuseMap)
                     {
-                        osg::ref_ptr<osg::Image> image (new osg::Image);
-                        image->allocateImage(blendmapImageSize, blendmapImageSize, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
-                        unsigned char* pData = image->data();
-                        memset(pData, 0, image->getTotalDataSize());
-                        blendmaps.emplace_back(image);
-                        layerList.emplace_back(info);
+                        layerIndex = j;
+                        break;
                     }
                 }
-                unsigned int layerIndex = found->second;
-                unsigned char* pData = blendmaps[layerIndex]->data();
-                int realY = (blendmapSize - y - 1)*imageScaleFactor;
-                int realX = x*imageScaleFactor;
-                pData[((realY+0)*blendmapImageSize + realX + 0)] = 255;
-                pData[((realY+1)*blendmapImageSize + realX + 0)] = 255;
-                pData[((realY+0)*blendmapImageSize + realX + 1)] = 255;
-                pData[((realY+1)*blendmapImageSize + realX + 1)] = 255;
+
+                found = textureIndicesMap.emplace(id, layerIndex).first;
+
+                if (layerIndex >= layerList.size())
+                {
+                    osg::ref_ptr<osg::Image> image (new osg::Image);
+                    image->allocateImage(blendmapImageSize, blendmapImageSize, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
+                    std::memset(image->data(), 0, image->getTotalDataSize());
+                    blendmaps.emplace_back(image);
+                    layerList.emplace_back(info);
+                }
             }
+            layers[i] = found->second;
         }
 
         if (blendmaps.size() == 1)
+        {
             blendmaps.clear(); // If a single texture fills the whole terrain, there is no need to blend
+            return;
+        }
+
+        for (unsigned int layer = 0; layer < blendmaps.size(); ++layer)
+        {
+            unsigned char* const pData = blendmaps[layer]->data();
+            for (int y = 0; y < blendmapSize; ++y)
+            {
+                const unsigned int* source = layers.data() + static_cast<std::size_t>(y) * blendmapSize;
+                unsigned char* const row = pData + static_cast<std::size_t>(blendmapSize - y - 1) * imageScaleFactor * blendmapImageSize;
+                for (int x = 0; x < blendmapSize; ++x)
+                {
+                    const unsigned char value = source[x] == layer ? 255 : 0;
+                    row[x * imageScaleFactor] |= value;
+                    row[x * imageScaleFactor + 1] |= value;
+                }
+                for (int i = 1; i < imageScaleFactor; ++i)
+                    std::memcpy(row + i * blendmapImageSize, row, blendmapImageSize);
+            }
+        }
     }
 
     float Storage::getHeightAt(const osg::Vec3f &worldPos)
@@ -523,18 +594,6 @@ namespace ESMTerrain
 
     }
 
-    const LandObject* Storage::getLand(int cellX, int cellY, LandCache& cache)
-    {
-        LandCache::Map::iterator found = cache.mMap.find(std::make_pair(cellX, cellY));
-        if (found != cache.mMap.end())
-            return found->second;
-        else
-        {
-            found = cache.mMap.insert(std::make_pair(std::make_pair(cellX, cellY), getLand(cellX, cellY))).first;
-            return found->second;
-        }
-    }
-
     void Storage::adjustColor(int col, int row, const ESM::Land::LandData *heightData, osg::Vec4ub& color) const
     {
     }
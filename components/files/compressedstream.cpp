@@ -0,0 +1,68 @@
+#include "compressedstream.hpp"
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Files
+{
+    namespace
+    {
+        template <class T>
+        void writeValue(std::ostream& stream, T value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+
+    bool isCompressedStream(std::istream& stream)
+    {
+        const std::istream::pos_type position = stream.tellg();
+        char magic[compressedStreamMagic.size()];
+        stream.read(magic, sizeof(magic));
+        const bool result = stream.gcount() == static_cast<std::streamsize>(sizeof(magic))
+            && std::string_view(magic, sizeof(magic)) == compressedStreamMagic;
+        stream.clear();
+        stream.seekg(position);
+        return result;
+    }
+
+    void writeCompressedStream(std::ostream& stream, std::string_view data, std::size_t frameSize)
+    {
+        if (frameSize == 0 || frameSize > LZ4_MAX_INPUT_SIZE)
+            throw std::invalid_argument("Invalid compressed stream frame size: " + std::to_string(frameSize));
+
+        stream.write(compressedStreamMagic.data(), static_cast<std::streamsize>(compressedStreamMagic.size()));
+        writeValue(stream, compressedStreamVersion);
+        writeValue(stream, static_cast<std::uint64_t>(data.size()));
+        writeValue(stream, static_cast<std::uint32_t>(frameSize));
+
+        std::vector<char> compressed(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(frameSize))));
+        for (std::size_t start = 0; start < data.size(); start += frameSize)
+        {
+            const std::size_t size = std::min(frameSize, data.size() - start);
+            const int compressedSize = LZ4_compress_default(data.data() + start, compressed.data(),
+                static_cast<int>(size), static_cast<int>(compressed.size()));
+            if (compressedSize == 0)
+                throw std::runtime_error("Failed to compress frame at " + std::to_string(start));
+            writeValue(stream, static_cast<std::uint32_t>(compressedSize));
+            writeValue(stream, static_cast<std::uint32_t>(size));
+            stream.write(compressed.data(), compressedSize);
+        }
+    }
+
+    IStreamPtr openCompressedStream(IStreamPtr&& source)
+    {
+        if (!isCompressedStream(*source))
+            return std::move(source);
+        const std::ios_base::iostate exceptions = source->exceptions();
+        auto result = std::make_unique<CompressedStream>(std::make_unique<CompressedStreamBuf>(std::move(source)));
+        result->exceptions(exceptions);
+        return result;
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef OPENMW_COMPONENTS_FILES_COMPRESSEDSTREAM_H
+#define OPENMW_COMPONENTS_FILES_COMPRESSEDSTREAM_H
+
+#include "compressedstreambuf.hpp"
+#include "streamwithbuffer.hpp"
+#include "istreamptr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+namespace Files
+{
+    /// The container consists of a header with the magic "OMWZ", the format version, the total uncompressed size and the
+    /// maximum frame size, followed by LZ4 compressed frames, each prefixed by its compressed and uncompressed size.
+    using CompressedStream = StreamWithBuffer<CompressedStreamBuf>;
+
+    constexpr std::string_view compressedStreamMagic = "OMWZ";
+
+    constexpr std::uint32_t compressedStreamVersion = 1;
+
+    constexpr std::size_t defaultCompressedFrameSize = 1024 * 1024;
+
+    /// Checks for the magic of a compressed container at the current position, leaving the position unchanged.
+    bool isCompressedStream(std::istream& stream);
+
+    void writeCompressedStream(std::ostream& stream, std::string_view data,
+        std::size_t frameSize = defaultCompressedFrameSize);
+
+    /// Wraps the source into a decompressing stream if it is a compressed container, otherwise returns it as is.
+    IStreamPtr openCompressedStream(IStreamPtr&& source);
+}
+
+#endif
@@ -0,0 +1,245 @@
+#include "compressedstreambuf.hpp"
+#include "compressedstream.hpp"
+
+#include <lz4.h>
+
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace Files
+{
+    namespace
+    {
+        // Enough to have the next frame ready while the reader consumes the current one
+        constexpr std::size_t maxDecodedFrames = 2;
+
+        template <class T>
+        void readValue(std::istream& stream, T& value)
+        {
+            stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+        }
+    }
+
+    CompressedStreamBuf::CompressedStreamBuf(IStreamPtr&& source)
+        : mSource(std::move(source))
+    {
+        char magic[compressedStreamMagic.size()];
+        std::uint32_t version = 0;
+        mSource->read(magic, sizeof(magic));
+        readValue(*mSource, version);
+        readValue(*mSource, mSize);
+        readValue(*mSource, mMaxFrameSize);
+
+        if (!*mSource || std::string_view(magic, sizeof(magic)) != compressedStreamMagic)
+            throw std::runtime_error("Not a compressed stream");
+        if (version != compressedStreamVersion)
+            throw std::runtime_error("Unsupported compressed stream version: " + std::to_string(version));
+        if (mMaxFrameSize == 0 || mMaxFrameSize > LZ4_MAX_INPUT_SIZE)
+            throw std::runtime_error("Invalid compressed stream frame size: " + std::to_string(mMaxFrameSize));
+
+        mFramesBegin = mSource->tellg();
+
+        setg(nullptr, nullptr, nullptr);
+        startDecoder();
+    }
+
+    CompressedStreamBuf::~CompressedStreamBuf()
+    {
+        stopDecoder();
+    }
+
+    std::streambuf::int_type CompressedStreamBuf::underflow()
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+        const std::uint64_t position = getPosition();
+
+        // The current frame may be replaced below, so don't leave read pointers into it
+        mPosition = position;
+        setg(nullptr, nullptr, nullptr);
+
+        if (position >= mSize)
+            return traits_type::eof();
+
+        if (position < mCurrent.mStart)
+        {
+            stopDecoder();
+            mCurrent = Frame {};
+            startDecoder();
+        }
+
+        while (position >= mCurrent.mStart + mCurrent.mData.size())
+            if (!takeFrame(mCurrent))
+                return traits_type::eof();
+
+        char* const data = mCurrent.mData.data();
+        setg(data, data + (position - mCurrent.mStart), data + mCurrent.mData.size());
+
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streambuf::pos_type CompressedStreamBuf::seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode)
+    {
+        if ((mode & std::ios_base::out) || !(mode & std::ios_base::in))
+            return traits_type::eof();
+
+        std::streamoff newPos;
+        switch (whence)
+        {
+            case std::ios_base::beg:
+                newPos = offset;
+                break;
+            case std::ios_base::cur:
+                newPos = static_cast<std::streamoff>(getPosition()) + offset;
+                break;
+            case std::ios_base::end:
+                newPos = static_cast<std::streamoff>(mSize) + offset;
+                break;
+            default:
+                return traits_type::eof();
+        }
+
+        if (newPos < 0)
+            return traits_type::eof();
+
+        return seekpos(newPos, mode);
+    }
+
+    std::streambuf::pos_type CompressedStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode)
+    {
+        if ((mode & std::ios_base::out) || !(mode & std::ios_base::in))
+            return traits_type::eof();
+
+        if (pos < 0 || static_cast<std::uint64_t>(pos) > mSize)
+            return traits_type::eof();
+
+        const std::uint64_t newPos = static_cast<std::uint64_t>(pos);
+
+        // Stay within the current frame if possible, otherwise only remember the position. Decompression is caught up
+        // on the next read, so seeking to the end to find out the size doesn't decompress everything.
+        if (eback() != nullptr && newPos >= mCurrent.mStart && newPos < mCurrent.mStart + mCurrent.mData.size())
+        {
+            setg(eback(), eback() + (newPos - mCurrent.mStart), egptr());
+        }
+        else
+        {
+            mPosition = newPos;
+            setg(nullptr, nullptr, nullptr);
+        }
+
+        return pos;
+    }
+
+    std::uint64_t CompressedStreamBuf::getPosition() const
+    {
+        if (eback() == nullptr)
+            return mPosition;
+        return mCurrent.mStart + static_cast<std::uint64_t>(gptr() - eback());
+    }
+
+    void CompressedStreamBuf::startDecoder()
+    {
+        mFrames.clear();
+        mDecoderDone = false;
+        mStopDecoder = false;
+        mError.clear();
+
+        mSource->clear();
+        mSource->seekg(mFramesBegin);
+
+        mDecoder = std::thread([this] { decode(); });
+    }
+
+    void CompressedStreamBuf::stopDecoder()
+    {
+        {
+            const std::lock_guard lock(mMutex);
+            mStopDecoder = true;
+        }
+        mHasSpace.notify_all();
+        if (mDecoder.joinable())
+            mDecoder.join();
+    }
+
+    void CompressedStreamBuf::decode()
+    {
+        try
+        {
+            std::uint64_t start = 0;
+            std::vector<char> compressed;
+            while (start < mSize)
+            {
+                {
+                    std::unique_lock lock(mMutex);
+                    mHasSpace.wait(lock, [&] { return mStopDecoder || mFrames.size() < maxDecodedFrames; });
+                    if (mStopDecoder)
+                        return;
+                }
+
+                std::uint32_t compressedSize = 0;
+                std::uint32_t size = 0;
+                readValue(*mSource, compressedSize);
+                readValue(*mSource, size);
+                if (!*mSource)
+                    throw std::runtime_error("Unexpected end of compressed stream at " + std::to_string(start));
+                if (size == 0 || size > mMaxFrameSize || size > mSize - start
+                        || compressedSize > static_cast<std::uint32_t>(LZ4_compressBound(static_cast<int>(mMaxFrameSize))))
+                    throw std::runtime_error("Invalid compressed stream frame at " + std::to_string(start));
+
+                compressed.resize(compressedSize);
+                mSource->read(compressed.data(), static_cast<std::streamsize>(compressedSize));
+                if (!*mSource)
+                    throw std::runtime_error("Unexpected end of compressed stream at " + std::to_string(start));
+
+                Frame frame;
+                frame.mStart = start;
+                frame.mData.resize(size);
+                const int decompressed = LZ4_decompress_safe(compressed.data(), frame.mData.data(),
+                    static_cast<int>(compressedSize), static_cast<int>(size));
+                if (decompressed < 0 || static_cast<std::uint32_t>(decompressed) != size)
+                    throw std::runtime_error("Failed to decompress compressed stream frame at " + std::to_string(start));
+
+                start += size;
+
+                {
+                    const std::lock_guard lock(mMutex);
+                    mFrames.push_back(std::move(frame));
+                }
+                mHasFrame.notify_one();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            const std::lock_guard lock(mMutex);
+            mError = e.what();
+        }
+
+        {
+            const std::lock_guard lock(mMutex);
+            mDecoderDone = true;
+        }
+        mHasFrame.notify_one();
+    }
+
+    bool CompressedStreamBuf::takeFrame(Frame& frame)
+    {
+        std::unique_lock lock(mMutex);
+        mHasFrame.wait(lock, [&] { return !mFrames.empty() || mDecoderDone; });
+
+        if (mFrames.empty())
+        {
+            if (!mError.empty())
+                throw std::runtime_error(mError);
+            return false;
+        }
+
+        frame = std::move(mFrames.front());
+        mFrames.pop_front();
+        lock.unlock();
+        mHasSpace.notify_one();
+        return true;
+    }
+}
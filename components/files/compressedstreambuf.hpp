@@ -0,0 +1,69 @@
+#ifndef OPENMW_COMPONENTS_FILES_COMPRESSEDSTREAMBUF_H
+#define OPENMW_COMPONENTS_FILES_COMPRESSEDSTREAMBUF_H
+
+#include "istreamptr.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Files
+{
+    /// A streambuf reading the uncompressed contents of a compressed container written by writeCompressedStream.
+    /// Frames are decompressed ahead of the reader by a worker thread. Seeking is supported, but seeking backwards
+    /// outside of the current frame restarts decompression from the beginning.
+    class CompressedStreamBuf final : public std::streambuf
+    {
+    public:
+        /// @param source Stream positioned at the beginning of the container.
+        explicit CompressedStreamBuf(IStreamPtr&& source);
+
+        ~CompressedStreamBuf();
+
+        int_type underflow() final;
+
+        pos_type seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode) final;
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode mode) final;
+
+    private:
+        struct Frame
+        {
+            std::uint64_t mStart = 0;
+            std::vector<char> mData;
+        };
+
+        IStreamPtr mSource;
+        std::streamoff mFramesBegin;
+        std::uint64_t mSize;
+        std::uint32_t mMaxFrameSize;
+        Frame mCurrent;
+        std::uint64_t mPosition = 0;
+
+        std::mutex mMutex;
+        std::condition_variable mHasFrame;
+        std::condition_variable mHasSpace;
+        std::deque<Frame> mFrames;
+        bool mDecoderDone = false;
+        bool mStopDecoder = false;
+        std::string mError;
+        std::thread mDecoder;
+
+        std::uint64_t getPosition() const;
+
+        void startDecoder();
+
+        void stopDecoder();
+
+        void decode();
+
+        bool takeFrame(Frame& frame);
+    };
+}
+
+#endif
@@ -20,19 +20,28 @@ namespace Interpreter
         throw std::runtime_error(error);
     }
 
-    template<typename T>
-    auto& getDispatcher(const T& segment, unsigned int seg, int opcode)
+    [[noreturn]] static void abortUnknownInstruction(Type_Code code)
     {
-        auto it = segment.find(opcode);
-        if (it == segment.end())
+        switch (code >> 30)
         {
-            abortUnknownCode(seg, opcode);
+            case 0: abortUnknownCode(0, code >> 24);
+            case 2: abortUnknownCode(2, (code >> 20) & 0x3ff);
         }
-        return it->second;
+
+        switch (code >> 26)
+        {
+            case 0x30: abortUnknownCode(3, (code >> 8) & 0x3ffff);
+            case 0x32: abortUnknownCode(5, code & 0x3ffffff);
+        }
+
+        abortUnknownSegment(code);
     }
 
-    void Interpreter::execute (Type_Code code)
+    Instruction Interpreter::decode (Type_Code code) const
     {
+        Instruction instruction;
+        instruction.mCode = code;
+
         unsigned int segSpec = code >> 30;
 
         switch (segSpec)
@@ -40,17 +49,17 @@ namespace Interpreter
             case 0:
             {
                 const int opcode = code >> 24;
-                const unsigned int arg0 = code & 0xffffff;
-
-                return getDispatcher(mSegment0, 0, opcode)->execute(mRuntime, arg0);
+                instruction.mOpcode1 = mSegment0.find(opcode);
+                instruction.mArg0 = code & 0xffffff;
+                return instruction;
             }
 
             case 2:
             {
                 const int opcode = (code >> 20) & 0x3ff;
-                const unsigned int arg0 = code & 0xfffff;
-
-                return getDispatcher(mSegment2, 2, opcode)->execute(mRuntime, arg0);
+                instruction.mOpcode1 = mSegment2.find(opcode);
+                instruction.mArg0 = code & 0xfffff;
+                return instruction;
             }
         }
 
@@ -61,20 +70,31 @@ namespace Interpreter
             case 0x30:
             {
                 const int opcode = (code >> 8) & 0x3ffff;
-                const unsigned int arg0 = code & 0xff;
-
-                return getDispatcher(mSegment3, 3, opcode)->execute(mRuntime, arg0);
+                instruction.mOpcode1 = mSegment3.find(opcode);
+                instruction.mArg0 = code & 0xff;
+                return instruction;
             }
 
             case 0x32:
             {
                 const int opcode = code & 0x3ffffff;
-
-                return getDispatcher(mSegment5, 5, opcode)->execute(mRuntime);
+                instruction.mOpcode0 = mSegment5.find(opcode);
+                return instruction;
             }
         }
 
-        abortUnknownSegment (code);
+        return instruction;
+    }
+
+    void Interpreter::execute (const Instruction& instruction)
+    {
+        if (instruction.mOpcode1 != nullptr)
+            return instruction.mOpcode1->execute(mRuntime, instruction.mArg0);
+
+        if (instruction.mOpcode0 != nullptr)
+            return instruction.mOpcode0->execute(mRuntime);
+
+        abortUnknownInstruction(instruction.mCode);
     }
 
     void Interpreter::begin()
@@ -104,28 +124,44 @@ namespace Interpreter
         }
     }
 
-    Interpreter::Interpreter() : mRunning (false)
+    // Segments start their reserved extension opcodes at these, see docs/vmformat.txt
+    Interpreter::Interpreter()
+    : mRunning (false), mInstructionCount (0), mSegment0 (32), mSegment2 (512), mSegment3 (131072), mSegment5 (33554432)
     {}
 
-    void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
+    std::vector<Instruction> Interpreter::decode (const Type_Code *code, int codeSize) const
     {
         assert (codeSize>=4);
 
+        const int opcodes = static_cast<int> (code[0]);
+
+        const Type_Code *codeBlock = code + 4;
+
+        std::vector<Instruction> instructions;
+        instructions.reserve (opcodes);
+
+        for (int i = 0; i < opcodes; ++i)
+            instructions.push_back (decode (codeBlock[i]));
+
+        return instructions;
+    }
+
+    template <class TGetInstruction>
+    void Interpreter::run (const Type_Code *code, int codeSize, int opcodes, Context& context,
+        TGetInstruction&& getInstruction)
+    {
         begin();
 
         try
         {
             mRuntime.configure (code, codeSize, context);
 
-            int opcodes = static_cast<int> (code[0]);
-
-            const Type_Code *codeBlock = code + 4;
-
             while (mRuntime.getPC()>=0 && mRuntime.getPC()<opcodes)
             {
-                Type_Code runCode = codeBlock[mRuntime.getPC()];
+                const Instruction& instruction = getInstruction (mRuntime.getPC());
                 mRuntime.setPC (mRuntime.getPC()+1);
-                execute (runCode);
+                ++mInstructionCount;
+                execute (instruction);
             }
         }
         catch (...)
@@ -136,4 +172,26 @@ namespace Interpreter
 
         end();
     }
+
+    void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
+    {
+        assert (codeSize>=4);
+
+        // Console commands and dialogue results usually run once, so look up each opcode when it is executed rather
+        // than decoding the whole script up front
+        const Type_Code *codeBlock = code + 4;
+
+        run (code, codeSize, static_cast<int> (code[0]), context,
+            [&] (int pc) { return decode (codeBlock[pc]); });
+    }
+
+    void Interpreter::run (const Type_Code *code, int codeSize, const std::vector<Instruction>& instructions,
+        Context& context)
+    {
+        assert (codeSize>=4);
+        assert (instructions.size()==code[0]);
+
+        run (code, codeSize, static_cast<int> (instructions.size()), context,
+            [&] (int pc) -> const Instruction& { return instructions[pc]; });
+    }
 }
@@ -1,11 +1,12 @@
 #ifndef INTERPRETER_INTERPRETER_H_INCLUDED
 #define INTERPRETER_INTERPRETER_H_INCLUDED
 
-#include <map>
 #include <stack>
 #include <memory>
 #include <cassert>
+#include <cstddef>
 #include <utility>
+#include <vector>
 
 #include "runtime.hpp"
 #include "types.hpp"
@@ -13,32 +14,73 @@
 
 namespace Interpreter
 {
+    /// An instruction with its opcode already looked up (see Interpreter::decode). Both opcode pointers are null for
+    /// an unknown opcode.
+    struct Instruction
+    {
+        Opcode1 *mOpcode1 = nullptr;
+        Opcode0 *mOpcode0 = nullptr;
+        unsigned int mArg0 = 0;
+        Type_Code mCode = 0;
+    };
+
+    /// Opcodes of one segment, indexed by opcode. The opcodes reserved for extensions start at a high offset, so they
+    /// are kept in a second table to keep both dense.
+    template<typename TOp>
+    class OpcodeTable
+    {
+            int mExtensionsBegin;
+            std::vector<std::unique_ptr<TOp>> mOpcodes;
+            std::vector<std::unique_ptr<TOp>> mExtensionOpcodes;
+
+        public:
+
+            explicit OpcodeTable (int extensionsBegin) : mExtensionsBegin (extensionsBegin) {}
+
+            void install (int code, std::unique_ptr<TOp>&& op)
+            {
+                std::vector<std::unique_ptr<TOp>>& opcodes = code<mExtensionsBegin ? mOpcodes : mExtensionOpcodes;
+                const std::size_t index = static_cast<std::size_t> (code<mExtensionsBegin ? code : code-mExtensionsBegin);
+                if (index>=opcodes.size())
+                    opcodes.resize (index+1);
+                assert (opcodes[index]==nullptr);
+                opcodes[index] = std::move (op);
+            }
+
+            TOp *find (int code) const
+            {
+                const std::vector<std::unique_ptr<TOp>>& opcodes = code<mExtensionsBegin ? mOpcodes : mExtensionOpcodes;
+                const std::size_t index = static_cast<std::size_t> (code<mExtensionsBegin ? code : code-mExtensionsBegin);
+                return index<opcodes.size() ? opcodes[index].get() : nullptr;
+            }
+    };
+
     class Interpreter
     {
             std::stack<Runtime> mCallstack;
             bool mRunning;
+            std::size_t mInstructionCount;
             Runtime mRuntime;
-            std::map<int, std::unique_ptr<Opcode1>> mSegment0;
-            std::map<int, std::unique_ptr<Opcode1>> mSegment2;
-            std::map<int, std::unique_ptr<Opcode1>> mSegment3;
-            std::map<int, std::unique_ptr<Opcode0>> mSegment5;
+            OpcodeTable<Opcode1> mSegment0;
+            OpcodeTable<Opcode1> mSegment2;
+            OpcodeTable<Opcode1> mSegment3;
+            OpcodeTable<Opcode0> mSegment5;
 
             // not implemented
             Interpreter (const Interpreter&);
             Interpreter& operator= (const Interpreter&);
 
-            void execute (Type_Code code);
+            Instruction decode (Type_Code code) const;
+
+            void execute (const Instruction& instruction);
 
             void begin();
 
             void end();
 
-            template<typename TSeg, typename TOp>
-            void installSegment(TSeg& seg, int code, TOp&& op)
-            {
-                assert(seg.find(code) == seg.end());
-                seg.emplace(code, std::move(op));
-            }
+            template <class TGetInstruction>
+            void run (const Type_Code *code, int codeSize, int opcodes, Context& context,
+                TGetInstruction&& getInstruction);
 
         public:
 
@@ -47,28 +89,39 @@ namespace Interpreter
             template<typename T, typename ...TArgs>
             void installSegment0(int code, TArgs&& ...args)
             {
-                installSegment(mSegment0, code, std::make_unique<T>(std::forward<TArgs>(args)...));
+                mSegment0.install(code, std::make_unique<T>(std::forward<TArgs>(args)...));
             }
 
             template<typename T, typename ...TArgs>
             void installSegment2(int code, TArgs&& ...args)
             {
-                installSegment(mSegment2, code, std::make_unique<T>(std::forward<TArgs>(args)...));
+                mSegment2.install(code, std::make_unique<T>(std::forward<TArgs>(args)...));
             }
 
             template<typename T, typename ...TArgs>
             void installSegment3(int code, TArgs&& ...args)
             {
-                installSegment(mSegment3, code, std::make_unique<T>(std::forward<TArgs>(args)...));
+                mSegment3.install(code, std::make_unique<T>(std::forward<TArgs>(args)...));
             }
 
             template<typename T, typename ...TArgs>
             void installSegment5(int code, TArgs&& ...args)
             {
-                installSegment(mSegment5, code, std::make_unique<T>(std::forward<TArgs>(args)...));
+                mSegment5.install(code, std::make_unique<T>(std::forward<TArgs>(args)...));
             }
 
+            std::vector<Instruction> decode (const Type_Code *code, int codeSize) const;
+            ///< Look up the opcodes of all instructions in \a code, so running it doesn't have to. The result stays
+            /// valid for the lifetime of the interpreter.
+
             void run (const Type_Code *code, int codeSize, Context& context);
+
+            void run (const Type_Code *code, int codeSize, const std::vector<Instruction>& instructions,
+                Context& context);
+            ///< \param instructions Result of decode for \a code.
+
+            std::size_t getInstructionCount() const { return mInstructionCount; }
+            ///< Number of instructions executed since construction, including those of nested runs.
     };
 }
 
@@ -1,6 +1,7 @@
 #include "compression.hpp"
 
 #include <lz4.h>
+#include <lz4hc.h>
 
 #include <cstddef>
 #include <cstring>
@@ -10,16 +11,24 @@
 
 namespace Misc
 {
-    std::vector<std::byte> compress(const std::vector<std::byte>& data)
+    std::vector<std::byte> compress(const std::vector<std::byte>& data, int level)
     {
         const std::size_t originalSize = data.size();
         std::vector<std::byte> result(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(originalSize)) + sizeof(originalSize)));
-        const int size = LZ4_compress_default(
-            reinterpret_cast<const char*>(data.data()),
-            reinterpret_cast<char*>(result.data()) + sizeof(originalSize),
-            static_cast<int>(data.size()),
-            static_cast<int>(result.size() - sizeof(originalSize))
-        );
+        const int size = level > 0
+            ? LZ4_compress_HC(
+                reinterpret_cast<const char*>(data.data()),
+                reinterpret_cast<char*>(result.data()) + sizeof(originalSize),
+                static_cast<int>(data.size()),
+                static_cast<int>(result.size() - sizeof(originalSize)),
+                level
+            )
+            : LZ4_compress_default(
+                reinterpret_cast<const char*>(data.data()),
+                reinterpret_cast<char*>(result.data()) + sizeof(originalSize),
+                static_cast<int>(data.size()),
+                static_cast<int>(result.size() - sizeof(originalSize))
+            );
         if (size == 0)
             throw std::runtime_error("Failed to compress");
         std::memcpy(result.data(), &originalSize, sizeof(originalSize));
@@ -28,20 +37,27 @@ namespace Misc
     }
 
     std::vector<std::byte> decompress(const std::vector<std::byte>& data)
+    {
+        return decompress(data.data(), data.size());
+    }
+
+    std::vector<std::byte> decompress(const std::byte* data, std::size_t size)
     {
         std::size_t originalSize;
-        std::memcpy(&originalSize, data.data(), sizeof(originalSize));
+        if (size < sizeof(originalSize))
+            throw std::runtime_error("Compressed data is too small: " + std::to_string(size));
+        std::memcpy(&originalSize, data, sizeof(originalSize));
         std::vector<std::byte> result(originalSize);
-        const int size = LZ4_decompress_safe(
-            reinterpret_cast<const char*>(data.data()) + sizeof(originalSize),
+        const int decompressedSize = LZ4_decompress_safe(
+            reinterpret_cast<const char*>(data) + sizeof(originalSize),
             reinterpret_cast<char*>(result.data()),
-            static_cast<int>(data.size() - sizeof(originalSize)),
+            static_cast<int>(size - sizeof(originalSize)),
             static_cast<int>(result.size())
         );
-        if (size < 0)
+        if (decompressedSize < 0)
             throw std::runtime_error("Failed to decompress");
-        if (originalSize != static_cast<std::size_t>(size))
-            throw std::runtime_error("Size of decompressed data (" + std::to_string(size)
+        if (originalSize != static_cast<std::size_t>(decompressedSize))
+            throw std::runtime_error("Size of decompressed data (" + std::to_string(decompressedSize)
                                      + ") doesn't match stored (" + std::to_string(originalSize) + ")");
         return result;
     }
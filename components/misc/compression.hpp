@@ -6,9 +6,13 @@
 
 namespace Misc
 {
-    std::vector<std::byte> compress(const std::vector<std::byte>& data);
+    /// Compresses with LZ4. Level above 0 selects LZ4 HC with the given level, it is slower to compress but produces
+    /// smaller output that is decompressed as fast.
+    std::vector<std::byte> compress(const std::vector<std::byte>& data, int level = 0);
 
     std::vector<std::byte> decompress(const std::vector<std::byte>& data);
+
+    std::vector<std::byte> decompress(const std::byte* data, std::size_t size);
 }
 
 #endif
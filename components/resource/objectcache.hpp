@@ -27,6 +27,7 @@
 #include <string>
 #include <map>
 #include <mutex>
+#include <vector>
 
 namespace osg
 {
@@ -71,23 +72,27 @@ class GenericObjectCache : public osg::Referenced
         void removeExpiredObjectsInCache(double expiryTime)
         {
             std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+            removeExpiredObjectsInCache(expiryTime, objectsToRemove);
+            // note, actual unref happens outside of the lock
+            objectsToRemove.clear();
+        }
+
+        /** Same as above, but hands the removed objects to the caller instead of unreferencing them.*/
+        void removeExpiredObjectsInCache(double expiryTime, std::vector<osg::ref_ptr<osg::Object> >& objectsToRemove)
+        {
+            std::lock_guard<std::mutex> lock(_objectCacheMutex);
+            // Remove expired entries from object cache
+            typename ObjectCacheMap::iterator oitr = _objectCache.begin();
+            while(oitr != _objectCache.end())
             {
-                std::lock_guard<std::mutex> lock(_objectCacheMutex);
-                // Remove expired entries from object cache
-                typename ObjectCacheMap::iterator oitr = _objectCache.begin();
-                while(oitr != _objectCache.end())
+                if (oitr->second.second<=expiryTime)
                 {
-                    if (oitr->second.second<=expiryTime)
-                    {
-                        objectsToRemove.push_back(oitr->second.first);
-                        _objectCache.erase(oitr++);
-                    }
-                    else
-                        ++oitr;
+                    objectsToRemove.push_back(oitr->second.first);
+                    _objectCache.erase(oitr++);
                 }
+                else
+                    ++oitr;
             }
-            // note, actual unref happens outside of the lock
-            objectsToRemove.clear();
         }
 
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
@@ -3,6 +3,8 @@
 
 #include <osg/ref_ptr>
 
+#include <components/sceneutil/unrefqueue.hpp>
+
 #include "objectcache.hpp"
 
 namespace VFS
@@ -42,6 +44,7 @@ namespace Resource
             : mVFS(vfs)
             , mCache(new CacheType)
             , mExpiryDelay(0.0)
+            , mUnrefQueue(nullptr)
         {
         }
 
@@ -51,7 +54,15 @@ namespace Resource
         void updateCache(double referenceTime) override
         {
             mCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
-            mCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
+            if (mUnrefQueue == nullptr)
+            {
+                mCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
+                return;
+            }
+            std::vector<osg::ref_ptr<osg::Object>> expired;
+            mCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay, expired);
+            for (const osg::ref_ptr<osg::Object>& object : expired)
+                mUnrefQueue->push(object);
         }
 
         /// Clear all cache entries.
@@ -61,6 +72,9 @@ namespace Resource
         void setExpiryDelay (double expiryDelay) override { mExpiryDelay = expiryDelay; }
         float getExpiryDelay() const { return mExpiryDelay; }
 
+        /// Unreference expired cache entries through the given queue instead of all at once when the cache is updated.
+        void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue) { mUnrefQueue = unrefQueue; }
+
         const VFS::Manager* getVFS() const { return mVFS; }
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override {}
@@ -71,6 +85,7 @@ namespace Resource
         const VFS::Manager* mVFS;
         osg::ref_ptr<CacheType> mCache;
         double mExpiryDelay;
+        SceneUtil::UnrefQueue* mUnrefQueue;
     };
 
 
@@ -418,6 +418,9 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "WorkQueue",
             "WorkThread",
             "UnrefQueue",
+            "UnrefQueue Batch",
+            "UnrefQueue Time",
+            "UnrefQueue Limit",
             "",
             "Texture",
             "StateSet",
@@ -430,21 +433,41 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "",
             "Groundcover Chunk",
             "Object Chunk",
+            "Object Chunk Queued",
+            "Object Chunk Cancelled",
             "Terrain Chunk",
             "Terrain Texture",
             "Land",
             "Composite",
+            "Composite Preparing",
+            "Composite Time",
+            "Composite Budget",
+            "",
+            "Light StateSet",
+            "Light Hit",
+            "Light Miss",
+            "Light Evicted",
+            "",
+            "Occluder",
+            "Occlusion Tested",
+            "Occlusion Culled",
             "",
             "NavMesh Jobs",
             "NavMesh Waiting",
             "NavMesh Pushed",
             "NavMesh Processing",
+            "NavMesh Cancelled",
+            "NavMesh QueueLatency",
             "NavMesh DbJobs",
             "NavMesh DbCacheHitRate",
             "NavMesh CacheSize",
             "NavMesh UsedTiles",
             "NavMesh CachedTiles",
             "NavMesh CacheHitRate",
+            "NavMesh CacheAgents",
+            "NavMesh LayersCacheSize",
+            "NavMesh CachedLayers",
+            "NavMesh LayersCacheHitRate",
             "",
             "Mechanics Actors",
             "Mechanics Objects",
@@ -455,6 +478,11 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "Physics HeightFields",
             "",
             "Lua UsedMemory",
+            "",
+            "Script Runs",
+            "Script Instructions",
+            "Script Deferred",
+            "Script Time",
         });
 
         static const auto longest = std::max_element(statNames.begin(), statNames.end(),
@@ -27,6 +27,11 @@ namespace
     constexpr int maxLightsUpperLimit = 64;
     constexpr int ffpMaxLights = 8;
 
+    // Cached light list StateSets not requested for this many frames are evicted
+    constexpr std::size_t stateSetCacheMaxAge = 300;
+    // Evict at most this often to keep the per-frame cost of the cache sweep low
+    constexpr std::size_t stateSetCacheEvictionInterval = 60;
+
     bool sortLights(const SceneUtil::LightManager::LightSourceViewBound* left, const SceneUtil::LightManager::LightSourceViewBound* right)
     {
         static auto constexpr illuminationBias = 81.f;
@@ -1024,14 +1029,40 @@ namespace SceneUtil
         mLights.clear();
         mLightsInViewSpace.clear();
 
-        // Do an occasional cleanup for orphaned lights.
-        for (int i = 0; i < 2; ++i)
+        mLastStateSetCacheStats = mStateSetCacheStats;
+        mStateSetCacheStats = StateSetCacheStats();
+
+        if (frameNum % stateSetCacheEvictionInterval == 0)
+            evictStateSetCache(frameNum);
+    }
+
+    void LightManager::evictStateSetCache(size_t frameNum)
+    {
+        // Light lists that were not used recently most likely refer to lights that no longer exist, or to
+        // combinations that will not come back soon. Both frame buffers age independently.
+        for (auto& cache : mStateSetCache)
         {
-            if (mStateSetCache[i].size() > 5000)
-                mStateSetCache[i].clear();
+            for (auto it = cache.begin(); it != cache.end();)
+            {
+                if (it->second.mLastUsedFrame + stateSetCacheMaxAge < frameNum)
+                {
+                    it = cache.erase(it);
+                    ++mStateSetCacheStats.mEvicted;
+                }
+                else
+                    ++it;
+            }
         }
     }
 
+    void LightManager::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        stats->setAttribute(frameNumber, "Light StateSet", mStateSetCache[0].size() + mStateSetCache[1].size());
+        stats->setAttribute(frameNumber, "Light Hit", mLastStateSetCacheStats.mHits);
+        stats->setAttribute(frameNumber, "Light Miss", mLastStateSetCacheStats.mMisses);
+        stats->setAttribute(frameNumber, "Light Evicted", mLastStateSetCacheStats.mEvicted);
+    }
+
     void LightManager::addLight(LightSource* lightSource, const osg::Matrixf& worldMat, size_t frameNum)
     {
         LightSourceTransform l;
@@ -1057,7 +1088,7 @@ namespace SceneUtil
 
     size_t LightManager::HashLightIdList::operator()(const LightIdList& lightIdList) const
     {
-        size_t hash = 0;
+        size_t hash = lightIdList.size();
         for (size_t i = 0; i < lightIdList.size(); ++i)
             Misc::hashCombine(hash, lightIdList[i]);
         return hash;
@@ -1065,6 +1096,8 @@ namespace SceneUtil
 
     osg::ref_ptr<osg::StateSet> LightManager::getLightListStateSet(const LightList& lightList, size_t frameNum, const osg::RefMatrix* viewMatrix)
     {
+        std::lock_guard<std::mutex> lock(mCullMutex);
+
         if (getLightingMethod() == LightingMethod::PerObjectUniform)
         {
             mStateSetGenerator->mViewMatrix = *viewMatrix;
@@ -1092,21 +1125,28 @@ namespace SceneUtil
         LightIdList lightIdList;
         lightIdList.reserve(lightList.size());
         std::transform(lightList.begin(), lightList.end(), std::back_inserter(lightIdList), [] (const LightSourceViewBound* l) { return l->mLightSource->getId(); });
+        // Light contributions are summed up in the shaders, so the order of lights within a list does not matter
+        std::sort(lightIdList.begin(), lightIdList.end());
 
         auto found = stateSetCache.find(lightIdList);
         if (found != stateSetCache.end())
         {
-            mStateSetGenerator->update(found->second, lightList, frameNum);
-            return found->second;
+            ++mStateSetCacheStats.mHits;
+            found->second.mLastUsedFrame = frameNum;
+            mStateSetGenerator->update(found->second.mStateSet, lightList, frameNum);
+            return found->second.mStateSet;
         }
 
+        ++mStateSetCacheStats.mMisses;
         auto stateset = mStateSetGenerator->generate(lightList, frameNum);
-        stateSetCache.emplace(lightIdList, stateset);
+        stateSetCache.emplace(std::move(lightIdList), CachedLightStateSet {stateset, frameNum});
         return stateset;
     }
 
     const std::vector<LightManager::LightSourceViewBound>& LightManager::getLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum)
     {
+        std::lock_guard<std::mutex> lock(mCullMutex);
+
         osg::Camera* camera = cv->getCurrentCamera();
 
         osg::observer_ptr<osg::Camera> camPtr (camera);
@@ -1240,6 +1280,9 @@ namespace SceneUtil
 
     bool LightListCallback::pushLightState(osg::Node *node, osgUtil::CullVisitor *cv)
     {
+        // The node may be culled by several cameras at once
+        std::lock_guard<std::mutex> lock(mMutex);
+
         if (!mLightManager)
         {
             mLightManager = findLightManager(cv->getNodePath());
@@ -4,12 +4,14 @@
 #include <set>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <array>
 
 #include <osg/Light>
 #include <osg/Group>
 #include <osg/NodeVisitor>
 #include <osg/observer_ptr>
+#include <osg/Stats>
 
 #include <components/shader/shadermanager.hpp>
 
@@ -267,8 +269,10 @@ namespace SceneUtil
         /// Internal use only, called automatically by the LightSource's UpdateCallback
         void addLight(LightSource* lightSource, const osg::Matrixf& worldMat, size_t frameNum);
 
+        /// @note Thread safe, cameras may be culled concurrently.
         const std::vector<LightSourceViewBound>& getLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum);
 
+        /// @note Thread safe, cameras may be culled concurrently.
         osg::ref_ptr<osg::StateSet> getLightListStateSet(const LightList& lightList, size_t frameNum, const osg::RefMatrix* viewMatrix);
 
         void setSunlight(osg::ref_ptr<osg::Light> sun);
@@ -307,6 +311,8 @@ namespace SceneUtil
 
         std::shared_ptr<PPLightBuffer> getPPLightsBuffer() { return mPPLightBuffer; }
 
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
     private:
         void initFFP(int targetLights);
         void initPerObjectUniform(int targetLights);
@@ -321,17 +327,38 @@ namespace SceneUtil
 
         std::vector<LightSourceTransform> mLights;
 
+        // Guards the state modified during cull
+        std::mutex mCullMutex;
+
         using LightSourceViewBoundCollection = std::vector<LightSourceViewBound>;
         std::map<osg::observer_ptr<osg::Camera>, LightSourceViewBoundCollection> mLightsInViewSpace;
 
+        void evictStateSetCache(size_t frameNum);
+
+        // Sorted light IDs, so that the same set of lights maps to the same StateSet regardless of the order
+        // in which the lights were collected.
         using LightIdList = std::vector<int>;
         struct HashLightIdList
         {
             size_t operator()(const LightIdList&) const;
         };
-        using LightStateSetMap = std::unordered_map<LightIdList, osg::ref_ptr<osg::StateSet>, HashLightIdList>;
+        struct CachedLightStateSet
+        {
+            osg::ref_ptr<osg::StateSet> mStateSet;
+            size_t mLastUsedFrame;
+        };
+        using LightStateSetMap = std::unordered_map<LightIdList, CachedLightStateSet, HashLightIdList>;
         LightStateSetMap mStateSetCache[2];
 
+        struct StateSetCacheStats
+        {
+            std::size_t mHits = 0;
+            std::size_t mMisses = 0;
+            std::size_t mEvicted = 0;
+        };
+        StateSetCacheStats mStateSetCacheStats;
+        StateSetCacheStats mLastStateSetCacheStats;
+
         std::vector<osg::ref_ptr<osg::StateAttribute>> mDummies;
 
         int mStartLight;
@@ -396,6 +423,7 @@ namespace SceneUtil
 
     private:
         LightManager* mLightManager;
+        std::mutex mMutex;
         size_t mLastFrameNumber;
         LightManager::LightList mLightList;
         LightManager::LightList mLightListCropped;
@@ -0,0 +1,221 @@
+#include "lodcache.hpp"
+
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <osg/Image>
+#include <osgDB/Registry>
+
+#include <components/debug/debuglog.hpp>
+#include <components/files/hash.hpp>
+#include <components/files/memorystream.hpp>
+
+#include "workqueue.hpp"
+
+namespace SceneUtil
+{
+
+namespace
+{
+    std::string getVersionDirectory(const std::string& version)
+    {
+        std::istringstream stream(version);
+        const std::array<std::uint64_t, 2> hash = Files::getHash("lod cache version", stream);
+        std::ostringstream result;
+        result << std::hex << std::setfill('0');
+        for (std::uint64_t value : hash)
+            result << std::setw(16) << value;
+        return result.str();
+    }
+
+    bool isVersionDirectory(const boost::filesystem::path& path)
+    {
+        const std::string name = path.filename().string();
+        if (name.size() != 32)
+            return false;
+        for (char c : name)
+        {
+            if (!std::isxdigit(static_cast<unsigned char>(c)))
+                return false;
+        }
+        return boost::filesystem::is_directory(path);
+    }
+
+    void writeFile(const boost::filesystem::path& path, const std::string& data)
+    {
+        try
+        {
+            const boost::filesystem::path tmpPath = path.parent_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.tmp");
+            {
+                boost::filesystem::ofstream stream(tmpPath, std::ios::binary);
+                stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+                if (!stream)
+                {
+                    stream.close();
+                    boost::filesystem::remove(tmpPath);
+                    Log(Debug::Warning) << "Failed to write LOD cache entry " << path;
+                    return;
+                }
+            }
+            boost::filesystem::rename(tmpPath, path);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to write LOD cache entry " << path << ": " << e.what();
+        }
+    }
+
+    std::optional<std::string> encodeImage(const osg::Image& image)
+    {
+        osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("png");
+        if (!readerwriter)
+        {
+            Log(Debug::Warning) << "Unable to write LOD cache image, can't find a png ReaderWriter";
+            return std::nullopt;
+        }
+        std::ostringstream stream;
+        osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(image, stream);
+        if (!result.success())
+        {
+            Log(Debug::Warning) << "Unable to write LOD cache image: " << result.message() << " code " << result.status();
+            return std::nullopt;
+        }
+        return stream.str();
+    }
+
+    class WriteFileWorkItem : public WorkItem
+    {
+    public:
+        WriteFileWorkItem(const boost::filesystem::path& path, std::string data)
+            : mPath(path)
+            , mData(std::move(data))
+        {
+        }
+
+        void doWork() override
+        {
+            writeFile(mPath, mData);
+        }
+
+    private:
+        boost::filesystem::path mPath;
+        std::string mData;
+    };
+
+    class WriteImageWorkItem : public WorkItem
+    {
+    public:
+        WriteImageWorkItem(const boost::filesystem::path& path, osg::ref_ptr<osg::Image> image)
+            : mPath(path)
+            , mImage(std::move(image))
+        {
+        }
+
+        void doWork() override
+        {
+            if (const std::optional<std::string> data = encodeImage(*mImage))
+                writeFile(mPath, *data);
+        }
+
+    private:
+        boost::filesystem::path mPath;
+        osg::ref_ptr<osg::Image> mImage;
+    };
+}
+
+LodCache::LodCache(const boost::filesystem::path& directory, const std::string& version, WorkQueue* workQueue)
+    : mDirectory(directory / getVersionDirectory(version))
+    , mWorkQueue(workQueue)
+    , mEnabled(false)
+{
+    try
+    {
+        if (boost::filesystem::is_directory(directory))
+        {
+            for (const auto& entry : boost::filesystem::directory_iterator(directory))
+            {
+                if (entry.path() != mDirectory && isVersionDirectory(entry.path()))
+                {
+                    Log(Debug::Verbose) << "Removing outdated LOD cache " << entry.path();
+                    boost::filesystem::remove_all(entry.path());
+                }
+            }
+        }
+        boost::filesystem::create_directories(mDirectory);
+        mEnabled = true;
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Failed to initialize LOD cache in " << directory << ", it will be disabled: " << e.what();
+    }
+}
+
+std::optional<std::string> LodCache::read(const std::string& name) const
+{
+    if (!mEnabled)
+        return std::nullopt;
+    try
+    {
+        boost::filesystem::ifstream stream(mDirectory / name, std::ios::binary);
+        if (!stream.is_open())
+            return std::nullopt;
+        std::ostringstream result;
+        result << stream.rdbuf();
+        if (stream.bad())
+            return std::nullopt;
+        return result.str();
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Failed to read LOD cache entry " << (mDirectory / name) << ": " << e.what();
+        return std::nullopt;
+    }
+}
+
+void LodCache::write(const std::string& name, std::string data)
+{
+    if (!mEnabled)
+        return;
+    if (mWorkQueue)
+        mWorkQueue->addWorkItem(new WriteFileWorkItem(mDirectory / name, std::move(data)));
+    else
+        writeFile(mDirectory / name, data);
+}
+
+osg::ref_ptr<osg::Image> LodCache::readImage(const std::string& name) const
+{
+    const std::optional<std::string> data = read(name);
+    if (!data)
+        return nullptr;
+
+    osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("png");
+    if (!readerwriter)
+        return nullptr;
+
+    Files::IMemStream stream(data->data(), data->size());
+    osgDB::ReaderWriter::ReadResult result = readerwriter->readImage(stream);
+    if (!result.success())
+    {
+        Log(Debug::Warning) << "Failed to read LOD cache image " << (mDirectory / name) << ": " << result.message() << " code " << result.status();
+        return nullptr;
+    }
+    return result.getImage();
+}
+
+void LodCache::writeImage(const std::string& name, osg::ref_ptr<osg::Image> image)
+{
+    if (!mEnabled || !image)
+        return;
+    if (mWorkQueue)
+        mWorkQueue->addWorkItem(new WriteImageWorkItem(mDirectory / name, std::move(image)));
+    else if (const std::optional<std::string> data = encodeImage(*image))
+        writeFile(mDirectory / name, *data);
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_LODCACHE_H
+#define OPENMW_COMPONENTS_SCENEUTIL_LODCACHE_H
+
+#include <optional>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Image;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+
+    /// @brief Persistent cache for generated distant land data, stored as one file per entry.
+    /// @par Entries are stored in a subdirectory named after a hash of the version string, so changing the version,
+    /// e.g. because the content files or the settings affecting the generated data changed, starts over with an empty
+    /// cache. Subdirectories of previous versions are removed.
+    /// @note Thread safe. Write errors are logged and otherwise ignored, the cache is an optimization only.
+    class LodCache : public osg::Referenced
+    {
+    public:
+        /// @param workQueue If set, entries are encoded and written to disk in the background.
+        LodCache(const boost::filesystem::path& directory, const std::string& version, WorkQueue* workQueue = nullptr);
+
+        bool isEnabled() const { return mEnabled; }
+
+        std::optional<std::string> read(const std::string& name) const;
+
+        void write(const std::string& name, std::string data);
+
+        osg::ref_ptr<osg::Image> readImage(const std::string& name) const;
+
+        /// @note The image must not be modified afterwards.
+        void writeImage(const std::string& name, osg::ref_ptr<osg::Image> image);
+
+    private:
+        boost::filesystem::path mDirectory;
+        osg::ref_ptr<WorkQueue> mWorkQueue;
+        bool mEnabled;
+    };
+}
+
+#endif
@@ -169,9 +169,13 @@ osg::BoundingBox MorphGeometry::computeBoundingBox() const
 
 void MorphGeometry::cull(osg::NodeVisitor *nv)
 {
+    // Several cameras may cull the geometry at once, only the first one of a frame applies the morph targets
+    std::unique_lock<std::mutex> lock(mMutex);
+
     if (mLastFrameNumber == nv->getTraversalNumber() || !mDirty || mMorphTargets.size() == 0)
     {
         osg::Geometry& geom = *getGeometry(mLastFrameNumber);
+        lock.unlock();
         nv->pushOntoNodePath(&geom);
         nv->apply(geom);
         nv->popFromNodePath();
@@ -201,6 +205,7 @@ void MorphGeometry::cull(osg::NodeVisitor *nv)
     positionDst->dirty();
 
     geom.osg::Drawable::dirtyGLObjects();
+    lock.unlock();
 
     nv->pushOntoNodePath(&geom);
     nv->apply(geom);
@@ -3,6 +3,8 @@
 
 #include <osg/Geometry>
 
+#include <mutex>
+
 namespace SceneUtil
 {
 
@@ -75,6 +77,7 @@ namespace SceneUtil
         osg::ref_ptr<osg::Geometry> mGeometry[2];
         osg::Geometry* getGeometry(unsigned int frame) const;
 
+        std::mutex mMutex;
         unsigned int mLastFrameNumber;
         bool mDirty; // Have any morph targets changed?
 
@@ -24,11 +24,13 @@
 #include <osg/io_utils>
 #include <osg/Depth>
 #include <osg/ClipControl>
+#include <osg/FrameBufferObject>
 
 #include <sstream>
 #include <deque>
 #include <vector>
 
+#include "parallelcull.hpp"
 #include "shadowsbin.hpp"
 
 namespace {
@@ -239,7 +241,7 @@ class VDSMCameraCullCallback : public osg::NodeCallback
 {
     public:
 
-        VDSMCameraCullCallback(MWShadowTechnique* vdsm, osg::Polytope& polytope);
+        VDSMCameraCullCallback(MWShadowTechnique* vdsm, osg::Polytope& polytope, osg::Node* composite = nullptr);
 
         void operator()(osg::Node*, osg::NodeVisitor* nv) override;
 
@@ -252,11 +254,13 @@ class VDSMCameraCullCallback : public osg::NodeCallback
         osg::ref_ptr<osg::RefMatrix>            _projectionMatrix;
         osg::ref_ptr<osgUtil::RenderStage>      _renderStage;
         osg::Polytope                           _polytope;
+        osg::ref_ptr<osg::Node>                 _composite;
 };
 
-VDSMCameraCullCallback::VDSMCameraCullCallback(MWShadowTechnique* vdsm, osg::Polytope& polytope):
+VDSMCameraCullCallback::VDSMCameraCullCallback(MWShadowTechnique* vdsm, osg::Polytope& polytope, osg::Node* composite):
     _vdsm(vdsm),
-    _polytope(polytope)
+    _polytope(polytope),
+    _composite(composite)
 {
 }
 
@@ -266,6 +270,10 @@ void VDSMCameraCullCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
     osg::Camera* camera = node->asCamera();
     OSG_INFO<<"VDSMCameraCullCallback::operator()(osg::Node* "<<camera<<", osg::NodeVisitor* "<<cv<<")"<<std::endl;
 
+    // added outside of the shadows bin, which would override its render bin
+    if (_composite)
+        _composite->accept(*nv);
+
 #if 1
     if (!_polytope.empty())
     {
@@ -344,6 +352,98 @@ void VDSMCameraCullCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
     _projectionMatrix = cv->getProjectionMatrix();
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Static shadow map cache
+//
+// Bounds of the fraction of the cascade size added on each side when rendering a static shadow map, so that it stays usable while the camera moves
+constexpr double staticShadowMapMinPadding = 0.02;
+constexpr double staticShadowMapMaxPadding = 0.25;
+// Number of frames the padding should keep a static shadow map usable for at the speed its cascade moved recently
+constexpr double staticShadowMapTargetAge = 60.0;
+// Per frame decay of the tracked cascade speed, so that the padding shrinks again once the camera stops
+constexpr double staticShadowMapSpeedDecay = 0.98;
+// Re-render the static shadow map when a cascade shrinks below this fraction of the size it was rendered for, as it would waste most of its resolution
+constexpr double staticShadowMapMinCoverage = 0.7;
+// Cosine of the largest angle the light may move before the static shadow map is re-rendered, about half a degree
+constexpr double staticShadowMapMinCosAngle = 0.99996;
+// Re-render the static shadow map after this many frames anyway, so that changes not reported through dirtyStaticShadowMaps() show up eventually
+constexpr unsigned int staticShadowMapMaxAge = 120;
+
+/// Copies the depth of the cached static shadow map into the shadow map being rendered. It is drawn before anything
+/// else in its camera, after the depth buffer was cleared.
+class CompositeStaticShadowMap : public osg::Drawable
+{
+    public:
+
+        CompositeStaticShadowMap(osg::Texture2D* texture):
+            _texture(texture),
+            _fbo(new osg::FrameBufferObject)
+        {
+            _fbo->setAttachment(osg::FrameBufferObject::BufferComponent::DEPTH_BUFFER, osg::FrameBufferAttachment(texture));
+            setCullingActive(false);
+            setSupportsDisplayList(false);
+            getOrCreateStateSet()->setRenderBinDetails(-1, "RenderBin");
+        }
+
+        void drawImplementation(osg::RenderInfo& renderInfo) const override
+        {
+            osg::State& state = *renderInfo.getState();
+            osg::GLExtensions* ext = state.get<osg::GLExtensions>();
+
+            GLint drawFramebuffer = 0;
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING_EXT, &drawFramebuffer);
+
+            const GLint width = _texture->getTextureWidth();
+            const GLint height = _texture->getTextureHeight();
+            _fbo->apply(state, osg::FrameBufferObject::READ_FRAMEBUFFER);
+            ext->glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            ext->glBindFramebuffer(GL_READ_FRAMEBUFFER_EXT, drawFramebuffer);
+        }
+
+        void releaseGLObjects(osg::State* state) const override
+        {
+            osg::Drawable::releaseGLObjects(state);
+            _fbo->releaseGLObjects(state);
+        }
+
+    private:
+        osg::ref_ptr<osg::Texture2D> _texture;
+        osg::ref_ptr<osg::FrameBufferObject> _fbo;
+};
+
+/// Bounds of the clip space of a cascade in the clip space of its static shadow map. Invalid if the light moved too much
+/// for the static shadow map to be reused.
+osg::BoundingBoxd getBoundsInStaticShadowMap(const osg::Matrixd& cachedView, const osg::Matrixd& cachedProjection, const osg::Matrixd& view, const osg::Matrixd& projection)
+{
+    const osg::Vec3d cachedDirection = osg::Matrixd::transform3x3(cachedView, osg::Vec3d(0.0, 0.0, -1.0));
+    const osg::Vec3d direction = osg::Matrixd::transform3x3(view, osg::Vec3d(0.0, 0.0, -1.0));
+    if (cachedDirection * direction < staticShadowMapMinCosAngle)
+        return osg::BoundingBoxd();
+
+    // the light view may also rotate around the light direction with the camera, so compare the bounds in the clip space of the cached map
+    const osg::Matrixd toCachedClipSpace = osg::Matrixd::inverse(view * projection) * cachedView * cachedProjection;
+    osg::BoundingBoxd bounds;
+    for (double x : {-1.0, 1.0})
+        for (double y : {-1.0, 1.0})
+            for (double z : {-1.0, 1.0})
+                bounds.expandBy(osg::Vec3d(x, y, z) * toCachedClipSpace);
+    return bounds;
+}
+
+bool isStaticShadowMapReusable(const osg::BoundingBoxd& bounds, double padding)
+{
+    if (!bounds.valid())
+        return false;
+
+    if (bounds.xMin() < -1.0 || bounds.xMax() > 1.0 || bounds.yMin() < -1.0 || bounds.yMax() > 1.0
+        || bounds.zMin() < -1.0 || bounds.zMax() > 1.0)
+        return false;
+
+    const double minExtent = 2.0 / (1.0 + 2.0 * padding) * staticShadowMapMinCoverage;
+    return bounds.xMax() - bounds.xMin() >= minExtent && bounds.yMax() - bounds.yMin() >= minExtent;
+}
+
 } // namespace
 
 MWShadowTechnique::ComputeLightSpaceBounds::ComputeLightSpaceBounds() :
@@ -621,11 +721,47 @@ MWShadowTechnique::ShadowData::ShadowData(MWShadowTechnique::ViewDependentData*
     }
 }
 
+void MWShadowTechnique::ShadowData::setupStaticShadowMap()
+{
+    _staticTexture = new osg::Texture2D;
+    _staticTexture->setTextureSize(_texture->getTextureWidth(), _texture->getTextureHeight());
+    _staticTexture->setInternalFormat(GL_DEPTH_COMPONENT);
+    // only ever copied into _texture, which must have the same format for glBlitFramebuffer
+    _staticTexture->setFilter(osg::Texture2D::MIN_FILTER,osg::Texture2D::NEAREST);
+    _staticTexture->setFilter(osg::Texture2D::MAG_FILTER,osg::Texture2D::NEAREST);
+
+    _staticCamera = new osg::Camera;
+    // the same name as the cascade camera, which e.g. TerrainDrawable checks for
+    _staticCamera->setName("ShadowCamera");
+    _staticCamera->setReferenceFrame(osg::Camera::ABSOLUTE_RF_INHERIT_VIEWPOINT);
+#ifndef __APPLE__ // workaround shadow issue on macOS, https://gitlab.com/OpenMW/openmw/-/issues/6057
+    _staticCamera->setImplicitBufferAttachmentMask(0, 0);
+#endif
+    _staticCamera->setComputeNearFarMode(_camera->getComputeNearFarMode());
+    _staticCamera->setCullingMode(_camera->getCullingMode());
+    _staticCamera->setViewport(0,0,_texture->getTextureWidth(),_texture->getTextureHeight());
+    _staticCamera->setClearMask(GL_DEPTH_BUFFER_BIT);
+
+    // render before the camera compositing the dynamic casters on top.
+    _staticCamera->setRenderOrder(osg::Camera::PRE_RENDER, -1);
+    _staticCamera->setRenderTargetImplementation(osg::Camera::FRAME_BUFFER_OBJECT);
+    _staticCamera->attach(osg::Camera::DEPTH_BUFFER, _staticTexture.get());
+
+    _staticComposite = new CompositeStaticShadowMap(_staticTexture);
+    _staticValid = false;
+}
+
 void MWShadowTechnique::ShadowData::releaseGLObjects(osg::State* state) const
 {
     OSG_INFO<<"MWShadowTechnique::ShadowData::releaseGLObjects"<<std::endl;
     _texture->releaseGLObjects(state);
     _camera->releaseGLObjects(state);
+    if (_staticCamera)
+    {
+        _staticTexture->releaseGLObjects(state);
+        _staticCamera->releaseGLObjects(state);
+        _staticComposite->releaseGLObjects(state);
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -1202,6 +1338,27 @@ void MWShadowTechnique::cull(osgUtil::CullVisitor& cv)
 
     unsigned int numShadowMapsPerLight = settings->getNumShadowMapsPerLight();
 
+    const unsigned int castsMask = settings->getCastsShadowTraversalMask();
+    const unsigned int staticCastsMask = castsMask & _staticCastingMask;
+    const bool useStaticShadowMaps = _useStaticShadowMapCache && staticCastsMask != 0 && !settings->getDebugDraw()
+        && settings->getShadowMapProjectionHint() != ShadowSettings::PERSPECTIVE_SHADOW_MAP;
+    const unsigned int staticShadowMapGeneration = _staticShadowMapGeneration;
+
+    // created up front, shadow cameras may be culled concurrently
+    getOrCreateShadowsBinStateSet();
+
+    // shadow maps whose remaining setup depends on the result of culling their camera, which may happen in parallel
+    struct PendingShadowMap
+    {
+        osg::ref_ptr<ShadowData> _sd;
+        osg::ref_ptr<VDSMCameraCullCallback> _callback;
+        LightData* _light;
+        unsigned int _index;
+        double _near;
+        double _far;
+    };
+    std::vector<PendingShadowMap> pendingShadowMaps;
+
     LightDataList& pll = vdd->getLightDataList();
     for(LightDataList::iterator itr = pll.begin();
         itr != pll.end();
@@ -1500,7 +1657,75 @@ void MWShadowTechnique::cull(osgUtil::CullVisitor& cv)
             else
                 cropShadowCameraToMainFrustum(frustum, camera, reducedNear, reducedFar, extraPlanes);
 
-            osg::ref_ptr<VDSMCameraCullCallback> vdsmCallback = new VDSMCameraCullCallback(this, local_polytope);
+            // 4.2 render static casters into a separate shadow map unless the one from a previous frame still covers this one
+            //
+            unsigned int cameraCastsMask = castsMask;
+            osg::Node* composite = nullptr;
+            if (useStaticShadowMaps)
+            {
+                if (!sd->_staticCamera)
+                    sd->setupStaticShadowMap();
+
+                osg::BoundingBoxd bounds;
+                if (sd->_staticValid)
+                {
+                    bounds = getBoundsInStaticShadowMap(sd->_staticViewMatrix, sd->_staticProjectionMatrix, camera->getViewMatrix(), camera->getProjectionMatrix());
+                    if (bounds.valid())
+                    {
+                        // track how far the cascade moves per frame relative to its size, to pad the next static shadow map accordingly
+                        const osg::Vec2d center((bounds.xMin() + bounds.xMax()) / 2.0, (bounds.yMin() + bounds.yMax()) / 2.0);
+                        const double size = std::max(bounds.xMax() - bounds.xMin(), bounds.yMax() - bounds.yMin());
+                        const double speed = size > 0.0 ? (center - sd->_staticLastCenter).length() / size : 0.0;
+                        sd->_staticSpeed = std::max(speed, sd->_staticSpeed * staticShadowMapSpeedDecay);
+                        sd->_staticLastCenter = center;
+                    }
+                }
+
+                if (sd->_staticValid && sd->_staticCastsMask == staticCastsMask && sd->_staticGeneration == staticShadowMapGeneration
+                    && sd->_staticAge < staticShadowMapMaxAge && isStaticShadowMapReusable(bounds, sd->_staticPadding))
+                {
+                    ++sd->_staticAge;
+                }
+                else
+                {
+                    sd->_staticPadding = osg::clampBetween(sd->_staticSpeed * staticShadowMapTargetAge, staticShadowMapMinPadding, staticShadowMapMaxPadding);
+                    const double scale = 1.0 / (1.0 + 2.0 * sd->_staticPadding);
+                    sd->_staticViewMatrix = camera->getViewMatrix();
+                    sd->_staticProjectionMatrix = camera->getProjectionMatrix() * osg::Matrixd::scale(scale, scale, scale);
+                    sd->_staticCastsMask = staticCastsMask;
+                    sd->_staticGeneration = staticShadowMapGeneration;
+                    sd->_staticAge = 0;
+                    sd->_staticValid = true;
+                    // the padded projection is centered on the cascade
+                    sd->_staticLastCenter = osg::Vec2d(0.0, 0.0);
+
+                    sd->_staticCamera->setViewMatrix(sd->_staticViewMatrix);
+                    sd->_staticCamera->setProjectionMatrix(sd->_staticProjectionMatrix);
+
+                    // cover the whole padded map rather than just the current view, but keep casters between it and the light
+                    osg::Polytope staticPolytope;
+                    staticPolytope.setToUnitFrustum(false, true);
+                    staticPolytope.transformProvidingInverse(sd->_staticProjectionMatrix);
+                    sd->_staticCamera->setCullCallback(new VDSMCameraCullCallback(this, staticPolytope));
+
+                    cv.pushStateSet(_shadowCastingStateSet.get());
+
+                    cullShadowCastingScene(&cv, sd->_staticCamera.get(), staticCastsMask);
+
+                    cv.popStateSet();
+                }
+
+                // the remaining casters are rendered with the matrices of the static shadow map to be able to composite them
+                local_polytope.transformProvidingInverse(osg::Matrixd::inverse(sd->_staticViewMatrix) * camera->getViewMatrix());
+                camera->setViewMatrix(sd->_staticViewMatrix);
+                camera->setProjectionMatrix(sd->_staticProjectionMatrix);
+                cameraCastsMask &= ~staticCastsMask;
+                composite = sd->_staticComposite.get();
+            }
+            else
+                sd->_staticValid = false;
+
+            osg::ref_ptr<VDSMCameraCullCallback> vdsmCallback = new VDSMCameraCullCallback(this, local_polytope, composite);
             camera->setCullCallback(vdsmCallback.get());
 
             // 4.3 traverse RTT camera
@@ -1508,69 +1733,83 @@ void MWShadowTechnique::cull(osgUtil::CullVisitor& cv)
 
             cv.pushStateSet(_shadowCastingStateSet.get());
 
-            cullShadowCastingScene(&cv, camera.get());
+            cullShadowCastingScene(&cv, camera.get(), cameraCastsMask);
 
             cv.popStateSet();
 
-            if (!orthographicViewFrustum && settings->getShadowMapProjectionHint()==ShadowSettings::PERSPECTIVE_SHADOW_MAP)
-            {
-                {
-                    osg::Matrix validRegionMatrix = cv.getCurrentCamera()->getInverseViewMatrix() *  camera->getViewMatrix() * camera->getProjectionMatrix();
+            if (settings->getMultipleShadowMapHint() == ShadowSettings::CASCADED)
+                pendingShadowMaps.push_back({sd, vdsmCallback, &pl, sm_i, cascaseNear, cascadeFar});
+            else
+                pendingShadowMaps.push_back({sd, vdsmCallback, &pl, sm_i, reducedNear, reducedFar});
+        }
+    }
 
-                    std::string validRegionUniformName = "validRegionMatrix" + std::to_string(sm_i);
-                    osg::ref_ptr<osg::Uniform> validRegionUniform;
+    if (_parallelCull)
+        _parallelCull->finish(cv);
 
-                    for (const auto & uniform : _uniforms[cv.getTraversalNumber() % 2])
-                    {
-                        if (uniform->getName() == validRegionUniformName)
-                            validRegionUniform = uniform;
-                    }
+    for (const PendingShadowMap& pending : pendingShadowMaps)
+    {
+        const osg::ref_ptr<ShadowData>& sd = pending._sd;
+        const osg::ref_ptr<osg::Camera>& camera = sd->_camera;
+        VDSMCameraCullCallback* vdsmCallback = pending._callback.get();
+        LightData& pl = *pending._light;
+        const unsigned int sm_i = pending._index;
 
-                    if (!validRegionUniform)
-                    {
-                        validRegionUniform = new osg::Uniform(osg::Uniform::FLOAT_MAT4, validRegionUniformName);
-                        _uniforms[cv.getTraversalNumber() % 2].push_back(validRegionUniform);
-                    }
+        if (!orthographicViewFrustum && settings->getShadowMapProjectionHint()==ShadowSettings::PERSPECTIVE_SHADOW_MAP)
+        {
+            {
+                osg::Matrix validRegionMatrix = cv.getCurrentCamera()->getInverseViewMatrix() *  camera->getViewMatrix() * camera->getProjectionMatrix();
 
-                    validRegionUniform->set(validRegionMatrix);
-                }
+                std::string validRegionUniformName = "validRegionMatrix" + std::to_string(sm_i);
+                osg::ref_ptr<osg::Uniform> validRegionUniform;
 
-                if (settings->getMultipleShadowMapHint() == ShadowSettings::CASCADED)
-                    adjustPerspectiveShadowMapCameraSettings(vdsmCallback->getRenderStage(), frustum, pl, camera.get(), cascaseNear, cascadeFar);
-                else
-                    adjustPerspectiveShadowMapCameraSettings(vdsmCallback->getRenderStage(), frustum, pl, camera.get(), reducedNear, reducedFar);
-                if (vdsmCallback->getProjectionMatrix())
+                for (const auto & uniform : _uniforms[cv.getTraversalNumber() % 2])
                 {
-                    vdsmCallback->getProjectionMatrix()->set(camera->getProjectionMatrix());
+                    if (uniform->getName() == validRegionUniformName)
+                        validRegionUniform = uniform;
                 }
-            }
- 
-            // 4.4 compute main scene graph TexGen + uniform settings + setup state
-            //
-            assignTexGenSettings(&cv, camera.get(), textureUnit, sd->_texgen.get());
-
-            // mark the light as one that has active shadows and requires shaders
-            pl.textureUnits.push_back(textureUnit);
 
-            // pass on shadow data to ShadowDataList
-            sd->_textureUnit = textureUnit;
+                if (!validRegionUniform)
+                {
+                    validRegionUniform = new osg::Uniform(osg::Uniform::FLOAT_MAT4, validRegionUniformName);
+                    _uniforms[cv.getTraversalNumber() % 2].push_back(validRegionUniform);
+                }
 
-            if (textureUnit >= 8)
-            {
-                OSG_NOTICE<<"Shadow texture unit is invalid for texgen, will not be used."<<std::endl;
+                validRegionUniform->set(validRegionMatrix);
             }
-            else
+
+            adjustPerspectiveShadowMapCameraSettings(vdsmCallback->getRenderStage(), frustum, pl, camera.get(), pending._near, pending._far);
+            if (vdsmCallback->getProjectionMatrix())
             {
-                sdl.push_back(sd);
+                vdsmCallback->getProjectionMatrix()->set(camera->getProjectionMatrix());
             }
+        }
+ 
+        // 4.4 compute main scene graph TexGen + uniform settings + setup state
+        //
+        assignTexGenSettings(&cv, camera.get(), textureUnit, sd->_texgen.get());
+
+        // mark the light as one that has active shadows and requires shaders
+        pl.textureUnits.push_back(textureUnit);
 
-            // increment counters.
-            ++textureUnit;
-            ++numValidShadows ;
+        // pass on shadow data to ShadowDataList
+        sd->_textureUnit = textureUnit;
 
-            if (_debugHud)
-                _debugHud->draw(sd->_texture, sm_i, camera->getViewMatrix() * camera->getProjectionMatrix(), cv);
+        if (textureUnit >= 8)
+        {
+            OSG_NOTICE<<"Shadow texture unit is invalid for texgen, will not be used."<<std::endl;
+        }
+        else
+        {
+            sdl.push_back(sd);
         }
+
+        // increment counters.
+        ++textureUnit;
+        ++numValidShadows ;
+
+        if (_debugHud)
+            _debugHud->draw(sd->_texture, sm_i, camera->getViewMatrix() * camera->getProjectionMatrix(), cv);
     }
 
     vdd->setNumValidShadows(numValidShadows);
@@ -3118,14 +3357,25 @@ void MWShadowTechnique::cullShadowReceivingScene(osgUtil::CullVisitor* cv) const
     return;
 }
 
-void MWShadowTechnique::cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera) const
+void MWShadowTechnique::setParallelCull(ParallelCull* parallelCull)
+{
+    _parallelCull = parallelCull;
+}
+
+void MWShadowTechnique::cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera, unsigned int castsMask) const
 {
     OSG_INFO<<"cullShadowCastingScene()"<<std::endl;
 
     // record the traversal mask on entry so we can reapply it later.
     unsigned int traversalMask = cv->getTraversalMask();
 
-    cv->setTraversalMask( traversalMask & _shadowedScene->getShadowSettings()->getCastsShadowTraversalMask() );
+    if (_parallelCull)
+    {
+        if (camera) _parallelCull->addCamera(*cv, camera, traversalMask & castsMask);
+        return;
+    }
+
+    cv->setTraversalMask( traversalMask & castsMask );
 
         if (camera) camera->accept(*cv);
 
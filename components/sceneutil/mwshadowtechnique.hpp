@@ -20,6 +20,7 @@
 #define COMPONENTS_SCENEUTIL_MWSHADOWTECHNIQUE_H 1
 
 #include <array>
+#include <atomic>
 #include <mutex>
 #include <string>
 
@@ -28,6 +29,7 @@
 #include <osg/MatrixTransform>
 #include <osg/LightSource>
 #include <osg/PolygonOffset>
+#include <osg/Vec2d>
 
 #include <osgShadow/ShadowTechnique>
 
@@ -35,6 +37,8 @@
 
 namespace SceneUtil {
 
+    class ParallelCull;
+
     /** ViewDependentShadowMap provides an base implementation of view dependent shadow mapping techniques.*/
     class MWShadowTechnique : public osgShadow::ShadowTechnique
     {
@@ -194,6 +198,22 @@ namespace SceneUtil {
             osg::ref_ptr<osg::Texture2D>        _texture;
             osg::ref_ptr<osg::TexGen>           _texgen;
             osg::ref_ptr<osg::Camera>           _camera;
+
+            /// Lazily create the cached static shadow map, see enableStaticShadowMapCache().
+            void setupStaticShadowMap();
+
+            osg::ref_ptr<osg::Texture2D>        _staticTexture;
+            osg::ref_ptr<osg::Camera>           _staticCamera;
+            osg::ref_ptr<osg::Node>             _staticComposite;
+            osg::Matrixd                        _staticViewMatrix;
+            osg::Matrixd                        _staticProjectionMatrix;
+            osg::Vec2d                          _staticLastCenter;
+            double                              _staticPadding = 0.0;
+            double                              _staticSpeed = 0.0;
+            unsigned int                        _staticCastsMask = 0;
+            unsigned int                        _staticGeneration = 0;
+            unsigned int                        _staticAge = 0;
+            bool                                _staticValid = false;
         };
 
         typedef std::list< osg::ref_ptr<ShadowData> > ShadowDataList;
@@ -258,12 +278,27 @@ namespace SceneUtil {
 
         virtual void cullShadowReceivingScene(osgUtil::CullVisitor* cv) const;
 
-        virtual void cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera) const;
+        virtual void cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera, unsigned int castsMask) const;
 
         virtual osg::StateSet* prepareStateSetForRenderingShadow(ViewDependentData& vdd, unsigned int traversalNumber) const;
 
         void setWorldMask(unsigned int worldMask) { _worldMask = worldMask; }
 
+        /// Mask of shadow casters that don't move, e.g. statics and terrain.
+        void setStaticShadowCastingMask(unsigned int mask) { _staticCastingMask = mask; }
+
+        /// @brief Render static shadow casters into a separate shadow map per cascade and reuse it while the light
+        /// direction and the cascade bounds stay close to the ones it was rendered with.
+        /// @par Only the remaining casters are culled and rendered every frame, on top of a copy of the cached map.
+        /// Has no effect with perspective shadow maps, which change with every camera rotation.
+        void enableStaticShadowMapCache(bool enable) { _useStaticShadowMapCache = enable; }
+
+        /// Re-render cached static shadow maps on the next frame, e.g. because static casters were added or removed.
+        void dirtyStaticShadowMaps() { ++_staticShadowMapGeneration; }
+
+        /// Cull the shadow cameras in parallel rather than one after another if set.
+        void setParallelCull(ParallelCull* parallelCull);
+
         osg::ref_ptr<osg::StateSet> getOrCreateShadowsBinStateSet();
 
     protected:
@@ -303,6 +338,12 @@ namespace SceneUtil {
 
         unsigned int                            _worldMask = ~0u;
 
+        unsigned int                            _staticCastingMask = 0;
+        bool                                    _useStaticShadowMapCache = false;
+        std::atomic_uint                        _staticShadowMapGeneration{0};
+
+        osg::ref_ptr<ParallelCull>              _parallelCull;
+
         class DebugHUD final : public osg::Referenced
         {
         public:
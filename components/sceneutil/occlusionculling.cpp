@@ -0,0 +1,392 @@
+#include "occlusionculling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <osg/AlphaFunc>
+#include <osg/Drawable>
+#include <osg/Group>
+#include <osg/Transform>
+#include <osg/TriangleFunctor>
+
+#include <osgUtil/CullVisitor>
+
+#include <components/misc/constants.hpp>
+
+namespace SceneUtil
+{
+    namespace
+    {
+        // Vertices closer to the eye than this are not projected, the affected occluders are skipped and
+        // the affected boxes are considered visible
+        constexpr float minW = 1e-3f;
+
+        constexpr float minArea = 1e-6f;
+
+        struct CollectTrianglesFunctor
+        {
+            std::vector<osg::Vec3f>* mVertices = nullptr;
+            osg::Matrixf mMatrix;
+
+            void operator()(const osg::Vec3& v1, const osg::Vec3& v2, const osg::Vec3& v3, bool /*temp*/ = false) // Note: unused temp argument left here for OSG versions less than 3.5.6
+            {
+                mVertices->push_back(mMatrix.preMult(v1));
+                mVertices->push_back(mMatrix.preMult(v2));
+                mVertices->push_back(mMatrix.preMult(v3));
+            }
+        };
+
+        bool isTransparent(const osg::StateSet& stateset)
+        {
+            if (stateset.getRenderingHint() == osg::StateSet::TRANSPARENT_BIN)
+                return true;
+            if (stateset.getMode(GL_BLEND) & osg::StateAttribute::ON)
+                return true;
+            const osg::AlphaFunc* alphaFunc = static_cast<const osg::AlphaFunc*>(stateset.getAttribute(osg::StateAttribute::ALPHAFUNC));
+            return alphaFunc != nullptr && alphaFunc->getFunction() != osg::AlphaFunc::ALWAYS;
+        }
+
+        /// Collects opaque triangles of a subgraph in the coordinate frame of the node the traversal starts from.
+        /// Alpha blended and alpha tested geometry does not reliably hide anything behind it and is skipped.
+        class CollectOccluderTrianglesVisitor : public osg::NodeVisitor
+        {
+        public:
+            CollectOccluderTrianglesVisitor(unsigned int mask, std::vector<osg::Vec3f>& vertices)
+                : osg::NodeVisitor(TRAVERSE_ACTIVE_CHILDREN)
+                , mVertices(vertices)
+            {
+                setTraversalMask(mask);
+            }
+
+            void apply(osg::Node& node) override
+            {
+                if (node.getStateSet() != nullptr && isTransparent(*node.getStateSet()))
+                    return;
+                traverse(node);
+            }
+
+            void apply(osg::Drawable& drawable) override
+            {
+                if (drawable.getStateSet() != nullptr && isTransparent(*drawable.getStateSet()))
+                    return;
+
+                osg::TriangleFunctor<CollectTrianglesFunctor> functor;
+                functor.mVertices = &mVertices;
+                functor.mMatrix = osg::computeLocalToWorld(getNodePath());
+                drawable.accept(functor);
+            }
+
+        private:
+            std::vector<osg::Vec3f>& mVertices;
+        };
+
+        osg::Matrixf computeWorldMatrix(const osg::Transform& node)
+        {
+            osg::Matrix matrix;
+            node.computeLocalToWorldMatrix(matrix, nullptr);
+            const osg::Node* parent = node.getNumParents() > 0 ? node.getParent(0) : nullptr;
+            while (parent != nullptr)
+            {
+                if (const osg::Transform* transform = parent->asTransform())
+                {
+                    osg::Matrix parentMatrix;
+                    transform->computeLocalToWorldMatrix(parentMatrix, nullptr);
+                    matrix.postMult(parentMatrix);
+                }
+                parent = parent->getNumParents() > 0 ? parent->getParent(0) : nullptr;
+            }
+            return matrix;
+        }
+    }
+
+    OcclusionBuffer::OcclusionBuffer(unsigned int width, unsigned int height)
+        : mWidth(std::max(1u, width))
+        , mHeight(std::max(1u, height))
+        , mDepth(static_cast<std::size_t>(mWidth) * mHeight, 0.f)
+        , mNumRasterizedTriangles(0)
+    {
+    }
+
+    void OcclusionBuffer::clear(const osg::Matrixf& viewProjection)
+    {
+        mViewProjection = viewProjection;
+        std::fill(mDepth.begin(), mDepth.end(), 0.f);
+        mNumRasterizedTriangles = 0;
+    }
+
+    bool OcclusionBuffer::toScreen(const osg::Vec3f& vertex, const osg::Matrixf& transform, ScreenVertex& out) const
+    {
+        const osg::Vec4f clip = osg::Vec4f(vertex, 1.f) * transform;
+        if (clip.w() < minW)
+            return false;
+        const float invW = 1.f / clip.w();
+        out.mX = (clip.x() * invW * 0.5f + 0.5f) * mWidth;
+        out.mY = (clip.y() * invW * 0.5f + 0.5f) * mHeight;
+        out.mInvW = invW;
+        return true;
+    }
+
+    void OcclusionBuffer::rasterizeTriangles(const osg::Matrixf& transform, const std::vector<osg::Vec3f>& vertices,
+        const std::vector<int>& adjacentVertices)
+    {
+        const osg::Matrixf toClip = transform * mViewProjection;
+        const auto orientation = [] (const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c)
+        {
+            return (b.mX - a.mX) * (c.mY - a.mY) - (b.mY - a.mY) * (c.mX - a.mX);
+        };
+        for (std::size_t i = 0; i + 2 < vertices.size(); i += 3)
+        {
+            ScreenVertex v[3];
+            if (!toScreen(vertices[i], toClip, v[0]) || !toScreen(vertices[i + 1], toClip, v[1]) || !toScreen(vertices[i + 2], toClip, v[2]))
+                continue;
+            // An edge is inside of the occluder on screen when the adjacent triangle is rasterized on the other side
+            // of it. Otherwise it's a silhouette edge.
+            bool inner[3] = {false, false, false};
+            if (!adjacentVertices.empty())
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    const int adjacent = adjacentVertices[i + j];
+                    ScreenVertex other;
+                    if (adjacent < 0 || !toScreen(vertices[adjacent], toClip, other))
+                        continue;
+                    const ScreenVertex& b = v[(j + 1) % 3];
+                    const ScreenVertex& c = v[(j + 2) % 3];
+                    const float own = orientation(b, c, v[j]);
+                    const float opposite = orientation(b, c, other);
+                    inner[j] = std::abs(opposite) >= minArea && (own > 0) != (opposite > 0);
+                }
+            }
+            rasterizeTriangle(v[0], v[1], v[2], inner);
+        }
+    }
+
+    std::vector<int> OcclusionBuffer::findAdjacentVertices(const std::vector<osg::Vec3f>& vertices)
+    {
+        std::vector<int> result(vertices.size(), -1);
+        // Edge given by ordered end points -> vertex opposite to it in the first triangle having the edge
+        std::map<std::pair<osg::Vec3f, osg::Vec3f>, std::size_t> edges;
+        for (std::size_t i = 0; i < vertices.size() - vertices.size() % 3; ++i)
+        {
+            const std::size_t triangle = i - i % 3;
+            const osg::Vec3f& p = vertices[triangle + (i + 1) % 3];
+            const osg::Vec3f& q = vertices[triangle + (i + 2) % 3];
+            const auto [it, inserted] = edges.emplace(p < q ? std::make_pair(p, q) : std::make_pair(q, p), i);
+            if (inserted)
+                continue;
+            result[i] = static_cast<int>(it->second);
+            if (result[it->second] < 0)
+                result[it->second] = static_cast<int>(i);
+        }
+        return result;
+    }
+
+    void OcclusionBuffer::rasterizeTriangle(const ScreenVertex& a, const ScreenVertex& v1, const ScreenVertex& v2, const bool (&inner)[3])
+    {
+        float area = (v1.mX - a.mX) * (v2.mY - a.mY) - (v1.mY - a.mY) * (v2.mX - a.mX);
+        if (std::abs(area) < minArea)
+            return;
+
+        // Both windings are rasterized, back faces are behind front faces of the same closed mesh anyway
+        const ScreenVertex& b = area > 0 ? v1 : v2;
+        const ScreenVertex& c = area > 0 ? v2 : v1;
+        const bool innerB = area > 0 ? inner[1] : inner[2];
+        const bool innerC = area > 0 ? inner[2] : inner[1];
+        area = std::abs(area);
+
+        const int minX = std::max(0, static_cast<int>(std::floor(std::min({a.mX, b.mX, c.mX}))));
+        const int maxX = std::min(static_cast<int>(mWidth) - 1, static_cast<int>(std::ceil(std::max({a.mX, b.mX, c.mX}))) - 1);
+        const int minY = std::max(0, static_cast<int>(std::floor(std::min({a.mY, b.mY, c.mY}))));
+        const int maxY = std::min(static_cast<int>(mHeight) - 1, static_cast<int>(std::ceil(std::max({a.mY, b.mY, c.mY}))) - 1);
+        if (minX > maxX || minY > maxY)
+            return;
+
+        ++mNumRasterizedTriangles;
+
+        // Edge functions are positive inside the triangle. A pixel is covered when its whole square is inside, so
+        // the edge functions are biased by their smallest value over the square relative to its center. Edges shared
+        // with an adjacent triangle are sampled at pixel centers, like the GPU does, so that triangles of a mesh leave
+        // no gaps between them.
+        const float e0dx = -(c.mY - b.mY), e0dy = c.mX - b.mX;
+        const float e1dx = -(a.mY - c.mY), e1dy = a.mX - c.mX;
+        const float e2dx = -(b.mY - a.mY), e2dy = b.mX - a.mX;
+        const float e0bias = inner[0] ? 0.f : 0.5f * (std::abs(e0dx) + std::abs(e0dy));
+        const float e1bias = innerB ? 0.f : 0.5f * (std::abs(e1dx) + std::abs(e1dy));
+        const float e2bias = innerC ? 0.f : 0.5f * (std::abs(e2dx) + std::abs(e2dy));
+
+        // Inverse depth is affine in screen space. Use the smallest value within a pixel, but never less than the
+        // farthest vertex.
+        const float dzdx = ((b.mInvW - a.mInvW) * (c.mY - a.mY) - (c.mInvW - a.mInvW) * (b.mY - a.mY)) / area;
+        const float dzdy = ((c.mInvW - a.mInvW) * (b.mX - a.mX) - (b.mInvW - a.mInvW) * (c.mX - a.mX)) / area;
+        const float zmargin = 0.5f * (std::abs(dzdx) + std::abs(dzdy));
+        const float minZ = std::min({a.mInvW, b.mInvW, c.mInvW});
+
+        const float startX = minX + 0.5f;
+        for (int y = minY; y <= maxY; ++y)
+        {
+            const float py = y + 0.5f;
+            const float e0 = e0dx * (startX - b.mX) + e0dy * (py - b.mY) - e0bias;
+            const float e1 = e1dx * (startX - c.mX) + e1dy * (py - c.mY) - e1bias;
+            const float e2 = e2dx * (startX - a.mX) + e2dy * (py - a.mY) - e2bias;
+            const float z = a.mInvW + dzdx * (startX - a.mX) + dzdy * (py - a.mY) - zmargin;
+
+            float* row = mDepth.data() + static_cast<std::size_t>(y) * mWidth;
+            const int count = maxX - minX + 1;
+            // Branchless span loop, written so that the compiler can vectorize it
+            for (int i = 0; i < count; ++i)
+            {
+                const float fi = static_cast<float>(i);
+                const bool inside = (e0 + e0dx * fi >= 0.f) & (e1 + e1dx * fi >= 0.f) & (e2 + e2dx * fi >= 0.f);
+                const float depth = std::max(z + dzdx * fi, minZ);
+                float& stored = row[minX + i];
+                stored = inside ? std::max(stored, depth) : stored;
+            }
+        }
+    }
+
+    bool OcclusionBuffer::isOccluded(const osg::BoundingBox& box) const
+    {
+        if (!box.valid())
+            return false;
+
+        float minX = std::numeric_limits<float>::max();
+        float maxX = -std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxY = -std::numeric_limits<float>::max();
+        float nearest = 0.f;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            ScreenVertex v;
+            if (!toScreen(box.corner(i), mViewProjection, v))
+                return false;
+            minX = std::min(minX, v.mX);
+            maxX = std::max(maxX, v.mX);
+            minY = std::min(minY, v.mY);
+            maxY = std::max(maxY, v.mY);
+            nearest = std::max(nearest, v.mInvW);
+        }
+
+        // Leave boxes outside of the view to frustum culling
+        if (maxX < 0.f || maxY < 0.f || minX >= mWidth || minY >= mHeight)
+            return false;
+
+        const int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+        const int x1 = std::min(static_cast<int>(mWidth) - 1, static_cast<int>(std::floor(maxX)));
+        const int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+        const int y1 = std::min(static_cast<int>(mHeight) - 1, static_cast<int>(std::floor(maxY)));
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            const float* row = mDepth.data() + static_cast<std::size_t>(y) * mWidth;
+            for (int x = x0; x <= x1; ++x)
+                if (row[x] <= nearest)
+                    return false;
+        }
+        return true;
+    }
+
+    OcclusionCuller::OcclusionCuller(unsigned int resolutionX, unsigned int resolutionY, unsigned int occluderMask, float minOccluderRadius)
+        : mBuffer(resolutionX, resolutionY)
+        , mOccluderMask(occluderMask)
+        , mMinOccluderRadius(minOccluderRadius)
+        , mLastFrameNumber(0)
+        , mLastCamera(nullptr)
+        , mPrepared(false)
+        , mNumTested(0)
+        , mNumOccluded(0)
+    {
+    }
+
+    bool OcclusionCuller::addOccluder(osg::Transform* node)
+    {
+        if (node->getBound().radius() < mMinOccluderRadius)
+            return false;
+
+        Occluder occluder;
+        occluder.mNode = node;
+        CollectOccluderTrianglesVisitor visitor(mOccluderMask, occluder.mVertices);
+        for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+            node->getChild(i)->accept(visitor);
+
+        if (occluder.mVertices.empty())
+            return false;
+
+        occluder.mAdjacentVertices = OcclusionBuffer::findAdjacentVertices(occluder.mVertices);
+
+        mOccluders.insert_or_assign(node, std::move(occluder));
+        return true;
+    }
+
+    void OcclusionCuller::removeOccluder(const osg::Node* node)
+    {
+        mOccluders.erase(node);
+    }
+
+    bool OcclusionCuller::prepare(osgUtil::CullVisitor& cv)
+    {
+        const osg::Camera* camera = cv.getCurrentCamera();
+        // Only the main camera is handled. Other cameras may be culled concurrently, so leave the state alone for them.
+        if (camera == nullptr || camera->getName() != Constants::SceneCamera)
+            return false;
+
+        const unsigned int frameNumber = cv.getTraversalNumber();
+        if (frameNumber == mLastFrameNumber && camera == mLastCamera)
+            return mPrepared;
+
+        mLastFrameNumber = frameNumber;
+        mLastCamera = camera;
+        mNumTested = 0;
+        mNumOccluded = 0;
+
+        const osg::Matrix& projection = *cv.getProjectionMatrix();
+        // Only perspective projections are handled
+        mPrepared = projection(3, 3) == 0.0;
+        if (!mPrepared)
+            return false;
+
+        mBuffer.clear(osg::Matrixf(*cv.getCurrentRenderStage()->getInitialViewMatrix() * projection));
+
+        for (auto it = mOccluders.begin(); it != mOccluders.end();)
+        {
+            osg::ref_ptr<osg::Transform> node;
+            if (!it->second.mNode.lock(node))
+            {
+                it = mOccluders.erase(it);
+                continue;
+            }
+
+            if (node->getNumParents() != 0 && cv.validNodeMask(*node) && !cv.isCulled(node->getBound()))
+                mBuffer.rasterizeTriangles(computeWorldMatrix(*node), it->second.mVertices, it->second.mAdjacentVertices);
+            ++it;
+        }
+
+        return true;
+    }
+
+    void OcclusionCullCallback::operator()(osg::Group* node, osgUtil::CullVisitor* cv)
+    {
+        if (!mCuller.prepare(*cv))
+        {
+            traverse(node, cv);
+            return;
+        }
+
+        for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+        {
+            osg::Node* child = node->getChild(i);
+            const osg::BoundingSphere& bound = child->getBound();
+            if (bound.valid())
+            {
+                osg::BoundingBox box;
+                box.expandBy(bound);
+                const bool occluded = mCuller.isOccluded(box);
+                mCuller.countTest(occluded);
+                if (occluded)
+                    continue;
+            }
+            child->accept(*cv);
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONCULLING_H
+#define OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONCULLING_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include <osg/BoundingBox>
+#include <osg/Matrixf>
+#include <osg/Vec3f>
+#include <osg/observer_ptr>
+
+#include <components/sceneutil/nodecallback.hpp>
+
+namespace osg
+{
+    class Group;
+    class Node;
+    class Transform;
+}
+
+namespace osgUtil
+{
+    class CullVisitor;
+}
+
+namespace SceneUtil
+{
+    /// @brief Low resolution depth buffer rasterized on the CPU.
+    /// @par Stores inverse view space depth (1/w), so larger values are closer to the eye. Occluders write the farthest
+    /// depth they have within a pixel to every pixel they cover entirely. Queries use the nearest depth of the tested box
+    /// over all pixels it touches, so a box is only reported as occluded if it is behind occluder geometry everywhere on
+    /// screen.
+    class OcclusionBuffer
+    {
+    public:
+        OcclusionBuffer(unsigned int width, unsigned int height);
+
+        unsigned int getWidth() const { return mWidth; }
+        unsigned int getHeight() const { return mHeight; }
+
+        /// Resets the buffer to "nothing drawn" and sets the matrix transforming world space into clip space.
+        void clear(const osg::Matrixf& viewProjection);
+
+        /// @param transform Transforms the given vertices into clip space.
+        /// @param vertices Triangle list.
+        /// @param adjacentVertices Result of findAdjacentVertices for the triangle list. Edges without adjacent triangle
+        /// are rasterized conservatively, so when it's empty, pixels along the edges shared by triangles stay empty.
+        void rasterizeTriangles(const osg::Matrixf& transform, const std::vector<osg::Vec3f>& vertices,
+            const std::vector<int>& adjacentVertices);
+
+        /// For each vertex of a triangle list find the vertex of another triangle that is opposite to the same edge.
+        /// @return -1 for edges not shared by other triangles.
+        static std::vector<int> findAdjacentVertices(const std::vector<osg::Vec3f>& vertices);
+
+        /// @param box World space bounding box.
+        bool isOccluded(const osg::BoundingBox& box) const;
+
+        std::size_t getNumRasterizedTriangles() const { return mNumRasterizedTriangles; }
+
+        /// Inverse depth of the given pixel, 0 if nothing was drawn there.
+        float getDepth(unsigned int x, unsigned int y) const { return mDepth[y * mWidth + x]; }
+
+    private:
+        struct ScreenVertex
+        {
+            float mX;
+            float mY;
+            float mInvW;
+        };
+
+        /// @param inner Is the edge opposite to the vertex shared with a triangle on the other side of the edge?
+        void rasterizeTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c, const bool (&inner)[3]);
+
+        bool toScreen(const osg::Vec3f& vertex, const osg::Matrixf& transform, ScreenVertex& out) const;
+
+        unsigned int mWidth;
+        unsigned int mHeight;
+        osg::Matrixf mViewProjection;
+        std::vector<float> mDepth;
+        std::size_t mNumRasterizedTriangles;
+    };
+
+    /// @brief Maintains the set of occluders and the occlusion buffer for the main scene camera.
+    /// @par Occluders are registered by the owner of their scene graph, typically large static objects. Their triangles
+    /// are extracted once and rasterized into the buffer at the beginning of each cull traversal of the main camera.
+    /// @note Only meant for perspective cameras. Not thread safe, all functions must be called from the cull thread
+    /// or while it is not running.
+    class OcclusionCuller
+    {
+    public:
+        /// @param occluderMask Traversal mask used when extracting occluder triangles.
+        /// @param minOccluderRadius Nodes with a bounding sphere smaller than this are not used as occluders.
+        OcclusionCuller(unsigned int resolutionX, unsigned int resolutionY, unsigned int occluderMask, float minOccluderRadius);
+
+        /// @param node A transform whose matrix places the subgraph in world space, e.g. an object's base node.
+        /// @return Was the node accepted as occluder?
+        bool addOccluder(osg::Transform* node);
+        void removeOccluder(const osg::Node* node);
+
+        std::size_t getNumOccluders() const { return mOccluders.size(); }
+
+        /// Rebuild the occlusion buffer if the given traversal has not been prepared yet.
+        /// @return Can the traversal be occlusion tested?
+        bool prepare(osgUtil::CullVisitor& cv);
+
+        /// @param box World space bounding box.
+        bool isOccluded(const osg::BoundingBox& box) const { return mBuffer.isOccluded(box); }
+
+        const OcclusionBuffer& getBuffer() const { return mBuffer; }
+
+        std::size_t getNumTested() const { return mNumTested; }
+        std::size_t getNumOccluded() const { return mNumOccluded; }
+
+        void countTest(bool occluded)
+        {
+            ++mNumTested;
+            if (occluded)
+                ++mNumOccluded;
+        }
+
+    private:
+        struct Occluder
+        {
+            osg::observer_ptr<osg::Transform> mNode;
+            std::vector<osg::Vec3f> mVertices;
+            std::vector<int> mAdjacentVertices;
+        };
+
+        OcclusionBuffer mBuffer;
+        unsigned int mOccluderMask;
+        float mMinOccluderRadius;
+        std::map<const osg::Node*, Occluder> mOccluders;
+        unsigned int mLastFrameNumber;
+        const void* mLastCamera;
+        bool mPrepared;
+        std::size_t mNumTested;
+        std::size_t mNumOccluded;
+    };
+
+    /// @brief Cull callback for groups of objects, such as a cell's root node.
+    /// @par Tests each child's bounding box against the occlusion buffer and only traverses visible children.
+    /// Falls back to a regular traversal for cameras the OcclusionCuller does not handle.
+    class OcclusionCullCallback : public SceneUtil::NodeCallback<OcclusionCullCallback, osg::Group*, osgUtil::CullVisitor*>
+    {
+    public:
+        explicit OcclusionCullCallback(OcclusionCuller& culler) : mCuller(culler) {}
+
+        void operator()(osg::Group* node, osgUtil::CullVisitor* cv);
+
+    private:
+        OcclusionCuller& mCuller;
+    };
+}
+
+#endif
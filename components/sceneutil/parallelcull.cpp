@@ -0,0 +1,158 @@
+#include "parallelcull.hpp"
+
+#include <osg/Camera>
+#include <osgUtil/CullVisitor>
+#include <osgUtil/RenderStage>
+#include <osgUtil/StateGraph>
+
+#include "workqueue.hpp"
+
+namespace SceneUtil
+{
+    struct ParallelCull::Context : public osg::Referenced
+    {
+        osg::ref_ptr<osgUtil::CullVisitor> mCullVisitor;
+        osg::ref_ptr<osgUtil::StateGraph> mStateGraph;
+        osg::ref_ptr<osgUtil::RenderStage> mRenderStage;
+        osg::ref_ptr<osg::Camera> mCamera;
+        osg::ref_ptr<WorkItem> mWorkItem;
+
+        explicit Context(const osgUtil::CullVisitor& parent)
+            : mCullVisitor(parent.clone())
+            , mStateGraph(new osgUtil::StateGraph)
+            , mRenderStage(new osgUtil::RenderStage)
+        {
+        }
+
+        void prepare(osgUtil::CullVisitor& parent, osg::Camera* camera, unsigned int traversalMask)
+        {
+            osgUtil::CullVisitor& cv = *mCullVisitor;
+
+            // The leaves of the last use of this context have been drawn by now
+            cv.reset();
+            mStateGraph->clean();
+            mRenderStage->reset();
+            cv.setStateGraph(mStateGraph);
+            cv.setRenderStage(mRenderStage);
+
+            cv.inheritCullSettings(parent);
+            cv.setFrameStamp(const_cast<osg::FrameStamp*>(parent.getFrameStamp()));
+            cv.setTraversalNumber(parent.getTraversalNumber());
+            cv.setTraversalMask(traversalMask);
+            cv.setNodeMaskOverride(parent.getNodeMaskOverride());
+            cv.setRenderInfo(parent.getRenderInfo());
+            cv.setDatabaseRequestHandler(parent.getDatabaseRequestHandler());
+
+            std::vector<const osg::StateSet*> stateSets;
+            for (const osgUtil::StateGraph* stateGraph = parent.getCurrentStateGraph(); stateGraph != nullptr; stateGraph = stateGraph->_parent)
+            {
+                if (stateGraph->getStateSet() != nullptr)
+                    stateSets.push_back(stateGraph->getStateSet());
+            }
+            for (auto it = stateSets.rbegin(); it != stateSets.rend(); ++it)
+                cv.pushStateSet(*it);
+
+            cv.pushViewport(parent.getViewport());
+            cv.pushProjectionMatrix(parent.getProjectionMatrix());
+            cv.pushModelViewMatrix(parent.getModelViewMatrix(), osg::Transform::ABSOLUTE_RF);
+            cv.pushReferenceViewPoint(parent.getReferenceViewPoint());
+
+            mCamera = camera;
+        }
+
+        void cull()
+        {
+            mCamera->accept(*mCullVisitor);
+        }
+
+        void merge(osgUtil::RenderStage& stage)
+        {
+            for (const auto& [order, renderStage] : mRenderStage->getPreRenderList())
+                stage.addPreRenderStage(renderStage, order);
+            for (const auto& [order, renderStage] : mRenderStage->getPostRenderList())
+                stage.addPostRenderStage(renderStage, order);
+            mRenderStage->getPreRenderList().clear();
+            mRenderStage->getPostRenderList().clear();
+            mStateGraph->prune();
+            mCamera = nullptr;
+        }
+    };
+
+    class ParallelCull::CullWorkItem : public WorkItem
+    {
+    public:
+        explicit CullWorkItem(Context& context)
+            : mContext(&context)
+        {
+        }
+
+        void doWork() override
+        {
+            mContext->cull();
+        }
+
+    private:
+        osg::ref_ptr<Context> mContext;
+    };
+
+    ParallelCull::ParallelCull(std::size_t numThreads)
+        : mWorkQueue(numThreads > 0 ? new WorkQueue(numThreads) : nullptr)
+    {
+    }
+
+    ParallelCull::~ParallelCull() = default;
+
+    void ParallelCull::addCamera(osgUtil::CullVisitor& parent, osg::Camera* camera, unsigned int traversalMask)
+    {
+        osg::ref_ptr<Context> previous;
+        osg::ref_ptr<Context> context;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            Contexts& contexts = mContexts[&parent];
+            if (contexts.mNumUsed > 0)
+                previous = contexts.mContexts[contexts.mNumUsed - 1];
+            if (contexts.mNumUsed == contexts.mContexts.size())
+                contexts.mContexts.push_back(new Context(parent));
+            context = contexts.mContexts[contexts.mNumUsed++];
+        }
+
+        // Hand out cameras one late, so that finish() may cull the last one on the calling thread
+        if (previous != nullptr && mWorkQueue != nullptr)
+        {
+            previous->mWorkItem = new CullWorkItem(*previous);
+            mWorkQueue->addWorkItem(previous->mWorkItem);
+        }
+
+        context->prepare(parent, camera, traversalMask);
+    }
+
+    void ParallelCull::finish(osgUtil::CullVisitor& parent)
+    {
+        std::vector<osg::ref_ptr<Context>> used;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const auto it = mContexts.find(&parent);
+            if (it == mContexts.end())
+                return;
+            Contexts& contexts = it->second;
+            used.assign(contexts.mContexts.begin(), contexts.mContexts.begin() + contexts.mNumUsed);
+            contexts.mNumUsed = 0;
+        }
+
+        if (!used.empty() && used.back()->mWorkItem == nullptr)
+            used.back()->cull();
+
+        osgUtil::RenderStage& stage = *parent.getCurrentRenderBin()->getStage();
+        for (const osg::ref_ptr<Context>& context : used)
+        {
+            if (context->mWorkItem != nullptr)
+            {
+                context->mWorkItem->waitTillDone();
+                context->mWorkItem = nullptr;
+            }
+            else if (context != used.back())
+                context->cull();
+            context->merge(stage);
+        }
+    }
+}
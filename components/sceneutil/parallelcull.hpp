@@ -0,0 +1,62 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_PARALLELCULL_H
+#define OPENMW_COMPONENTS_SCENEUTIL_PARALLELCULL_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Camera;
+}
+
+namespace osgUtil
+{
+    class CullVisitor;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+
+    /// @brief Culls render to texture cameras nested in the scene graph on worker threads, each with its own CullVisitor.
+    /// @par A camera's CullVisitor starts out with the state, matrices and settings of the parent CullVisitor at the
+    /// time the camera is added. The resulting render stages are added to the parent's current render stage in the
+    /// order the cameras were added, so the result matches letting the parent cull them one after another.
+    /// @note Everything reachable from the cameras must be safe to cull concurrently. The cameras must render before or
+    /// after their parent rather than nested into it, and do not inherit its positional state, e.g. osg::LightSource.
+    class ParallelCull : public osg::Referenced
+    {
+    public:
+        /// @param numThreads Number of worker threads. The calling thread culls the last camera itself.
+        explicit ParallelCull(std::size_t numThreads);
+        ~ParallelCull();
+
+        /// @param traversalMask Traversal mask to cull the camera with, in place of the parent's.
+        void addCamera(osgUtil::CullVisitor& parent, osg::Camera* camera, unsigned int traversalMask);
+
+        /// Wait until the cameras added with the given parent since the last call are culled and add their render stages.
+        void finish(osgUtil::CullVisitor& parent);
+
+    private:
+        struct Context;
+        class CullWorkItem;
+
+        struct Contexts
+        {
+            std::vector<osg::ref_ptr<Context>> mContexts;
+            std::size_t mNumUsed = 0;
+        };
+
+        osg::ref_ptr<WorkQueue> mWorkQueue;
+        std::mutex mMutex;
+        // OSG double buffers CullVisitors, so contexts per parent are not reused before the previous frame is drawn
+        std::map<osgUtil::CullVisitor*, Contexts> mContexts;
+    };
+}
+
+#endif
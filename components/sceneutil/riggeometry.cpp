@@ -189,6 +189,9 @@ bool RigGeometry::initFromParentSkeleton(osg::NodeVisitor* nv)
 
 void RigGeometry::cull(osg::NodeVisitor* nv)
 {
+    // Several cameras may cull the geometry at once, only the first one of a frame does the skinning
+    std::unique_lock<std::mutex> lock(mMutex);
+
     if (!mSkeleton)
     {
         Log(Debug::Error) << "Error: RigGeometry rendering with no skeleton, should have been initialized by UpdateVisitor";
@@ -201,6 +204,7 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
     if (mLastFrameNumber == traversalNumber || (mLastFrameNumber != 0 && !mSkeleton->getActive()))
     {
         osg::Geometry& geom = *getGeometry(mLastFrameNumber);
+        lock.unlock();
         nv->pushOntoNodePath(&geom);
         nv->apply(geom);
         nv->popFromNodePath();
@@ -267,6 +271,7 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
         tangentDst->dirty();
 
     geom.osg::Drawable::dirtyGLObjects();
+    lock.unlock();
 
     nv->pushOntoNodePath(&geom);
     nv->apply(geom);
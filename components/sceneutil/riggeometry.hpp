@@ -4,6 +4,8 @@
 #include <osg/Geometry>
 #include <osg/Matrixf>
 
+#include <mutex>
+
 namespace SceneUtil
 {
     class Skeleton;
@@ -107,6 +109,7 @@ namespace SceneUtil
         osg::ref_ptr<BoneSphereVector> mBoneSphereVector;
         std::vector<Bone*> mBoneNodesVector;
 
+        std::mutex mMutex;
         unsigned int mLastFrameNumber;
         bool mBoundsFirstFrame;
 
@@ -8,6 +8,7 @@
 #include <components/stereo/stereomanager.hpp>
 
 #include "mwshadowtechnique.hpp"
+#include "parallelcull.hpp"
 
 namespace SceneUtil
 {
@@ -67,6 +68,14 @@ namespace SceneUtil
         else
             mShadowSettings->setMultipleShadowMapHint(osgShadow::ShadowSettings::PARALLEL_SPLIT);
 
+        // Perspective shadow maps change with every camera rotation, so static shadow maps could never be reused
+        const bool staticShadowMapCache = Settings::Manager::getBool("static shadow map cache", "Shadows");
+        mShadowTechnique->enableStaticShadowMapCache(staticShadowMapCache);
+        mShadowSettings->setShadowMapProjectionHint(staticShadowMapCache ? ShadowSettings::ORTHOGRAPHIC_SHADOW_MAP : ShadowSettings::PERSPECTIVE_SHADOW_MAP);
+
+        const int cullThreads = Settings::Manager::getInt("parallel cull threads", "Shadows");
+        mShadowTechnique->setParallelCull(cullThreads > 0 ? new ParallelCull(static_cast<std::size_t>(cullThreads)) : nullptr);
+
         if (Settings::Manager::getBool("enable debug hud", "Shadows"))
             mShadowTechnique->enableDebugHUD();
         else
@@ -99,7 +108,7 @@ namespace SceneUtil
         }
     }
 
-    ShadowManager::ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, Shader::ShaderManager &shaderManager) : mShadowedScene(new osgShadow::ShadowedScene),
+    ShadowManager::ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, unsigned int staticShadowCastingMask, Shader::ShaderManager &shaderManager) : mShadowedScene(new osgShadow::ShadowedScene),
         mShadowTechnique(new MWShadowTechnique),
         mOutdoorShadowCastingMask(outdoorShadowCastingMask),
         mIndoorShadowCastingMask(indoorShadowCastingMask)
@@ -118,6 +127,7 @@ namespace SceneUtil
 
         mShadowTechnique->setupCastingShader(shaderManager);
         mShadowTechnique->setWorldMask(worldMask);
+        mShadowTechnique->setStaticShadowCastingMask(staticShadowCastingMask);
 
         enableOutdoorMode();
     }
@@ -195,4 +205,9 @@ namespace SceneUtil
             mShadowTechnique->enableShadows();
         mShadowSettings->setCastsShadowTraversalMask(mOutdoorShadowCastingMask);
     }
+
+    void ShadowManager::dirtyStaticShadowMaps()
+    {
+        mShadowTechnique->dirtyStaticShadowMaps();
+    }
 }
@@ -24,7 +24,7 @@ namespace SceneUtil
 
         static Shader::ShaderManager::DefineMap getShadowsDisabledDefines();
 
-        ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, Shader::ShaderManager &shaderManager);
+        ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, unsigned int staticShadowCastingMask, Shader::ShaderManager &shaderManager);
         ~ShadowManager();
 
         void setupShadowSettings();
@@ -34,6 +34,9 @@ namespace SceneUtil
         void enableIndoorMode();
 
         void enableOutdoorMode();
+
+        /// Re-render cached static shadow maps, e.g. because cells were loaded or unloaded.
+        void dirtyStaticShadowMaps();
     protected:
         bool mEnableShadows;
 
@@ -98,6 +98,8 @@ Bone* Skeleton::getBone(const std::string &name)
 
 bool Skeleton::updateBoneMatrices(unsigned int traversalNumber)
 {
+    std::lock_guard<std::mutex> lock(mMutex);
+
     if (traversalNumber != mLastFrameNumber)
         mNeedToUpdateBoneMatrices = true;
 
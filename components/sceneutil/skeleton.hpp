@@ -4,6 +4,7 @@
 #include <osg/Group>
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace SceneUtil
@@ -41,6 +42,7 @@ namespace SceneUtil
         Bone* getBone(const std::string& name);
 
         /// Request an update of bone matrices. May be a no-op if already updated in this frame. Returns true if update was performed.
+        /// @note Thread safe, the skinned geometries may be culled by several cameras at once.
         bool updateBoneMatrices(unsigned int traversalNumber);
 
         enum ActiveType
@@ -77,6 +79,7 @@ namespace SceneUtil
         BoneCache mBoneCache;
         bool mBoneCacheInit;
 
+        std::mutex mMutex;
         bool mNeedToUpdateBoneMatrices;
         bool mTracked;
 
@@ -4,6 +4,7 @@
 #include <components/sceneutil/nodecallback.hpp>
 
 #include <map>
+#include <mutex>
 #include <array>
 
 namespace osgUtil
@@ -59,6 +60,8 @@ namespace SceneUtil
         osg::StateSet* getCvDependentStateset(osgUtil::CullVisitor* cv);
 
         std::array<osg::ref_ptr<osg::StateSet>, 2> mStateSetsUpdate;
+        // Each CullVisitor has its own StateSet, but cameras may be culled concurrently with separate CullVisitors
+        std::mutex mStateSetsCullMutex;
         std::map<osgUtil::CullVisitor*, osg::ref_ptr<osg::StateSet>> mStateSetsCull;
     };
 
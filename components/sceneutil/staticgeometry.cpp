@@ -0,0 +1,520 @@
+#include "staticgeometry.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/PrimitiveSet>
+
+namespace SceneUtil
+{
+
+namespace
+{
+    constexpr std::uint32_t sMagic = 0x4d475354; // "TSGM"
+    constexpr std::uint32_t sVersion = 1;
+    constexpr unsigned int sMaxDepth = 256;
+
+    enum class NodeType : std::uint8_t
+    {
+        Group = 0,
+        MatrixTransform = 1,
+        Geometry = 2,
+    };
+
+    enum class ArrayType : std::uint8_t
+    {
+        None = 0,
+        Vec2 = 1,
+        Vec3 = 2,
+        Vec4 = 3,
+        Vec4ub = 4,
+    };
+
+    enum class PrimitiveType : std::uint8_t
+    {
+        DrawArrays = 0,
+        DrawElementsUByte = 1,
+        DrawElementsUShort = 2,
+        DrawElementsUInt = 3,
+    };
+
+    template <class T>
+    void write(std::ostream& stream, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    T read(std::istream& stream)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+        if (!stream)
+            throw std::runtime_error("Unexpected end of static geometry data");
+        return value;
+    }
+
+    void readData(std::istream& stream, void* data, std::size_t size)
+    {
+        stream.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+        if (!stream)
+            throw std::runtime_error("Unexpected end of static geometry data");
+    }
+
+    /// Counts come from a file that might be truncated or corrupted, check them before allocating memory for the data
+    void checkAvailable(std::istream& stream, std::uint32_t count, std::size_t elementSize)
+    {
+        const std::istream::pos_type position = stream.tellg();
+        stream.seekg(0, std::ios::end);
+        const std::istream::pos_type end = stream.tellg();
+        stream.seekg(position);
+        if (position == std::istream::pos_type(-1) || end == std::istream::pos_type(-1) || !stream)
+            throw std::runtime_error("Static geometry data stream is not seekable");
+        if (static_cast<std::uint64_t>(count) * elementSize > static_cast<std::uint64_t>(end - position))
+            throw std::runtime_error("Invalid element count in static geometry data");
+    }
+
+    bool isExactly(const osg::Object& object, const char* libraryName, const char* className)
+    {
+        return std::strcmp(object.libraryName(), libraryName) == 0 && std::strcmp(object.className(), className) == 0;
+    }
+
+    template <class Elements>
+    void writeElements(std::ostream& stream, const Elements& elements)
+    {
+        write(stream, static_cast<std::uint32_t>(elements.size()));
+        if (!elements.empty())
+            stream.write(reinterpret_cast<const char*>(&elements.front()), elements.size() * sizeof(elements.front()));
+    }
+
+    template <class Elements>
+    osg::ref_ptr<Elements> readElements(std::istream& stream, GLenum mode)
+    {
+        const std::uint32_t size = read<std::uint32_t>(stream);
+        checkAvailable(stream, size, sizeof(typename Elements::value_type));
+        osg::ref_ptr<Elements> elements = new Elements(mode, size);
+        if (size)
+            readData(stream, &elements->front(), size * sizeof(elements->front()));
+        return elements;
+    }
+
+    template <class Array>
+    osg::ref_ptr<Array> readArray(std::istream& stream)
+    {
+        const std::uint32_t size = read<std::uint32_t>(stream);
+        checkAvailable(stream, size, sizeof(typename Array::ElementDataType));
+        osg::ref_ptr<Array> array = new Array(size);
+        if (size)
+            readData(stream, &array->front(), size * sizeof(array->front()));
+        return array;
+    }
+
+    class Writer
+    {
+    public:
+        Writer(std::ostream& stream, const WriteStateSetFunc& writeStateSet, const WriteUserObjectFunc& writeUserObject)
+            : mStream(stream)
+            , mWriteStateSet(writeStateSet)
+            , mWriteUserObject(writeUserObject)
+        {
+        }
+
+        bool writeNode(const osg::Node& node)
+        {
+            if (node.getUpdateCallback() || node.getCullCallback() || node.getEventCallback() || node.getUserData())
+                return false;
+
+            if (const osg::Geometry* geometry = node.asGeometry())
+            {
+                if (!isExactly(*geometry, "osg", "Geometry"))
+                    return false;
+                write(mStream, NodeType::Geometry);
+                return writeCommon(node) && writeGeometry(*geometry);
+            }
+
+            const osg::Group* group = node.asGroup();
+            if (!group)
+                return false;
+            if (const osg::Transform* transform = group->asTransform())
+            {
+                const osg::MatrixTransform* matrixTransform = transform->asMatrixTransform();
+                if (!matrixTransform || !isExactly(*matrixTransform, "osg", "MatrixTransform") || matrixTransform->getReferenceFrame() != osg::Transform::RELATIVE_RF)
+                    return false;
+                write(mStream, NodeType::MatrixTransform);
+                if (!writeCommon(node))
+                    return false;
+                const osg::Matrix& matrix = matrixTransform->getMatrix();
+                for (int i = 0; i < 16; ++i)
+                    write(mStream, static_cast<double>(matrix.ptr()[i]));
+            }
+            else
+            {
+                if (!isExactly(*group, "osg", "Group"))
+                    return false;
+                write(mStream, NodeType::Group);
+                if (!writeCommon(node))
+                    return false;
+            }
+
+            write(mStream, static_cast<std::uint32_t>(group->getNumChildren()));
+            for (unsigned int i = 0; i < group->getNumChildren(); ++i)
+            {
+                if (!writeNode(*group->getChild(i)))
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        std::ostream& mStream;
+        const WriteStateSetFunc& mWriteStateSet;
+        const WriteUserObjectFunc& mWriteUserObject;
+
+        bool writeCommon(const osg::Node& node)
+        {
+            write(mStream, node.getNodeMask());
+            write(mStream, static_cast<std::uint8_t>(node.getDataVariance()));
+
+            const osg::StateSet* stateSet = node.getStateSet();
+            write(mStream, static_cast<std::uint8_t>(stateSet != nullptr));
+            if (stateSet && !mWriteStateSet(*stateSet, mStream))
+                return false;
+
+            const osg::UserDataContainer* userDataContainer = node.getUserDataContainer();
+            const unsigned int numUserObjects = userDataContainer ? userDataContainer->getNumUserObjects() : 0;
+            write(mStream, static_cast<std::uint32_t>(numUserObjects));
+            for (unsigned int i = 0; i < numUserObjects; ++i)
+            {
+                if (!mWriteUserObject(*userDataContainer->getUserObject(i), mStream))
+                    return false;
+            }
+            return true;
+        }
+
+        bool writeArray(const osg::Array* array)
+        {
+            if (!array)
+            {
+                write(mStream, ArrayType::None);
+                return true;
+            }
+            if (array->getBinding() != osg::Array::BIND_PER_VERTEX && array->getBinding() != osg::Array::BIND_OVERALL)
+                return false;
+
+            switch (array->getType())
+            {
+                case osg::Array::Vec2ArrayType:
+                    write(mStream, ArrayType::Vec2);
+                    writeElements(mStream, static_cast<const osg::Vec2Array&>(*array));
+                    break;
+                case osg::Array::Vec3ArrayType:
+                    write(mStream, ArrayType::Vec3);
+                    writeElements(mStream, static_cast<const osg::Vec3Array&>(*array));
+                    break;
+                case osg::Array::Vec4ArrayType:
+                    write(mStream, ArrayType::Vec4);
+                    writeElements(mStream, static_cast<const osg::Vec4Array&>(*array));
+                    break;
+                case osg::Array::Vec4ubArrayType:
+                    write(mStream, ArrayType::Vec4ub);
+                    writeElements(mStream, static_cast<const osg::Vec4ubArray&>(*array));
+                    break;
+                default:
+                    return false;
+            }
+            write(mStream, static_cast<std::int32_t>(array->getBinding()));
+            write(mStream, static_cast<std::uint8_t>(array->getNormalize()));
+            return true;
+        }
+
+        bool writePrimitiveSet(const osg::PrimitiveSet& primitiveSet)
+        {
+            if (primitiveSet.getNumInstances() != 0)
+                return false;
+
+            switch (primitiveSet.getType())
+            {
+                case osg::PrimitiveSet::DrawArraysPrimitiveType:
+                {
+                    const osg::DrawArrays& drawArrays = static_cast<const osg::DrawArrays&>(primitiveSet);
+                    write(mStream, PrimitiveType::DrawArrays);
+                    write(mStream, static_cast<std::uint32_t>(drawArrays.getMode()));
+                    write(mStream, static_cast<std::int32_t>(drawArrays.getFirst()));
+                    write(mStream, static_cast<std::int32_t>(drawArrays.getCount()));
+                    return true;
+                }
+                case osg::PrimitiveSet::DrawElementsUBytePrimitiveType:
+                    write(mStream, PrimitiveType::DrawElementsUByte);
+                    write(mStream, static_cast<std::uint32_t>(primitiveSet.getMode()));
+                    writeElements(mStream, static_cast<const osg::DrawElementsUByte&>(primitiveSet));
+                    return true;
+                case osg::PrimitiveSet::DrawElementsUShortPrimitiveType:
+                    write(mStream, PrimitiveType::DrawElementsUShort);
+                    write(mStream, static_cast<std::uint32_t>(primitiveSet.getMode()));
+                    writeElements(mStream, static_cast<const osg::DrawElementsUShort&>(primitiveSet));
+                    return true;
+                case osg::PrimitiveSet::DrawElementsUIntPrimitiveType:
+                    write(mStream, PrimitiveType::DrawElementsUInt);
+                    write(mStream, static_cast<std::uint32_t>(primitiveSet.getMode()));
+                    writeElements(mStream, static_cast<const osg::DrawElementsUInt&>(primitiveSet));
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool writeGeometry(const osg::Geometry& geometry)
+        {
+            if (geometry.getDrawCallback() || geometry.getComputeBoundingBoxCallback() || geometry.getInitialBound().valid()
+                || geometry.getSecondaryColorArray() || geometry.getFogCoordArray())
+                return false;
+
+            write(mStream, static_cast<std::uint8_t>(geometry.getUseDisplayList()));
+            write(mStream, static_cast<std::uint8_t>(geometry.getUseVertexBufferObjects()));
+
+            if (!writeArray(geometry.getVertexArray()) || !writeArray(geometry.getNormalArray()) || !writeArray(geometry.getColorArray()))
+                return false;
+
+            write(mStream, static_cast<std::uint32_t>(geometry.getNumTexCoordArrays()));
+            for (unsigned int i = 0; i < geometry.getNumTexCoordArrays(); ++i)
+            {
+                if (!writeArray(geometry.getTexCoordArray(i)))
+                    return false;
+            }
+
+            write(mStream, static_cast<std::uint32_t>(geometry.getNumVertexAttribArrays()));
+            for (unsigned int i = 0; i < geometry.getNumVertexAttribArrays(); ++i)
+            {
+                if (!writeArray(geometry.getVertexAttribArray(i)))
+                    return false;
+            }
+
+            write(mStream, static_cast<std::uint32_t>(geometry.getNumPrimitiveSets()));
+            for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+            {
+                if (!writePrimitiveSet(*geometry.getPrimitiveSet(i)))
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    class Reader
+    {
+    public:
+        Reader(std::istream& stream, const ReadStateSetFunc& readStateSet, const ReadUserObjectFunc& readUserObject)
+            : mStream(stream)
+            , mReadStateSet(readStateSet)
+            , mReadUserObject(readUserObject)
+        {
+        }
+
+        osg::ref_ptr<osg::Node> readNode(unsigned int depth = 0)
+        {
+            if (depth > sMaxDepth)
+                throw std::runtime_error("Too deep node hierarchy in static geometry data");
+            const NodeType type = read<NodeType>(mStream);
+            switch (type)
+            {
+                case NodeType::Geometry:
+                {
+                    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+                    readCommon(*geometry);
+                    readGeometry(*geometry);
+                    return geometry;
+                }
+                case NodeType::MatrixTransform:
+                {
+                    osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform;
+                    readCommon(*transform);
+                    double matrix[16];
+                    for (double& value : matrix)
+                        value = read<double>(mStream);
+                    transform->setMatrix(osg::Matrixd(matrix));
+                    readChildren(*transform, depth);
+                    return transform;
+                }
+                case NodeType::Group:
+                {
+                    osg::ref_ptr<osg::Group> group = new osg::Group;
+                    readCommon(*group);
+                    readChildren(*group, depth);
+                    return group;
+                }
+            }
+            throw std::runtime_error("Invalid node type in static geometry data");
+        }
+
+    private:
+        std::istream& mStream;
+        const ReadStateSetFunc& mReadStateSet;
+        const ReadUserObjectFunc& mReadUserObject;
+
+        void readCommon(osg::Node& node)
+        {
+            node.setNodeMask(read<osg::Node::NodeMask>(mStream));
+            node.setDataVariance(static_cast<osg::Object::DataVariance>(read<std::uint8_t>(mStream)));
+
+            if (read<std::uint8_t>(mStream))
+                node.setStateSet(mReadStateSet(mStream));
+
+            const std::uint32_t numUserObjects = read<std::uint32_t>(mStream);
+            for (std::uint32_t i = 0; i < numUserObjects; ++i)
+                node.getOrCreateUserDataContainer()->addUserObject(mReadUserObject(mStream));
+        }
+
+        void readChildren(osg::Group& group, unsigned int depth)
+        {
+            const std::uint32_t numChildren = read<std::uint32_t>(mStream);
+            for (std::uint32_t i = 0; i < numChildren; ++i)
+                group.addChild(readNode(depth + 1));
+        }
+
+        osg::ref_ptr<osg::Array> readArray()
+        {
+            osg::ref_ptr<osg::Array> array;
+            switch (read<ArrayType>(mStream))
+            {
+                case ArrayType::None:
+                    return nullptr;
+                case ArrayType::Vec2:
+                    array = SceneUtil::readArray<osg::Vec2Array>(mStream);
+                    break;
+                case ArrayType::Vec3:
+                    array = SceneUtil::readArray<osg::Vec3Array>(mStream);
+                    break;
+                case ArrayType::Vec4:
+                    array = SceneUtil::readArray<osg::Vec4Array>(mStream);
+                    break;
+                case ArrayType::Vec4ub:
+                    array = SceneUtil::readArray<osg::Vec4ubArray>(mStream);
+                    break;
+                default:
+                    throw std::runtime_error("Invalid array type in static geometry data");
+            }
+            const std::int32_t binding = read<std::int32_t>(mStream);
+            if (binding != osg::Array::BIND_PER_VERTEX && binding != osg::Array::BIND_OVERALL)
+                throw std::runtime_error("Invalid array binding in static geometry data");
+            array->setBinding(static_cast<osg::Array::Binding>(binding));
+            array->setNormalize(read<std::uint8_t>(mStream) != 0);
+            return array;
+        }
+
+        osg::ref_ptr<osg::PrimitiveSet> readPrimitiveSet()
+        {
+            const PrimitiveType type = read<PrimitiveType>(mStream);
+            const GLenum mode = read<std::uint32_t>(mStream);
+            switch (type)
+            {
+                case PrimitiveType::DrawArrays:
+                {
+                    const std::int32_t first = read<std::int32_t>(mStream);
+                    const std::int32_t count = read<std::int32_t>(mStream);
+                    return new osg::DrawArrays(mode, first, count);
+                }
+                case PrimitiveType::DrawElementsUByte:
+                    return readElements<osg::DrawElementsUByte>(mStream, mode);
+                case PrimitiveType::DrawElementsUShort:
+                    return readElements<osg::DrawElementsUShort>(mStream, mode);
+                case PrimitiveType::DrawElementsUInt:
+                    return readElements<osg::DrawElementsUInt>(mStream, mode);
+            }
+            throw std::runtime_error("Invalid primitive set type in static geometry data");
+        }
+
+        void readGeometry(osg::Geometry& geometry)
+        {
+            // Must be set before the arrays and primitive sets so that they receive buffer objects
+            geometry.setUseDisplayList(read<std::uint8_t>(mStream) != 0);
+            geometry.setUseVertexBufferObjects(read<std::uint8_t>(mStream) != 0);
+
+            geometry.setVertexArray(readArray());
+            geometry.setNormalArray(readArray());
+            geometry.setColorArray(readArray());
+
+            const std::uint32_t numTexCoordArrays = read<std::uint32_t>(mStream);
+            for (std::uint32_t i = 0; i < numTexCoordArrays; ++i)
+                geometry.setTexCoordArray(i, readArray());
+
+            const std::uint32_t numVertexAttribArrays = read<std::uint32_t>(mStream);
+            for (std::uint32_t i = 0; i < numVertexAttribArrays; ++i)
+                geometry.setVertexAttribArray(i, readArray());
+
+            const std::uint32_t numPrimitiveSets = read<std::uint32_t>(mStream);
+            for (std::uint32_t i = 0; i < numPrimitiveSets; ++i)
+                geometry.addPrimitiveSet(readPrimitiveSet());
+
+            validate(geometry);
+        }
+
+        /// Corrupted arrays or indices would make the draw read out of bounds
+        static void validate(const osg::Geometry& geometry)
+        {
+            const osg::Array* vertices = geometry.getVertexArray();
+            if (vertices == nullptr || vertices->getBinding() != osg::Array::BIND_PER_VERTEX)
+                throw std::runtime_error("Invalid vertex array in static geometry data");
+            const unsigned int numVertices = vertices->getNumElements();
+
+            const auto validateArray = [&] (const osg::Array* array)
+            {
+                if (array == nullptr)
+                    return;
+                if (array->getBinding() == osg::Array::BIND_PER_VERTEX ? array->getNumElements() != numVertices : array->getNumElements() == 0)
+                    throw std::runtime_error("Invalid array size in static geometry data");
+            };
+            validateArray(geometry.getNormalArray());
+            validateArray(geometry.getColorArray());
+            for (unsigned int i = 0; i < geometry.getNumTexCoordArrays(); ++i)
+                validateArray(geometry.getTexCoordArray(i));
+            for (unsigned int i = 0; i < geometry.getNumVertexAttribArrays(); ++i)
+                validateArray(geometry.getVertexAttribArray(i));
+
+            for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+            {
+                const osg::PrimitiveSet& primitiveSet = *geometry.getPrimitiveSet(i);
+                if (const osg::DrawArrays* drawArrays = dynamic_cast<const osg::DrawArrays*>(&primitiveSet))
+                {
+                    if (drawArrays->getFirst() < 0 || drawArrays->getCount() < 0
+                        || static_cast<std::int64_t>(drawArrays->getFirst()) + drawArrays->getCount() > numVertices)
+                        throw std::runtime_error("Invalid vertex range in static geometry data");
+                    continue;
+                }
+                for (unsigned int j = 0; j < primitiveSet.getNumIndices(); ++j)
+                {
+                    if (primitiveSet.index(j) >= numVertices)
+                        throw std::runtime_error("Invalid vertex index in static geometry data");
+                }
+            }
+        }
+    };
+}
+
+bool writeStaticGeometry(const osg::Node& node, std::ostream& stream,
+    const WriteStateSetFunc& writeStateSet, const WriteUserObjectFunc& writeUserObject)
+{
+    write(stream, sMagic);
+    write(stream, sVersion);
+    Writer writer(stream, writeStateSet, writeUserObject);
+    return writer.writeNode(node) && stream.good();
+}
+
+osg::ref_ptr<osg::Node> readStaticGeometry(std::istream& stream,
+    const ReadStateSetFunc& readStateSet, const ReadUserObjectFunc& readUserObject)
+{
+    if (read<std::uint32_t>(stream) != sMagic)
+        throw std::runtime_error("Not static geometry data");
+    if (read<std::uint32_t>(stream) != sVersion)
+        throw std::runtime_error("Unsupported static geometry data version");
+    Reader reader(stream, readStateSet, readUserObject);
+    return reader.readNode();
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_STATICGEOMETRY_H
+#define OPENMW_COMPONENTS_SCENEUTIL_STATICGEOMETRY_H
+
+#include <functional>
+#include <iosfwd>
+
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Node;
+    class Object;
+    class StateSet;
+}
+
+namespace SceneUtil
+{
+
+    /// @return false if the StateSet can not be written.
+    using WriteStateSetFunc = std::function<bool(const osg::StateSet& stateSet, std::ostream& stream)>;
+    /// @throw std::runtime_error if the StateSet can not be read.
+    using ReadStateSetFunc = std::function<osg::ref_ptr<osg::StateSet>(std::istream& stream)>;
+
+    /// @return false if the user object can not be written.
+    using WriteUserObjectFunc = std::function<bool(const osg::Object& object, std::ostream& stream)>;
+    /// @throw std::runtime_error if the user object can not be read.
+    using ReadUserObjectFunc = std::function<osg::ref_ptr<osg::Object>(std::istream& stream)>;
+
+    /// @brief Write a subgraph of static geometry in a compact binary format, e.g. to cache the result of merging geometry.
+    /// @par Supports osg::Group, osg::MatrixTransform and osg::Geometry with float or unsigned byte vector arrays bound
+    /// per vertex or overall, and DrawArrays and DrawElements primitive sets. StateSets and user objects are handled by
+    /// the given functions, so that they may be written as a reference to an existing object.
+    /// @return false if the subgraph contains anything that is not supported, e.g. callbacks. The stream contents are
+    /// unusable in that case.
+    bool writeStaticGeometry(const osg::Node& node, std::ostream& stream,
+        const WriteStateSetFunc& writeStateSet, const WriteUserObjectFunc& writeUserObject);
+
+    /// @brief Read a subgraph written by writeStaticGeometry.
+    /// @throw std::runtime_error if the stream does not contain valid data.
+    osg::ref_ptr<osg::Node> readStaticGeometry(std::istream& stream,
+        const ReadStateSetFunc& readStateSet, const ReadUserObjectFunc& readUserObject);
+
+}
+
+#endif
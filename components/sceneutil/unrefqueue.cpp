@@ -1,28 +1,100 @@
 #include "unrefqueue.hpp"
 
+#include <osg/Stats>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <vector>
+
 namespace SceneUtil
 {
     namespace
     {
-        struct ClearVector final : SceneUtil::WorkItem
+        constexpr std::size_t initialBatchSize = 64;
+    }
+
+    struct UnrefQueue::Batches
+    {
+        std::atomic<std::size_t> mLimit;
+        std::atomic<std::size_t> mLastSize {0};
+        std::atomic<double> mLastTime {0};
+
+        explicit Batches(std::size_t limit) : mLimit(limit) {}
+    };
+
+    class UnrefQueue::ClearBatch final : public SceneUtil::WorkItem
+    {
+    public:
+        ClearBatch(std::vector<osg::ref_ptr<osg::Referenced>>&& objects, std::shared_ptr<Batches> batches,
+                std::size_t maxObjects, double maxTime)
+            : mObjects(std::move(objects))
+            , mBatches(std::move(batches))
+            , mMaxObjects(maxObjects)
+            , mMaxTime(maxTime)
+        {}
+
+        void doWork() override
         {
-            std::vector<osg::ref_ptr<osg::Referenced>> mObjects;
+            const std::size_t size = mObjects.size();
+            const auto start = std::chrono::steady_clock::now();
+            mObjects.clear();
+            const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            explicit ClearVector(std::vector<osg::ref_ptr<osg::Referenced>>&& objects)
-                : mObjects(std::move(objects)) {}
+            mBatches->mLastSize = size;
+            mBatches->mLastTime = time;
 
-            void doWork() override { mObjects.clear(); }
-        };
+            if (mMaxTime <= 0)
+                return;
+
+            // Grow slowly while well within the budget, shrink right away when over it
+            const std::size_t limit = mBatches->mLimit;
+            if (time > mMaxTime)
+                mBatches->mLimit = std::max<std::size_t>(1, static_cast<std::size_t>(size * mMaxTime / time));
+            else if (time < mMaxTime / 2 && size == limit)
+                mBatches->mLimit = std::min(limit * 2, mMaxObjects);
+        }
+
+    private:
+        std::vector<osg::ref_ptr<osg::Referenced>> mObjects;
+        std::shared_ptr<Batches> mBatches;
+        const std::size_t mMaxObjects;
+        const double mMaxTime;
+    };
+
+    UnrefQueue::UnrefQueue(std::size_t maxObjectsPerFlush, double maxTimePerFlush)
+        : mMaxObjectsPerFlush(maxObjectsPerFlush == 0 ? std::numeric_limits<std::size_t>::max() : maxObjectsPerFlush)
+        , mMaxTimePerFlush(maxTimePerFlush)
+        , mBatches(std::make_shared<Batches>(maxTimePerFlush > 0 ? std::min(initialBatchSize, mMaxObjectsPerFlush) : mMaxObjectsPerFlush))
+    {
     }
 
-    void UnrefQueue::flush(SceneUtil::WorkQueue& workQueue)
+    osg::ref_ptr<WorkItem> UnrefQueue::flush(SceneUtil::WorkQueue& workQueue)
     {
+        if (mPendingBatch != nullptr && !mPendingBatch->isDone())
+            return nullptr;
+
+        const std::lock_guard<std::mutex> lock(mMutex);
         if (mObjects.empty())
-            return;
+            return nullptr;
 
-        // Move only objects to keep allocated storage in mObjects
-        workQueue.addWorkItem(new ClearVector(std::vector<osg::ref_ptr<osg::Referenced>>(
-            std::move_iterator(mObjects.begin()), std::move_iterator(mObjects.end()))));
-        mObjects.clear();
+        const std::size_t size = std::min<std::size_t>(mObjects.size(), mBatches->mLimit);
+        std::vector<osg::ref_ptr<osg::Referenced>> objects(std::move_iterator(mObjects.begin()),
+            std::move_iterator(mObjects.begin() + static_cast<std::ptrdiff_t>(size)));
+        mObjects.erase(mObjects.begin(), mObjects.begin() + static_cast<std::ptrdiff_t>(size));
+
+        mPendingBatch = new ClearBatch(std::move(objects), mBatches, mMaxObjectsPerFlush, mMaxTimePerFlush);
+        workQueue.addWorkItem(mPendingBatch);
+        return mPendingBatch;
+    }
+
+    void UnrefQueue::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        stats.setAttribute(frameNumber, "UnrefQueue", getSize());
+        stats.setAttribute(frameNumber, "UnrefQueue Batch", mBatches->mLastSize);
+        stats.setAttribute(frameNumber, "UnrefQueue Time", mBatches->mLastTime * 1e6);
+        if (mBatches->mLimit != std::numeric_limits<std::size_t>::max())
+            stats.setAttribute(frameNumber, "UnrefQueue Limit", mBatches->mLimit);
     }
 }
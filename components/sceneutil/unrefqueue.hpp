@@ -6,7 +6,15 @@
 #include <osg/ref_ptr>
 #include <osg/Referenced>
 
-#include <vector>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace osg
+{
+    class Stats;
+}
 
 namespace SceneUtil
 {
@@ -14,22 +22,54 @@ namespace SceneUtil
 
     /// @brief Handles unreferencing of objects through the WorkQueue. Typical use scenario
     /// would be the main thread pushing objects that are no longer needed, and the background thread deleting them.
+    /// @par Deleting objects also releases their GL objects, so deleting everything that was dropped at once, e.g. on a
+    /// cell change, causes a burst of work. The queue hands out at most one batch at a time instead, of a size adapted to
+    /// how long the previous batches took to unreference, and keeps the rest for later flushes.
     class UnrefQueue
     {
     public:
-        /// Adds an object to the list of objects to be unreferenced. Call from the main thread.
-        void push(osg::ref_ptr<osg::Referenced>&& obj) { mObjects.push_back(std::move(obj)); }
+        /// @param maxObjectsPerFlush Maximum number of objects unreferenced by one batch, 0 for no limit.
+        /// @param maxTimePerFlush Time in seconds a batch should take to unreference, 0 for no limit.
+        explicit UnrefQueue(std::size_t maxObjectsPerFlush = 0, double maxTimePerFlush = 0);
 
-        void push(const osg::ref_ptr<osg::Referenced>& obj) { mObjects.push_back(obj); }
+        /// Adds an object to the list of objects to be unreferenced.
+        /// @note Thread safe, caches may expire objects in a worker thread.
+        void push(osg::ref_ptr<osg::Referenced>&& obj)
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            mObjects.push_back(std::move(obj));
+        }
 
-        /// Adds a WorkItem to the given WorkQueue that will clear the list of objects in a worker thread,
-        /// thus unreferencing them. Call from the main thread.
-        void flush(SceneUtil::WorkQueue& workQueue);
+        void push(const osg::ref_ptr<osg::Referenced>& obj)
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            mObjects.push_back(obj);
+        }
 
-        std::size_t getSize() const { return mObjects.size(); }
+        /// Adds a WorkItem to the given WorkQueue that will clear the next batch of objects in a worker thread,
+        /// thus unreferencing them. Does nothing while the previous batch is not done yet. Call from the main thread.
+        /// @return The added WorkItem, if any.
+        osg::ref_ptr<WorkItem> flush(SceneUtil::WorkQueue& workQueue);
+
+        /// Number of objects not handed to the WorkQueue yet.
+        std::size_t getSize() const
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            return mObjects.size();
+        }
+
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
 
     private:
-        std::vector<osg::ref_ptr<osg::Referenced>> mObjects;
+        struct Batches;
+        class ClearBatch;
+
+        const std::size_t mMaxObjectsPerFlush;
+        const double mMaxTimePerFlush;
+        mutable std::mutex mMutex;
+        std::deque<osg::ref_ptr<osg::Referenced>> mObjects;
+        std::shared_ptr<Batches> mBatches;
+        osg::ref_ptr<WorkItem> mPendingBatch;
     };
 }
 
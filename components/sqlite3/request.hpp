@@ -165,6 +165,25 @@ namespace Sqlite3
         value.assign(static_cast<const std::byte*>(blob), static_cast<const std::byte*>(blob) + size);
     }
 
+    /// Points to the blob owned by the statement instead of copying it. The blob is valid until the statement is
+    /// stepped, reset or destroyed, so it should be consumed before the next request with the same statement.
+    inline void copyColumn(sqlite3& db, sqlite3_stmt& statement, int index, int type, ConstBlob& value)
+    {
+        if (type != SQLITE_BLOB)
+            throw std::logic_error("Type of column " + std::to_string(index) + " is " + sqliteTypeToString(type)
+                                   + " that does not match expected output type: SQLITE_BLOB");
+        const void* const blob = sqlite3_column_blob(&statement, index);
+        if (blob == nullptr)
+        {
+            if (const int ec = sqlite3_errcode(&db); ec != SQLITE_OK)
+                throw std::runtime_error("Failed to read blob from column " + std::to_string(index)
+                                         + ": " + sqlite3_errmsg(&db));
+            value = ConstBlob {nullptr, 0};
+            return;
+        }
+        value = ConstBlob {static_cast<const char*>(blob), sqlite3_column_bytes(&statement, index)};
+    }
+
     template <int index, class T>
     inline void getColumnsImpl(sqlite3& db, sqlite3_stmt& statement, T& row)
     {
@@ -251,7 +270,8 @@ namespace Sqlite3
         {
             statement.mNeedReset = true;
             prepare(db, statement, std::forward<Args>(args) ...);
-            for (std::size_t i = 0; executeStep(db, statement) && i < max; ++i)
+            // Don't step after the last requested row, it would invalidate blobs pointing to the statement memory
+            for (std::size_t i = 0; i < max && executeStep(db, statement); ++i)
                 getRow(db, *statement.mHandle, *out++);
             return out;
         }
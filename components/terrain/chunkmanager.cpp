@@ -1,5 +1,6 @@
 #include "chunkmanager.hpp"
 
+#include <osg/Image>
 #include <osg/Texture2D>
 #include <osg/Material>
 
@@ -10,6 +11,10 @@
 
 #include <components/sceneutil/lightmanager.hpp>
 
+#include <algorithm>
+#include <locale>
+#include <sstream>
+
 #include "terraindrawable.hpp"
 #include "material.hpp"
 #include "storage.hpp"
@@ -37,6 +42,31 @@ ChunkManager::ChunkManager(Storage *storage, Resource::SceneManager *sceneMgr, T
     mMultiPassRoot->setAttributeAndModes(material, osg::StateAttribute::ON);
 }
 
+ChunkManager::~ChunkManager()
+{
+    // composite maps waiting for preparation refer to this object
+    if (mCompositeMapRenderer)
+        mCompositeMapRenderer->cancelPreparation();
+}
+
+namespace
+{
+    std::string getCompositeMapCacheName(float chunkSize, const osg::Vec2f& chunkCenter)
+    {
+        std::ostringstream stream;
+        stream.imbue(std::locale::classic());
+        stream << "composite_" << chunkCenter.x() << '_' << chunkCenter.y() << '_' << chunkSize << ".png";
+        return stream.str();
+    }
+
+    /// @return Size of the chunk relative to its distance from the view point, as an estimate of its size on screen.
+    float getCompositeMapPriority(float chunkSize, const osg::Vec2f& chunkCenter, const osg::Vec3f& viewPoint, float cellWorldSize)
+    {
+        const osg::Vec2f offset = chunkCenter * cellWorldSize - osg::Vec2f(viewPoint.x(), viewPoint.y());
+        return chunkSize * cellWorldSize / std::max(offset.length(), 1.f);
+    }
+}
+
 struct FindChunkTemplate
 {
     void operator() (ChunkId id, osg::Object* obj)
@@ -63,12 +93,17 @@ osg::ref_ptr<osg::Node> ChunkManager::getChunk(float size, const osg::Vec2f& cen
         find.mId = id;
         mCache->call(find);
         TerrainDrawable* templateGeometry = find.mFoundTemplate ? static_cast<TerrainDrawable*>(find.mFoundTemplate.get()) : nullptr;
-        osg::ref_ptr<osg::Node> node = createChunk(size, center, lod, lodFlags, compile, templateGeometry);
+        osg::ref_ptr<osg::Node> node = createChunk(size, center, lod, lodFlags, viewPoint, compile, templateGeometry);
         mCache->addEntryToObjectCache(id, node.get());
         return node;
     }
 }
 
+void ChunkManager::setLodCache(SceneUtil::LodCache* cache)
+{
+    mLodCache = cache;
+}
+
 void ChunkManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
 {
     stats->setAttribute(frameNumber, "Terrain Chunk", mCache->getCacheSize());
@@ -181,7 +216,7 @@ std::vector<osg::ref_ptr<osg::StateSet> > ChunkManager::createPasses(float chunk
     return ::Terrain::createPasses(useShaders, mSceneManager, layers, blendmapTextures, blendmapScale, blendmapScale);
 }
 
-osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Vec2f &chunkCenter, unsigned char lod, unsigned int lodFlags, bool compile, TerrainDrawable* templateGeometry)
+osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Vec2f &chunkCenter, unsigned char lod, unsigned int lodFlags, const osg::Vec3f& viewPoint, bool compile, TerrainDrawable* templateGeometry)
 {
     osg::ref_ptr<TerrainDrawable> geometry (new TerrainDrawable);
 
@@ -252,10 +287,40 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
     {
         if (useCompositeMap)
         {
-            osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
-            compositeMap->mTexture = createCompositeMapRTT();
+            osg::ref_ptr<osg::Texture2D> texture = createCompositeMapRTT();
 
-            createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), *compositeMap);
+            osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
+            compositeMap->mTexture = texture;
+            compositeMap->mPriority = getCompositeMapPriority(chunkSize, chunkCenter, viewPoint, mStorage->getCellWorldSize());
+
+            osg::ref_ptr<SceneUtil::LodCache> cache = mLodCache;
+            const std::string cacheName = cache ? getCompositeMapCacheName(chunkSize, chunkCenter) : std::string();
+            const int compositeMapSize = static_cast<int>(mCompositeMapSize);
+            auto prepare = [this, chunkSize, chunkCenter, cache, cacheName, compositeMapSize] (CompositeMap& map)
+            {
+                osg::ref_ptr<osg::Image> cachedImage = cache ? cache->readImage(cacheName) : nullptr;
+                if (cachedImage && cachedImage->s() == compositeMapSize && cachedImage->t() == compositeMapSize)
+                {
+                    map.mImage = std::move(cachedImage);
+                    map.mReadBackCallback = nullptr;
+                    return;
+                }
+                createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), map);
+            };
+
+            if (cache)
+            {
+                compositeMap->mReadBackCallback = [cache, cacheName] (osg::ref_ptr<osg::Image> image)
+                {
+                    cache->writeImage(cacheName, std::move(image));
+                };
+            }
+
+            // leave decoding the cached image or loading the blendmaps and textures to a worker thread
+            if (mCompositeMapRenderer->hasWorkQueue())
+                compositeMap->setPrepareCallback(prepare);
+            else
+                prepare(*compositeMap);
 
             mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
 
@@ -263,7 +328,7 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
             geometry->setCompositeMapRenderer(mCompositeMapRenderer);
 
             TextureLayer layer;
-            layer.mDiffuseMap = compositeMap->mTexture;
+            layer.mDiffuseMap = texture;
             layer.mParallax = false;
             layer.mSpecular = false;
             geometry->setPasses(::Terrain::createPasses(mSceneManager->getForceShaders() || !mSceneManager->getClampLighting(), mSceneManager, std::vector<TextureLayer>(1, layer), std::vector<osg::ref_ptr<osg::Texture2D> >(), 1.f, 1.f));
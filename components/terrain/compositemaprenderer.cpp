@@ -1,17 +1,54 @@
 #include "compositemaprenderer.hpp"
 
+#include <osg/BufferObject>
 #include <osg/FrameBufferObject>
+#include <osg/Image>
 #include <osg/Texture2D>
 #include <osg/RenderInfo>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include <algorithm>
+#include <cstring>
 
 namespace Terrain
 {
 
+namespace
+{
+    class PrepareCompositeMapsWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        PrepareCompositeMapsWorkItem(CompositeMapRenderer* renderer) : mRenderer(renderer) {}
+
+        void doWork() override
+        {
+            mRenderer->prepareNextCompositeMap(mAbort);
+        }
+
+        void abort() override
+        {
+            mAbort = true;
+        }
+
+    private:
+        CompositeMapRenderer* mRenderer;
+        std::atomic_bool mAbort {false};
+    };
+
+    // Frames to wait before mapping a pixel buffer object, so the GPU is most likely done writing to it
+    constexpr unsigned int sReadBackDelay = 2;
+}
+
 CompositeMapRenderer::CompositeMapRenderer()
     : mTargetFrameRate(120)
     , mMinimumTimeAvailable(0.0025)
+    , mAverageFrameTime(0.0)
+    , mAverageDrawTime(0.0)
+    , mLastCompileTime(0.0)
+    , mLastTimeAvailable(0.0)
+    , mFrameNumber(0)
+    , mPrepareScheduled(false)
 {
     setSupportsDisplayList(false);
     setCullingActive(false);
@@ -23,6 +60,7 @@ CompositeMapRenderer::CompositeMapRenderer()
 
 CompositeMapRenderer::~CompositeMapRenderer()
 {
+    stopPreparation();
 }
 
 void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
@@ -30,34 +68,58 @@ void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
     double dt = mTimer.time_s();
     dt = std::min(dt, 0.2);
     mTimer.setStartTick();
+    // React to slow frames immediately, but only give more time to compiling once frames are fast consistently
+    mAverageFrameTime += (dt - mAverageFrameTime) * 0.1;
     double targetFrameTime = 1.0/static_cast<double>(mTargetFrameRate);
     double conservativeTimeRatio(0.75);
-    double availableTime = std::max((targetFrameTime - dt)*conservativeTimeRatio,
+    double availableTime = std::max((targetFrameTime - std::max(dt, mAverageFrameTime))*conservativeTimeRatio,
                                     mMinimumTimeAvailable);
 
+    ++mFrameNumber;
+    if (!mPendingReadBacks.empty())
+        finishReadBacks(*renderInfo.getState());
+
     std::lock_guard<std::mutex> lock(mMutex);
 
+    mLastCompileTime = 0.0;
+    mLastTimeAvailable = availableTime;
+
     if (mImmediateCompileSet.empty() && mCompileSet.empty())
         return;
 
+    osg::Timer compileTimer;
+
     while (!mImmediateCompileSet.empty())
     {
         osg::ref_ptr<CompositeMap> node = *mImmediateCompileSet.begin();
         mImmediateCompileSet.erase(node);
+        mPrepareSet.erase(node);
 
         mMutex.unlock();
+        // The map is required for this frame, so prepare it here if no worker thread got to it yet
+        node->prepare();
         compile(*node, renderInfo, nullptr);
         mMutex.lock();
     }
 
     double timeLeft = availableTime;
 
-    while (!mCompileSet.empty() && timeLeft > 0)
+    // Always make some progress, but do not start on another map that is unlikely to fit into the remaining time
+    bool first = true;
+    while (timeLeft > 0 && (first || timeLeft > mAverageDrawTime))
     {
-        osg::ref_ptr<CompositeMap> node = *mCompileSet.begin();
-        mCompileSet.erase(node);
+        // Skip the maps that are still waiting for a worker thread
+        CompileSet::iterator it = std::find_if(mCompileSet.begin(), mCompileSet.end(),
+            [&] (const osg::ref_ptr<CompositeMap>& map) { return map->isPrepared() || !mWorkQueue; });
+        if (it == mCompileSet.end())
+            break;
+        osg::ref_ptr<CompositeMap> node = *it;
+        mCompileSet.erase(it);
+        mPrepareSet.erase(node);
+        first = false;
 
         mMutex.unlock();
+        node->prepare();
         compile(*node, renderInfo, &timeLeft);
         mMutex.lock();
 
@@ -68,6 +130,7 @@ void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
             mCompileSet.insert(node);
         }
     }
+    mLastCompileTime = compileTimer.time_s();
     mTimer.setStartTick();
 }
 
@@ -80,6 +143,16 @@ void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &
         return;
     }
 
+    if (compositeMap.mImage)
+    {
+        // uploaded when the texture is applied for drawing the terrain
+        compositeMap.mTexture->setImage(compositeMap.mImage);
+        compositeMap.mTexture->setUnRefImageDataAfterApply(true);
+        compositeMap.mImage = nullptr;
+        compositeMap.mCompiled = compositeMap.mDrawables.size();
+        return;
+    }
+
     osg::Timer timer;
     osg::State& state = *renderInfo.getState();
     osg::GLExtensions* ext = state.get<osg::GLExtensions>();
@@ -130,22 +203,91 @@ void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &
 
         if (timeLeft)
         {
-            *timeLeft -= timer.time_s();
+            double drawTime = timer.time_s();
             timer.setStartTick();
+            mAverageDrawTime += (drawTime - mAverageDrawTime) * 0.1;
+            *timeLeft -= drawTime;
 
-            if (*timeLeft <= 0)
+            if (*timeLeft <= mAverageDrawTime)
                 break;
         }
     }
     if (compositeMap.mCompiled == compositeMap.mDrawables.size())
+    {
         compositeMap.mDrawables = std::vector<osg::ref_ptr<osg::Drawable>>();
 
+        if (compositeMap.mReadBackCallback)
+            readBack(compositeMap, state);
+    }
+
     state.haveAppliedAttribute(osg::StateAttribute::VIEWPORT);
 
     GLuint fboId = state.getGraphicsContext() ? state.getGraphicsContext()->getDefaultFboId() : 0;
     ext->glBindFramebuffer(GL_FRAMEBUFFER_EXT, fboId);
 }
 
+void CompositeMapRenderer::readBack(CompositeMap& compositeMap, osg::State& state) const
+{
+    osg::GLExtensions* ext = state.get<osg::GLExtensions>();
+    const int width = compositeMap.mTexture->getTextureWidth();
+    const int height = compositeMap.mTexture->getTextureHeight();
+
+    mFBO->apply(state, osg::FrameBufferObject::READ_FRAMEBUFFER);
+
+    if (!ext->isPBOSupported)
+    {
+        // blocks until the GPU has finished rendering the map
+        osg::ref_ptr<osg::Image> image = new osg::Image;
+        image->readPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE);
+        compositeMap.mReadBackCallback(std::move(image));
+        compositeMap.mReadBackCallback = nullptr;
+        return;
+    }
+
+    PendingReadBack pending;
+    pending.mWidth = width;
+    pending.mHeight = height;
+    pending.mFrame = mFrameNumber;
+    pending.mCallback = std::move(compositeMap.mReadBackCallback);
+    compositeMap.mReadBackCallback = nullptr;
+
+    ext->glGenBuffers(1, &pending.mBuffer);
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, pending.mBuffer);
+    ext->glBufferData(GL_PIXEL_PACK_BUFFER_ARB, width * height * 3, nullptr, GL_STREAM_READ_ARB);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    mPendingReadBacks.push_back(std::move(pending));
+}
+
+void CompositeMapRenderer::finishReadBacks(osg::State& state) const
+{
+    osg::GLExtensions* ext = state.get<osg::GLExtensions>();
+
+    // pending read backs are ordered by frame
+    std::size_t finished = 0;
+    for (; finished < mPendingReadBacks.size(); ++finished)
+    {
+        PendingReadBack& pending = mPendingReadBacks[finished];
+        if (mFrameNumber - pending.mFrame < sReadBackDelay)
+            break;
+
+        ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, pending.mBuffer);
+        if (const void* data = ext->glMapBuffer(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB))
+        {
+            osg::ref_ptr<osg::Image> image = new osg::Image;
+            image->allocateImage(pending.mWidth, pending.mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE, 1);
+            std::memcpy(image->data(), data, image->getTotalSizeInBytes());
+            ext->glUnmapBuffer(GL_PIXEL_PACK_BUFFER_ARB);
+            pending.mCallback(std::move(image));
+        }
+        ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+        ext->glDeleteBuffers(1, &pending.mBuffer);
+    }
+    mPendingReadBacks.erase(mPendingReadBacks.begin(), mPendingReadBacks.begin() + finished);
+}
+
 void CompositeMapRenderer::setMinimumTimeAvailableForCompile(double time)
 {
     mMinimumTimeAvailable = time;
@@ -163,6 +305,11 @@ void CompositeMapRenderer::addCompositeMap(CompositeMap* compositeMap, bool imme
         mImmediateCompileSet.insert(compositeMap);
     else
         mCompileSet.insert(compositeMap);
+    if (!compositeMap->isPrepared() && mWorkQueue)
+    {
+        mPrepareSet.insert(compositeMap);
+        schedulePreparation();
+    }
 }
 
 void CompositeMapRenderer::setImmediate(CompositeMap* compositeMap)
@@ -178,14 +325,103 @@ void CompositeMapRenderer::setImmediate(CompositeMap* compositeMap)
     }
 }
 
+void CompositeMapRenderer::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+{
+    stopPreparation();
+    std::lock_guard<std::mutex> lock(mMutex);
+    mWorkQueue = workQueue;
+    if (mWorkQueue && !mPrepareSet.empty())
+        schedulePreparation();
+}
+
+void CompositeMapRenderer::cancelPreparation()
+{
+    stopPreparation();
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const osg::ref_ptr<CompositeMap>& map : mCompileSet)
+        map->cancelPreparation();
+    for (const osg::ref_ptr<CompositeMap>& map : mImmediateCompileSet)
+        map->cancelPreparation();
+    mPrepareSet.clear();
+}
+
+void CompositeMapRenderer::prepareNextCompositeMap(const std::atomic_bool& abort)
+{
+    osg::ref_ptr<CompositeMap> map;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (abort || mPrepareSet.empty())
+        {
+            mPrepareScheduled = false;
+            return;
+        }
+        map = *mPrepareSet.begin();
+        mPrepareSet.erase(mPrepareSet.begin());
+    }
+    map->prepare();
+
+    // Go to the back of the work queue after each map, so that other work like cell preloading is not held up by a long
+    // backlog of maps. The next item picks the map by the priorities at that time.
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPrepareScheduled = false;
+    if (!abort && !mPrepareSet.empty())
+        schedulePreparation();
+}
+
+void CompositeMapRenderer::schedulePreparation()
+{
+    if (mPrepareScheduled)
+        return;
+    mPrepareScheduled = true;
+    mPrepareItem = new PrepareCompositeMapsWorkItem(this);
+    mWorkQueue->addWorkItem(mPrepareItem);
+}
+
+void CompositeMapRenderer::stopPreparation()
+{
+    osg::ref_ptr<SceneUtil::WorkItem> item;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        item = mPrepareItem;
+        mPrepareItem = nullptr;
+        // The item checks for abort with mMutex locked before scheduling the next one
+        if (item)
+            item->abort();
+    }
+    if (item)
+        item->waitTillDone();
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPrepareScheduled = false;
+}
+
 unsigned int CompositeMapRenderer::getCompileSetSize() const
 {
     std::lock_guard<std::mutex> lock(mMutex);
     return mCompileSet.size();
 }
 
+unsigned int CompositeMapRenderer::getPrepareSetSize() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mPrepareSet.size();
+}
+
+double CompositeMapRenderer::getLastCompileTime() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLastCompileTime;
+}
+
+double CompositeMapRenderer::getLastTimeAvailable() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLastTimeAvailable;
+}
+
 CompositeMap::CompositeMap()
     : mCompiled(0)
+    , mPriority(0.f)
+    , mPrepared(true)
 {
 }
 
@@ -194,6 +430,38 @@ CompositeMap::~CompositeMap()
 
 }
 
+void CompositeMap::setPrepareCallback(std::function<void(CompositeMap&)> callback)
+{
+    std::lock_guard<std::mutex> lock(mPrepareMutex);
+    mPrepareCallback = std::move(callback);
+    mPrepared = false;
+}
+
+void CompositeMap::prepare()
+{
+    if (mPrepared)
+        return;
+    std::lock_guard<std::mutex> lock(mPrepareMutex);
+    if (mPrepared)
+        return;
+    // if there are no more external references the map will not be rendered anyway, see CompositeMapRenderer::compile
+    if (mTexture->referenceCount() > 1)
+        mPrepareCallback(*this);
+    mPrepareCallback = nullptr;
+    mPrepared = true;
+}
+
+void CompositeMap::cancelPreparation()
+{
+    std::lock_guard<std::mutex> lock(mPrepareMutex);
+    if (mPrepared)
+        return;
+    mPrepareCallback = nullptr;
+    // the texture is left incomplete, so do not let it end up in a cache
+    mReadBackCallback = nullptr;
+    mPrepared = true;
+}
+
 
 
 }
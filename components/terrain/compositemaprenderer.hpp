@@ -3,16 +3,27 @@
 
 #include <osg/Drawable>
 
+#include <atomic>
+#include <functional>
 #include <set>
 #include <mutex>
+#include <vector>
 
 namespace osg
 {
     class FrameBufferObject;
+    class Image;
     class RenderInfo;
+    class State;
     class Texture2D;
 }
 
+namespace SceneUtil
+{
+    class WorkItem;
+    class WorkQueue;
+}
+
 namespace Terrain
 {
 
@@ -24,6 +35,33 @@ namespace Terrain
         std::vector<osg::ref_ptr<osg::Drawable> > mDrawables;
         osg::ref_ptr<osg::Texture2D> mTexture;
         unsigned int mCompiled;
+
+        /// Estimate of the size of the map on screen, larger maps are rendered first.
+        /// @note Must not be changed after the map was added to a CompositeMapRenderer.
+        float mPriority;
+
+        /// Called from the draw thread with a copy of the texture contents once the map is fully rendered.
+        /// @note Where supported the contents are read back asynchronously, a few frames after rendering finished.
+        std::function<void(osg::ref_ptr<osg::Image>)> mReadBackCallback;
+
+        /// Contents to upload rather than rendering mDrawables, e.g. loaded from a cache by the prepare callback.
+        osg::ref_ptr<osg::Image> mImage;
+
+        /// Set a function creating mDrawables later on, e.g. in a worker thread, rather than creating them up front.
+        void setPrepareCallback(std::function<void(CompositeMap&)> callback);
+
+        /// Create mDrawables unless that was done already. Thread safe, if another thread is creating them waits until it is done.
+        void prepare();
+
+        /// Do not create mDrawables anymore, e.g. because the objects required to do so are going away.
+        void cancelPreparation();
+
+        bool isPrepared() const { return mPrepared; }
+
+    private:
+        std::function<void(CompositeMap&)> mPrepareCallback;
+        std::atomic_bool mPrepared;
+        std::mutex mPrepareMutex;
     };
 
     /**
@@ -51,21 +89,83 @@ namespace Terrain
         /// Mark this composite map to be required for the current frame
         void setImmediate(CompositeMap* map);
 
+        /// Prepare composite maps added with a prepare callback in the background, rather than in the draw thread.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+        bool hasWorkQueue() const { return mWorkQueue != nullptr; }
+
+        /// Wait for background preparation to finish and cancel the preparation of all remaining composite maps.
+        void cancelPreparation();
+
+        /// Internal use by the WorkItem preparing composite maps. Prepares the map with the highest priority and schedules
+        /// another WorkItem for the rest.
+        void prepareNextCompositeMap(const std::atomic_bool& abort);
+
         unsigned int getCompileSetSize() const;
 
+        /// Number of composite maps waiting for a worker thread to prepare them.
+        unsigned int getPrepareSetSize() const;
+
+        /// Time in seconds spent on rendering composite maps during the previous frame.
+        double getLastCompileTime() const;
+
+        /// Time in seconds that was available for rendering non-immediate composite maps during the previous frame.
+        double getLastTimeAvailable() const;
+
     private:
+        struct ComparePriority
+        {
+            bool operator()(const osg::ref_ptr<CompositeMap>& lhs, const osg::ref_ptr<CompositeMap>& rhs) const
+            {
+                if (lhs->mPriority != rhs->mPriority)
+                    return lhs->mPriority > rhs->mPriority;
+                return lhs < rhs;
+            }
+        };
+
         float mTargetFrameRate;
         double mMinimumTimeAvailable;
         mutable osg::Timer mTimer;
 
-        typedef std::set<osg::ref_ptr<CompositeMap> > CompileSet;
+        // Smoothed time of the rest of the frame and of rendering a single drawable, to adapt the time available for compiling
+        mutable double mAverageFrameTime;
+        mutable double mAverageDrawTime;
+        mutable double mLastCompileTime;
+        mutable double mLastTimeAvailable;
+
+        typedef std::set<osg::ref_ptr<CompositeMap>, ComparePriority> CompileSet;
 
         mutable CompileSet mCompileSet;
         mutable CompileSet mImmediateCompileSet;
+        // Maps waiting to be prepared, in either of the sets above as well
+        mutable CompileSet mPrepareSet;
 
         mutable std::mutex mMutex;
 
+        // Read back into a pixel buffer object, mapped once the GPU is likely done with it
+        struct PendingReadBack
+        {
+            GLuint mBuffer;
+            int mWidth;
+            int mHeight;
+            unsigned int mFrame;
+            std::function<void(osg::ref_ptr<osg::Image>)> mCallback;
+        };
+
+        // Only used from the draw thread
+        mutable std::vector<PendingReadBack> mPendingReadBacks;
+        mutable unsigned int mFrameNumber;
+
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        osg::ref_ptr<SceneUtil::WorkItem> mPrepareItem;
+        bool mPrepareScheduled;
+
         osg::ref_ptr<osg::FrameBufferObject> mFBO;
+
+        void schedulePreparation();
+        void stopPreparation();
+
+        void readBack(CompositeMap& compositeMap, osg::State& state) const;
+        void finishReadBacks(osg::State& state) const;
     };
 
 }
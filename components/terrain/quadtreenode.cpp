@@ -1,6 +1,8 @@
 #include "quadtreenode.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 #include <osgUtil/CullVisitor>
 
@@ -129,6 +131,86 @@ void QuadTreeNode::traverseNodes(ViewData* vd, const osg::Vec3f& viewPoint, LodC
         vd->add(this);
 }
 
+/// Traverse nodes according to LOD selection and record the decisions.
+/// @return the smallest margin of the recorded decisions.
+float recordNodes(QuadTreeNode* node, ViewData* vd, const osg::Vec3f& viewPoint, LodCallback* lodCallback, std::vector<LodDecision>& decisions)
+{
+    if (!node->hasValidBounds())
+        return std::numeric_limits<float>::max();
+    const float dist = node->distance(viewPoint);
+    const std::size_t index = decisions.size();
+    const unsigned int firstEntry = vd->getNumEntries();
+    const float margin = lodCallback->getDetailMargin(node, dist);
+    float subtreeMargin = margin;
+    decisions.push_back(LodDecision {node, 1, 0, margin, margin});
+    LodCallback::ReturnValue lodResult = lodCallback->isSufficientDetail(node, dist);
+    if (lodResult == LodCallback::StopTraversal)
+        return margin;
+    else if (lodResult == LodCallback::Deeper && node->getNumChildren())
+    {
+        for (unsigned int i=0; i<node->getNumChildren(); ++i)
+            subtreeMargin = std::min(subtreeMargin, recordNodes(node->getChild(i), vd, viewPoint, lodCallback, decisions));
+    }
+    else
+        vd->add(node);
+    LodDecision& decision = decisions[index];
+    decision.mSubtreeSize = static_cast<unsigned int>(decisions.size() - index);
+    decision.mNumEntries = vd->getNumEntries() - firstEntry;
+    decision.mSubtreeMargin = subtreeMargin;
+    return subtreeMargin;
+}
+
+/// Update the decisions for the subtree of previous[index] after the view point moved by the given distance.
+/// @return the smallest margin of the updated decisions.
+float updateDecisions(const std::vector<LodDecision>& previous, std::size_t index, float moved, ViewData* vd, const osg::Vec3f& viewPoint,
+    LodCallback* lodCallback, std::vector<LodDecision>& decisions)
+{
+    const LodDecision& decision = previous[index];
+    if (decision.mSubtreeMargin > moved)
+    {
+        // None of the decisions in this subtree could have changed, reuse them as they are
+        const std::size_t first = decisions.size();
+        decisions.insert(decisions.end(), previous.begin() + index, previous.begin() + index + decision.mSubtreeSize);
+        for (std::size_t i=first; i<decisions.size(); ++i)
+        {
+            LodDecision& copy = decisions[i];
+            copy.mMargin -= moved;
+            copy.mSubtreeMargin -= moved;
+            if (copy.mSubtreeSize == 1 && copy.mNumEntries == 1)
+                vd->add(copy.mNode);
+        }
+        return decision.mSubtreeMargin - moved;
+    }
+    if (decision.mMargin <= moved)
+        return recordNodes(decision.mNode, vd, viewPoint, lodCallback, decisions);
+
+    // The node itself still needs more detail, so only some of its descendants are affected
+    const std::size_t newIndex = decisions.size();
+    const unsigned int firstEntry = vd->getNumEntries();
+    float subtreeMargin = decision.mMargin - moved;
+    decisions.push_back(LodDecision {decision.mNode, 1, 0, subtreeMargin, subtreeMargin});
+    for (std::size_t child = index + 1, end = index + decision.mSubtreeSize; child < end; child += previous[child].mSubtreeSize)
+        subtreeMargin = std::min(subtreeMargin, updateDecisions(previous, child, moved, vd, viewPoint, lodCallback, decisions));
+    LodDecision& updated = decisions[newIndex];
+    updated.mSubtreeSize = static_cast<unsigned int>(decisions.size() - newIndex);
+    updated.mNumEntries = vd->getNumEntries() - firstEntry;
+    updated.mSubtreeMargin = subtreeMargin;
+    return subtreeMargin;
+}
+
+void QuadTreeNode::updateNodes(ViewData* vd, const osg::Vec3f& viewPoint, LodCallback* lodCallback)
+{
+    std::vector<LodDecision>& decisions = vd->getLodDecisions();
+    std::vector<LodDecision>& previous = vd->getPreviousLodDecisions();
+    previous.swap(decisions);
+    decisions.clear();
+    if (!previous.empty() && previous.front().mNode == this)
+        updateDecisions(previous, 0, (viewPoint - vd->getLodDecisionsViewPoint()).length(), vd, viewPoint, lodCallback, decisions);
+    else
+        recordNodes(this, vd, viewPoint, lodCallback, decisions);
+    vd->setLodDecisionsViewPoint(viewPoint);
+}
+
 void QuadTreeNode::setBoundingBox(const osg::BoundingBox &boundingBox)
 {
     mBoundingBox = boundingBox;
@@ -30,6 +30,9 @@ namespace Terrain
             StopTraversalAndUse
         };
         virtual ReturnValue isSufficientDetail(QuadTreeNode *node, float dist) = 0;
+
+        /// @return the distance the view point may move before the result of isSufficientDetail for this node could change.
+        virtual float getDetailMargin(QuadTreeNode* /*node*/, float /*dist*/) { return 0.f; }
     };
 
     class ViewData;
@@ -80,6 +83,10 @@ namespace Terrain
         /// Traverse nodes according to LOD selection.
         void traverseNodes(ViewData* vd, const osg::Vec3f& viewPoint, LodCallback* lodCallback);
 
+        /// Traverse nodes according to LOD selection, only making the decisions again that could have changed since
+        /// the previous update of the view.
+        void updateNodes(ViewData* vd, const osg::Vec3f& viewPoint, LodCallback* lodCallback);
+
     private:
         QuadTreeNode* mParent;
 
@@ -5,6 +5,8 @@
 #include <osg/PolygonMode>
 #include <osg/Material>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include <components/misc/constants.hpp>
@@ -66,23 +68,29 @@ public:
 
     ReturnValue isSufficientDetail(QuadTreeNode* node, float dist) override
     {
-        const osg::Vec2f& center = node->getCenter();
-        bool activeGrid = (center.x() > mActiveGrid.x() && center.y() > mActiveGrid.y() && center.x() < mActiveGrid.z() && center.y() < mActiveGrid.w());
-
-        if (node->getSize()>1)
-        {
-            float halfSize = node->getSize()/2;
-            osg::Vec4i nodeBounds (static_cast<int>(center.x() - halfSize), static_cast<int>(center.y() - halfSize), static_cast<int>(center.x() + halfSize), static_cast<int>(center.y() + halfSize));
-            bool intersects = (std::max(nodeBounds.x(), mActiveGrid.x()) < std::min(nodeBounds.z(), mActiveGrid.z()) && std::max(nodeBounds.y(), mActiveGrid.y()) < std::min(nodeBounds.w(), mActiveGrid.w()));
-            // to prevent making chunks who will cross the activegrid border
-            if (intersects)
-                return Deeper;
-        }
+        // to prevent making chunks who will cross the activegrid border
+        if (intersectsActiveGrid(node))
+            return Deeper;
         dist = std::max(0.f, dist + mDistanceModifier);
-        if (dist > mViewDistance && !activeGrid) // for Scene<->ObjectPaging sync the activegrid must remain loaded
+        if (dist > mViewDistance && !isInActiveGrid(node)) // for Scene<->ObjectPaging sync the activegrid must remain loaded
             return StopTraversal;
         return getNativeLodLevel(node, mMinSize) <= convertDistanceToLodLevel(dist, mMinSize, mFactor) ? StopTraversalAndUse : Deeper;
     }
+    float getDetailMargin(QuadTreeNode* node, float dist) override
+    {
+        if (intersectsActiveGrid(node))
+            return std::numeric_limits<float>::max();
+        dist = std::max(0.f, dist + mDistanceModifier);
+        float margin = std::numeric_limits<float>::max();
+        if (!isInActiveGrid(node))
+            margin = std::abs(dist - mViewDistance);
+        // The native LOD level is sufficient from the distance where convertDistanceToLodLevel reaches it
+        unsigned int lodLevel = getNativeLodLevel(node, mMinSize);
+        if (lodLevel > 0)
+            margin = std::min(margin, std::abs(dist - Constants::CellSizeInUnits*mMinSize*mFactor*(1 << lodLevel)));
+        // leave some room for rounding errors
+        return std::max(0.f, margin - 1.f);
+    }
     static unsigned int getNativeLodLevel(const QuadTreeNode* node, float minSize)
     {
         return Log2(static_cast<unsigned int>(node->getSize()/minSize));
@@ -93,6 +101,21 @@ public:
     }
 
 private:
+    bool isInActiveGrid(const QuadTreeNode* node) const
+    {
+        const osg::Vec2f& center = node->getCenter();
+        return center.x() > mActiveGrid.x() && center.y() > mActiveGrid.y() && center.x() < mActiveGrid.z() && center.y() < mActiveGrid.w();
+    }
+    bool intersectsActiveGrid(const QuadTreeNode* node) const
+    {
+        if (node->getSize() <= 1)
+            return false;
+        const osg::Vec2f& center = node->getCenter();
+        float halfSize = node->getSize()/2;
+        osg::Vec4i nodeBounds (static_cast<int>(center.x() - halfSize), static_cast<int>(center.y() - halfSize), static_cast<int>(center.x() + halfSize), static_cast<int>(center.y() + halfSize));
+        return (std::max(nodeBounds.x(), mActiveGrid.x()) < std::min(nodeBounds.z(), mActiveGrid.z()) && std::max(nodeBounds.y(), mActiveGrid.y()) < std::min(nodeBounds.w(), mActiveGrid.w()));
+    }
+
     float mFactor;
     float mMinSize;
     float mViewDistance;
@@ -444,37 +467,47 @@ void QuadTreeWorld::accept(osg::NodeVisitor &nv)
     if (!isCullVisitor && nv.getVisitorType() != osg::NodeVisitor::INTERSECTION_VISITOR)
         return;
 
-    osg::Object * viewer = isCullVisitor ? static_cast<osgUtil::CullVisitor*>(&nv)->getCurrentCamera() : nullptr;
-    bool needsUpdate = true;
-    osg::Vec3f viewPoint = viewer ? nv.getViewPoint() : nv.getEyePoint();
-    ViewData *vd = mViewDataMap->getViewData(viewer, viewPoint, mActiveGrid, needsUpdate);
-    if (needsUpdate)
+    // Cameras may be culled concurrently, so only the traversal of the chunks happens outside of the lock
+    std::vector<osg::ref_ptr<osg::Node>> renderingNodes;
     {
-        vd->reset();
-        DefaultLodCallback lodCallback(mLodFactor, mMinSize, mViewDistance, mActiveGrid);
-        mRootNode->traverseNodes(vd, viewPoint, &lodCallback);
-    }
+        std::lock_guard<std::mutex> lock(mCullMutex);
 
-    const float cellWorldSize = mStorage->getCellWorldSize();
+        osg::Object * viewer = isCullVisitor ? static_cast<osgUtil::CullVisitor*>(&nv)->getCurrentCamera() : nullptr;
+        bool needsUpdate = true;
+        osg::Vec3f viewPoint = viewer ? nv.getViewPoint() : nv.getEyePoint();
+        ViewData *vd = mViewDataMap->getViewData(viewer, viewPoint, mActiveGrid, needsUpdate);
+        if (needsUpdate)
+        {
+            vd->reset();
+            DefaultLodCallback lodCallback(mLodFactor, mMinSize, mViewDistance, mActiveGrid);
+            mRootNode->updateNodes(vd, viewPoint, &lodCallback);
+        }
 
-    for (unsigned int i=0; i<vd->getNumEntries(); ++i)
-    {
-        ViewDataEntry& entry = vd->getEntry(i);
-        loadRenderingNode(entry, vd, cellWorldSize, mActiveGrid, false);
-        entry.mRenderingNode->accept(nv);
-    }
+        const float cellWorldSize = mStorage->getCellWorldSize();
 
-    if (mHeightCullCallback && isCullVisitor)
-        updateWaterCullingView(mHeightCullCallback, vd, static_cast<osgUtil::CullVisitor*>(&nv), mStorage->getCellWorldSize(), !isGridEmpty());
+        renderingNodes.reserve(vd->getNumEntries());
+        for (unsigned int i=0; i<vd->getNumEntries(); ++i)
+        {
+            ViewDataEntry& entry = vd->getEntry(i);
+            loadRenderingNode(entry, vd, cellWorldSize, mActiveGrid, false);
+            renderingNodes.push_back(entry.mRenderingNode);
+        }
 
-    vd->setChanged(false);
+        if (mHeightCullCallback && isCullVisitor)
+            updateWaterCullingView(mHeightCullCallback, vd, static_cast<osgUtil::CullVisitor*>(&nv), mStorage->getCellWorldSize(), !isGridEmpty());
 
-    double referenceTime = nv.getFrameStamp() ? nv.getFrameStamp()->getReferenceTime() : 0.0;
-    if (referenceTime != 0.0)
-    {
-        vd->setLastUsageTimeStamp(referenceTime);
-        mViewDataMap->clearUnusedViews(referenceTime);
+        vd->setChanged(false);
+
+        double referenceTime = nv.getFrameStamp() ? nv.getFrameStamp()->getReferenceTime() : 0.0;
+        if (referenceTime != 0.0)
+        {
+            vd->setLastUsageTimeStamp(referenceTime);
+            mViewDataMap->clearUnusedViews(referenceTime);
+        }
     }
+
+    for (const osg::ref_ptr<osg::Node>& node : renderingNodes)
+        node->accept(nv);
 }
 
 void QuadTreeWorld::ensureQuadTreeBuilt()
@@ -553,7 +586,13 @@ void QuadTreeWorld::preload(View *view, const osg::Vec3f &viewPoint, const osg::
 void QuadTreeWorld::reportStats(unsigned int frameNumber, osg::Stats *stats)
 {
     if (mCompositeMapRenderer)
+    {
         stats->setAttribute(frameNumber, "Composite", mCompositeMapRenderer->getCompileSetSize());
+        stats->setAttribute(frameNumber, "Composite Preparing", mCompositeMapRenderer->getPrepareSetSize());
+        // in microseconds, as the stats are shown without decimals
+        stats->setAttribute(frameNumber, "Composite Time", mCompositeMapRenderer->getLastCompileTime() * 1e6);
+        stats->setAttribute(frameNumber, "Composite Budget", mCompositeMapRenderer->getLastTimeAvailable() * 1e6);
+    }
 }
 
 void QuadTreeWorld::loadCell(int x, int y)
@@ -589,6 +628,12 @@ void QuadTreeWorld::rebuildViews()
     mViewDataMap->rebuildViews();
 }
 
+void QuadTreeWorld::setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue)
+{
+    World::setUnrefQueue(unrefQueue);
+    mViewDataMap->setUnrefQueue(unrefQueue);
+}
+
 void QuadTreeWorld::setViewDistance(float viewDistance)
 {
     if (mViewDistance == viewDistance)
@@ -47,6 +47,8 @@ namespace Terrain
         void preload(View* view, const osg::Vec3f& eyePoint, const osg::Vec4i &cellgrid, std::atomic<bool>& abort, Loading::Reporter& reporter) override;
         void rebuildViews() override;
 
+        void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue) override;
+
         void reportStats(unsigned int frameNumber, osg::Stats* stats) override;
 
         class ChunkManager
@@ -79,6 +81,7 @@ namespace Terrain
         std::vector<ChunkManager*> mChunkManagers;
 
         std::mutex mQuadTreeMutex;
+        std::mutex mCullMutex;
         bool mQuadTreeBuilt;
         float mLodFactor;
         int mVertexLodMod;
@@ -1,5 +1,10 @@
 #include "viewdata.hpp"
 
+#include <algorithm>
+#include <limits>
+
+#include <components/sceneutil/unrefqueue.hpp>
+
 #include "quadtreenode.hpp"
 
 namespace Terrain
@@ -11,6 +16,7 @@ ViewData::ViewData()
     , mChanged(false)
     , mHasViewPoint(false)
     , mWorldUpdateRevision(0)
+    , mSortedNodesValid(false)
 {
 }
 
@@ -27,6 +33,9 @@ void ViewData::copyFrom(const ViewData& other)
     mViewPoint = other.mViewPoint;
     mActiveGrid = other.mActiveGrid;
     mWorldUpdateRevision = other.mWorldUpdateRevision;
+    mLodDecisions = other.mLodDecisions;
+    mLodDecisionsViewPoint = other.mLodDecisionsViewPoint;
+    mSortedNodesValid = false;
 }
 
 void ViewData::add(QuadTreeNode *node)
@@ -39,6 +48,7 @@ void ViewData::add(QuadTreeNode *node)
     ViewDataEntry& entry = mEntries[index];
     if (entry.set(node))
         mChanged = true;
+    mSortedNodesValid = false;
 }
 
 void ViewData::setViewPoint(const osg::Vec3f &viewPoint)
@@ -58,6 +68,7 @@ void ViewData::reset()
     // reset index for next frame
     mNumEntries = 0;
     mChanged = false;
+    mSortedNodesValid = false;
 }
 
 void ViewData::clear()
@@ -68,6 +79,20 @@ void ViewData::clear()
     mLastUsageTimeStamp = 0;
     mChanged = false;
     mHasViewPoint = false;
+    mLodDecisions.clear();
+    mSortedNodesValid = false;
+}
+
+void ViewData::unrefRenderingNodes(SceneUtil::UnrefQueue& unrefQueue)
+{
+    for (ViewDataEntry& entry : mEntries)
+    {
+        if (entry.mRenderingNode)
+        {
+            unrefQueue.push(entry.mRenderingNode);
+            entry.mRenderingNode = nullptr;
+        }
+    }
 }
 
 bool ViewData::suitableToUse(const osg::Vec4i &activeGrid) const
@@ -77,8 +102,19 @@ bool ViewData::suitableToUse(const osg::Vec4i &activeGrid) const
 
 bool ViewData::contains(QuadTreeNode *node) const
 {
-    for (unsigned int i=0; i<mNumEntries; ++i)
-        if (mEntries[i].mNode == node)
+    if (!mSortedNodesValid)
+    {
+        mSortedNodes.clear();
+        mSortedNodes.reserve(mNumEntries);
+        for (unsigned int i=0; i<mNumEntries; ++i)
+            mSortedNodes.emplace_back(mEntries[i].mNode, i);
+        std::sort(mSortedNodes.begin(), mSortedNodes.end());
+        mSortedNodesValid = true;
+    }
+    // Entries may have been modified through getEntry() since sorting, so check that the node is still there
+    auto it = std::lower_bound(mSortedNodes.begin(), mSortedNodes.end(), std::make_pair(static_cast<const QuadTreeNode*>(node), 0u));
+    for (; it != mSortedNodes.end() && it->first == node; ++it)
+        if (mEntries[it->second].mNode == node)
             return true;
     return false;
 }
@@ -141,8 +177,32 @@ ViewData *ViewDataMap::getViewData(osg::Object *viewer, const osg::Vec3f& viewPo
             if (vd->getWorldUpdateRevision() != mWorldUpdateRevision)
             {
                 vd->setWorldUpdateRevision(mWorldUpdateRevision);
+                if (mUnrefQueue)
+                    vd->unrefRenderingNodes(*mUnrefQueue);
                 vd->clear();
             }
+            if (vd->getLodDecisions().empty() || vd->getActiveGrid() != activeGrid)
+            {
+                // Start from the closest compatible view, so that only the decisions affected by the difference
+                // in view points have to be made again.
+                const ViewData* closestView = nullptr;
+                float closestDist = std::numeric_limits<float>::max();
+                for (const ViewData* other : mUsedViews)
+                {
+                    if (other != vd && other->suitableToUse(activeGrid) && other->getWorldUpdateRevision() >= mWorldUpdateRevision
+                        && !other->getLodDecisions().empty())
+                    {
+                        float dist = (viewPoint-other->getViewPoint()).length2();
+                        if (dist < closestDist)
+                        {
+                            closestDist = dist;
+                            closestView = other;
+                        }
+                    }
+                }
+                if (closestView)
+                    vd->copyFrom(*closestView);
+            }
             vd->setViewPoint(viewPoint);
             vd->setActiveGrid(activeGrid);
             needsUpdate = true;
@@ -189,6 +249,8 @@ void ViewDataMap::clearUnusedViews(double referenceTime)
     {
         if ((*it)->getLastUsageTimeStamp() + mExpiryDelay < referenceTime)
         {
+            if (mUnrefQueue)
+                (*it)->unrefRenderingNodes(*mUnrefQueue);
             (*it)->clear();
             mUnusedViews.push_back(*it);
             it = mUsedViews.erase(it);
@@ -3,11 +3,17 @@
 
 #include <vector>
 #include <deque>
+#include <utility>
 
 #include <osg/Node>
 
 #include "view.hpp"
 
+namespace SceneUtil
+{
+    class UnrefQueue;
+}
+
 namespace Terrain
 {
 
@@ -25,6 +31,24 @@ namespace Terrain
         osg::ref_ptr<osg::Node> mRenderingNode;
     };
 
+    /// LOD decision made for a node while traversing the quad tree, stored in depth first order.
+    struct LodDecision
+    {
+        QuadTreeNode* mNode;
+
+        /// Number of decisions in the subtree of mNode, including this one.
+        unsigned int mSubtreeSize;
+
+        /// Number of entries added to the view by the subtree of mNode.
+        unsigned int mNumEntries;
+
+        /// Distance the view point may move before this decision could change.
+        float mMargin;
+
+        /// Smallest mMargin in the subtree of mNode.
+        float mSubtreeMargin;
+    };
+
     class ViewData : public View
     {
     public:
@@ -39,6 +63,9 @@ namespace Terrain
 
         void clear();
 
+        /// Hand the rendering nodes to the queue, so that nodes no longer cached elsewhere are not deleted by the cull thread.
+        void unrefRenderingNodes(SceneUtil::UnrefQueue& unrefQueue);
+
         bool contains(QuadTreeNode* node) const;
 
         void copyFrom(const ViewData& other);
@@ -60,12 +87,23 @@ namespace Terrain
         void setViewPoint(const osg::Vec3f& viewPoint);
         const osg::Vec3f& getViewPoint() const { return mViewPoint; }
 
-        void setActiveGrid(const osg::Vec4i &grid) { if (grid != mActiveGrid) {mActiveGrid = grid;mEntries.clear();mNumEntries=0;} }
+        void setActiveGrid(const osg::Vec4i &grid) { if (grid != mActiveGrid) {mActiveGrid = grid;mEntries.clear();mNumEntries=0;mLodDecisions.clear();mSortedNodesValid=false;} }
         const osg::Vec4i &getActiveGrid() const { return mActiveGrid;}
 
         unsigned int getWorldUpdateRevision() const { return mWorldUpdateRevision; }
         void setWorldUpdateRevision(int updateRevision) { mWorldUpdateRevision = updateRevision; }
 
+        /// Decisions of the last traversal, used to update the view incrementally when the view point moves.
+        std::vector<LodDecision>& getLodDecisions() { return mLodDecisions; }
+        const std::vector<LodDecision>& getLodDecisions() const { return mLodDecisions; }
+
+        /// Storage for the decisions of the previous traversal while the next one is in progress.
+        std::vector<LodDecision>& getPreviousLodDecisions() { return mPreviousLodDecisions; }
+
+        /// The view point the margins of the decisions are relative to.
+        void setLodDecisionsViewPoint(const osg::Vec3f& viewPoint) { mLodDecisionsViewPoint = viewPoint; }
+        const osg::Vec3f& getLodDecisionsViewPoint() const { return mLodDecisionsViewPoint; }
+
     private:
         std::vector<ViewDataEntry> mEntries;
         unsigned int mNumEntries;
@@ -75,6 +113,13 @@ namespace Terrain
         bool mHasViewPoint;
         osg::Vec4i mActiveGrid;
         unsigned int mWorldUpdateRevision;
+        std::vector<LodDecision> mLodDecisions;
+        std::vector<LodDecision> mPreviousLodDecisions;
+        osg::Vec3f mLodDecisionsViewPoint;
+
+        // Nodes of mEntries along with their index, sorted by node for contains()
+        mutable std::vector<std::pair<const QuadTreeNode*, unsigned int>> mSortedNodes;
+        mutable bool mSortedNodesValid;
     };
 
     class ViewDataMap : public osg::Referenced
@@ -85,6 +130,7 @@ namespace Terrain
                                   // this value also serves as a threshold for when a newly loaded LOD gets unloaded again so that if you hover around an LOD transition point the LODs won't keep loading and unloading all the time.
             , mExpiryDelay(1.f)
             , mWorldUpdateRevision(0)
+            , mUnrefQueue(nullptr)
         {}
 
         ViewData* getViewData(osg::Object* viewer, const osg::Vec3f& viewPoint, const osg::Vec4i &activeGrid, bool& needsUpdate);
@@ -95,6 +141,9 @@ namespace Terrain
         void clearUnusedViews(double referenceTime);
         void rebuildViews();
 
+        /// Unreference the rendering nodes of views cleared by rebuildViews() or expiry through the given queue.
+        void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue) { mUnrefQueue = unrefQueue; }
+
         float getReuseDistance() const { return mReuseDistance; }
 
     private:
@@ -108,6 +157,8 @@ namespace Terrain
 
         unsigned int mWorldUpdateRevision;
 
+        SceneUtil::UnrefQueue* mUnrefQueue;
+
         std::deque<ViewData*> mUsedViews;
         std::deque<ViewData*> mUnusedViews;
     };
@@ -119,6 +119,24 @@ void World::setTargetFrameRate(float rate)
     mCompositeMapRenderer->setTargetFrameRate(rate);
 }
 
+void World::setLodCache(SceneUtil::LodCache* cache)
+{
+    if (mChunkManager)
+        mChunkManager->setLodCache(cache);
+}
+
+void World::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+{
+    if (mCompositeMapRenderer)
+        mCompositeMapRenderer->setWorkQueue(workQueue);
+}
+
+void World::setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue)
+{
+    if (mChunkManager)
+        mChunkManager->setUnrefQueue(unrefQueue);
+}
+
 float World::getHeightAt(const osg::Vec3f &worldPos)
 {
     return mStorage->getHeightAt(worldPos);
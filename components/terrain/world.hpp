@@ -29,6 +29,13 @@ namespace Loading
     class Reporter;
 }
 
+namespace SceneUtil
+{
+    class LodCache;
+    class UnrefQueue;
+    class WorkQueue;
+}
+
 namespace Terrain
 {
     class Storage;
@@ -57,6 +64,15 @@ namespace Terrain
         /// See CompositeMapRenderer::setTargetFrameRate
         void setTargetFrameRate(float rate);
 
+        /// See ChunkManager::setLodCache
+        void setLodCache(SceneUtil::LodCache* cache);
+
+        /// See CompositeMapRenderer::setWorkQueue
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
+        /// Unreference expired chunks through the given queue, and for QuadTreeWorld the nodes dropped by rebuilt views.
+        virtual void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue);
+
         /// Apply the scene manager's texture filtering settings to all cached textures.
         /// @note Thread safe.
         void updateTextureFiltering();